@@ -1,10 +1,16 @@
 /** @file MicroSwitch1.cpp
  *  This task is the first of two micro limit switch tasks in the program.
  *  This switch is pressed when the fire extinguisher is fully compressed.
- *  This switch is designed to change the value of the shared state variable
- *  to 2 for the FSM within task_Extinguish. This will switch the direction
+ *  This switch is designed to tell the FSM in task_Dispatcher that the
+ *  lever is clamped. This will switch the direction
  *  of the motor's rotation, thus translating the motor back toward its reset
  *  position.
+ *
+ *  By default the switch input raises an interrupt on its falling edge which
+ *  posts an event to task_Dispatcher at once, so the
+ *  motor reverses within microseconds of the switch closing. Building with
+ *  LIMIT_SWITCH_POLLING defined instead creates the original task which
+ *  reads the switch every MICROSWITCH_PERIOD ticks.
  * 
  *  @author  Hunter Brooks & William Dorosk
  *  @date    20 Nov 2021 File Created
@@ -18,20 +24,23 @@
     #include <STM32FreeRTOS.h>
 #endif
 
-#include "taskshare.h"               // Header for inter-task shared data
-#include "taskqueue.h"               // Header for inter-task data queues 
-#include "shares.h"                  // Header for shares
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
 #include "MircroSwitch1.h"           // Header for MicroSwitch1 task module
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "task_table.h"              // Header for the polling period
+#include "pin_map.h"                 // Header for the pin the switch is wired to
 
-/// Define the input pin from the Nucleo that will integrate with the micro limit switch
-//  This pin will be read whenever the extinguisher motor is rotating toward the extinguisher lever
-#define IN1 PA9 // The input pin that reads as a digital zero when the switch is pressed
+#ifdef LIMIT_SWITCH_POLLING
+
+/// Run-time statistics of this task
+TaskStats switch1_stats;
 
  /** @brief   This is the task function that controls the first micro limit switch
   *  @details This task is the first of two micro limit switch tasks in the program.
   *           This switch is pressed when the fire extinguisher is fully compressed.
-  *           This switch is designed to change the value of the shared state variable
-  *           to 2 for the FSM within task_Extinguish. This will switch the direction
+  *           This switch is designed to tell the FSM in task_Dispatcher that the
+  *           lever is clamped. This will switch the direction
   *           of the motor's rotation, thus translating the motor back toward its reset
   *           position.
   *  @param   p_params A pointer to function parameters which we don't use.
@@ -41,32 +50,32 @@ void MicroSwitch1 (void* p_params)
 {
     (void)p_params;                             // Shuts up a compiler warning
 
-    /// The number of RTOS ticks between runs of the MicroSwitch1 task
-    const TickType_t MICROSWITCH1_PERIOD = 100;
-    
     // Initialise the xLastWakeTime variable with the current time.
     // It will be used to run the task at precise intervals
 
     TickType_t xLastWakeTime = xTaskGetTickCount();
 
     // Set the pin to behave as an input pin tied to pullup resistor
-    pinMode(IN1, INPUT_PULLUP);  
+    pinMode(MICROSWITCH1_PIN, INPUT_PULLUP);  
 
     for (;;)
     {
+        switch1_stats.begin_run (xLastWakeTime);
+
         // If the extinguisher motor is rotating toward the extinguisher lever, 
         //     the input pin tied to the micro limit switch will be read every
         //     time this task is run, else the task exits
-        // If the input pin is read and returns a digital zero, the task_extinguisher
-        //     state variable share is set to two
+        // If the input pin is read and returns a digital zero, the dispatcher
+        //     is told that the lever is clamped
  
-        if (state_extinguish.get() == 1)  //share
+        if (firebot_get_state () == STATE_SPRAYING)
         {
-            uint8_t current_value = digitalRead (IN1);
+            uint8_t current_value = digitalRead (MICROSWITCH1_PIN);
             if (current_value == 0)
             {
                 current_value = 1;
-                state_extinguish.put(2);  //share
+                trace_write (TRACE_SWITCH1, TRACE_SWITCH, 1, 1);
+                firebot_post (EVENT_LEVER_CLAMPED);
             }
             else
             {
@@ -75,9 +84,53 @@ void MicroSwitch1 (void* p_params)
         else
         {
         }
+        switch1_stats.end_run ();
+
         // This type of delay waits until it has been the given number of RTOS
         // ticks since the task previously began running. This prevents timing
         // inaccuracy due to not accounting for how long the task took to run
-        vTaskDelayUntil (&xLastWakeTime, MICROSWITCH1_PERIOD);
+        vTaskDelayUntil (&xLastWakeTime, MICROSWITCH_PERIOD);
     }
 }
+
+#else
+
+/// Shortest time between two accepted presses, in microseconds. Contact bounce
+//  within this window after a press is ignored
+const uint32_t MICROSWITCH1_DEBOUNCE_US = 5000;
+
+/// Time of the last press which was passed on to the dispatcher
+volatile uint32_t switch1_last_press = 0;
+
+/** @brief   Interrupt service routine which runs when the first micro limit switch closes
+ *  @details The first edge of a press is passed on at once; the edges of the contact
+ *           bounce which follow it are dropped. The dispatcher decides whether
+ *           the press matters in its current state, so a bounce while the switch opens
+ *           again cannot advance the FSM.
+ */
+void MicroSwitch1_ISR (void)
+{
+    uint32_t now = micros ();
+    if (now - switch1_last_press < MICROSWITCH1_DEBOUNCE_US)
+    {
+        trace_write (TRACE_SWITCH1, TRACE_SWITCH, 1, 0);
+        return;
+    }
+    switch1_last_press = now;
+    trace_write (TRACE_SWITCH1, TRACE_SWITCH, 1, 1);
+
+    firebot_post_from_ISR (EVENT_LEVER_CLAMPED);
+}
+
+/** @brief   Sets up the first micro limit switch to interrupt when it is pressed
+ *  @details Must be called after firebot_events_begin(), because the interrupt
+ *           posts to the dispatcher's event queue.
+ */
+void MicroSwitch1_begin (void)
+{
+    // Set the pin to behave as an input pin tied to pullup resistor
+    pinMode(MICROSWITCH1_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(MICROSWITCH1_PIN), MicroSwitch1_ISR, FALLING);
+}
+
+#endif // LIMIT_SWITCH_POLLING
@@ -2,9 +2,12 @@
  *  This task is the first of two micro limit switch tasks in the program.
  *  This switch is pressed when the motor has fully translated back to the
  *  position it began before the fire was extinguished. This switch is 
- *  designed to change the value of the shared state variable to 3 for the
- *  FSM within task_Extinguish. This will halt the motor's rotation once 
- *  it is back to its reset position
+ *  designed to tell the FSM in task_Dispatcher that the carriage is home.
+ *  This will halt the motor's rotation once it is back to its reset position
+ *
+ *  As with MicroSwitch1, the switch normally interrupts on its falling edge
+ *  and posts to task_Dispatcher directly; LIMIT_SWITCH_POLLING brings back
+ *  the task which reads it every MICROSWITCH_PERIOD ticks.
  * 
  *  @author  Hunter Brooks & William Dorosk
  *  @date    20 Nov 2021 File Created
@@ -17,22 +20,24 @@
     #include <STM32FreeRTOS.h>
 #endif
 
-#include "taskshare.h"               // Header for inter-task shared data
-#include "taskqueue.h"               // Header for inter-task data queues  
-#include "shares.h"                  // Header for shares
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
 #include "MicroSwitch2.h"            // Header for MicroSwitch2 task module
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "task_table.h"              // Header for the polling period
+#include "pin_map.h"                 // Header for the pin the switch is wired to
 
-/// Define the input pin from the Nucleo that will integrate with the micro limit switch
-//  This pin will be read whenever the extinguisher motor is rotating away from the extinguisher lever
-#define IN1 PB6 // The input pin that reads as a digital zero when the switch is pressed
+#ifdef LIMIT_SWITCH_POLLING
+
+/// Run-time statistics of this task
+TaskStats switch2_stats;
 
  /** @brief   This is the task function that controls the first micro limit switch
   *  @details This task is the first of two micro limit switch tasks in the program.
   *           This switch is pressed when the motor has fully translated back to the
   *           position it began before the fire was extinguished. This switch is 
-  *           designed to change the value of the shared state variable to 3 for the
-  *           FSM within task_Extinguish. This will halt the motor's rotation once 
-  *           it is back to its reset position
+  *           designed to tell the FSM in task_Dispatcher that the carriage is home.
+  *           This will halt the motor's rotation once it is back to its reset position
   *  @param   p_params A pointer to function parameters which we don't use.
   */
 
@@ -40,31 +45,31 @@ void MicroSwitch2 (void* p_params)
 {
     (void)p_params;                             // Shuts up a compiler warning
 
-    /// The number of RTOS ticks between runs of the MicroSwitch2 task
-    const TickType_t MICROSWITCH2_PERIOD = 100;
-
     // Initialise the xLastWakeTime variable with the current time.
     // It will be used to run the task at precise intervals
     TickType_t xLastWakeTime = xTaskGetTickCount();
 
     // Set the pin to behave as an input pin tied to pullup resistor
-    pinMode(IN1, INPUT_PULLUP);
+    pinMode(MICROSWITCH2_PIN, INPUT_PULLUP);
 
     for (;;)
     {
+        switch2_stats.begin_run (xLastWakeTime);
+
         // If the extinguisher motor is rotating away from the extinguisher lever, 
         //     the input pin tied to the micro limit switch will be read every
         //     time this task is run, else the task exits
-        // If the input pin is read and returns a digital zero, the task_extinguisher
-        //     state variable share is set to three
+        // If the input pin is read and returns a digital zero, the dispatcher
+        //     is told that the carriage is home
  
-        if (state_extinguish.get() == 2)  //share
+        if (firebot_get_state () == STATE_UNCLAMPING)
         {
-            uint8_t current_value = digitalRead (IN1);
+            uint8_t current_value = digitalRead (MICROSWITCH2_PIN);
             if (current_value == 0)
             {
                 current_value = 1;
-                state_extinguish.put(3);  //share
+                trace_write (TRACE_SWITCH2, TRACE_SWITCH, 2, 1);
+                firebot_post (EVENT_CARRIAGE_HOME);
             }
             else
             {
@@ -74,9 +79,51 @@ void MicroSwitch2 (void* p_params)
         {
         }
 
+        switch2_stats.end_run ();
+
         // This type of delay waits until it has been the given number of RTOS
         // ticks since the task previously began running. This prevents timing
         // inaccuracy due to not accounting for how long the task took to run
-        vTaskDelayUntil (&xLastWakeTime, MICROSWITCH2_PERIOD);
+        vTaskDelayUntil (&xLastWakeTime, MICROSWITCH_PERIOD);
+    }
+}
+
+#else
+
+/// Shortest time between two accepted presses, in microseconds. Contact bounce
+//  within this window after a press is ignored
+const uint32_t MICROSWITCH2_DEBOUNCE_US = 5000;
+
+/// Time of the last press which was passed on to the dispatcher
+volatile uint32_t switch2_last_press = 0;
+
+/** @brief   Interrupt service routine which runs when the second micro limit switch closes
+ *  @details The first edge of a press is passed on at once and the contact bounce
+ *           which follows it is dropped, the same as for the first switch.
+ */
+void MicroSwitch2_ISR (void)
+{
+    uint32_t now = micros ();
+    if (now - switch2_last_press < MICROSWITCH2_DEBOUNCE_US)
+    {
+        trace_write (TRACE_SWITCH2, TRACE_SWITCH, 2, 0);
+        return;
     }
+    switch2_last_press = now;
+    trace_write (TRACE_SWITCH2, TRACE_SWITCH, 2, 1);
+
+    firebot_post_from_ISR (EVENT_CARRIAGE_HOME);
+}
+
+/** @brief   Sets up the second micro limit switch to interrupt when it is pressed
+ *  @details Must be called after firebot_events_begin(), because the interrupt
+ *           posts to the dispatcher's event queue.
+ */
+void MicroSwitch2_begin (void)
+{
+    // Set the pin to behave as an input pin tied to pullup resistor
+    pinMode(MICROSWITCH2_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(MICROSWITCH2_PIN), MicroSwitch2_ISR, FALLING);
 }
+
+#endif // LIMIT_SWITCH_POLLING
@@ -1,8 +1,8 @@
 /** @file MircroSwitch1.h
  *  This task is the first of two micro limit switch tasks in the program.
  *  This switch is pressed when the fire extinguisher is fully compressed.
- *  This switch is designed to change the value of the shared state variable
- *  to 2 for the FSM within task_Extinguish. This will switch the direction
+ *  This switch is designed to tell the FSM in task_Dispatcher that the
+ *  lever is clamped. This will switch the direction
  *  of the motor's rotation, thus translating the motor back toward its reset
  *  position.
  * 
@@ -11,3 +11,4 @@
  */
 
 void MicroSwitch1 (void* p_params);
+void MicroSwitch1_begin (void);
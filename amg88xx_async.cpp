@@ -0,0 +1,246 @@
+/** @file amg88xx_async.cpp
+ *  This file contains the AMG88xx driver which blocks its task on a task
+ *  notification while the I2C interrupt runs each transfer.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "amg88xx_async.h"           // Header for the driver
+
+#ifdef AMG88XX_ASYNC
+
+/// NVIC priority of the I2C interrupts: the most urgent one which may still call FreeRTOS
+const uint32_t AMG88XX_I2C_IRQ_PRIO = configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY;
+
+/// The task waiting for the transfer on the bus, or NULL if none is
+static TaskHandle_t i2c_waiting = NULL;
+
+
+/** @brief   Gives the waiting task its notification; called from the I2C interrupt.
+ */
+static void i2c_done (void)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+    if (i2c_waiting != NULL)
+    {
+        vTaskNotifyGiveFromISR (i2c_waiting, &higher_priority_woken);
+    }
+    portYIELD_FROM_ISR (higher_priority_woken);
+}
+
+
+/** @brief   Called by the HAL from the I2C interrupt when a memory read is over.
+ */
+void HAL_I2C_MemRxCpltCallback (I2C_HandleTypeDef* hi2c)
+{
+    (void)hi2c;
+    i2c_done ();
+}
+
+
+/** @brief   Called by the HAL from the I2C interrupt when a memory write is over.
+ */
+void HAL_I2C_MemTxCpltCallback (I2C_HandleTypeDef* hi2c)
+{
+    (void)hi2c;
+    i2c_done ();
+}
+
+
+/** @brief   Lets the I2C interrupts of a bus call FreeRTOS.
+ *  @details The Wire library gives its event and error interrupts priority
+ *           I2C_IRQ_PRIO, 2 unless the build says otherwise, which is more
+ *           urgent than FreeRTOS allows an interrupt which gives a task
+ *           notification to be; it would then corrupt the kernel's lists now
+ *           and then rather than fail outright. The Wire library sets them
+ *           in its begin(), so they are set again here after it.
+ *  @param   hi2c The bus's HAL handle
+ */
+static void i2c_irq_priority (I2C_HandleTypeDef* hi2c)
+{
+    IRQn_Type event;
+    IRQn_Type error;
+    if (hi2c->Instance == I2C1)
+    {
+        event = I2C1_EV_IRQn;
+        error = I2C1_ER_IRQn;
+    }
+#ifdef I2C2
+    else if (hi2c->Instance == I2C2)
+    {
+        event = I2C2_EV_IRQn;
+        error = I2C2_ER_IRQn;
+    }
+#endif
+#ifdef I2C3
+    else if (hi2c->Instance == I2C3)
+    {
+        event = I2C3_EV_IRQn;
+        error = I2C3_ER_IRQn;
+    }
+#endif
+    else
+    {
+        return;
+    }
+    HAL_NVIC_SetPriority (event, AMG88XX_I2C_IRQ_PRIO, 0);
+    HAL_NVIC_SetPriority (error, AMG88XX_I2C_IRQ_PRIO, 0);
+}
+
+
+/** @brief   Creates a driver which hasn't been started.
+ */
+Amg88xxAsync::Amg88xxAsync (void)
+{
+    p_i2c = NULL;
+    address = 0;
+    wait_us = 0;
+}
+
+
+/** @brief   Runs one transfer to or from the camera's registers, blocking the task until it is over.
+ *  @details A transfer which fails, such as one to a camera which doesn't
+ *           answer, ends in the Wire library's error callback rather than
+ *           ours, so it is found when the wait runs out. It is then aborted,
+ *           and a notification it might still give is taken before the next
+ *           transfer starts.
+ *  @param   read True to read the registers, false to write them
+ *  @param   reg The first register; the camera steps through the rest
+ *  @param   p_data Where the bytes go to or come from
+ *  @param   bytes How many bytes
+ *  @return  true if the camera took part in the whole transfer
+ */
+bool Amg88xxAsync::transfer (bool read, uint8_t reg, uint8_t* p_data, uint16_t bytes)
+{
+    ulTaskNotifyTake (pdTRUE, 0);
+    i2c_waiting = xTaskGetCurrentTaskHandle ();
+    HAL_StatusTypeDef status = read ? HAL_I2C_Mem_Read_IT (p_i2c, address << 1, reg, I2C_MEMADD_SIZE_8BIT,
+                                                           p_data, bytes)
+                                    : HAL_I2C_Mem_Write_IT (p_i2c, address << 1, reg, I2C_MEMADD_SIZE_8BIT,
+                                                            p_data, bytes);
+    bool done = false;
+    wait_us = 0;
+    if (status == HAL_OK)
+    {
+        uint32_t start_us = micros ();
+        done = ulTaskNotifyTake (pdTRUE, AMG88XX_TRANSFER_TIMEOUT) != 0;
+        wait_us = micros () - start_us;
+        if (!done)
+        {
+            HAL_I2C_Master_Abort_IT (p_i2c, address << 1);
+        }
+    }
+    i2c_waiting = NULL;
+    return done && HAL_I2C_GetError (p_i2c) == HAL_I2C_ERROR_NONE;
+}
+
+
+/** @brief   Writes one register.
+ */
+bool Amg88xxAsync::write (uint8_t reg, uint8_t value)
+{
+    return transfer (false, reg, &value, 1);
+}
+
+
+/** @brief   Starts the camera at an address with its interrupt off, as the Adafruit library does.
+ *  @param   addr The camera's I2C address
+ *  @param   p_wire The I2C bus it is on, whose HAL handle the transfers use
+ *  @param   settle Whether to wait the 100 ms the part takes to settle after
+ *           its reset; false lets the caller start several cameras and wait
+ *           once for them all
+ *  @return  true if the camera answered
+ */
+bool Amg88xxAsync::begin (uint8_t addr, TwoWire* p_wire, bool settle)
+{
+    address = addr;
+    p_wire->begin ();
+    p_i2c = p_wire->getHandle ();
+    i2c_irq_priority (p_i2c);
+
+    // Normal mode, software reset, interrupts off, 10 fps, then let the part settle
+    if (!write (AMG88XX_PCTL, 0x00) || !write (AMG88XX_RST, AMG88XX_RESET_INITIAL)
+        || !write (AMG88XX_INTC, 0x00) || !write (AMG88XX_FPSC, 0x00))
+    {
+        return false;
+    }
+    if (settle)
+    {
+        delay (100);
+    }
+    return true;
+}
+
+
+/** @brief   Reads a whole frame in one transfer.
+ *  @details Each pixel is a 12 bit two's complement count of 0.25 degrees C,
+ *           low byte first, which is the unit the frame ring keeps.
+ *  @param   p_pixels Where to put the 64 pixels
+ *  @return  true if the frame was read
+ */
+bool Amg88xxAsync::read_frame (int16_t* p_pixels)
+{
+    if (!transfer (true, AMG88XX_T01L, raw, sizeof (raw)))
+    {
+        return false;
+    }
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        uint16_t word = (uint16_t)(raw[2 * pixel] | (raw[2 * pixel + 1] << 8));
+        p_pixels[pixel] = (int16_t)(uint16_t)(word << 4) >> 4;
+    }
+    return true;
+}
+
+
+/** @brief   Reads the interrupt table, one bit per pixel which is past a level.
+ *  @param   p_table Where to put the 8 bytes
+ */
+bool Amg88xxAsync::read_interrupt (uint8_t* p_table)
+{
+    return transfer (true, AMG88XX_INT0, p_table, 8);
+}
+
+
+/** @brief   Clears the interrupt table, which lets the INT output go high again.
+ */
+bool Amg88xxAsync::clear_interrupt (void)
+{
+    return write (AMG88XX_RST, AMG88XX_RESET_FLAGS);
+}
+
+
+/** @brief   Sets the interrupt levels, all six bytes in one transfer.
+ *  @param   high_c Upper level in degrees C
+ *  @param   low_c Lower level in degrees C
+ *  @param   hysteresis_c Hysteresis in degrees C
+ */
+bool Amg88xxAsync::set_interrupt_levels (float high_c, float low_c, float hysteresis_c)
+{
+    uint8_t levels[6];
+    const float values[3] = { high_c, low_c, hysteresis_c };
+    for (uint8_t level = 0; level < 3; level++)
+    {
+        int16_t counts = (int16_t)constrain (lroundf (values[level] * 4.0f), -4095L, 4095L);
+        levels[2 * level] = (uint8_t)(counts & 0xFF);
+        levels[2 * level + 1] = (uint8_t)((counts >> 8) & 0x0F);
+    }
+    return transfer (false, AMG88XX_INTHL, levels, sizeof (levels));
+}
+
+
+/** @brief   Turns the INT output on.
+ *  @param   absolute true to compare pixels with the levels, false to compare them with the last frame
+ */
+bool Amg88xxAsync::enable_interrupt (bool absolute)
+{
+    return write (AMG88XX_INTC, AMG88XX_INT_ENABLE | (absolute ? AMG88XX_INT_ABSOLUTE : 0));
+}
+
+#endif // AMG88XX_ASYNC
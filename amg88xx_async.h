@@ -0,0 +1,97 @@
+/** @file amg88xx_async.h
+ *  This file contains a driver for the AMG88xx thermal camera which leaves
+ *  the processor to other tasks while it talks to the camera. The Adafruit
+ *  library reads a frame through the Wire library, which waits in a loop
+ *  until each transfer is over: 128 bytes in four pieces of 32, almost 13
+ *  milliseconds at the bus's 100 kHz, during which no task of lower
+ *  priority than the camera task gets to run. This driver starts each
+ *  transfer with the STM32 HAL's interrupt-driven memory read or write on
+ *  the Wire library's own I2C handle, and the calling task blocks on its
+ *  task notification until the transfer-complete interrupt gives it. A
+ *  whole frame is read in one transfer, and the pixels are turned straight
+ *  into 0.25 degree C counts without going through floating point.
+ *
+ *  Only the registers task_Thermal_Sensor uses are covered: the frame, the
+ *  interrupt table and its flag reset, and the interrupt levels and mode.
+ *  Every call blocks its task until the transfer is over or has failed, so
+ *  only one task may use the bus at a time, and every call must be made
+ *  from that task, not before the scheduler starts.
+ *
+ *  The I2C interrupt must be allowed to call FreeRTOS, which the Wire
+ *  library's default priority of 2 isn't, so begin() moves the bus's event
+ *  and error interrupts to configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ *  after the Wire library has set them up. Defining THERMAL_BLOCKING_I2C
+ *  at build time goes back to the Adafruit library, as does a build whose
+ *  core has no HAL I2C driver.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _AMG88XX_ASYNC_H_
+#define _AMG88XX_ASYNC_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#if defined HAL_I2C_MODULE_ENABLED && !defined THERMAL_BLOCKING_I2C
+    /// Defined when the cameras are read with this driver rather than the Adafruit library
+    #define AMG88XX_ASYNC
+#endif
+
+#ifdef AMG88XX_ASYNC
+
+/// Registers of the AMG88xx which the driver uses
+enum amg88xx_register : uint8_t
+{
+    AMG88XX_PCTL = 0x00,                     ///< Power control: 0 for normal mode
+    AMG88XX_RST = 0x01,                      ///< Reset: AMG88XX_RESET_INITIAL or AMG88XX_RESET_FLAGS
+    AMG88XX_FPSC = 0x02,                     ///< Frame rate: 0 for 10 frames per second
+    AMG88XX_INTC = 0x03,                     ///< Interrupt control: AMG88XX_INT_ENABLE and AMG88XX_INT_ABSOLUTE
+    AMG88XX_INTHL = 0x08,                    ///< Upper, lower and hysteresis levels, two bytes each
+    AMG88XX_INT0 = 0x10,                     ///< Interrupt table, eight bytes of one bit per pixel
+    AMG88XX_T01L = 0x80                      ///< Pixels, two bytes each, low byte first
+};
+
+/// Value of AMG88XX_RST which resets the whole part
+const uint8_t AMG88XX_RESET_INITIAL = 0x3F;
+/// Value of AMG88XX_RST which clears the status flags and the interrupt table
+const uint8_t AMG88XX_RESET_FLAGS = 0x30;
+/// Bit of AMG88XX_INTC which turns the INT output on
+const uint8_t AMG88XX_INT_ENABLE = 0x01;
+/// Bit of AMG88XX_INTC which compares pixels with the levels rather than with the last frame
+const uint8_t AMG88XX_INT_ABSOLUTE = 0x02;
+
+/// Longest a transfer may take before it is given up, in RTOS ticks; a frame takes 12 at 100 kHz
+const TickType_t AMG88XX_TRANSFER_TIMEOUT = 30;
+
+/** @brief   Driver for one AMG88xx on the I2C bus, which blocks its task rather than the processor.
+ */
+class Amg88xxAsync
+{
+protected:
+    I2C_HandleTypeDef* p_i2c;                ///< HAL handle of the bus, set up by the Wire library
+    uint8_t address;                         ///< 7 bit I2C address
+    uint8_t raw[128];                        ///< A frame as it comes off the bus
+    uint32_t wait_us;                        ///< Time the task spent blocked in the last transfer
+
+    bool transfer (bool read, uint8_t reg, uint8_t* p_data, uint16_t bytes);
+    bool write (uint8_t reg, uint8_t value);
+
+public:
+    Amg88xxAsync (void);
+
+    bool begin (uint8_t addr, TwoWire* p_wire = &Wire, bool settle = true);
+    bool read_frame (int16_t* p_pixels);
+    bool read_interrupt (uint8_t* p_table);
+    bool clear_interrupt (void);
+    bool set_interrupt_levels (float high_c, float low_c, float hysteresis_c);
+    bool enable_interrupt (bool absolute);
+
+    /// Returns the time the task spent blocked while the last transfer ran, in microseconds
+    uint32_t get_wait_us (void) const { return wait_us; }
+};
+
+#endif // AMG88XX_ASYNC
+
+#endif // _AMG88XX_ASYNC_H_
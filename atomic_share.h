@@ -0,0 +1,164 @@
+/** @file atomic_share.h
+ *  This file contains a share for data no bigger than one word, such as a
+ *  flag or FireBot's state, which tasks and interrupts read and write with
+ *  single atomic loads and stores. It has the get() and put() of the ME507
+ *  Share template, but where a Share copies in and out of a one-item queue
+ *  in a critical section, an AtomicShare is a plain variable: reading it
+ *  costs about as much as reading a volatile, and it never blocks. The
+ *  loads and stores are ordered, so whatever a task wrote before a put() is
+ *  seen by a task on the other core of the ESP32 which sees the new value.
+ *
+ *  Unlike a Share, get() never waits for the first put(); the share starts
+ *  with the value given to its constructor. A task which needs to know when
+ *  the value changes can ask with notify() to be sent a direct task
+ *  notification, with bits of its choosing, by each put() which changes
+ *  it, and wait for that with wait(). atomic_share_check, built with the
+ *  host simulation, checks that a waiting task is woken by a change and by
+ *  nothing else.
+ *
+ *  The cost of a get() and a put() of each kind of share is measured by
+ *  atomic_share_bench(), run when the letter 'b' is sent to the serial port.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _ATOMIC_SHARE_H_
+#define _ATOMIC_SHARE_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+/** @brief   Data of one word or less which tasks and interrupts share without a lock.
+ *  @tparam  DataType The type of the data, which the processor must be able to load
+ *           and store in one instruction
+ */
+template <class DataType>
+class AtomicShare
+{
+    static_assert (__atomic_always_lock_free (sizeof (DataType), 0),
+                   "an AtomicShare can only hold data the processor loads and stores in one go");
+
+protected:
+    DataType value;                          ///< The data
+    TaskHandle_t notify_task;                ///< Task told of each change, NULL if none
+    uint32_t notify_bits;                    ///< Notification bits that task is sent
+    const char* name;                        ///< Name for printouts
+
+    /// Swaps in a new value and returns the old one
+    DataType exchange (DataType new_data)
+    {
+        DataType old_data;
+        __atomic_exchange (&value, &new_data, &old_data, __ATOMIC_ACQ_REL);
+        return old_data;
+    }
+
+public:
+    /** @brief   Creates a share holding a starting value.
+     *  @param   p_name A name for the share, used in printouts
+     *  @param   initial The value get() returns until the first put()
+     */
+    AtomicShare (const char* p_name = NULL, DataType initial = DataType ())
+        : value (initial), notify_task (NULL), notify_bits (0), name (p_name)
+    {
+    }
+
+    /** @brief   Has a task sent a notification each time put() changes the value.
+     *  @details Call before the writers start. The bits are set in the task's
+     *           notification value, so they can be told apart from the other
+     *           notifications it gets.
+     *  @param   task The task to notify, or NULL to stop notifying
+     *  @param   bits The bits to set in its notification value
+     */
+    void notify (TaskHandle_t task, uint32_t bits)
+    {
+        notify_task = task;
+        notify_bits = bits;
+    }
+
+    /// Writes new data into the share, replacing what was there
+    void put (DataType new_data)
+    {
+        if (notify_task == NULL)
+        {
+            __atomic_store (&value, &new_data, __ATOMIC_RELEASE);
+        }
+        else if (exchange (new_data) != new_data)
+        {
+            xTaskNotify (notify_task, notify_bits, eSetBits);
+        }
+    }
+
+    /// Writes new data into the share from within an interrupt service routine
+    void ISR_put (DataType new_data)
+    {
+        if (notify_task == NULL)
+        {
+            __atomic_store (&value, &new_data, __ATOMIC_RELEASE);
+        }
+        else if (exchange (new_data) != new_data)
+        {
+            BaseType_t woken = pdFALSE;
+            xTaskNotifyFromISR (notify_task, notify_bits, eSetBits, &woken);
+            portYIELD_FROM_ISR (woken);
+        }
+    }
+
+    /// Reads the share
+    void get (DataType& recv_data)
+    {
+        __atomic_load (&value, &recv_data, __ATOMIC_ACQUIRE);
+    }
+
+    /// Reads the share and returns its value
+    DataType get (void)
+    {
+        DataType recv_data;
+        get (recv_data);
+        return recv_data;
+    }
+
+    /// Reads the share from within an interrupt service routine
+    void ISR_get (DataType& recv_data)
+    {
+        get (recv_data);
+    }
+
+    /** @brief   Waits until the share holds something other than a given value.
+     *  @details Only the task given to notify() may call this, and only if it
+     *           isn't waiting for other notifications as well, as any which
+     *           arrive meanwhile are taken along with the share's.
+     *  @param   old_data The value to wait for a change from
+     *  @param   ticks The longest time to wait, in RTOS ticks
+     *  @return  The value in the share, which is still @c old_data if the time ran out
+     */
+    DataType wait (DataType old_data, TickType_t ticks = portMAX_DELAY)
+    {
+        TickType_t start = xTaskGetTickCount ();
+        DataType now_data = get ();
+        while (now_data == old_data)
+        {
+            TickType_t waited = xTaskGetTickCount () - start;
+            if (ticks != portMAX_DELAY && waited >= ticks)
+            {
+                break;
+            }
+            uint32_t bits = 0;
+            xTaskNotifyWait (0, notify_bits, &bits, ticks == portMAX_DELAY ? portMAX_DELAY : ticks - waited);
+            now_data = get ();
+        }
+        return now_data;
+    }
+
+    void operator<< (DataType new_data) { put (new_data); }
+    void operator>> (DataType& recv_data) { get (recv_data); }
+
+    /// Returns the name given to the constructor
+    const char* get_name (void) const { return name; }
+};
+
+void atomic_share_bench (Print& printer);
+
+#endif // _ATOMIC_SHARE_H_
@@ -0,0 +1,133 @@
+/** @file background_model.cpp
+ *  This file contains the per-pixel, per-sector background model which the
+ *  thermal camera task uses to decide whether a frame contains a fire.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include <math.h>
+
+#include "background_model.h"        // Header for the background model
+
+
+/** @brief   Creates a background model which has not yet seen any frames.
+ */
+BackgroundModel::BackgroundModel (void)
+{
+    memset (mean, 0, sizeof (mean));
+    memset (variance, 0, sizeof (variance));
+    memset (samples, 0, sizeof (samples));
+}
+
+
+/** @brief   Compares a frame with the background of its sector and learns from it.
+ *  @details Each pixel is compared with its average before the average is
+ *           updated, so a pixel is judged only against frames before it; to
+ *           allow for error in the heading, it must be above the averages of
+ *           the pixels on either side of it as well as its own.
+ *           Pixels which are flagged still move the averages, but much more
+ *           slowly, so something that really does stay hot, like a heater
+ *           which has been switched on, is eventually taken as background.
+ *           Until a sector has seen BACKGROUND_WARMUP_FRAMES frames no pixel
+ *           in it is flagged.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts
+ *  @param   sector The turntable sector the camera was pointing into
+ *  @param   learn Whether to update the averages; pass false while spraying
+ *  @return  A mask with bit (row * 8 + column) set for each pixel well above its background
+ */
+uint64_t BackgroundModel::update (const int16_t* pixels, uint8_t sector, bool learn)
+{
+    int16_t* p_mean = mean[sector];
+    uint16_t* p_variance = variance[sector];
+    uint64_t flagged = 0;
+
+    // The first frame of a sector simply becomes its average
+    if (samples[sector] == 0)
+    {
+        if (learn)
+        {
+            for (uint8_t pixel = 0; pixel < 64; pixel++)
+            {
+                p_mean[pixel] = (int16_t)(pixels[pixel] << 4);
+                p_variance[pixel] = 0;
+            }
+            samples[sector] = 1;
+        }
+        return 0;
+    }
+
+    const bool warm = is_warm (sector);
+    const int32_t min_rise = (int32_t)BACKGROUND_MIN_RISE << 4;
+    const int32_t sigmas_squared = (int32_t)BACKGROUND_SIGMAS * BACKGROUND_SIGMAS;
+
+    // Compare against the hottest background of each pixel and its left and
+    //     right neighbours, because the heading is only an estimate and the
+    //     scene in a sector slides sideways a little from one turn to the next
+    int16_t near_mean[64];
+    uint16_t near_variance[64];
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        uint8_t left = (pixel & 7) ? pixel - 1 : pixel;
+        uint8_t right = ((pixel & 7) != 7) ? pixel + 1 : pixel;
+        int16_t hottest = p_mean[pixel];
+        hottest = p_mean[left] > hottest ? p_mean[left] : hottest;
+        near_mean[pixel] = p_mean[right] > hottest ? p_mean[right] : hottest;
+        uint16_t widest = p_variance[pixel];
+        widest = p_variance[left] > widest ? p_variance[left] : widest;
+        near_variance[pixel] = p_variance[right] > widest ? p_variance[right] : widest;
+    }
+
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        // Deviation in 1/16 counts, and its square in 1/16 counts squared
+        int32_t deviation = ((int32_t)pixels[pixel] << 4) - p_mean[pixel];
+        int32_t squared = (deviation * deviation) >> 4;
+        int32_t rise = ((int32_t)pixels[pixel] << 4) - near_mean[pixel];
+
+        bool hot = warm && rise >= min_rise
+                   && ((rise * rise) >> 4) > sigmas_squared * near_variance[pixel];
+        if (hot)
+        {
+            flagged |= 1ull << pixel;
+        }
+
+        if (learn)
+        {
+            uint8_t shift = hot ? BACKGROUND_ALPHA_SHIFT + BACKGROUND_FLAGGED_SHIFT
+                                : BACKGROUND_ALPHA_SHIFT;
+            int32_t half = 1 << (shift - 1);
+            p_mean[pixel] += (int16_t)((deviation + half) >> shift);
+
+            if (squared > UINT16_MAX)
+            {
+                squared = UINT16_MAX;
+            }
+            int32_t new_variance = p_variance[pixel] + ((squared - p_variance[pixel] + half) >> shift);
+            p_variance[pixel] = (uint16_t)(new_variance < 0 ? 0 : new_variance);
+        }
+    }
+
+    if (learn && samples[sector] < UINT8_MAX)
+    {
+        samples[sector]++;
+    }
+    return flagged;
+}
+
+
+/** @brief   Returns the sector a turntable heading in degrees falls in.
+ *  @param   heading_deg The heading, which may be negative or more than a full turn
+ */
+uint8_t BackgroundModel::sector_of (float heading_deg)
+{
+    float wrapped = fmodf (heading_deg, 360.0f);
+    if (wrapped < 0.0f)
+    {
+        wrapped += 360.0f;
+    }
+    uint8_t sector = (uint8_t)(wrapped * (BACKGROUND_SECTORS / 360.0f));
+    return sector < BACKGROUND_SECTORS ? sector : 0;
+}
@@ -0,0 +1,64 @@
+/** @file background_model.h
+ *  This file contains a model of what each thermal camera pixel normally
+ *  sees, so that a fire can be told apart from a surface which is simply
+ *  warm. The turntable's circle is split into sectors, and for every pixel
+ *  in every sector the model keeps an exponentially weighted moving average
+ *  of the temperature and of its squared deviation. A pixel is flagged only
+ *  when it is well above its own average by both an absolute margin and a
+ *  number of standard deviations, so a sun-warmed wall which is always hot
+ *  stops triggering while a small fire in a cold room which never gets near
+ *  60 degrees C still stands out. Memory and update time are both constant
+ *  per pixel: four bytes for each pixel in each sector, and a few integer
+ *  operations per pixel per frame.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _BACKGROUND_MODEL_H_
+#define _BACKGROUND_MODEL_H_
+
+#include <stdint.h>
+
+/// Number of sectors the turntable's circle is split into, each with its own background
+const uint8_t BACKGROUND_SECTORS = 24;
+
+/// Frames a sector must have seen before its background is trusted
+const uint8_t BACKGROUND_WARMUP_FRAMES = 8;
+
+/// Each new frame moves the averages by 1/2^BACKGROUND_ALPHA_SHIFT of the way
+const uint8_t BACKGROUND_ALPHA_SHIFT = 3;
+
+/// Flagged pixels are learned this many times more slowly, so a fire is not absorbed
+const uint8_t BACKGROUND_FLAGGED_SHIFT = 4;
+
+/// A pixel must be at least this far above its average, in 0.25 degree C counts (8 degrees C)
+const int16_t BACKGROUND_MIN_RISE = 32;
+
+/// A pixel must be at least this many standard deviations above its average
+const uint8_t BACKGROUND_SIGMAS = 5;
+
+/** @brief   Per-pixel, per-sector background temperature model with incremental updates.
+ *  @details The averages are kept in fixed point: the mean in 1/16 of a count
+ *           and the variance in 1/16 of a count squared, both in 16 bits.
+ */
+class BackgroundModel
+{
+protected:
+    int16_t mean[BACKGROUND_SECTORS][64];    ///< Average temperature, 1/16 count units
+    uint16_t variance[BACKGROUND_SECTORS][64]; ///< Average squared deviation, 1/16 count^2 units
+    uint8_t samples[BACKGROUND_SECTORS];     ///< Frames learned in each sector, saturating
+
+public:
+    BackgroundModel (void);
+
+    uint64_t update (const int16_t* pixels, uint8_t sector, bool learn = true);
+
+    /// Returns true once a sector has seen enough frames for its flags to be trusted
+    bool is_warm (uint8_t sector) const { return samples[sector] >= BACKGROUND_WARMUP_FRAMES; }
+
+    /// Returns the sector a turntable heading in degrees falls in
+    static uint8_t sector_of (float heading_deg);
+};
+
+#endif // _BACKGROUND_MODEL_H_
@@ -0,0 +1,117 @@
+/** @file boot.cpp
+ *  This file keeps track of which parts of FireBot have passed their boot
+ *  self-test (see boot.h), arms it when the last one does, and reports the
+ *  time each took.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "boot.h"                    // Header for the fast boot
+#include "task_Dispatcher.h"         // Header for the event which arms FireBot
+
+/// Names of the parts, in the order of their bits in boot_part
+static const char* const BOOT_PART_NAMES[BOOT_PARTS] = { "cameras", "motors", "switches" };
+
+/// Bits of boot_part which have passed; changed only with atomic operations
+static uint8_t boot_parts_passed = 0;
+
+/// Value of micros() when each part passed, each written only by the task which tests it
+static uint32_t boot_part_us[BOOT_PARTS];
+
+/// Tries each part took, each written only by the task which tests it
+static uint16_t boot_part_tries[BOOT_PARTS];
+
+/// Value of micros() when FireBot was armed, or 0 if it hasn't been
+static uint32_t boot_armed_at_us = 0;
+
+
+/** @brief   Records that a part of FireBot has passed its self-test, and arms
+ *           FireBot if it was the last.
+ *  @details Each part is tested by one task, and the task whose part completes
+ *           BOOT_ALL posts EVENT_ARMED; the parts are marked with an atomic
+ *           OR, so that exactly one task does so even when the tasks run on
+ *           both cores.
+ *  @param   part The part which passed
+ *  @param   source The trace ring of the task calling, which the result goes into
+ *  @param   tries How many tries the part took
+ */
+void boot_passed (boot_part part, trace_source source, uint16_t tries)
+{
+    uint32_t now = micros ();
+    for (uint8_t index = 0; index < BOOT_PARTS; index++)
+    {
+        if (part == (1 << index))
+        {
+            boot_part_us[index] = now;
+            boot_part_tries[index] = tries;
+        }
+    }
+    trace_write (source, TRACE_BOOT, part, tries);
+
+    uint8_t before = __atomic_fetch_or (&boot_parts_passed, (uint8_t)part, __ATOMIC_ACQ_REL);
+    if ((before | part) == BOOT_ALL && before != BOOT_ALL)
+    {
+        __atomic_store_n (&boot_armed_at_us, now ? now : 1, __ATOMIC_RELEASE);
+        firebot_post (EVENT_ARMED);
+    }
+}
+
+
+/** @brief   Returns whether every part of FireBot has passed its self-test.
+ */
+bool boot_is_armed (void)
+{
+    return __atomic_load_n (&boot_armed_at_us, __ATOMIC_ACQUIRE) != 0;
+}
+
+
+/** @brief   Returns the value of micros() when FireBot was armed, which is the
+ *           time from power-up to armed, or 0 if it hasn't been armed yet.
+ */
+uint32_t boot_armed_us (void)
+{
+    return __atomic_load_n (&boot_armed_at_us, __ATOMIC_ACQUIRE);
+}
+
+
+/** @brief   Prints the time from power-up to armed and each part's time and tries.
+ *  @details A part which hasn't passed yet is shown as waiting, which after a
+ *           power blip tells which peripheral is still missing.
+ *  @param   printer The serial port or other stream to print to
+ */
+void boot_report (Print& printer)
+{
+    uint32_t armed_us = boot_armed_us ();
+    uint8_t passed = __atomic_load_n (&boot_parts_passed, __ATOMIC_ACQUIRE);
+
+    printer << "Boot: ";
+    if (armed_us != 0)
+    {
+        printer << "armed at " << armed_us / 1000 << "." << (armed_us / 100) % 10 << " ms";
+    }
+    else
+    {
+        printer << "not armed";
+    }
+    for (uint8_t index = 0; index < BOOT_PARTS; index++)
+    {
+        printer << (index ? ", " : "; ") << BOOT_PART_NAMES[index];
+        if (passed & (1 << index))
+        {
+            printer << " " << boot_part_us[index] / 1000 << " ms in " << boot_part_tries[index]
+                    << (boot_part_tries[index] == 1 ? " try" : " tries");
+        }
+        else
+        {
+            printer << " waiting";
+        }
+    }
+    printer << endl;
+}
@@ -0,0 +1,116 @@
+/** @file boot.h
+ *  This file contains FireBot's fast boot. setup() starts every task at
+ *  once, without waiting, and each task brings up and tests the hardware it
+ *  owns while the others do the same: task_Thermal_Sensor the thermal
+ *  cameras, which take the longest, task_Rotation_Base the motor driver,
+ *  and task_Extinguisher the limit switches. Each self-test is short and
+ *  bounded:
+ *
+ *  - cameras: every camera which answers is sent one reset together, they
+ *    settle together, and each must then give a frame whose pixels are not
+ *    all the same, which a stuck bus or a camera still in reset would;
+ *  - switches: the carriage can't be pressing the lever and be home at
+ *    once, so the two limit switches must not both read closed.
+ *
+ *  The motor driver isn't tested: the TB6612 has no fault or current
+ *  output and the turntable no encoder, so nothing it does can be read
+ *  back. Stopping the turntable brings the driver out of standby, and the
+ *  motors count as ready once that is done.
+ *
+ *  As each part passes it says so with boot_passed(), and the one which
+ *  completes the set posts EVENT_ARMED to the dispatcher, which leaves
+ *  STATE_BOOTING and starts the turntable scanning. Until then no fire is
+ *  acted on. A part which fails isn't waited for in a loop; its task tries
+ *  again after a wait which doubles each time, from BOOT_RETRY_FIRST up to
+ *  BOOT_RETRY_MAX ticks, so a camera which comes up late after a power blip
+ *  is picked up within a second or so while the rest of FireBot, the trace
+ *  log and the serial commands keep running. FireBot is armed as soon as
+ *  one camera passes; a camera which wasn't there then goes on being tried
+ *  with the same growing wait, between frames, and joins the others when
+ *  it passes.
+ *
+ *  The time from power-up to armed, and each part's time and tries, go into
+ *  the trace log and are printed with the task statistics when the letter
+ *  's' is sent to the serial port.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _BOOT_H_
+#define _BOOT_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "trace.h"                   // Header for the trace log each part's self-test goes into
+
+/// Parts of FireBot which must be ready, most by passing a self-test, before it is armed
+enum boot_part : uint8_t
+{
+    BOOT_CAMERAS = 1 << 0,                   ///< Thermal cameras, tested by task_Thermal_Sensor
+    BOOT_MOTORS = 1 << 1,                    ///< Motor driver, brought up but not tested by task_Rotation_Base
+    BOOT_SWITCHES = 1 << 2,                  ///< Limit switches, tested by task_Extinguisher
+    BOOT_ALL = BOOT_CAMERAS | BOOT_MOTORS | BOOT_SWITCHES
+};
+
+/// Number of parts in boot_part
+const uint8_t BOOT_PARTS = 3;
+
+/// RTOS ticks a part waits before its first retry
+const TickType_t BOOT_RETRY_FIRST = 50;
+
+/// Most RTOS ticks a part waits between retries
+const TickType_t BOOT_RETRY_MAX = 1000;
+
+/** @brief   Waits between tries at bringing up a part, twice as long each time.
+ */
+class BootRetry
+{
+protected:
+    TickType_t wait_ticks;                   ///< How long the next wait is
+    uint16_t tries;                          ///< Tries made so far
+    TickType_t failed_tick;                  ///< When the last try failed, for is_due()
+    TickType_t due_ticks;                    ///< How long after that the next try is due
+
+    /// Moves on to the next try, doubling the wait up to BOOT_RETRY_MAX
+    void advance (void)
+    {
+        wait_ticks = wait_ticks < BOOT_RETRY_MAX / 2 ? 2 * wait_ticks : BOOT_RETRY_MAX;
+        tries++;
+    }
+
+public:
+    /// Starts counting from the first try
+    BootRetry (void) : wait_ticks (BOOT_RETRY_FIRST), tries (1), failed_tick (0), due_ticks (0) { }
+
+    /// Waits before the next try, then doubles the wait up to BOOT_RETRY_MAX
+    void wait (void)
+    {
+        vTaskDelay (wait_ticks);
+        advance ();
+    }
+
+    /// Starts the wait before the next try without waiting, for a task which has other work meanwhile
+    void failed (void)
+    {
+        failed_tick = xTaskGetTickCount ();
+        due_ticks = wait_ticks;
+        advance ();
+    }
+
+    /// Returns whether the wait started by failed() is over
+    bool is_due (void) const { return (TickType_t)(xTaskGetTickCount () - failed_tick) >= due_ticks; }
+
+    /// Returns the number of tries made, counting the one under way
+    uint16_t get_tries (void) const { return tries; }
+};
+
+void boot_passed (boot_part part, trace_source source, uint16_t tries);
+bool boot_is_armed (void);
+uint32_t boot_armed_us (void);
+void boot_report (Print& printer);
+
+#endif // _BOOT_H_
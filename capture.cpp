@@ -0,0 +1,233 @@
+/** @file capture.cpp
+ *  This file contains the ring task_Thermal_Sensor writes its frames into
+ *  while a capture is running, and the code task_Trace uses to send a
+ *  capture over the serial port: the header, then on each run the records
+ *  of every trace ring and the capture ring merged into time order.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "capture.h"                 // Header for the capture format
+#include "fire_queue.h"              // Header for FIRE_SINGLE_TARGET, which TURNTABLE_STOP_IN_PLACE implies
+
+static_assert (sizeof (capture_header) == 16, "the capture header must pack into sixteen bytes");
+static_assert (sizeof (capture_record) == sizeof (trace_record), "capture records are trace records");
+static_assert ((CAPTURE_RING_SIZE & (CAPTURE_RING_SIZE - 1)) == 0, "CAPTURE_RING_SIZE must be a power of two");
+static_assert ((uint8_t)TRACE_TYPES <= (uint8_t)CAPTURE_PAYLOAD, "trace types must stay below the types with a payload");
+static_assert (((TRACE_RINGS * TRACE_RING_SIZE + TRACE_RINGS + 2) * sizeof (capture_record)
+                + CAPTURE_RING_SIZE * (sizeof (capture_record) + CAPTURE_MAX_PAYLOAD)) * 10
+               <= TRACE_BAUD_RATE * TRACE_DRAIN_PERIOD / 1000,
+               "the serial port must be able to send full rings before the next drain");
+
+/// Frames and interrupt tables waiting to be sent, written by task_Thermal_Sensor
+capture_ring capture_frames;
+
+/// Whether a capture is running; set and cleared only by task_Trace
+AtomicShare<bool> capturing ("capturing", false);
+
+/// Drop count of the capture ring already reported
+static uint16_t capture_dropped_sent = 0;
+
+
+/** @brief   Writes one record with its payload into the capture ring.
+ *  @details Only task_Thermal_Sensor may call this. A record which finds the
+ *           ring full is dropped and counted. Payloads longer than
+ *           CAPTURE_MAX_PAYLOAD are cut short.
+ *  @param   type What the record holds
+ *  @param   arg Small argument, see capture_type
+ *  @param   p_payload The payload
+ *  @param   bytes Size of the payload
+ */
+void capture_write (capture_type type, uint8_t arg, const void* p_payload, uint16_t bytes)
+{
+    uint16_t head = capture_frames.head;
+    if ((uint16_t)(head - __atomic_load_n (&capture_frames.tail, __ATOMIC_ACQUIRE)) >= CAPTURE_RING_SIZE)
+    {
+        capture_frames.dropped++;
+        return;
+    }
+    capture_slot& slot = capture_frames.slots[head & (CAPTURE_RING_SIZE - 1)];
+    bytes = bytes < CAPTURE_MAX_PAYLOAD ? bytes : CAPTURE_MAX_PAYLOAD;
+    memcpy (slot.payload, p_payload, bytes);
+    slot.record.time_us = trace_clock ();
+    slot.record.type = type;
+    slot.record.arg = arg;
+    slot.record.value = bytes;
+    __atomic_store_n (&capture_frames.head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+}
+
+
+/** @brief   Returns the capture_flag bits of the build options this firmware was compiled with.
+ */
+uint16_t capture_build_flags (void)
+{
+    uint16_t flags = 0;
+#ifdef LIMIT_SWITCH_POLLING
+    flags |= CAPTURE_SWITCH_POLLING;
+#endif
+#ifdef THERMAL_ABSOLUTE_MODE
+    flags |= CAPTURE_ABSOLUTE_MODE;
+#endif
+#ifdef TURNTABLE_STOP_IN_PLACE
+    flags |= CAPTURE_STOP_IN_PLACE;
+#endif
+#ifdef EXTINGUISHER_CONSTANT_PWM
+    flags |= CAPTURE_CONSTANT_PWM;
+#endif
+#ifdef TURNTABLE_CONSTANT_SCAN
+    flags |= CAPTURE_CONSTANT_SCAN;
+#endif
+#ifdef THERMAL_SINGLE_SENSOR
+    flags |= CAPTURE_SINGLE_SENSOR;
+#endif
+#ifdef THERMAL_BLOCKING_I2C
+    flags |= CAPTURE_BLOCKING_I2C;
+#endif
+#ifdef AIM_PIXEL_CENTROID
+    flags |= CAPTURE_PIXEL_CENTROID;
+#endif
+#ifdef FIRE_SINGLE_TARGET
+    flags |= CAPTURE_SINGLE_TARGET;
+#endif
+    return flags;
+}
+
+
+/** @brief   Starts a capture by sending its header.
+ *  @details Frames left in the capture ring from an earlier capture are thrown
+ *           away. Only task_Trace may call this.
+ *  @param   port The serial port the capture goes out of
+ *  @param   cameras The number of thermal cameras which answered at power-up
+ */
+void capture_start (Print& port, uint8_t cameras)
+{
+    __atomic_store_n (&capture_frames.tail, __atomic_load_n (&capture_frames.head, __ATOMIC_ACQUIRE),
+                      __ATOMIC_RELEASE);
+    capture_dropped_sent = __atomic_load_n (&capture_frames.dropped, __ATOMIC_RELAXED);
+
+    capture_header header;
+    memcpy (header.magic, CAPTURE_MAGIC, sizeof (header.magic));
+    header.version = CAPTURE_VERSION;
+    header.header_bytes = sizeof (header);
+    header.start_us = micros ();
+    header.flags = capture_build_flags ();
+    header.cameras = cameras;
+    header.reserved = 0;
+    port.write ((const uint8_t*)&header, sizeof (header));
+    capturing.put (true);
+}
+
+
+/** @brief   Sends every record waiting in the trace rings and the capture ring, oldest first.
+ *  @details Each ring is in time order already, so the rings are merged by
+ *           taking the oldest waiting record of any of them each time. Only
+ *           the records already written when the drain starts are sent, so
+ *           the next drain's records are all later. Time stamps are turned from
+ *           trace_clock() counts into micros() by their age, which is right as
+ *           long as no record waits longer than the clock takes to wrap around,
+ *           53 seconds at 80 MHz. Records lost to full rings are reported last.
+ *           Only task_Trace may call this.
+ *  @param   port The serial port the capture goes out of
+ *  @param   p_dropped_sent Drop count of each trace ring already reported
+ */
+void capture_drain (Print& port, uint16_t* p_dropped_sent)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    const uint32_t clock_mhz = SystemCoreClock / 1000000;
+#else
+    const uint32_t clock_mhz = 1;
+#endif
+
+    // Look at the heads first, so that every record to be sent is older than the clock reading
+    uint16_t heads[TRACE_RINGS + 1];
+    uint16_t tails[TRACE_RINGS + 1];
+    for (uint8_t source = 0; source < TRACE_RINGS; source++)
+    {
+        heads[source] = __atomic_load_n (&trace_rings[source].head, __ATOMIC_ACQUIRE);
+        tails[source] = trace_rings[source].tail;
+    }
+    heads[TRACE_RINGS] = __atomic_load_n (&capture_frames.head, __ATOMIC_ACQUIRE);
+    tails[TRACE_RINGS] = capture_frames.tail;
+    uint32_t now_clock = trace_clock ();
+    uint32_t now_us = micros ();
+
+    for (;;)
+    {
+        // The oldest record at the tail of any ring goes next
+        uint8_t oldest = TRACE_RINGS + 1;
+        uint32_t oldest_age = 0;
+        for (uint8_t source = 0; source <= TRACE_RINGS; source++)
+        {
+            if (tails[source] == heads[source])
+            {
+                continue;
+            }
+            uint32_t time = source < TRACE_RINGS
+                            ? trace_rings[source].records[tails[source] & (TRACE_RING_SIZE - 1)].time
+                            : capture_frames.slots[tails[source] & (CAPTURE_RING_SIZE - 1)].record.time_us;
+            uint32_t age = now_clock - time;
+            if (oldest > TRACE_RINGS || age > oldest_age)
+            {
+                oldest = source;
+                oldest_age = age;
+            }
+        }
+        if (oldest > TRACE_RINGS)
+        {
+            break;
+        }
+
+        // Copy the record, hand its slot back, then send it; a frame's payload
+        //     is sent from its slot before the slot is handed back
+        uint16_t tail = tails[oldest]++;
+        if (oldest < TRACE_RINGS)
+        {
+            const trace_record& source_record = trace_rings[oldest].records[tail & (TRACE_RING_SIZE - 1)];
+            capture_record record = { now_us - oldest_age / clock_mhz, source_record.type,
+                                      source_record.arg, source_record.value };
+            __atomic_store_n (&trace_rings[oldest].tail, tails[oldest], __ATOMIC_RELEASE);
+            port.write ((const uint8_t*)&record, sizeof (record));
+        }
+        else
+        {
+            const capture_slot& slot = capture_frames.slots[tail & (CAPTURE_RING_SIZE - 1)];
+            capture_record record = slot.record;
+            record.time_us = now_us - oldest_age / clock_mhz;
+            port.write ((const uint8_t*)&record, sizeof (record));
+            port.write (slot.payload, record.value);
+            __atomic_store_n (&capture_frames.tail, tails[oldest], __ATOMIC_RELEASE);
+        }
+    }
+
+    // Report records lost since the last run, the capture ring as source TRACE_RINGS
+    for (uint8_t source = 0; source <= TRACE_RINGS; source++)
+    {
+        uint16_t dropped = __atomic_load_n (source < TRACE_RINGS ? &trace_rings[source].dropped
+                                                                 : &capture_frames.dropped, __ATOMIC_RELAXED);
+        uint16_t& sent = source < TRACE_RINGS ? p_dropped_sent[source] : capture_dropped_sent;
+        if (dropped != sent)
+        {
+            capture_record record = { now_us, TRACE_DROPPED, source, (uint16_t)(dropped - sent) };
+            port.write ((const uint8_t*)&record, sizeof (record));
+            sent = dropped;
+        }
+    }
+}
+
+
+/** @brief   Sends what is left of a capture and ends it.
+ *  @details Only task_Trace may call this.
+ *  @param   port The serial port the capture goes out of
+ *  @param   p_dropped_sent Drop count of each trace ring already reported
+ */
+void capture_stop (Print& port, uint16_t* p_dropped_sent)
+{
+    capturing.put (false);
+    capture_drain (port, p_dropped_sent);
+    capture_record record = { micros (), CAPTURE_END, 0, 0 };
+    port.write ((const uint8_t*)&record, sizeof (record));
+}
@@ -0,0 +1,151 @@
+/** @file capture.h
+ *  This file contains FireBot's capture format, a versioned binary recording
+ *  of what the firmware saw and did, and the writer which streams it out of
+ *  the serial port. A capture holds every thermal camera frame, the
+ *  interrupt tables read from the cameras, the limit switch edges, the motor
+ *  commands and the dispatcher's events, each with its time in
+ *  microseconds. It is meant to be recorded in the field and played back on
+ *  the host (see sim/replay_main.cpp), where the unmodified firmware is fed
+ *  the recorded frames and switch edges many times faster than real time so
+ *  that thresholds and timing can be tuned against real data.
+ *
+ *  Sending the letter 'r' to task_Trace starts a capture and sending it
+ *  again stops it. While a capture is running the trace log's records go
+ *  out in the capture format instead of as framed trace records, and no
+ *  text is printed, so the bytes from the port after the header can be
+ *  saved straight to a file. A capture is
+ *
+ *      capture_header, then capture_record, capture_record, ...
+ *
+ *  all little endian. A record whose type is below CAPTURE_PAYLOAD is a
+ *  trace_record (see trace.h) with its time turned into microseconds; a
+ *  record of type CAPTURE_PAYLOAD or above is followed by @c value bytes of
+ *  payload. A reader skips the types it doesn't know, so new types can be
+ *  added without changing the version; CAPTURE_VERSION changes only when
+ *  the layout of something already in the format does. The records of one
+ *  drain of task_Trace are in time order, and each drain's records are
+ *  later than the last one's.
+ *
+ *  The thermal camera task writes its frames into a single-writer,
+ *  single-reader ring of its own, in the same way as the trace rings, so
+ *  writing a frame never waits. When no capture is running the writer
+ *  returns after looking at one flag.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _CAPTURE_H_
+#define _CAPTURE_H_
+
+#include <Arduino.h>
+
+#include "trace.h"                   // Header for the trace records a capture is made of
+#include "atomic_share.h"            // Header for the flag which says a capture is running
+
+/// Bytes at the start of every capture
+const char CAPTURE_MAGIC[4] = { 'F', 'B', 'C', 'P' };
+
+/// Version of the format, changed only when something already in it is laid out differently
+const uint16_t CAPTURE_VERSION = 1;
+
+/// Number of records with payload the capture ring holds; must be a power of two
+const uint16_t CAPTURE_RING_SIZE = 16;
+
+/// Most bytes of payload one record carries
+const uint16_t CAPTURE_MAX_PAYLOAD = 128;
+
+/// Build options the firmware was compiled with, which change how a capture replays
+enum capture_flag : uint16_t
+{
+    CAPTURE_SWITCH_POLLING = 1 << 0,         ///< LIMIT_SWITCH_POLLING
+    CAPTURE_ABSOLUTE_MODE = 1 << 1,          ///< THERMAL_ABSOLUTE_MODE
+    CAPTURE_STOP_IN_PLACE = 1 << 2,          ///< TURNTABLE_STOP_IN_PLACE
+    CAPTURE_CONSTANT_PWM = 1 << 3,           ///< EXTINGUISHER_CONSTANT_PWM
+    CAPTURE_CONSTANT_SCAN = 1 << 4,          ///< TURNTABLE_CONSTANT_SCAN
+    CAPTURE_SINGLE_SENSOR = 1 << 5,          ///< THERMAL_SINGLE_SENSOR
+    CAPTURE_BLOCKING_I2C = 1 << 6,           ///< THERMAL_BLOCKING_I2C
+    CAPTURE_PIXEL_CENTROID = 1 << 7,         ///< AIM_PIXEL_CENTROID
+    CAPTURE_SINGLE_TARGET = 1 << 8           ///< FIRE_SINGLE_TARGET
+};
+
+/// Types of the records which carry a payload, after the trace_type ones
+enum capture_type : uint8_t
+{
+    CAPTURE_PAYLOAD = 0x80,                  ///< First type with a payload
+    CAPTURE_FRAME = CAPTURE_PAYLOAD,         ///< Camera frame published: arg camera, payload 64 pixels in 0.25 C
+    CAPTURE_INTERRUPT,                       ///< Interrupt table read: arg camera, payload 8 bytes, one bit per pixel
+    CAPTURE_END = 0xFF                       ///< Capture stopped; nothing follows
+};
+
+/// First bytes of a capture; sixteen bytes with no padding
+struct capture_header
+{
+    char magic[4];                           ///< CAPTURE_MAGIC
+    uint16_t version;                        ///< CAPTURE_VERSION
+    uint16_t header_bytes;                   ///< Size of this header, so later versions can add to it
+    uint32_t start_us;                       ///< Value of micros() when the capture started
+    uint16_t flags;                          ///< capture_flag bits of the build which made it
+    uint8_t cameras;                         ///< Thermal cameras which answered at power-up, 0 if not looked for yet
+    uint8_t reserved;                        ///< Zero
+};
+
+/// One record of a capture; the same eight bytes as a trace_record, with the time in microseconds
+struct capture_record
+{
+    uint32_t time_us;                        ///< Value of micros() when it happened; wraps after 71 minutes
+    uint8_t type;                            ///< A trace_type, or a capture_type
+    uint8_t arg;                             ///< Small argument, see trace_type and capture_type
+    uint16_t value;                          ///< Larger argument, or for a capture_type the bytes of payload
+};
+
+/// One slot of the capture ring: a record, its time still in trace_clock() counts, and its payload
+struct capture_slot
+{
+    capture_record record;                   ///< Type, argument and payload size
+    uint8_t payload[CAPTURE_MAX_PAYLOAD];    ///< Payload bytes
+};
+
+/// The single-writer, single-reader ring task_Thermal_Sensor writes frames into
+struct capture_ring
+{
+    capture_slot slots[CAPTURE_RING_SIZE];   ///< Slot storage
+    uint16_t head;                           ///< Slots written; changed only by the writer
+    uint16_t tail;                           ///< Slots read; changed only by task_Trace
+    uint16_t dropped;                        ///< Records lost to a full ring; changed only by the writer
+};
+
+extern capture_ring capture_frames;
+extern AtomicShare<bool> capturing;
+
+void capture_write (capture_type type, uint8_t arg, const void* p_payload, uint16_t bytes);
+uint16_t capture_build_flags (void);
+void capture_start (Print& port, uint8_t cameras);
+void capture_drain (Print& port, uint16_t* p_dropped_sent);
+void capture_stop (Print& port, uint16_t* p_dropped_sent);
+
+/** @brief   Records a thermal camera frame, if a capture is running.
+ *  @param   camera The camera it came from, an index into THERMAL_SENSOR_LAYOUT
+ *  @param   p_pixels The 64 pixels in 0.25 degree C counts
+ */
+inline void capture_frame (uint8_t camera, const int16_t* p_pixels)
+{
+    if (capturing.get ())
+    {
+        capture_write (CAPTURE_FRAME, camera, p_pixels, 64 * sizeof (int16_t));
+    }
+}
+
+/** @brief   Records an interrupt table read from a thermal camera, if a capture is running.
+ *  @param   camera The camera it came from
+ *  @param   p_table The 8 bytes of the table, one bit per pixel
+ */
+inline void capture_interrupt (uint8_t camera, const uint8_t* p_table)
+{
+    if (capturing.get ())
+    {
+        capture_write (CAPTURE_INTERRUPT, camera, p_table, 8);
+    }
+}
+
+#endif // _CAPTURE_H_
@@ -0,0 +1,85 @@
+/** @file core_lock.h
+ *  This file contains the lock which guards data that more than one task
+ *  reads and writes, such as the frame ring and the fire queue. On a single
+ *  core a critical section only has to keep the scheduler and interrupts
+ *  away while the data is changed, which taskENTER_CRITICAL() does. On the
+ *  dual-core ESP32 a task on the other core can be in the same data at the
+ *  same moment, so there a critical section also takes a spinlock, which
+ *  the other core waits on; each piece of shared data has its own, so that
+ *  the two cores only ever wait for each other over the same data.
+ *
+ *  A CoreLock holds that spinlock where the kernel has one and is empty
+ *  where it hasn't, so the same code is right on both. Like any critical
+ *  section, what is done while it is held must be short and must never
+ *  block. enter() and exit() may only be called from tasks; an interrupt
+ *  service routine uses enter_from_ISR() and exit_from_ISR() instead,
+ *  which on the STM32 save and restore the interrupt mask rather than
+ *  counting nested critical sections, and on the ESP32 take the spinlock
+ *  with the kernel's interrupt version of the critical section.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _CORE_LOCK_H_
+#define _CORE_LOCK_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+/** @brief   Critical section which also holds off the other core of a dual-core processor.
+ */
+class CoreLock
+{
+protected:
+#ifdef portMUX_INITIALIZER_UNLOCKED
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;     ///< Spinlock the other core waits on
+#endif
+
+public:
+    /// Enters the critical section, waiting for the other core to leave it first
+    void enter (void)
+    {
+#ifdef portMUX_INITIALIZER_UNLOCKED
+        portENTER_CRITICAL_SAFE (&mux);
+#else
+        taskENTER_CRITICAL ();
+#endif
+    }
+
+    /// Leaves the critical section
+    void exit (void)
+    {
+#ifdef portMUX_INITIALIZER_UNLOCKED
+        portEXIT_CRITICAL_SAFE (&mux);
+#else
+        taskEXIT_CRITICAL ();
+#endif
+    }
+
+    /// Enters the critical section from an interrupt; returns what exit_from_ISR() needs
+    UBaseType_t enter_from_ISR (void)
+    {
+#ifdef portMUX_INITIALIZER_UNLOCKED
+        portENTER_CRITICAL_ISR (&mux);
+        return 0;
+#else
+        return taskENTER_CRITICAL_FROM_ISR ();
+#endif
+    }
+
+    /// Leaves the critical section from an interrupt, given what enter_from_ISR() returned
+    void exit_from_ISR (UBaseType_t saved)
+    {
+#ifdef portMUX_INITIALIZER_UNLOCKED
+        (void)saved;
+        portEXIT_CRITICAL_ISR (&mux);
+#else
+        taskEXIT_CRITICAL_FROM_ISR (saved);
+#endif
+    }
+};
+
+#endif // _CORE_LOCK_H_
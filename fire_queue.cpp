@@ -0,0 +1,358 @@
+/** @file fire_queue.cpp
+ *  This file contains the queue of fires FireBot has seen and not yet put
+ *  out, and the choice of which one to turn to next.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include <math.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "fire_queue.h"              // Header for the fire queue
+#include "frame_ring.h"              // Header for the angle each pixel covers
+#include "task_Rotation_Base.h"      // Header for the turntable's rate
+
+/// A fire this far inside the edge of a camera's view, in degrees, must show in its frames
+const float FIRE_VIEW_HALF_DEG = 3.5f * FRAME_DEG_PER_PIXEL;
+
+/// One hot patch across the width of a frame
+struct fire_sighting
+{
+    float bearing_deg;                       ///< Direction of its weighted centre, 0 to 360
+    int16_t intensity;                       ///< Rise of its hottest pixel over the frame's coolest, at least 1
+    bool matched;                            ///< Whether it is a fire already in the queue
+};
+
+
+/** @brief   Returns an angle wrapped into -180 to 180 degrees.
+ */
+static float wrap_180 (float angle_deg)
+{
+    angle_deg = fmodf (angle_deg, 360.0f);
+    if (angle_deg > 180.0f)
+    {
+        angle_deg -= 360.0f;
+    }
+    else if (angle_deg < -180.0f)
+    {
+        angle_deg += 360.0f;
+    }
+    return angle_deg;
+}
+
+
+/** @brief   Returns an angle wrapped into 0 to 360 degrees.
+ */
+static float wrap_360 (float angle_deg)
+{
+    angle_deg = fmodf (angle_deg, 360.0f);
+    return angle_deg < 0.0f ? angle_deg + 360.0f : angle_deg;
+}
+
+
+/** @brief   Creates an empty queue.
+ */
+FireQueue::FireQueue (void)
+{
+    memset (targets, 0, sizeof (targets));
+    count = 0;
+    last_id = 0;
+    engaged_id = 0;
+}
+
+
+/** @brief   Takes one fire out of the queue; called with the lock held.
+ *  @param   index Where it is in @c targets
+ */
+void FireQueue::remove (uint8_t index)
+{
+    targets[index] = targets[count - 1];
+    count--;
+}
+
+
+/** @brief   Updates the queue from one camera's frame.
+ *  @details The columns of the frame with a hot pixel in them are split into
+ *           runs of touching columns, and each run is one sighting at the
+ *           bearing of the weighted centre of its hot pixels. Each sighting
+ *           updates the nearest fire in the queue within FIRE_MERGE_DEG, or
+ *           else is added as a new one. Fires well inside the camera's view
+ *           which no sighting matched count a miss.
+ *  @param   pixels The frame in 0.25 degree C counts
+ *  @param   mask Bit (row * 8 + column) set for each pixel hot enough to be a fire
+ *  @param   heading_deg The turntable's heading when the frame was taken
+ *  @param   offset_deg The direction the camera looks, forward of the nozzle
+ *  @param   now_ms The value of millis() when the frame was taken
+ */
+void FireQueue::observe (const int16_t* pixels, uint64_t mask, float heading_deg, float offset_deg, uint32_t now_ms)
+{
+    // The coolest pixel is the zero of the weights, so that the centre of a patch is
+    //     pulled toward its hottest part and not toward the middle of its pixels
+    int16_t coolest = pixels[0];
+    for (uint8_t pixel = 1; pixel < FRAME_PIXELS; pixel++)
+    {
+        coolest = pixels[pixel] < coolest ? pixels[pixel] : coolest;
+    }
+
+    // Split the hot columns into runs; there can be at most four in eight columns
+    fire_sighting sightings[4];
+    uint8_t found = 0;
+    int32_t weight_sum = 0;
+    int32_t moment_sum = 0;
+    int16_t hottest = INT16_MIN;
+    for (uint8_t column = 0; column <= 8; column++)
+    {
+        bool hot = false;
+        for (uint8_t row = 0; row < 8 && column < 8; row++)
+        {
+            uint8_t pixel = row * 8 + column;
+            if (mask & ((uint64_t)1 << pixel))
+            {
+                int32_t weight = pixels[pixel] - coolest + 1;
+                weight_sum += weight;
+                moment_sum += weight * column;
+                hottest = pixels[pixel] > hottest ? pixels[pixel] : hottest;
+                hot = true;
+            }
+        }
+        if (!hot && weight_sum > 0)
+        {
+            float centre = (float)moment_sum / weight_sum;
+            sightings[found].bearing_deg = wrap_360 (heading_deg + offset_deg + (centre - 3.5f) * FRAME_DEG_PER_PIXEL);
+            // How hot it is over the frame's coolest pixel, never zero or less even in a frame
+            //     below 0 C, since the order of the fires is searched on costs which only grow
+            int32_t rise = (int32_t)hottest - coolest;
+            sightings[found].intensity = (int16_t)(rise > 1 ? rise : 1);
+            sightings[found].matched = false;
+            found++;
+            weight_sum = 0;
+            moment_sum = 0;
+            hottest = INT16_MIN;
+        }
+    }
+
+    lock.enter ();
+
+    // Each sighting is a new look at the nearest fire close enough to it
+    bool updated[FIRE_QUEUE_SIZE] = { };
+    for (uint8_t sighting = 0; sighting < found; sighting++)
+    {
+        int8_t nearest = -1;
+        float nearest_deg = FIRE_MERGE_DEG;
+        for (uint8_t index = 0; index < count; index++)
+        {
+            float apart = fabsf (wrap_180 (sightings[sighting].bearing_deg - targets[index].bearing_deg));
+            if (apart <= nearest_deg)
+            {
+                nearest = index;
+                nearest_deg = apart;
+            }
+        }
+        if (nearest >= 0)
+        {
+            fire_target& target = targets[nearest];
+            target.bearing_deg = sightings[sighting].bearing_deg;
+            target.intensity = sightings[sighting].intensity;
+            target.last_seen_ms = now_ms;
+            target.misses = 0;
+            updated[nearest] = true;
+            sightings[sighting].matched = true;
+        }
+    }
+
+    // A fire well inside the view which wasn't seen is a miss, and one not seen for
+    //     a long time is forgotten, unless it is the one being sprayed
+    for (uint8_t index = count; index > 0; index--)
+    {
+        fire_target& target = targets[index - 1];
+        if (updated[index - 1])
+        {
+            continue;
+        }
+        if (fabsf (wrap_180 (target.bearing_deg - heading_deg - offset_deg)) <= FIRE_VIEW_HALF_DEG)
+        {
+            target.misses++;
+        }
+        if (target.misses >= FIRE_MISSES
+            || (target.id != engaged_id && now_ms - target.last_seen_ms > FIRE_FORGET_MS))
+        {
+            remove (index - 1);
+        }
+    }
+
+    // Sightings of no fire in the queue are new fires; when the queue is full, a new
+    //     fire only takes the place of a cooler one which isn't being sprayed
+    for (uint8_t sighting = 0; sighting < found; sighting++)
+    {
+        if (sightings[sighting].matched)
+        {
+            continue;
+        }
+        int8_t place = -1;
+        if (count < FIRE_QUEUE_SIZE)
+        {
+            place = count++;
+        }
+        else
+        {
+            for (uint8_t index = 0; index < count; index++)
+            {
+                if (targets[index].id != engaged_id && targets[index].intensity < sightings[sighting].intensity
+                    && (place < 0 || targets[index].intensity < targets[place].intensity))
+                {
+                    place = index;
+                }
+            }
+        }
+        if (place >= 0)
+        {
+            fire_target& target = targets[place];
+            target.bearing_deg = sightings[sighting].bearing_deg;
+            target.intensity = sightings[sighting].intensity;
+            target.first_seen_ms = now_ms;
+            target.last_seen_ms = now_ms;
+            target.misses = 0;
+            last_id = last_id == UINT8_MAX ? 1 : last_id + 1;
+            target.id = last_id;
+        }
+    }
+
+    lock.exit ();
+}
+
+
+/** @brief   Searches every order of the fires not yet placed for the one which puts them out soonest.
+ *  @details The cost of an order is the sum over the fires of the time until
+ *           each is sprayed, times how hot it is, so a hot fire is worth
+ *           turning a little further for, and every fire waits for the
+ *           turns and sprays of those before it. A branch is given up as
+ *           soon as it costs more than the best order found so far, which
+ *           is only right while adding a fire never lowers the cost, so
+ *           every fire's intensity must be positive.
+ *  @param   fires The fires
+ *  @param   number Number of fires
+ *  @param   placed Bit set for each fire already in the order
+ *  @param   bearing_deg Where the turntable is after the fires already in the order
+ *  @param   elapsed_ms When the fires already in the order have been sprayed
+ *  @param   cost Cost of the fires already in the order
+ *  @param   p_best Least cost of a whole order found so far, updated
+ *  @return  Index of the first fire of the best order from here, or -1 if
+ *           nothing from here beats @c p_best
+ */
+static int8_t best_order (const fire_target* fires, uint8_t number, uint8_t placed, float bearing_deg,
+                          float elapsed_ms, float cost, float* p_best)
+{
+    if (placed == (1 << number) - 1)
+    {
+        *p_best = cost;
+        return 0;
+    }
+    int8_t first = -1;
+    for (uint8_t index = 0; index < number; index++)
+    {
+        if (placed & (1 << index))
+        {
+            continue;
+        }
+        float turn_ms = fabsf (wrap_180 (fires[index].bearing_deg - bearing_deg)) * 1000.0f / TURNTABLE_DEG_PER_S;
+        float sprayed_ms = elapsed_ms + turn_ms + FIRE_ENGAGE_MS;
+        float next_cost = cost + sprayed_ms * fires[index].intensity;
+        if (next_cost < *p_best
+            && best_order (fires, number, placed | (1 << index), fires[index].bearing_deg, sprayed_ms,
+                           next_cost, p_best) >= 0)
+        {
+            first = index;
+        }
+    }
+    return first;
+}
+
+
+/** @brief   Chooses the fire to aim at next and marks it as the one being sprayed.
+ *  @param   heading_deg The turntable's heading now
+ *  @param   p_target Where to put the fire chosen
+ *  @return  true if a fire was chosen, false if the queue is empty
+ */
+bool FireQueue::choose (float heading_deg, fire_target* p_target)
+{
+    fire_target fires[FIRE_QUEUE_SIZE];
+    lock.enter ();
+    uint8_t number = count;
+    memcpy (fires, targets, sizeof (fires));
+    lock.exit ();
+    if (number == 0)
+    {
+        return false;
+    }
+
+    // The search runs on a copy, without holding the lock
+    float best = INFINITY;
+    int8_t first = best_order (fires, number, 0, heading_deg, 0.0f, 0.0f, &best);
+    if (first < 0)
+    {
+        return false;
+    }
+
+    lock.enter ();
+    engaged_id = fires[first].id;
+    lock.exit ();
+    *p_target = fires[first];
+    return true;
+}
+
+
+/** @brief   Looks up a fire by its number.
+ *  @param   id The number from fire_target::id
+ *  @param   p_target Where to put the fire as last seen
+ *  @return  true if it is still in the queue
+ */
+bool FireQueue::get (uint8_t id, fire_target* p_target)
+{
+    bool present = false;
+    lock.enter ();
+    for (uint8_t index = 0; index < count; index++)
+    {
+        if (targets[index].id == id)
+        {
+            *p_target = targets[index];
+            present = true;
+        }
+    }
+    lock.exit ();
+    return present;
+}
+
+
+/** @brief   Takes the fire which has just been sprayed out of the queue.
+ *  @details If it is still burning, the next frame which sees it puts it back.
+ */
+void FireQueue::finish (void)
+{
+    lock.enter ();
+    for (uint8_t index = 0; index < count; index++)
+    {
+        if (targets[index].id == engaged_id)
+        {
+            remove (index);
+            break;
+        }
+    }
+    engaged_id = 0;
+    lock.exit ();
+}
+
+
+/** @brief   Returns the number of fires in the queue.
+ */
+uint8_t FireQueue::size (void)
+{
+    lock.enter ();
+    uint8_t number = count;
+    lock.exit ();
+    return number;
+}
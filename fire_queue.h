@@ -0,0 +1,95 @@
+/** @file fire_queue.h
+ *  This file contains the queue of fires FireBot has seen and not yet put
+ *  out. Each frame from each camera is split into the separate hot patches
+ *  across its width, and each patch is a fire at a bearing on the
+ *  turntable's heading. A patch within FIRE_MERGE_DEG of a fire already in
+ *  the queue is a new sighting of it, which updates its bearing and how hot
+ *  it is; any other patch is a new fire. A fire which should be in a
+ *  camera's view but is missing from FIRE_MISSES frames in a row has gone
+ *  out, and one which hasn't been seen for FIRE_FORGET_MS is forgotten, so
+ *  the queue is re-scored from fresh frames as the turntable turns.
+ *
+ *  When the extinguisher is free, choose() picks the fire to aim at next:
+ *  the first of the order of all the fires in the queue which puts them out
+ *  soonest, each one's time to be sprayed counted in proportion to how hot
+ *  it is, with the turntable turning the short way between them. The order
+ *  is found by trying every one, which is quick for the few fires the queue
+ *  holds. Once a fire has been sprayed it is taken out of the queue with
+ *  finish(), and if any are left the turntable turns to the next one rather
+ *  than scanning round again. A fire which is still burning is seen again
+ *  and comes back into the queue.
+ *
+ *  Defining FIRE_SINGLE_TARGET at build time goes back to aiming at the
+ *  hottest point of the frame which saw a fire, and scanning again after
+ *  each one. Spraying wherever the turntable stopped (TURNTABLE_STOP_IN_PLACE)
+ *  can't turn to a fire in the queue, so it implies FIRE_SINGLE_TARGET.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _FIRE_QUEUE_H_
+#define _FIRE_QUEUE_H_
+
+#include <stdint.h>
+
+#include "core_lock.h"               // Header for the lock which also holds off the other core
+
+#if defined TURNTABLE_STOP_IN_PLACE && !defined FIRE_SINGLE_TARGET
+    #define FIRE_SINGLE_TARGET
+#endif
+
+/// Most fires the queue holds; a new fire hotter than the coolest one takes its place when full
+const uint8_t FIRE_QUEUE_SIZE = 6;
+
+/// Sightings this many degrees apart or closer are of the same fire
+const float FIRE_MERGE_DEG = 10.0f;
+
+/// A fire which is missing from this many frames in a row of a camera it should be in view of is out
+const uint8_t FIRE_MISSES = 4;
+
+/// A fire which hasn't been seen for this many milliseconds is forgotten
+const uint32_t FIRE_FORGET_MS = 30000;
+
+/// Time to aim at a fire and spray it once the turntable has turned to it, in milliseconds
+const uint32_t FIRE_ENGAGE_MS = 3800;
+
+/// One fire in the queue
+struct fire_target
+{
+    float bearing_deg;                       ///< Direction of the fire on the turntable's heading, 0 to 360
+    int16_t intensity;                       ///< Latest sighting's hottest pixel over the coolest, in 0.25 C, at least 1
+    uint32_t first_seen_ms;                  ///< Value of millis() when it was first seen
+    uint32_t last_seen_ms;                   ///< Value of millis() when it was last seen
+    uint8_t id;                              ///< Number it was given when first seen, never 0
+    uint8_t misses;                          ///< Frames in a row it should have been in and wasn't
+};
+
+/** @brief   Fires seen and not yet put out, with the order to put them out in.
+ *  @details task_Thermal_Sensor adds every frame with observe(), task_Rotation_Base
+ *           chooses the fire to aim at and follows it with get(), and the
+ *           dispatcher takes it out with finish() once it has been sprayed.
+ *           Every call copies in or out of the queue while holding its lock.
+ */
+class FireQueue
+{
+protected:
+    fire_target targets[FIRE_QUEUE_SIZE];    ///< The fires, in no particular order
+    uint8_t count;                           ///< Number of fires in the queue
+    uint8_t last_id;                         ///< Number given to the newest fire
+    uint8_t engaged_id;                      ///< Fire being aimed at or sprayed, 0 if none
+    CoreLock lock;                           ///< Guards everything above against the other tasks and core
+
+    void remove (uint8_t index);
+
+public:
+    FireQueue (void);
+
+    void observe (const int16_t* pixels, uint64_t mask, float heading_deg, float offset_deg, uint32_t now_ms);
+    bool choose (float heading_deg, fire_target* p_target);
+    bool get (uint8_t id, fire_target* p_target);
+    void finish (void);
+    uint8_t size (void);
+};
+
+#endif // _FIRE_QUEUE_H_
@@ -0,0 +1,167 @@
+/** @file frame_ring.cpp
+ *  This file contains the ring of frame buffers which carries full thermal
+ *  camera frames from task_Thermal_Sensor to the other tasks without copying.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "frame_ring.h"              // Header for the frame ring
+
+
+/** @brief   Creates an empty frame ring.
+ *  @param   p_name A name for the ring, used in printouts
+ */
+FrameRing::FrameRing (const char* p_name)
+{
+    memset (slots, 0, sizeof (slots));
+    memset (readers, 0, sizeof (readers));
+    memset (&stats, 0, sizeof (stats));
+    newest = -1;
+    filling = -1;
+    last_sequence = 0;
+    memset (camera_last_us, 0, sizeof (camera_last_us));
+    cameras_seen = 0;
+    name = p_name;
+}
+
+
+/** @brief   Gets a free buffer for the writer to fill with the next frame.
+ *  @details A buffer is free if it doesn't hold the newest frame and no reader
+ *           holds it. If there is none, the frame is counted as dropped and the
+ *           writer should skip reading it from the camera at all.
+ *  @return  A pointer to the buffer to fill, or NULL if the frame must be dropped
+ */
+thermal_frame* FrameRing::begin_write (void)
+{
+    thermal_frame* p_frame = NULL;
+
+    lock.enter ();
+    for (int8_t slot = 0; slot < FRAME_RING_SLOTS; slot++)
+    {
+        if (slot != newest && readers[slot] == 0)
+        {
+            filling = slot;
+            p_frame = &slots[slot];
+            break;
+        }
+    }
+    if (p_frame == NULL)
+    {
+        stats.dropped++;
+    }
+    lock.exit ();
+
+    return p_frame;
+}
+
+
+/** @brief   Makes a filled buffer the newest frame.
+ *  @details The sequence number is assigned here. If more than one and a half
+ *           frame periods have passed since the previous frame from the same
+ *           camera, the camera has produced frames which were never read, and
+ *           those are counted as dropped. Frames from the other camera come in
+ *           between, so the newest frame of the ring isn't the one to go by.
+ *  @param   p_frame The buffer from begin_write(), with pixels and timestamp filled in
+ *  @param   i2c_us How long reading the frame over I2C took, in microseconds
+ */
+void FrameRing::publish (thermal_frame* p_frame, uint32_t i2c_us)
+{
+    lock.enter ();
+    uint8_t camera = p_frame->sensor;
+    if (camera < FRAME_RING_CAMERAS)
+    {
+        if (cameras_seen & (1 << camera))
+        {
+            uint32_t gap = p_frame->timestamp_us - camera_last_us[camera];
+            if (gap > FRAME_PERIOD_US + FRAME_PERIOD_US / 2)
+            {
+                stats.dropped += (gap + FRAME_PERIOD_US / 2) / FRAME_PERIOD_US - 1;
+            }
+        }
+        camera_last_us[camera] = p_frame->timestamp_us;
+        cameras_seen |= 1 << camera;
+    }
+    p_frame->sequence = ++last_sequence;
+    newest = filling;
+    filling = -1;
+
+    stats.frames++;
+    stats.i2c_last_us = i2c_us;
+    stats.i2c_total_us += i2c_us;
+    if (i2c_us > stats.i2c_max_us)
+    {
+        stats.i2c_max_us = i2c_us;
+    }
+    lock.exit ();
+}
+
+
+/** @brief   Borrows the newest frame.
+ *  @details The frame stays valid and unchanged until it is given back with
+ *           release(), which should be done as soon as the reader is finished.
+ *  @param   newer_than Only return a frame with a sequence number above this one,
+ *           so a periodic reader can skip a frame it has already seen
+ *  @return  A pointer to the frame, or NULL if there is no newer frame yet
+ */
+const thermal_frame* FrameRing::acquire (uint32_t newer_than)
+{
+    const thermal_frame* p_frame = NULL;
+
+    lock.enter ();
+    if (newest >= 0 && slots[newest].sequence > newer_than)
+    {
+        readers[newest]++;
+        p_frame = &slots[newest];
+    }
+    lock.exit ();
+
+    return p_frame;
+}
+
+
+/** @brief   Gives back a frame borrowed with acquire().
+ *  @param   p_frame The pointer acquire() returned
+ */
+void FrameRing::release (const thermal_frame* p_frame)
+{
+    int8_t slot = (int8_t)(p_frame - slots);
+
+    lock.enter ();
+    if (slot >= 0 && slot < FRAME_RING_SLOTS && readers[slot] > 0)
+    {
+        readers[slot]--;
+    }
+    lock.exit ();
+}
+
+
+/** @brief   Returns a consistent copy of the frame counters.
+ */
+frame_ring_stats FrameRing::get_stats (void)
+{
+    lock.enter ();
+    frame_ring_stats copy = stats;
+    lock.exit ();
+
+    return copy;
+}
+
+
+/** @brief   Prints the frame counters on one line.
+ *  @param   printer The serial port or other stream to print to
+ */
+void FrameRing::print_stats (Print& printer)
+{
+    frame_ring_stats copy = get_stats ();
+    uint32_t i2c_mean = copy.frames ? copy.i2c_total_us / copy.frames : 0;
+
+    printer << name << ": " << copy.frames << " frames, " << copy.dropped << " dropped, I2C "
+            << i2c_mean << " us mean, " << copy.i2c_max_us << " us max" << endl;
+}
@@ -0,0 +1,97 @@
+/** @file frame_ring.h
+ *  This file contains a ring of frame buffers through which task_Thermal_Sensor
+ *  hands full 8x8 thermal camera frames to any other task that wants them.
+ *  The thermal task fills a free buffer and publishes it; readers borrow the
+ *  newest published buffer by pointer and give it back when they are done, so
+ *  a frame is never copied after it has been read from the camera. With the
+ *  default of two buffers this is a double buffer: the camera fills one while
+ *  readers look at the other. If a reader still holds the only free buffer
+ *  when the next frame is due, that frame is dropped and counted.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _FRAME_RING_H_
+#define _FRAME_RING_H_
+
+#include "hotspot.h"                 // Header for the hotspot detector
+#include "upsample.h"                // Header for the sub-pixel locator
+#include "core_lock.h"               // Header for the lock which also holds off the other core
+
+/// Number of pixels in one frame from the AMG88xx thermal camera
+const uint8_t FRAME_PIXELS = 64;
+
+/// Number of frame buffers in the ring; two makes a double buffer
+const uint8_t FRAME_RING_SLOTS = 2;
+
+/// Most cameras whose frames the ring keeps apart when counting frames lost between reads
+const uint8_t FRAME_RING_CAMERAS = 2;
+
+/// Angle each pixel column of the thermal camera covers, 60 degrees over 8 columns
+const float FRAME_DEG_PER_PIXEL = 7.5f;
+
+/// Time between frames at the thermal camera's native 10 frames per second
+const uint32_t FRAME_PERIOD_US = 100000;
+
+/// One timestamped frame from the thermal camera
+struct thermal_frame
+{
+    uint32_t sequence;                       ///< Frame number counting from 1, so readers can spot skipped frames
+    uint32_t timestamp_us;                   ///< Value of micros() when the frame had been read
+    int16_t pixels[FRAME_PIXELS];            ///< Temperatures in counts of 0.25 degrees C, top row first
+    hotspot_result hotspot;                  ///< What the hotspot detector found in this frame
+    subpixel_peak peak;                      ///< Where the hottest point is, to a fraction of a pixel
+    uint64_t background_mask;                ///< Pixels well above the background of their sector
+    uint8_t sector;                          ///< Turntable sector the camera was pointing into
+    uint8_t sensor;                          ///< Camera the frame came from, an index into THERMAL_SENSOR_LAYOUT
+};
+
+/// Counters kept by the frame ring about the frames going through it
+struct frame_ring_stats
+{
+    uint32_t frames;                         ///< Frames published
+    uint32_t dropped;                        ///< Frames lost to a late read or to no free buffer
+    uint32_t i2c_last_us;                    ///< Time the last frame took to read over I2C
+    uint32_t i2c_max_us;                     ///< Longest frame read so far
+    uint32_t i2c_total_us;                   ///< Time spent reading all published frames; wraps after hours
+};
+
+/** @brief   Ring of frame buffers handed from the thermal camera task to readers without copying.
+ *  @details One task, task_Thermal_Sensor, writes frames; any number of tasks may
+ *           read them. All bookkeeping is done in short critical sections, and no
+ *           call ever blocks.
+ */
+class FrameRing
+{
+protected:
+    thermal_frame slots[FRAME_RING_SLOTS];   ///< The frame buffers
+    uint8_t readers[FRAME_RING_SLOTS];       ///< Number of readers holding each buffer
+    int8_t newest;                           ///< Buffer holding the newest frame, -1 before the first one
+    int8_t filling;                          ///< Buffer being filled by the writer, -1 if none
+    uint32_t last_sequence;                  ///< Sequence number of the newest frame
+    uint32_t camera_last_us[FRAME_RING_CAMERAS]; ///< Timestamp of each camera's newest frame
+    uint8_t cameras_seen;                    ///< Bit set for each camera which has published a frame
+    frame_ring_stats stats;                  ///< Counters
+    const char* name;                        ///< Name for printouts
+    CoreLock lock;                           ///< Guards everything above against the other tasks and core
+
+public:
+    FrameRing (const char* p_name = NULL);
+
+    // Writer side, used only by task_Thermal_Sensor
+    thermal_frame* begin_write (void);
+    void publish (thermal_frame* p_frame, uint32_t i2c_us);
+
+    // Reader side
+    const thermal_frame* acquire (uint32_t newer_than = 0);
+    void release (const thermal_frame* p_frame);
+
+    frame_ring_stats get_stats (void);
+    void print_stats (Print& printer);
+
+    /// Returns the name given to the constructor
+    const char* get_name (void) const { return name; }
+};
+
+#endif // _FRAME_RING_H_
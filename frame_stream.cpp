@@ -0,0 +1,387 @@
+/** @file frame_stream.cpp
+ *  This file contains the live stream of thermal camera frames: the coder
+ *  task_Thermal_Sensor turns each frame into a packet with, the ring the
+ *  packets wait in, the code task_Trace sends them with, and the decoder a
+ *  receiver rebuilds the frames with.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "frame_stream.h"            // Header for the frame stream
+#include "trace.h"                   // Header for the trace rings sent along with it
+
+static_assert ((FRAME_STREAM_RING_BYTES & (FRAME_STREAM_RING_BYTES - 1)) == 0,
+               "FRAME_STREAM_RING_BYTES must be a power of two");
+static_assert (FRAME_STREAM_MAX_PACKET <= FRAME_STREAM_RING_BYTES, "the ring must hold the biggest packet");
+static_assert (THERMAL_SENSORS <= FRAME_STREAM_CAMERA + 1, "the camera number must fit in the flags");
+static_assert (FRAME_STREAM_SHIFT <= (FRAME_STREAM_SHIFT_BITS >> 5), "the quantization must fit in the flags");
+static_assert (((TRACE_RINGS * (TRACE_RING_SIZE + 1) + 1) * TRACE_FRAME_SIZE + FRAME_STREAM_RING_BYTES) * 10
+               <= TRACE_BAUD_RATE * TRACE_DRAIN_PERIOD / 1000,
+               "the serial port must be able to send full rings and a full stream before the next drain");
+
+/// Packets waiting to be sent, written by task_Thermal_Sensor
+frame_stream_ring frame_stream;
+
+/// Whether the stream is running; set and cleared only by task_Trace
+AtomicShare<bool> streaming ("streaming", false);
+
+/// Times the stream was started; changed only by task_Trace
+static uint8_t stream_starts = 0;
+
+/// Each camera's last frame as the receiver has it; used only by task_Thermal_Sensor
+static int16_t stream_reference[THERMAL_SENSORS][FRAME_PIXELS];
+
+/// Frames of each camera sent since its last keyframe; used only by task_Thermal_Sensor
+static uint8_t stream_since_key[THERMAL_SENSORS];
+
+/// Sequence number of the next packet; used only by task_Thermal_Sensor
+static uint8_t stream_sequence = 0;
+
+/// Value of stream_starts when task_Thermal_Sensor last looked; used only by it
+static uint8_t stream_starts_seen = 0;
+
+/// Space for the packet being made; used only by task_Thermal_Sensor
+static uint8_t stream_packet[FRAME_STREAM_MAX_PACKET];
+
+
+/** @brief   Packs numbers into bytes, lowest bit first.
+ */
+class BitWriter
+{
+protected:
+    uint8_t* p_out;                          ///< Where the next whole byte goes
+    uint32_t bits;                           ///< Bits not yet written out
+    uint8_t count;                           ///< Number of them
+
+public:
+    /// Starts writing at @c p_buffer
+    BitWriter (uint8_t* p_buffer) : p_out (p_buffer), bits (0), count (0) { }
+
+    /// Adds the low @c width bits of @c value, at most 16
+    void put (uint32_t value, uint8_t width)
+    {
+        bits |= value << count;
+        count += width;
+        while (count >= 8)
+        {
+            *p_out++ = (uint8_t)bits;
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    /// Writes out the last part byte and returns where the bytes end
+    uint8_t* finish (void)
+    {
+        if (count > 0)
+        {
+            *p_out++ = (uint8_t)bits;
+        }
+        return p_out;
+    }
+};
+
+
+/** @brief   Unpacks numbers packed by a BitWriter, never reading past the end.
+ */
+class BitReader
+{
+protected:
+    const uint8_t* p_in;                     ///< The next byte to read
+    const uint8_t* p_end;                    ///< Just past the last byte
+    uint32_t bits;                           ///< Bits read in but not yet taken
+    uint8_t count;                           ///< Number of them
+    bool overrun;                            ///< Whether more bits were taken than there are
+
+public:
+    /// Reads the bytes from @c p_buffer up to @c p_stop
+    BitReader (const uint8_t* p_buffer, const uint8_t* p_stop)
+        : p_in (p_buffer), p_end (p_stop), bits (0), count (0), overrun (false) { }
+
+    /// Takes the next @c width bits, at most 16
+    uint32_t get (uint8_t width)
+    {
+        while (count < width)
+        {
+            if (p_in < p_end)
+            {
+                bits |= (uint32_t)*p_in++ << count;
+            }
+            else
+            {
+                overrun = true;
+            }
+            count += 8;
+        }
+        uint32_t value = bits & ((1UL << width) - 1);
+        bits >>= width;
+        count -= width;
+        return value;
+    }
+
+    /// Returns true if more bits were taken than the bytes hold
+    bool is_overrun (void) const { return overrun; }
+};
+
+
+/** @brief   Returns the value of pixel @c index which it is sent as a difference from.
+ *  @details In a keyframe that is the pixel to its left, or above it for the
+ *           first pixel of a row, and 0 for the first pixel of all. In any
+ *           other frame it is the same pixel of the camera's last frame.
+ */
+static inline int16_t predict (const int16_t* p_quantized, const int16_t* p_last, bool key, uint8_t index)
+{
+    if (!key)
+    {
+        return p_last[index];
+    }
+    if (index == 0)
+    {
+        return 0;
+    }
+    return p_quantized[(index & 7) ? index - 1 : index - 8];
+}
+
+
+/** @brief   Turns one frame into a packet as it is sent.
+ *  @details This is the whole coder, used by frame_stream_write() and by the
+ *           benchmarks. Pixels are clamped to 14 bits after quantizing, so
+ *           that every difference fits in the 16 bits of an escape.
+ *  @param   sequence The packet's sequence number
+ *  @param   camera The camera the frame came from
+ *  @param   key Whether to make a keyframe, which needs no earlier frame
+ *  @param   p_pixels The 64 pixels in 0.25 degree C counts
+ *  @param   p_reference The camera's last frame as the receiver rebuilt it,
+ *           which is not read for a keyframe; it is replaced by this frame as
+ *           the receiver will rebuild it
+ *  @param   timestamp_us Value of micros() when the frame was read
+ *  @param   p_packet Space for FRAME_STREAM_MAX_PACKET bytes
+ *  @return  The number of bytes in the packet
+ */
+uint16_t frame_stream_encode (uint8_t sequence, uint8_t camera, bool key, const int16_t* p_pixels,
+                              int16_t* p_reference, uint32_t timestamp_us, uint8_t* p_packet)
+{
+    int16_t quantized[FRAME_PIXELS];
+    int16_t last[FRAME_PIXELS];
+    uint16_t folded[FRAME_PIXELS];
+    const int16_t half = FRAME_STREAM_SHIFT ? 1 << (FRAME_STREAM_SHIFT - 1) : 0;
+
+    for (uint8_t index = 0; index < FRAME_PIXELS; index++)
+    {
+        int16_t value = (int16_t)((p_pixels[index] + half) >> FRAME_STREAM_SHIFT);
+        quantized[index] = value < -8192 ? -8192 : (value > 8191 ? 8191 : value);
+        last[index] = key ? 0 : (int16_t)(p_reference[index] >> FRAME_STREAM_SHIFT);
+    }
+
+    // Fold each difference into an unsigned number, small ones staying small,
+    //     and count the bits every k would take for them
+    uint16_t cost[FRAME_STREAM_MAX_K + 1] = { 0 };
+    for (uint8_t index = 0; index < FRAME_PIXELS; index++)
+    {
+        int16_t difference = (int16_t)(quantized[index] - predict (quantized, last, key, index));
+        folded[index] = (uint16_t)((difference << 1) ^ (difference >> 15));
+        for (uint8_t k = 0; k <= FRAME_STREAM_MAX_K; k++)
+        {
+            uint16_t unary = folded[index] >> k;
+            cost[k] += unary < FRAME_STREAM_ESCAPE ? unary + 1 + k : FRAME_STREAM_ESCAPE + 16;
+        }
+    }
+    uint8_t best_k = 0;
+    for (uint8_t k = 1; k <= FRAME_STREAM_MAX_K; k++)
+    {
+        best_k = cost[k] < cost[best_k] ? k : best_k;
+    }
+
+    // The header, then the pixels
+    uint8_t* p_payload = p_packet + 2;
+    p_payload[0] = sequence;
+    p_payload[1] = (camera & FRAME_STREAM_CAMERA) | (key ? FRAME_STREAM_KEY : 0) | (FRAME_STREAM_SHIFT << 5);
+    memcpy (p_payload + 2, &timestamp_us, sizeof (timestamp_us));
+    p_payload[6] = best_k;
+    BitWriter writer (p_payload + FRAME_STREAM_HEADER);
+    for (uint8_t index = 0; index < FRAME_PIXELS; index++)
+    {
+        uint16_t unary = folded[index] >> best_k;
+        if (unary < FRAME_STREAM_ESCAPE)
+        {
+            writer.put ((1UL << unary) - 1, unary + 1);
+            writer.put (folded[index] & ((1U << best_k) - 1), best_k);
+        }
+        else
+        {
+            writer.put ((1UL << FRAME_STREAM_ESCAPE) - 1, FRAME_STREAM_ESCAPE);
+            writer.put (folded[index], 16);
+        }
+        p_reference[index] = (int16_t)(quantized[index] << FRAME_STREAM_SHIFT);
+    }
+    uint8_t length = (uint8_t)(writer.finish () - p_payload);
+
+    p_packet[0] = FRAME_STREAM_SYNC_BYTE;
+    p_packet[1] = length;
+    uint8_t sum = 0;
+    for (uint16_t index = 1; index < length + 2; index++)
+    {
+        sum += p_packet[index];
+    }
+    p_packet[length + 2] = (uint8_t)~sum;
+    return length + 3;
+}
+
+
+/** @brief   Codes one frame and writes its packet into the stream ring.
+ *  @details Only task_Thermal_Sensor may call this. A packet which finds the
+ *           ring full is dropped and counted, and the camera's next frame is
+ *           made a keyframe so that the receiver can pick it up again.
+ *  @param   camera The camera it came from, an index into THERMAL_SENSOR_LAYOUT
+ *  @param   p_pixels The 64 pixels in 0.25 degree C counts
+ *  @param   timestamp_us Value of micros() when it was read
+ */
+void frame_stream_write (uint8_t camera, const int16_t* p_pixels, uint32_t timestamp_us)
+{
+    if (camera >= THERMAL_SENSORS)
+    {
+        return;
+    }
+
+    // A stream which was just started begins with a keyframe from each camera
+    uint8_t starts = __atomic_load_n (&stream_starts, __ATOMIC_ACQUIRE);
+    if (starts != stream_starts_seen)
+    {
+        stream_starts_seen = starts;
+        memset (stream_since_key, FRAME_STREAM_KEY_INTERVAL, sizeof (stream_since_key));
+    }
+
+    bool key = stream_since_key[camera] >= FRAME_STREAM_KEY_INTERVAL;
+    uint16_t bytes = frame_stream_encode (stream_sequence, camera, key, p_pixels, stream_reference[camera],
+                                          timestamp_us, stream_packet);
+
+    uint16_t head = frame_stream.head;
+    if ((uint16_t)(head - __atomic_load_n (&frame_stream.tail, __ATOMIC_ACQUIRE)) + bytes > FRAME_STREAM_RING_BYTES)
+    {
+        frame_stream.dropped++;
+        stream_since_key[camera] = FRAME_STREAM_KEY_INTERVAL;
+        return;
+    }
+    uint16_t start = head & (FRAME_STREAM_RING_BYTES - 1);
+    uint16_t first = FRAME_STREAM_RING_BYTES - start < bytes ? FRAME_STREAM_RING_BYTES - start : bytes;
+    memcpy (frame_stream.bytes + start, stream_packet, first);
+    memcpy (frame_stream.bytes, stream_packet + first, bytes - first);
+    __atomic_store_n (&frame_stream.head, (uint16_t)(head + bytes), __ATOMIC_RELEASE);
+
+    stream_sequence++;
+    stream_since_key[camera] = key ? 1 : stream_since_key[camera] + 1;
+}
+
+
+/** @brief   Starts the stream.
+ *  @details Packets left in the ring from an earlier stream are thrown away,
+ *           and each camera's next frame is made a keyframe. Only task_Trace
+ *           may call this.
+ */
+void frame_stream_start (void)
+{
+    __atomic_store_n (&frame_stream.tail, __atomic_load_n (&frame_stream.head, __ATOMIC_ACQUIRE),
+                      __ATOMIC_RELEASE);
+    __atomic_store_n (&stream_starts, (uint8_t)(stream_starts + 1), __ATOMIC_RELEASE);
+    streaming.put (true);
+}
+
+
+/** @brief   Sends every packet waiting in the stream ring.
+ *  @details The packets are copied out a piece at a time, each piece handed
+ *           back to the writer as soon as it has been sent. Only task_Trace
+ *           may call this.
+ *  @param   port The serial port the stream goes out of
+ */
+void frame_stream_send (Print& port)
+{
+    uint16_t head = __atomic_load_n (&frame_stream.head, __ATOMIC_ACQUIRE);
+    uint16_t tail = frame_stream.tail;
+    while (tail != head)
+    {
+        uint16_t start = tail & (FRAME_STREAM_RING_BYTES - 1);
+        uint16_t bytes = (uint16_t)(head - tail);
+        bytes = FRAME_STREAM_RING_BYTES - start < bytes ? FRAME_STREAM_RING_BYTES - start : bytes;
+        port.write (frame_stream.bytes + start, bytes);
+        tail += bytes;
+        __atomic_store_n (&frame_stream.tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+
+/** @brief   Checks whether a complete, valid packet starts at @c p_bytes.
+ *  @param   p_bytes Bytes from the serial port
+ *  @param   available How many bytes there are from @c p_bytes on
+ *  @return  The number of bytes in the packet, or 0 if there isn't one
+ */
+uint16_t frame_stream_check (const uint8_t* p_bytes, size_t available)
+{
+    if (available < 3 || p_bytes[0] != FRAME_STREAM_SYNC_BYTE)
+    {
+        return 0;
+    }
+    uint8_t length = p_bytes[1];
+    if (length < FRAME_STREAM_HEADER || length > FRAME_STREAM_MAX_PAYLOAD || available < (size_t)length + 3
+        || p_bytes[8] > FRAME_STREAM_MAX_K)
+    {
+        return 0;
+    }
+    uint8_t sum = 0;
+    for (uint16_t index = 1; index < length + 2; index++)
+    {
+        sum += p_bytes[index];
+    }
+    return (uint8_t)~sum == p_bytes[length + 2] ? length + 3 : 0;
+}
+
+
+/** @brief   Rebuilds the frame in a packet.
+ *  @param   p_packet A packet which frame_stream_check() passed
+ *  @param   p_reference The camera's last frame as this function rebuilt it,
+ *           or NULL if there is none, in which case only a keyframe can be
+ *           rebuilt
+ *  @param   p_frame Where to put the frame; its pixels are in 0.25 C counts
+ *           with the low bits left out of the stream set to zero
+ *  @return  true if the frame was rebuilt, false if it needs a last frame
+ *           which there isn't or its bits don't add up
+ */
+bool frame_stream_decode (const uint8_t* p_packet, const int16_t* p_reference, frame_stream_frame* p_frame)
+{
+    const uint8_t* p_payload = p_packet + 2;
+    p_frame->sequence = p_payload[0];
+    p_frame->camera = p_payload[1] & FRAME_STREAM_CAMERA;
+    p_frame->key = (p_payload[1] & FRAME_STREAM_KEY) != 0;
+    p_frame->shift = (p_payload[1] & FRAME_STREAM_SHIFT_BITS) >> 5;
+    memcpy (&p_frame->timestamp_us, p_payload + 2, sizeof (p_frame->timestamp_us));
+    uint8_t k = p_payload[6];
+    if (!p_frame->key && p_reference == NULL)
+    {
+        return false;
+    }
+
+    int16_t quantized[FRAME_PIXELS];
+    int16_t last[FRAME_PIXELS];
+    for (uint8_t index = 0; index < FRAME_PIXELS && !p_frame->key; index++)
+    {
+        last[index] = (int16_t)(p_reference[index] >> p_frame->shift);
+    }
+    BitReader reader (p_payload + FRAME_STREAM_HEADER, p_payload + p_packet[1]);
+    for (uint8_t index = 0; index < FRAME_PIXELS; index++)
+    {
+        uint16_t unary = 0;
+        while (unary < FRAME_STREAM_ESCAPE && reader.get (1))
+        {
+            unary++;
+        }
+        uint16_t folded = unary < FRAME_STREAM_ESCAPE ? (uint16_t)((unary << k) | reader.get (k))
+                                                      : (uint16_t)reader.get (16);
+        int16_t difference = (int16_t)((folded >> 1) ^ -(int16_t)(folded & 1));
+        quantized[index] = (int16_t)(predict (quantized, last, p_frame->key, index) + difference);
+        p_frame->pixels[index] = (int16_t)(quantized[index] << p_frame->shift);
+    }
+    return !reader.is_overrun ();
+}
@@ -0,0 +1,138 @@
+/** @file frame_stream.h
+ *  This file contains FireBot's live stream of thermal camera frames, which
+ *  sends every frame from every camera over the serial port along with the
+ *  trace log, so that what the cameras see can be watched as the robot
+ *  runs. Raw frames would not fit: 64 pixels of two bytes, 20 times a
+ *  second, is more than the 115200 baud port carries with the log. So each
+ *  frame is squeezed before it is sent:
+ *
+ *  - Quantized: the 0.25 C counts lose FRAME_STREAM_SHIFT low bits, which
+ *    at one bit gives 0.5 C steps, finer than the cameras' own noise.
+ *  - Delta encoded: a frame is sent as its difference from the last frame
+ *    of the same camera, which in a still room is mostly zeros. Every
+ *    FRAME_STREAM_KEY_INTERVAL frames of a camera a keyframe is sent
+ *    instead, which stands alone: each pixel is sent as its difference
+ *    from the one before it.
+ *  - Entropy packed: the differences are folded to unsigned numbers (0, -1,
+ *    1, -2, ... become 0, 1, 2, 3, ...) and Rice coded, the low @c k bits
+ *    of each as they are and the rest in unary, with the @c k which makes
+ *    the packet smallest. A difference too big for that, as when a fire
+ *    comes into view, is sent whole after an escape.
+ *
+ *  In a still room a frame takes about 20 bytes and a keyframe about 50,
+ *  so both cameras at full rate use under a tenth of the port. Each packet
+ *  goes out as
+ *
+ *      0x5A, length, sequence, flags, time_us (4 bytes), k, bits..., checksum
+ *
+ *  where the length counts the bytes from the sequence number to the last
+ *  byte of bits, the flags hold the camera number, whether it is a keyframe
+ *  and the quantization, and the checksum is the complement of the sum of
+ *  the length and the bytes it counts. The sequence number goes up by one
+ *  for each packet, so a receiver can tell when one was lost; it then has
+ *  no last frame to add differences to and waits for each camera's next
+ *  keyframe, at most FRAME_STREAM_KEY_INTERVAL frames later. A packet the
+ *  ring has no room for is dropped before it gets a sequence number, and
+ *  the camera's next frame is made a keyframe.
+ *
+ *  Sending the letter 'f' to task_Trace starts the stream and sending it
+ *  again stops it. task_Thermal_Sensor encodes each frame into a
+ *  single-writer, single-reader ring of bytes like the trace rings, so
+ *  streaming never makes it wait for the port; task_Trace sends what is in
+ *  the ring between runs of trace records, and both decoders pick the
+ *  packets out from among the records by their sync bytes and checksums.
+ *  The program in sim/frame_receive.cpp rebuilds the frames.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _FRAME_STREAM_H_
+#define _FRAME_STREAM_H_
+
+#include <Arduino.h>
+
+#include "frame_ring.h"              // Header for the frame size
+#include "thermal_array.h"           // Header for the number of cameras
+#include "atomic_share.h"            // Header for the flag which says the stream is running
+
+/// First byte of each packet on the serial port
+const uint8_t FRAME_STREAM_SYNC_BYTE = 0x5A;
+
+/// Low bits of the 0.25 C counts left out of the stream; each one halves the resolution
+const uint8_t FRAME_STREAM_SHIFT = 1;
+
+/// Frames of one camera from one keyframe to the next; a second of frames at 10 per second
+const uint8_t FRAME_STREAM_KEY_INTERVAL = 10;
+
+/// Bytes the stream ring holds; must be a power of two
+const uint16_t FRAME_STREAM_RING_BYTES = 1024;
+
+/// Unary bits after which a difference is sent whole instead, in 16 bits
+const uint8_t FRAME_STREAM_ESCAPE = 12;
+
+/// Largest Rice parameter @c k tried
+const uint8_t FRAME_STREAM_MAX_K = 7;
+
+/// Bytes of a packet's payload before the coded pixels: sequence, flags, time and k
+const uint8_t FRAME_STREAM_HEADER = 7;
+
+/// Most bytes of payload, with every pixel escaped
+const uint8_t FRAME_STREAM_MAX_PAYLOAD = FRAME_STREAM_HEADER + FRAME_PIXELS * (FRAME_STREAM_ESCAPE + 16) / 8;
+
+/// Most bytes of a packet on the serial port: sync byte, length, payload and checksum
+const uint16_t FRAME_STREAM_MAX_PACKET = FRAME_STREAM_MAX_PAYLOAD + 3;
+
+/// Bits of the flags byte of a packet
+enum frame_stream_flag : uint8_t
+{
+    FRAME_STREAM_CAMERA = 0x0F,              ///< Camera the frame came from, an index into THERMAL_SENSOR_LAYOUT
+    FRAME_STREAM_KEY = 0x10,                 ///< Keyframe, which needs no earlier frame to decode
+    FRAME_STREAM_SHIFT_BITS = 0xE0           ///< FRAME_STREAM_SHIFT of the firmware which sent it
+};
+
+/// The single-writer, single-reader ring of packets task_Thermal_Sensor writes into
+struct frame_stream_ring
+{
+    uint8_t bytes[FRAME_STREAM_RING_BYTES];  ///< Packets as they are sent, one after another
+    uint16_t head;                           ///< Bytes written; changed only by the writer
+    uint16_t tail;                           ///< Bytes read; changed only by task_Trace
+    uint16_t dropped;                        ///< Packets lost to a full ring; changed only by the writer
+};
+
+/// One frame rebuilt from a packet
+struct frame_stream_frame
+{
+    uint8_t sequence;                        ///< Sequence number of its packet
+    uint8_t camera;                          ///< Camera it came from
+    bool key;                                ///< Whether it was sent as a keyframe
+    uint8_t shift;                           ///< Low bits left out of its pixels
+    uint32_t timestamp_us;                   ///< Value of micros() when it was read
+    int16_t pixels[FRAME_PIXELS];            ///< Temperatures in counts of 0.25 degrees C, top row first
+};
+
+extern frame_stream_ring frame_stream;
+extern AtomicShare<bool> streaming;
+
+void frame_stream_write (uint8_t camera, const int16_t* p_pixels, uint32_t timestamp_us);
+uint16_t frame_stream_encode (uint8_t sequence, uint8_t camera, bool key, const int16_t* p_pixels,
+                              int16_t* p_reference, uint32_t timestamp_us, uint8_t* p_packet);
+void frame_stream_start (void);
+void frame_stream_send (Print& port);
+uint16_t frame_stream_check (const uint8_t* p_bytes, size_t available);
+bool frame_stream_decode (const uint8_t* p_packet, const int16_t* p_reference, frame_stream_frame* p_frame);
+
+/** @brief   Sends a thermal camera frame to the live stream, if it is running.
+ *  @param   camera The camera it came from, an index into THERMAL_SENSOR_LAYOUT
+ *  @param   p_pixels The 64 pixels in 0.25 degree C counts
+ *  @param   timestamp_us Value of micros() when it was read
+ */
+inline void stream_frame (uint8_t camera, const int16_t* p_pixels, uint32_t timestamp_us)
+{
+    if (streaming.get ())
+    {
+        frame_stream_write (camera, p_pixels, timestamp_us);
+    }
+}
+
+#endif // _FRAME_STREAM_H_
@@ -0,0 +1,304 @@
+/** @file hotspot.cpp
+ *  This file contains the software hotspot detector for 8x8 thermal frames.
+ *  Each hot pixel (one at or above the threshold) is weighted by how many
+ *  counts it is above one count below the threshold, so that every hot
+ *  pixel has a weight of at least one, and the centroid is the weighted
+ *  mean of the hot pixels' columns and rows. Blobs are counted on a 64-bit
+ *  mask of the hot pixels by growing each blob in all eight directions at
+ *  once with shifts, which takes a handful of instructions per step.
+ *
+ *  Pixels must be in the camera's range of counts (-80 to 320 for -20 to
+ *  80 degrees C) and the threshold well inside the int16_t range, so that
+ *  the weights can't overflow 16 bits. Defining HOTSPOT_PORTABLE at build
+ *  time forces the plain C version, for comparison.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "hotspot.h"                 // Header for the hotspot detector
+
+#if !defined HOTSPOT_PORTABLE && defined __ARM_FEATURE_DSP
+    #define HOTSPOT_ARM_DSP          // Cortex-M4/M7 SIMD instructions from CMSIS
+#elif !defined HOTSPOT_PORTABLE && defined __SSE2__
+    #define HOTSPOT_SSE2             // x86 host
+    #include <emmintrin.h>
+#endif
+
+/// Every pixel except those in the leftmost column
+const uint64_t NOT_COLUMN_0 = 0xFEFEFEFEFEFEFEFEull;
+/// Every pixel except those in the rightmost column
+const uint64_t NOT_COLUMN_7 = 0x7F7F7F7F7F7F7F7Full;
+
+
+/** @brief   Adds every pixel which touches a pixel in @c blob, diagonals included.
+ */
+static inline uint64_t grow (uint64_t blob)
+{
+    uint64_t wide = blob | ((blob << 1) & NOT_COLUMN_0) | ((blob >> 1) & NOT_COLUMN_7);
+    return wide | (wide << 8) | (wide >> 8);
+}
+
+
+/** @brief   Counts separate 8-connected groups of set bits in an 8x8 mask.
+ */
+static uint8_t count_blobs (uint64_t mask)
+{
+    uint8_t blobs = 0;
+    while (mask != 0)
+    {
+        // Start from the lowest hot pixel and grow until the blob stops changing
+        uint64_t blob = mask & (~mask + 1);
+        for (;;)
+        {
+            uint64_t bigger = grow (blob) & mask;
+            if (bigger == blob)
+            {
+                break;
+            }
+            blob = bigger;
+        }
+        mask &= ~blob;
+        blobs++;
+    }
+    return blobs;
+}
+
+
+/** @brief   Counts the set bits in a 64-bit mask.
+ */
+static inline uint8_t count_bits (uint64_t mask)
+{
+    return (uint8_t)__builtin_popcountll (mask);
+}
+
+
+/** @brief   Fills in the parts of a result which every version works out the same way.
+ *  @details Called with the maximum, hot mask and weight sums from the pass
+ *           over the pixels. The hottest pixel is found by a search for the
+ *           first pixel equal to the maximum, which stops early.
+ */
+static void finish (const int16_t* pixels, int16_t max_temp, uint64_t hot_mask,
+                    int32_t sum_w, int32_t sum_wx, int32_t sum_wy, hotspot_result* p_result)
+{
+    uint8_t index = 0;
+    while (pixels[index] != max_temp)
+    {
+        index++;
+    }
+
+    p_result->hot_mask = hot_mask;
+    p_result->max_temp = max_temp;
+    p_result->max_pixel = index;
+    p_result->hot_pixels = count_bits (hot_mask);
+    p_result->blobs = count_blobs (hot_mask);
+    if (sum_w > 0)
+    {
+        p_result->centroid_col = (uint16_t)(((sum_wx << 8) + sum_w / 2) / sum_w);
+        p_result->centroid_row = (uint16_t)(((sum_wy << 8) + sum_w / 2) / sum_w);
+    }
+    else
+    {
+        p_result->centroid_col = 0;
+        p_result->centroid_row = 0;
+    }
+}
+
+
+/** @brief   Runs the hotspot detector on one frame.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts, top row first
+ *  @param   threshold The lowest temperature, in counts, which makes a pixel hot
+ *  @param   p_result Where to put what was found
+ */
+void hotspot_find (const int16_t* pixels, int16_t threshold, hotspot_result* p_result)
+{
+    int16_t max_temp;
+    uint64_t hot_mask = 0;
+    int32_t sum_w = 0;
+    int32_t sum_wx = 0;
+    int32_t sum_wy = 0;
+
+#if defined HOTSPOT_ARM_DSP
+    // Two pixels per 32-bit word. SSUB16 sets a GE flag for each half which
+    //     didn't go negative and SEL picks halves by those flags, which gives a
+    //     branchless per-pixel compare; SMLAD multiplies and adds both halves
+    const uint32_t below2 = (uint16_t)(threshold - 1) * 0x00010001u;
+    const uint32_t threshold2 = (uint16_t)threshold * 0x00010001u;
+    const uint32_t ones2 = 0x00010001u;
+    const uint32_t columns2[4] = { 0x00010000u, 0x00030002u, 0x00050004u, 0x00070006u };
+    uint32_t max2 = 0x80008000u;
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        int32_t row_w = 0;
+        uint32_t row_mask = 0;
+        for (uint8_t pair = 0; pair < 4; pair++)
+        {
+            uint32_t two;
+            memcpy (&two, &pixels[row * 8 + pair * 2], sizeof (two));
+
+            uint32_t above = __SSUB16 (two, below2);
+            __SSUB16 (two, threshold2);
+            uint32_t weight = __SEL (above, 0);
+            uint32_t hot = __SEL (0xFFFFFFFFu, 0);
+            row_mask |= ((hot & 1) | ((hot >> 15) & 2)) << (pair * 2);
+
+            row_w = __SMLAD (weight, ones2, row_w);
+            sum_wx = __SMLAD (weight, columns2[pair], sum_wx);
+
+            __SSUB16 (two, max2);
+            max2 = __SEL (two, max2);
+        }
+        sum_w += row_w;
+        sum_wy += row_w * row;
+        hot_mask |= (uint64_t)row_mask << (row * 8);
+    }
+    int16_t low_half = (int16_t)(max2 & 0xFFFF);
+    int16_t high_half = (int16_t)(max2 >> 16);
+    max_temp = low_half > high_half ? low_half : high_half;
+
+#elif defined HOTSPOT_SSE2
+    // A whole row of eight pixels per register; PMADDWD does the job of SMLAD
+    const __m128i below = _mm_set1_epi16 ((int16_t)(threshold - 1));
+    const __m128i ones = _mm_set1_epi16 (1);
+    const __m128i columns = _mm_setr_epi16 (0, 1, 2, 3, 4, 5, 6, 7);
+    __m128i max8 = _mm_set1_epi16 (INT16_MIN);
+    __m128i acc_w = _mm_setzero_si128 ();
+    __m128i acc_wx = _mm_setzero_si128 ();
+    __m128i acc_wy = _mm_setzero_si128 ();
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        __m128i eight = _mm_loadu_si128 ((const __m128i*)&pixels[row * 8]);
+        max8 = _mm_max_epi16 (max8, eight);
+
+        __m128i hot = _mm_cmpgt_epi16 (eight, below);
+        __m128i weight = _mm_and_si128 (_mm_sub_epi16 (eight, below), hot);
+        uint32_t row_mask = (uint32_t)_mm_movemask_epi8 (_mm_packs_epi16 (hot, hot)) & 0xFF;
+        hot_mask |= (uint64_t)row_mask << (row * 8);
+
+        acc_w = _mm_add_epi32 (acc_w, _mm_madd_epi16 (weight, ones));
+        acc_wx = _mm_add_epi32 (acc_wx, _mm_madd_epi16 (weight, columns));
+        acc_wy = _mm_add_epi32 (acc_wy, _mm_madd_epi16 (weight, _mm_set1_epi16 (row)));
+    }
+
+    // Horizontal reductions
+    max8 = _mm_max_epi16 (max8, _mm_shuffle_epi32 (max8, _MM_SHUFFLE (1, 0, 3, 2)));
+    max8 = _mm_max_epi16 (max8, _mm_shuffle_epi32 (max8, _MM_SHUFFLE (2, 3, 0, 1)));
+    max8 = _mm_max_epi16 (max8, _mm_shufflelo_epi16 (max8, _MM_SHUFFLE (2, 3, 0, 1)));
+    max_temp = (int16_t)_mm_cvtsi128_si32 (max8);
+
+    int32_t sums[3][4];
+    _mm_storeu_si128 ((__m128i*)sums[0], acc_w);
+    _mm_storeu_si128 ((__m128i*)sums[1], acc_wx);
+    _mm_storeu_si128 ((__m128i*)sums[2], acc_wy);
+    sum_w = sums[0][0] + sums[0][1] + sums[0][2] + sums[0][3];
+    sum_wx = sums[1][0] + sums[1][1] + sums[1][2] + sums[1][3];
+    sum_wy = sums[2][0] + sums[2][1] + sums[2][2] + sums[2][3];
+
+#else
+    // Plain C, one pixel at a time without branches in the loop body
+    const int16_t below = threshold - 1;
+    max_temp = INT16_MIN;
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        int16_t temp = pixels[pixel];
+        int32_t hot = temp > below;
+        int32_t weight = (temp - below) & -hot;
+        max_temp = temp > max_temp ? temp : max_temp;
+        hot_mask |= (uint64_t)hot << pixel;
+        sum_w += weight;
+        sum_wx += weight * (pixel & 7);
+        sum_wy += weight * (pixel >> 3);
+    }
+#endif
+
+    finish (pixels, max_temp, hot_mask, sum_w, sum_wx, sum_wy, p_result);
+}
+
+
+/** @brief   Simple scalar version of hotspot_find(), used to check it.
+ *  @details Works on a 2-D copy of the frame and counts blobs with an ordinary
+ *           flood fill, so it shares no tricks with the fast version.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts, top row first
+ *  @param   threshold The lowest temperature, in counts, which makes a pixel hot
+ *  @param   p_result Where to put what was found
+ */
+void hotspot_find_reference (const int16_t* pixels, int16_t threshold, hotspot_result* p_result)
+{
+    int16_t grid[8][8];
+    bool hot[8][8];
+    bool seen[8][8];
+    memcpy (grid, pixels, sizeof (grid));
+
+    memset (p_result, 0, sizeof (*p_result));
+    p_result->max_temp = grid[0][0];
+    int32_t sum_w = 0;
+    int32_t sum_wx = 0;
+    int32_t sum_wy = 0;
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            int16_t temp = grid[row][col];
+            if (temp > p_result->max_temp)
+            {
+                p_result->max_temp = temp;
+                p_result->max_pixel = row * 8 + col;
+            }
+            hot[row][col] = temp >= threshold;
+            seen[row][col] = false;
+            if (hot[row][col])
+            {
+                int32_t weight = temp - threshold + 1;
+                p_result->hot_mask |= 1ull << (row * 8 + col);
+                p_result->hot_pixels++;
+                sum_w += weight;
+                sum_wx += weight * col;
+                sum_wy += weight * row;
+            }
+        }
+    }
+    if (sum_w > 0)
+    {
+        p_result->centroid_col = (uint16_t)(((sum_wx << 8) + sum_w / 2) / sum_w);
+        p_result->centroid_row = (uint16_t)(((sum_wy << 8) + sum_w / 2) / sum_w);
+    }
+
+    // Flood fill from each hot pixel not yet part of a blob
+    uint8_t stack[64];
+    for (uint8_t start = 0; start < 64; start++)
+    {
+        if (!hot[start / 8][start % 8] || seen[start / 8][start % 8])
+        {
+            continue;
+        }
+        p_result->blobs++;
+        uint8_t depth = 0;
+        stack[depth++] = start;
+        seen[start / 8][start % 8] = true;
+        while (depth > 0)
+        {
+            uint8_t here = stack[--depth];
+            int8_t row = here / 8;
+            int8_t col = here % 8;
+            for (int8_t dr = -1; dr <= 1; dr++)
+            {
+                for (int8_t dc = -1; dc <= 1; dc++)
+                {
+                    int8_t r = row + dr;
+                    int8_t c = col + dc;
+                    if (r >= 0 && r < 8 && c >= 0 && c < 8 && hot[r][c] && !seen[r][c])
+                    {
+                        seen[r][c] = true;
+                        stack[depth++] = r * 8 + c;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/** @file hotspot.h
+ *  This file contains the software hotspot detector which runs on every 8x8
+ *  frame from the thermal camera. In one pass over the frame it finds the
+ *  hottest pixel, which pixels are at or above a threshold, and the weighted
+ *  centre of those hot pixels; it then counts how many separate hot blobs
+ *  there are. Everything is in fixed point. On a Cortex-M4 the pass uses the
+ *  DSP extension's two-pixels-per-instruction SIMD instructions, on a host
+ *  with SSE2 it does a whole row at a time, and elsewhere it falls back on
+ *  plain C. hotspot_find_reference() is a simple scalar version which the
+ *  fast one must always agree with.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _HOTSPOT_H_
+#define _HOTSPOT_H_
+
+#include <stdint.h>
+
+/// What the hotspot detector found in one frame
+struct hotspot_result
+{
+    uint64_t hot_mask;                       ///< Bit (row * 8 + column) is set for each hot pixel
+    int16_t max_temp;                        ///< Temperature of the hottest pixel, in 0.25 degree C counts
+    uint8_t max_pixel;                       ///< Index (row * 8 + column) of the hottest pixel, the first if tied
+    uint8_t hot_pixels;                      ///< Number of pixels at or above the threshold
+    uint8_t blobs;                           ///< Number of separate groups of touching hot pixels, diagonals included
+    uint16_t centroid_col;                   ///< Centre column of the hot pixels in 8.8 fixed point, 0 if none
+    uint16_t centroid_row;                   ///< Centre row of the hot pixels in 8.8 fixed point, 0 if none
+};
+
+void hotspot_find (const int16_t* pixels, int16_t threshold, hotspot_result* p_result);
+void hotspot_find_reference (const int16_t* pixels, int16_t threshold, hotspot_result* p_result);
+
+#endif // _HOTSPOT_H_
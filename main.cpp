@@ -9,7 +9,9 @@
  *                                extinguished. If a temperature above 140 degrees Fahrenheit
  *                                is measured, an interrupt is generated which raises the 
  *                                value of a share from 0 to 1, thus allowing the other tasks
- *                                to take the appropriate actions.
+ *                                to take the appropriate actions. It also reads every full
+ *                                8x8 frame into the thermal_frames ring for other tasks to use,
+ *                                taking the cameras in thermal_array.h in turn.
  *    (3) - task_Extinguisher -   when a fire is detected, this task actuates a motor that is 
  *                                press-fit to a lead screw which clamps down the lever of a 
  *                                fire extinguisher that is mounted to the assembly.  When the 
@@ -29,6 +31,46 @@
  *                                before the fire was extinguished. This switch is designed to change the value
  *                                of the shared state variable to 3 for the FSM within task_Extinguish. This will
  *                                halt the motor's rotation once it is back to its reset position
+ *
+ *    The micro limit switches normally raise interrupts which post events to task_Dispatcher
+ *    directly, so (4) and (5) are interrupt service routines rather than tasks. Defining
+ *    LIMIT_SWITCH_POLLING at build time brings back the two polling tasks.
+ *
+ *    The tasks no longer poll shares to find out what to do. task_Dispatcher holds the one
+ *    state machine: the other tasks and the switch interrupts post events to it, and it tells
+ *    the rotation and extinguisher tasks what to do with direct task notifications.
+ *
+ *    After the greeting, the serial port carries a binary trace log of events, motor
+ *    commands, switch edges and frame statistics, sent by the lowest priority task,
+ *    task_Trace (see trace.h). sim/trace_decode.cpp turns it into a timeline.
+ *    Every task also keeps its own run-time statistics (see task_stats.h), which
+ *    are printed, with each camera's frame rate and share of the I2C bus, when the
+ *    letter 's' is sent to the serial port. The thermal task
+ *    also builds a map of the whole room as the turntable turns (see panorama.h),
+ *    which is printed when the letter 'p' is sent. Sending 'r' starts a capture of
+ *    every camera frame, switch edge and motor command in place of the trace log
+ *    (see capture.h), and sending it again stops it; sim/replay_main.cpp plays a
+ *    capture back through this firmware on the host. Sending 'f' starts a live stream
+ *    of every camera frame, delta coded so that it fits on the port along with the
+ *    trace log (see frame_stream.h); sim/frame_receive.cpp rebuilds the frames.
+ *
+ *    The flags and the FSM state which tasks and interrupts read all the time are
+ *    AtomicShares (see atomic_share.h), read and written without a lock; sending
+ *    'b' prints what a read and a write cost against the ME507 Share.
+ *
+ *    Every fire the cameras see goes into a queue (see fire_queue.h). When one has been
+ *    put out, the turntable turns to the next one in the queue, in the order which puts
+ *    them all out soonest, rather than scanning round again to find it.
+ *
+ *    There is no wait at power-up. Each task brings up and tests its own hardware at
+ *    the same time as the others, the cameras, the motor driver and the limit switches,
+ *    and a part which is missing is tried again after a growing wait rather than hung
+ *    on; FireBot is armed and starts scanning once every part has passed, and the time
+ *    that took is printed with the task statistics (see boot.h).
+ *
+ *    On the dual-core ESP32 the cameras are read and searched for fires on one core and
+ *    the motors are driven on the other (see task_table.h), and the data the two share
+ *    is guarded by locks which hold off the other core (see core_lock.h).
  * 
  *  @author Hunter Brooks & William Dorosk
  *  @date   20 Nov 2021 Created file
@@ -42,23 +84,73 @@
     #include <STM32FreeRTOS.h>
 #endif
 
-#include "taskshare.h"               // Header for inter-task shared data
-#include "taskqueue.h"               // Header for inter-task data queues
 #include "shares.h"                  // Header for shares
 #include "task_Rotation_Base.h"      // Header for turntable rotation task module
 #include "task_Thermal_Sensor.h"     // Header for thermal camera task module
 #include "task_Extinguisher.h"       // Header for extinguisher task module
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
 #include "MircroSwitch1.h"           // Header for micro limit switch 1 task module
 #include "MicroSwitch2.h"            // Header for micro limit switch 2 task module
+#include "trace.h"                   // Header for the trace log
+#include "task_table.h"              // Header for the table of tasks and the memory they are made in
 
-/// Share which keeps track of whether a fire is being extinguished (1) or not (0)
-Share<uint8_t> fire_detected ("fire_detected");
+/// Ring of full thermal camera frames, written by task_Thermal_Sensor and read by any task
+FrameRing thermal_frames ("thermal_frames");
 
-/// A share which holds the state of the FSM within task_Extinguish
-Share<uint8_t> state_extinguish ("state_extinguish");
+/// Scan speed chosen by task_Thermal_Sensor for task_Rotation_Base
+ScanScheduler scan_scheduler;
 
-/// A share which keeps track of whether the fire has been extinguished and the values of the shares are being reset (1) or not (0)
-Share<uint8_t> restart_program ("restart_program");
+/// Map of the whole room built by task_Thermal_Sensor, printed by task_Trace
+Panorama panorama;
+
+/// Thermal cameras read by task_Thermal_Sensor; task_Trace prints their statistics
+ThermalArray thermal_array;
+
+/// Fires seen and not yet put out, filled by task_Thermal_Sensor and followed by task_Rotation_Base
+FireQueue fire_queue;
+
+// The memory each task is made in, sized from its line of the task table; see task_memory.h
+TaskMemoryOf<TASK_DISPATCHER> dispatcher_memory;       ///< Memory of task_Dispatcher
+TaskMemoryOf<TASK_ROTATION> rotation_memory;           ///< Memory of task_Rotation_Base
+TaskMemoryOf<TASK_THERMAL> thermal_memory;             ///< Memory of task_Thermal_Sensor
+TaskMemoryOf<TASK_EXTINGUISHER> extinguisher_memory;   ///< Memory of task_Extinguisher
+TaskMemoryOf<TASK_TRACE> trace_memory;                 ///< Memory of task_Trace
+#ifdef LIMIT_SWITCH_POLLING
+TaskMemoryOf<TASK_SWITCH1> switch1_memory;             ///< Memory of the MicroSwitch1 polling task
+TaskMemoryOf<TASK_SWITCH2> switch2_memory;             ///< Memory of the MicroSwitch2 polling task
+#endif
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+/** @brief   Gives the kernel the memory for its idle task.
+ *  @details Called by vTaskStartScheduler() in a build without dynamic allocation.
+ */
+extern "C" void vApplicationGetIdleTaskMemory (StaticTask_t** ppxIdleTaskTCBBuffer,
+                                               StackType_t** ppxIdleTaskStackBuffer,
+                                               uint32_t* pulIdleTaskStackSize)
+{
+    static StaticTask_t idle_tcb;
+    static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+    *ppxIdleTaskTCBBuffer = &idle_tcb;
+    *ppxIdleTaskStackBuffer = idle_stack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if configUSE_TIMERS == 1
+/** @brief   Gives the kernel the memory for its timer task.
+ *  @details Called by vTaskStartScheduler() in a build without dynamic allocation.
+ */
+extern "C" void vApplicationGetTimerTaskMemory (StaticTask_t** ppxTimerTaskTCBBuffer,
+                                                StackType_t** ppxTimerTaskStackBuffer,
+                                                uint32_t* pulTimerTaskStackSize)
+{
+    static StaticTask_t timer_tcb;
+    static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH];
+    *ppxTimerTaskTCBBuffer = &timer_tcb;
+    *ppxTimerTaskStackBuffer = timer_stack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+#endif
 
 /** @brief   Arduino setup function which runs once at program startup.
  *  @details This function sets up a serial port for communication and creates
@@ -66,53 +158,43 @@ Share<uint8_t> restart_program ("restart_program");
  */
 void setup () 
 {
-    // Start the serial port, wait a short time, then say hello. Use the
-    // non-RTOS delay() function because the RTOS hasn't been started yet
+    // Start the serial port and say hello. There is no wait: every task starts at
+    //     once and brings up its own hardware alongside the others, and FireBot is
+    //     armed as soon as all of it is ready (see boot.h)
     Serial.begin (115200);
-    delay (5000);
     Serial << endl << endl << "Hello, I am FireBot" << endl;
 
-    // Create a task which rotates the turntable while a fire has not been detected
-    xTaskCreate (task_Rotation_Base,              // Task function
-                 "Rotation",                      // Task name for debugging printouts
-                 4096,                            // Stack size for this task
-                 NULL,                            // Pointer to no parameters
-                 1,                               // Priority
-                 NULL);                           // Don't save task object pointer
-
-    // Create a task which continuously scans for temperatures when a fire is not being extinguished
-    xTaskCreate (task_Thermal_Sensor,             // Task function
-                 "Thermal Sensor",                // Task name for debugging printouts
-                 4096,                            // Stack size for this task
-                 NULL,                            // Pointer to no parameters
-                 2,                               // Priority
-                 NULL);                           // Don't save task object pointer
-    // Create a task which actuates a motor that compresses the lever of a fire extinguisher, thus extinguishing a fire
-    xTaskCreate (task_Extinguisher,               // Task function
-                 "Extinguisher",                  // Task name for debugging printouts
-                 4096,                            // Stack size for this task
-                 NULL,                            // Pointer to no parameters
-                 3,                               // Priority
-                 NULL);                           // Don't save task object pointer
-                 
-    // Create a task which switches the direction of the motor's rotation, thus translating the motor back toward its reset position
-    xTaskCreate (MicroSwitch1,                    // Task function
-                 "MicroSwitch1",                  // Task name for debugging printouts
-                 4096,                            // Stack size for this task
-                 NULL,                            // Pointer to no parameters
-                 4,                               // Priority
-                 NULL);                           // Don't save task object pointer
-
-    // Create a task which halts the motor's rotation once it is back to its reset position
-    xTaskCreate (MicroSwitch2,                    // Task function
-                 "MicroSwitch2",                  // Task name for debugging printouts
-                 4096,                            // Stack size for this task
-                 NULL,                            // Pointer to no parameters
-                 5,                               // Priority
-                 NULL);                           // Don't save task object pointer
-                 
+    // Create the dispatcher's event queue before anything can post to it, and
+    //     start the trace log's clock before anything can write to it
+    firebot_events_begin ();
+    trace_begin ();
+
+#ifndef LIMIT_SWITCH_POLLING
+    // Attach the limit switch interrupts, which post to the dispatcher directly
+    //     and so need no tasks or stacks of their own. This comes before the tasks
+    //     are made so that the inputs are set up when the switches are tested
+    MicroSwitch1_begin ();
+    MicroSwitch2_begin ();
+#endif
+
+    // Create the tasks from their lines of the task table (see task_table.h), which
+    //     gives each its name, priority and stack size. Save the handles of the
+    //     rotation and extinguisher tasks so the dispatcher can notify them
+    task_create<TASK_DISPATCHER> (dispatcher_memory);
+    rotation_handle = task_create<TASK_ROTATION> (rotation_memory);
+    task_create<TASK_THERMAL> (thermal_memory);
+    extinguisher_handle = task_create<TASK_EXTINGUISHER> (extinguisher_memory);
+    task_create<TASK_TRACE> (trace_memory);
+
+#ifdef LIMIT_SWITCH_POLLING
+    // Create the tasks which read the limit switches
+    task_create<TASK_SWITCH1> (switch1_memory);
+    task_create<TASK_SWITCH2> (switch2_memory);
+#endif
+
     // If using an STM32, we need to call the scheduler startup function now;
-    // if using an ESP32, it has already been called for us
+    // if using an ESP32, it has already been called for us, and each task
+    // started on the core its line of the task table pins it to
     #if (defined STM32L4xx || defined STM32F4xx)
         vTaskStartScheduler ();
     #endif
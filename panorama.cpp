@@ -0,0 +1,232 @@
+/** @file panorama.cpp
+ *  This file contains the 360 degree thermal map which task_Thermal_Sensor
+ *  builds from its frames as the turntable turns.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#include <string.h>
+#include <math.h>
+
+#include "panorama.h"                // Header for the thermal map
+
+/// Angle each camera pixel column covers, in degrees
+const float PANORAMA_PIXEL_DEG = 7.5f;
+
+/// Characters which show a cell's temperature in print(), coolest first
+const char PANORAMA_SHADES[] = " .:-=+*#%@";
+
+
+/** @brief   Creates a map in which nothing has been seen yet.
+ */
+Panorama::Panorama (void)
+{
+    memset (cells, 0, sizeof (cells));
+    memset (reference, 0, sizeof (reference));
+    for (uint16_t column = 0; column < PANORAMA_COLUMNS; column++)
+    {
+        seen_revolution[column] = UINT16_MAX;
+        column_max[column] = INT16_MIN;
+    }
+    revolution = 0;
+    last_heading_deg = 0.0f;
+}
+
+
+/** @brief   Returns the column a bearing falls in.
+ *  @param   bearing_deg The bearing, which may be negative or more than a full turn
+ */
+uint16_t Panorama::column_of (float bearing_deg)
+{
+    float wrapped = fmodf (bearing_deg, 360.0f);
+    if (wrapped < 0.0f)
+    {
+        wrapped += 360.0f;
+    }
+    uint16_t column = (uint16_t)(wrapped / PANORAMA_DEG_PER_COLUMN);
+    return column < PANORAMA_COLUMNS ? column : 0;
+}
+
+
+/** @brief   Blends a frame into the map at the heading it was taken at.
+ *  @details Camera pixel column @c c looks along heading + offset + (c - 3.5)
+ *           * 7.5 degrees, so it covers the two map columns nearest that bearing.
+ *           The first time a column is updated in a revolution, its cells are
+ *           copied as the reference which changes are measured against; a
+ *           column seen for the first time ever simply takes the pixels. A
+ *           revolution is counted each time the turntable's heading passes
+ *           zero going forward, whichever camera the frames come from.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts, top row first
+ *  @param   heading_deg The turntable's heading when the frame was taken, 0 to 360
+ *  @param   offset_deg Direction the camera looks, in degrees forward of the turntable's heading
+ */
+void Panorama::update (const int16_t* pixels, float heading_deg, float offset_deg)
+{
+    if (heading_deg < last_heading_deg - 180.0f)
+    {
+        revolution = revolution + 1 < UINT16_MAX ? revolution + 1 : 0;
+    }
+    last_heading_deg = heading_deg;
+
+    const int32_t half = 1 << (PANORAMA_BLEND_SHIFT - 1);
+    for (uint8_t pixel_column = 0; pixel_column < 8; pixel_column++)
+    {
+        // Left edge of the pixel, rounded to the nearest column boundary
+        float left_deg = heading_deg + offset_deg + (pixel_column - 4) * PANORAMA_PIXEL_DEG;
+        uint16_t first = column_of (left_deg + PANORAMA_DEG_PER_COLUMN / 2.0f);
+        for (uint8_t part = 0; part < 2; part++)
+        {
+            uint16_t column = (first + part) % PANORAMA_COLUMNS;
+            int16_t* p_cells = cells[column];
+            if (seen_revolution[column] == UINT16_MAX)
+            {
+                for (uint8_t row = 0; row < PANORAMA_ROWS; row++)
+                {
+                    p_cells[row] = pixels[row * 8 + pixel_column];
+                }
+                memcpy (reference[column], p_cells, sizeof (cells[0]));
+            }
+            else
+            {
+                if (seen_revolution[column] != revolution)
+                {
+                    memcpy (reference[column], p_cells, sizeof (cells[0]));
+                }
+                for (uint8_t row = 0; row < PANORAMA_ROWS; row++)
+                {
+                    int32_t difference = pixels[row * 8 + pixel_column] - p_cells[row];
+                    p_cells[row] += (int16_t)((difference + half) >> PANORAMA_BLEND_SHIFT);
+                }
+            }
+            seen_revolution[column] = revolution;
+
+            int16_t most = p_cells[0];
+            for (uint8_t row = 1; row < PANORAMA_ROWS; row++)
+            {
+                most = p_cells[row] > most ? p_cells[row] : most;
+            }
+            column_max[column] = most;
+        }
+    }
+}
+
+
+/** @brief   Finds the hottest cell in the map.
+ *  @details Looks only at the hottest cell of each column, which update()
+ *           keeps, so the search is one pass over PANORAMA_COLUMNS values.
+ *  @param   p_bearing_deg Where to put the bearing of the middle of its column, if not NULL
+ *  @param   p_row Where to put its row, if not NULL
+ *  @return  Its temperature in 0.25 degree C counts, or INT16_MIN if nothing has been seen
+ */
+int16_t Panorama::hottest (float* p_bearing_deg, uint8_t* p_row) const
+{
+    uint16_t best = 0;
+    for (uint16_t column = 1; column < PANORAMA_COLUMNS; column++)
+    {
+        if (column_max[column] > column_max[best])
+        {
+            best = column;
+        }
+    }
+    if (p_bearing_deg != NULL)
+    {
+        *p_bearing_deg = (best + 0.5f) * PANORAMA_DEG_PER_COLUMN;
+    }
+    if (p_row != NULL)
+    {
+        uint8_t row = 0;
+        while (row < PANORAMA_ROWS - 1 && cells[best][row] != column_max[best])
+        {
+            row++;
+        }
+        *p_row = row;
+    }
+    return column_max[best];
+}
+
+
+/** @brief   Lists the cells which have changed since the last revolution.
+ *  @details A cell has changed if it is at least @c threshold away from its
+ *           value at the end of the last revolution in which its column was
+ *           seen. Columns not yet seen in this revolution are compared as they
+ *           were when last seen, so a change shows up as soon as the camera
+ *           has passed over it.
+ *  @param   p_changes Where to put the changed cells, in column order; may be
+ *           NULL to count them only
+ *  @param   max_changes Room in @c p_changes
+ *  @param   threshold Smallest change which counts, in 0.25 degree C counts
+ *  @return  The number of changed cells, which may be more than @c max_changes
+ */
+uint16_t Panorama::changed_since_last_revolution (panorama_change* p_changes, uint16_t max_changes,
+                                                  int16_t threshold) const
+{
+    uint16_t count = 0;
+    for (uint16_t column = 0; column < PANORAMA_COLUMNS; column++)
+    {
+        if (seen_revolution[column] == UINT16_MAX)
+        {
+            continue;
+        }
+        for (uint8_t row = 0; row < PANORAMA_ROWS; row++)
+        {
+            int16_t delta = cells[column][row] - reference[column][row];
+            if (delta >= threshold || delta <= -threshold)
+            {
+                if (p_changes != NULL && count < max_changes)
+                {
+                    p_changes[count].column = column;
+                    p_changes[count].row = row;
+                    p_changes[count].delta = delta;
+                }
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+
+/** @brief   Prints the map as text, one character per cell.
+ *  @details The coolest cell prints as a space and the hottest as '@', with
+ *           the range between shaded evenly; columns not yet seen print as
+ *           '?'. Bearing 0 is on the left. The hottest cell and the number of
+ *           changed cells are printed first.
+ *  @param   printer The serial port or other stream to print to
+ */
+void Panorama::print (Print& printer) const
+{
+    float bearing;
+    int16_t high = hottest (&bearing);
+    if (high == INT16_MIN)
+    {
+        printer << "Panorama: nothing seen yet" << endl;
+        return;
+    }
+    int16_t low = high;
+    for (uint16_t column = 0; column < PANORAMA_COLUMNS; column++)
+    {
+        for (uint8_t row = 0; row < PANORAMA_ROWS && seen_revolution[column] != UINT16_MAX; row++)
+        {
+            low = cells[column][row] < low ? cells[column][row] : low;
+        }
+    }
+    printer << "Panorama, revolution " << revolution << ": hottest " << high / 4 << " C at "
+            << (int)bearing << " deg, " << changed_since_last_revolution (NULL, 0) << " cells changed" << endl;
+
+    const int32_t shades = sizeof (PANORAMA_SHADES) - 2;
+    int32_t span = high > low ? high - low : 1;
+    char line[PANORAMA_COLUMNS + 1];
+    line[PANORAMA_COLUMNS] = '\0';
+    for (uint8_t row = 0; row < PANORAMA_ROWS; row++)
+    {
+        for (uint16_t column = 0; column < PANORAMA_COLUMNS; column++)
+        {
+            line[column] = seen_revolution[column] == UINT16_MAX
+                           ? '?' : PANORAMA_SHADES[(cells[column][row] - low) * shades / span];
+        }
+        printer << line << endl;
+    }
+}
@@ -0,0 +1,89 @@
+/** @file panorama.h
+ *  This file contains a 360 degree thermal map of the room around FireBot,
+ *  built up from the thermal camera frames as the turntable turns. The map
+ *  is a cylinder of PANORAMA_COLUMNS columns by the camera's 8 rows, each
+ *  cell holding a temperature in the same 0.25 degree C counts as a frame.
+ *  Every frame is blended into the columns it covers at the turntable's
+ *  heading when it was taken, so the map remembers what has been seen in
+ *  every direction and can answer questions such as "where is the hottest
+ *  thing in the room" or "what has changed since the last time round"
+ *  without waiting for the turntable to come back.
+ *
+ *  The cells are stored a column at a time, so the 8 rows of one column are
+ *  16 contiguous bytes and a frame's pixel column lands in one or two such
+ *  runs; the columns wrap around as a ring indexed by bearing. The whole
+ *  map, with the copy kept for change detection, takes a little over 3 KB.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _PANORAMA_H_
+#define _PANORAMA_H_
+
+#include <stdint.h>
+
+class Print;
+
+/// Number of columns around the circle; each camera pixel covers two
+const uint16_t PANORAMA_COLUMNS = 96;
+
+/// Number of rows, one for each row of camera pixels
+const uint8_t PANORAMA_ROWS = 8;
+
+/// Angle each column covers, in degrees
+const float PANORAMA_DEG_PER_COLUMN = 360.0f / PANORAMA_COLUMNS;
+
+/// Each frame moves a cell 1/2^PANORAMA_BLEND_SHIFT of the way to the new pixel
+const uint8_t PANORAMA_BLEND_SHIFT = 1;
+
+/// A cell counts as changed if it has moved this far since the last revolution, in 0.25 degree C counts (2 degrees C)
+const int16_t PANORAMA_CHANGE_COUNTS = 8;
+
+/// One cell which has changed since the last revolution
+struct panorama_change
+{
+    uint16_t column;                         ///< Column of the cell, 0 at bearing 0
+    uint8_t row;                             ///< Row of the cell, 0 at the top
+    int16_t delta;                           ///< How far it moved, in 0.25 degree C counts
+};
+
+/** @brief   Cylindrical map of the temperatures all around the turntable.
+ *  @details Only task_Thermal_Sensor calls update(). The queries may be made
+ *           from any task; each cell is read in one go, but a query made while
+ *           a frame is being blended in may see some of its columns before the
+ *           frame and some after.
+ */
+class Panorama
+{
+protected:
+    int16_t cells[PANORAMA_COLUMNS][PANORAMA_ROWS];      ///< Temperatures, a column at a time
+    int16_t reference[PANORAMA_COLUMNS][PANORAMA_ROWS];  ///< Each column as it was at the end of the last revolution it was seen in
+    uint16_t seen_revolution[PANORAMA_COLUMNS];          ///< Revolution each column was last updated in
+    int16_t column_max[PANORAMA_COLUMNS];                ///< Hottest cell of each column
+    uint16_t revolution;                                 ///< Turns of the heading past zero since power-up
+    float last_heading_deg;                              ///< Turntable heading of the previous frame
+
+public:
+    Panorama (void);
+
+    void update (const int16_t* pixels, float heading_deg, float offset_deg = 0.0f);
+
+    int16_t hottest (float* p_bearing_deg = NULL, uint8_t* p_row = NULL) const;
+    uint16_t changed_since_last_revolution (panorama_change* p_changes, uint16_t max_changes,
+                                            int16_t threshold = PANORAMA_CHANGE_COUNTS) const;
+    void print (Print& printer) const;
+
+    /// Returns one cell in 0.25 degree C counts, or INT16_MIN if it hasn't been seen
+    int16_t get (uint16_t column, uint8_t row) const
+    {
+        return seen_revolution[column] == UINT16_MAX ? INT16_MIN : cells[column][row];
+    }
+
+    /// Returns how many times the heading has passed zero
+    uint16_t get_revolution (void) const { return revolution; }
+
+    static uint16_t column_of (float bearing_deg);
+};
+
+#endif // _PANORAMA_H_
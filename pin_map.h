@@ -0,0 +1,83 @@
+/** @file pin_map.h
+ *  This file contains every pin of the Nucleo which FireBot is wired to, in
+ *  one place. The motor driver is a TB6612, whose two channels share one
+ *  standby input, so the turntable and carriage motors are listed with the
+ *  same STBY pin rather than each file defining its own. The thermal
+ *  cameras' INT pins are listed with the cameras in thermal_array.h.
+ *
+ *  Every pin is checked at compile time against every other, and against
+ *  the pins the board already uses for the serial port and the I2C bus, so
+ *  a pin given to two things stops the build rather than the robot.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _PIN_MAP_H_
+#define _PIN_MAP_H_
+
+#include <Arduino.h>
+
+#include "thermal_array.h"           // Header for the cameras' INT pins
+
+/// Pins of one channel of the TB6612 motor driver
+struct motor_pins
+{
+    uint32_t in1;                            ///< One of the two inputs that determines the direction
+    uint32_t in2;                            ///< The other input that determines the direction
+    uint32_t pwm;                            ///< PWM input that controls the speed
+    uint32_t standby;                        ///< Lets the H-bridges work when high; has a pulldown so it must be driven high
+    int offset;                              ///< 1 or -1, so that "forward" in the Motor class turns the right way
+};
+
+/// The motor that rotates the turntable, on channel A
+constexpr motor_pins TURNTABLE_MOTOR_PINS = { PA8, PB10, PA7, PB4, 1 };
+
+/// The motor that actuates the fire extinguisher, on channel B
+constexpr motor_pins CARRIAGE_MOTOR_PINS = { PB5, PA10, PB3, PB4, 1 };
+
+/// Limit switch 1, which reads as a digital zero when the extinguisher lever is fully pressed
+constexpr uint32_t MICROSWITCH1_PIN = PA9;
+
+/// Limit switch 2, which reads as a digital zero when the carriage is back home
+constexpr uint32_t MICROSWITCH2_PIN = PB6;
+
+/// Pins the board uses itself: the ST-Link serial port and the Wire library's I2C bus
+constexpr uint32_t BOARD_PINS[] = { PA2, PA3, PB8, PB9 };
+
+/// Every pin FireBot uses, each once; the motor driver's standby pin is shared by both channels
+constexpr uint32_t FIREBOT_PINS[] =
+{
+    TURNTABLE_MOTOR_PINS.in1, TURNTABLE_MOTOR_PINS.in2, TURNTABLE_MOTOR_PINS.pwm,
+    CARRIAGE_MOTOR_PINS.in1, CARRIAGE_MOTOR_PINS.in2, CARRIAGE_MOTOR_PINS.pwm,
+    TURNTABLE_MOTOR_PINS.standby,
+    MICROSWITCH1_PIN, MICROSWITCH2_PIN,
+    THERMAL_SENSOR_LAYOUT[0].int_pin,
+#ifndef THERMAL_SINGLE_SENSOR
+    THERMAL_SENSOR_LAYOUT[1].int_pin,
+#endif
+    BOARD_PINS[0], BOARD_PINS[1], BOARD_PINS[2], BOARD_PINS[3]
+};
+
+/// Number of pins in FIREBOT_PINS
+constexpr uint8_t FIREBOT_PIN_COUNT = sizeof (FIREBOT_PINS) / sizeof (FIREBOT_PINS[0]);
+
+/** @brief   Checks at compile time that no pin in FIREBOT_PINS is listed twice.
+ *  @param   first The first of the pins to compare with all those after it
+ *  @param   second The pin after it to compare it with
+ *  @return  true if no two of the pins from @c first on are the same
+ */
+constexpr bool pins_distinct (uint8_t first = 0, uint8_t second = 1)
+{
+    return first >= FIREBOT_PIN_COUNT ? true
+           : second >= FIREBOT_PIN_COUNT ? pins_distinct (first + 1, first + 2)
+           : FIREBOT_PINS[first] != FIREBOT_PINS[second] && pins_distinct (first, second + 1);
+}
+
+static_assert (pins_distinct (), "two things are wired to the same pin; see FIREBOT_PINS in pin_map.h");
+static_assert (TURNTABLE_MOTOR_PINS.standby == CARRIAGE_MOTOR_PINS.standby,
+               "both motors are on one TB6612, which has a single standby pin");
+static_assert (THERMAL_SENSORS <= 2,
+               "list the new camera's INT pin in FIREBOT_PINS");
+
+#endif // _PIN_MAP_H_
@@ -0,0 +1,126 @@
+/** @file scan_scheduler.cpp
+ *  This file contains the scheduler which slows the turntable down through
+ *  sectors which are getting warmer and speeds it up through the rest.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include <math.h>
+
+#include "scan_scheduler.h"          // Header for the scan scheduler
+#include "task_Rotation_Base.h"      // Header for the turntable's rate
+#include "thermal_array.h"           // Header for the directions the cameras look
+
+/// Angle each sector covers, in degrees
+const float SCAN_SECTOR_DEG = 360.0f / BACKGROUND_SECTORS;
+
+/// Turntable rate at full scan speed, in degrees per second
+const float SCAN_FAST_DEG_PER_S = TURNTABLE_DEG_PER_S * SCAN_FAST_PWM / 250.0f;
+
+
+/** @brief   Creates a scheduler which has seen nothing and scans at full speed.
+ *  @details Every sector counts as seen at time zero, so the revisit limit
+ *           holds from power-up.
+ */
+ScanScheduler::ScanScheduler (void)
+{
+    memset (baseline, 0, sizeof (baseline));
+    memset (score, 0, sizeof (score));
+    memset (seen_ms, 0, sizeof (seen_ms));
+    memset (known, 0, sizeof (known));
+    pwm = SCAN_FAST_PWM;
+    interested = false;
+}
+
+
+/** @brief   Learns from a frame and chooses the speed to scan at until the next one.
+ *  @details The frame's hottest pixel is compared with the average for the
+ *           sector the camera was pointing into. A sector is interesting while
+ *           its hottest pixel is at least SCAN_INTEREST_RISE above its average;
+ *           the average is learned much more slowly then, so a fire which is
+ *           growing can't catch up with it, but something which has warmed up
+ *           and stays warm is eventually taken as normal. The turntable goes
+ *           slowly if the sector any camera is looking into or one of the next
+ *           SCAN_LOOKAHEAD_SECTORS ahead of it is interesting, unless going
+ *           slowly for one more frame could leave some sector unseen by every
+ *           camera for longer than SCAN_MAX_REVISIT_MS. Only the cameras
+ *           which are being read count, so that a missing camera isn't taken
+ *           to be watching the sectors behind the turntable.
+ *  @param   p_frame The newest frame, with its sector filled in
+ *  @param   heading_deg The turntable's heading when the frame was taken, 0 to 360
+ *  @param   now_ms The time the frame was taken
+ *  @param   cameras The cameras being read, one bit each as from ThermalArray::get_present_mask()
+ *  @return  The PWM to scan at, which is also what get_pwm() returns from now on
+ */
+int16_t ScanScheduler::update (const thermal_frame* p_frame, float heading_deg, uint32_t now_ms, uint8_t cameras)
+{
+    uint8_t sector = p_frame->sector;
+    int16_t hottest = p_frame->hotspot.max_temp;
+
+    // The first look at a sector simply becomes its average
+    int16_t rise = 0;
+    if (!known[sector])
+    {
+        baseline[sector] = (int16_t)(hottest << 4);
+        known[sector] = true;
+    }
+    else
+    {
+        int32_t deviation = ((int32_t)hottest << 4) - baseline[sector];
+        rise = (int16_t)(deviation >> 4);
+        uint8_t shift = rise >= SCAN_INTEREST_RISE ? SCAN_BASELINE_SHIFT + SCAN_INTEREST_SHIFT
+                                                   : SCAN_BASELINE_SHIFT;
+        baseline[sector] += (int16_t)((deviation + (1 << (shift - 1))) >> shift);
+    }
+    score[sector] = rise > 0 ? rise : 0;
+    seen_ms[sector] = now_ms;
+    interested = score[sector] >= SCAN_INTEREST_RISE;
+
+    // Slow down for a sector some camera is looking into, or for one which is
+    //     about to come into its view. The other cameras' sectors are scored from
+    //     their own latest frames
+    bool slow = interested;
+    for (uint8_t camera = 0; camera < THERMAL_SENSORS && !slow; camera++)
+    {
+        if (!(cameras & (1 << camera)))
+        {
+            continue;
+        }
+        uint8_t in_view = BackgroundModel::sector_of (heading_deg + THERMAL_SENSOR_LAYOUT[camera].offset_deg);
+        for (uint8_t ahead = 0; ahead <= SCAN_LOOKAHEAD_SECTORS && !slow; ahead++)
+        {
+            slow = score[(in_view + ahead) % BACKGROUND_SECTORS] >= SCAN_INTEREST_RISE;
+        }
+    }
+
+    // The turntable only turns forward, so each sector is reached after turning
+    //     the angle forward from the nearest camera to its middle. Going slowly for
+    //     another frame is only allowed if every sector could then still be
+    //     reached in time at full speed
+    for (uint8_t other = 0; other < BACKGROUND_SECTORS && slow; other++)
+    {
+        float distance = 360.0f;
+        for (uint8_t camera = 0; camera < THERMAL_SENSORS; camera++)
+        {
+            if (!(cameras & (1 << camera)))
+            {
+                continue;
+            }
+            float forward = fmodf ((other + 0.5f) * SCAN_SECTOR_DEG - heading_deg
+                                   - THERMAL_SENSOR_LAYOUT[camera].offset_deg, 360.0f);
+            forward = forward < 0.0f ? forward + 360.0f : forward;
+            distance = forward < distance ? forward : distance;
+        }
+        uint32_t reach_ms = (uint32_t)(distance * 1000.0f / SCAN_FAST_DEG_PER_S);
+        if (now_ms - seen_ms[other] + FRAME_PERIOD_US / 1000 + reach_ms > SCAN_MAX_REVISIT_MS)
+        {
+            slow = false;
+        }
+    }
+
+    pwm = slow ? SCAN_SLOW_PWM : SCAN_FAST_PWM;
+    return pwm;
+}
@@ -0,0 +1,79 @@
+/** @file scan_scheduler.h
+ *  This file contains the scheduler which sets how fast the turntable scans.
+ *  Rather than turning at one speed past a cold wall and a warming pile of
+ *  rags alike, the turntable sweeps quickly through sectors where nothing is
+ *  changing and slowly through sectors which are getting warmer, so that a
+ *  fire which is still growing spends more time in front of the camera and
+ *  is caught sooner after it becomes hot enough to be detected.
+ *
+ *  For each sector of the turntable's circle (the same sectors as the
+ *  background model) the scheduler keeps a slow moving average of the
+ *  hottest pixel seen while the camera points into it, and an interest
+ *  score: how far the hottest pixel last climbed above that average. The
+ *  turntable slows down while the camera sees an interesting sector and as
+ *  it comes up on one, and goes at full speed otherwise. No sector is ever
+ *  left unseen for longer than SCAN_MAX_REVISIT_MS: before each slow frame
+ *  the scheduler checks that every sector could still be reached in time
+ *  at full speed, and if not, turns at full speed until it can.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _SCAN_SCHEDULER_H_
+#define _SCAN_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include "background_model.h"        // Header for the turntable sectors
+#include "frame_ring.h"              // Header for the thermal frames
+
+/// Turntable PWM through sectors where nothing is getting warmer
+const int16_t SCAN_FAST_PWM = 255;
+
+/// Turntable PWM through interesting sectors, a little above what friction holds still
+const int16_t SCAN_SLOW_PWM = 48;
+
+/// A sector is interesting if its hottest pixel is this far above its average, in 0.25 degree C counts (2 degrees C)
+const int16_t SCAN_INTEREST_RISE = 8;
+
+/// The turntable slows down this many sectors before an interesting one, so it is slow once it comes into view
+const uint8_t SCAN_LOOKAHEAD_SECTORS = 2;
+
+/// No sector goes unseen for longer than this many milliseconds
+const uint32_t SCAN_MAX_REVISIT_MS = 20000;
+
+/// Each frame moves a sector's average hottest pixel by 1/2^SCAN_BASELINE_SHIFT of the way
+const uint8_t SCAN_BASELINE_SHIFT = 4;
+
+/// While a sector is interesting its average is learned this many times more slowly
+const uint8_t SCAN_INTEREST_SHIFT = 4;
+
+/** @brief   Sets the turntable's scan speed from how each sector's temperature is changing.
+ *  @details Only task_Thermal_Sensor calls update(); any task may read the speed
+ *           with get_pwm(). The speed is one aligned 16 bit value, so reading it
+ *           needs no lock.
+ */
+class ScanScheduler
+{
+protected:
+    int16_t baseline[BACKGROUND_SECTORS];    ///< Average hottest pixel of each sector, 1/16 count units
+    int16_t score[BACKGROUND_SECTORS];       ///< How far the hottest pixel last rose above the average, in counts
+    uint32_t seen_ms[BACKGROUND_SECTORS];    ///< When the camera last pointed into each sector
+    bool known[BACKGROUND_SECTORS];          ///< Whether each sector has been seen at all
+    volatile int16_t pwm;                    ///< Speed the turntable should scan at
+    bool interested;                         ///< Whether the last frame showed a sector getting warmer
+
+public:
+    ScanScheduler (void);
+
+    int16_t update (const thermal_frame* p_frame, float heading_deg, uint32_t now_ms, uint8_t cameras);
+
+    /// Returns the PWM the turntable should scan at
+    int16_t get_pwm (void) const { return pwm; }
+
+    /// Returns true if the last frame showed something getting warmer
+    bool is_interested (void) const { return interested; }
+};
+
+#endif // _SCAN_SCHEDULER_H_
@@ -14,14 +14,29 @@
 #include "task_Rotation_Base.h"
 #include "task_Thermal_Sensor.h"
 #include "task_Extinguisher.h"
+#include "task_Dispatcher.h"
+#include "frame_ring.h"
+#include "scan_scheduler.h"
+#include "panorama.h"
+#include "thermal_array.h"
+#include "fire_queue.h"
 
-/// Share which keeps track of whether a fire is being extinguished (1) or not (0)
-extern Share<uint8_t> fire_detected;
+// The state of the FSM is kept by task_Dispatcher (see task_Dispatcher.h)
+//     rather than in shares
 
-/// A share which holds the state of the FSM within task_Extinguish
-extern Share<uint8_t> state_extinguish;
+/// Ring of full thermal camera frames, written by task_Thermal_Sensor and read by any task
+extern FrameRing thermal_frames;
 
-/// A share which keeps track of whether the fire has been extinguished and the values of the shares are being reset (1) or not (0)
-extern Share<uint8_t> restart_program;
+/// Scan speed chosen by task_Thermal_Sensor for task_Rotation_Base
+extern ScanScheduler scan_scheduler;
+
+/// Map of the whole room built by task_Thermal_Sensor, printed by task_Trace
+extern Panorama panorama;
+
+/// Thermal cameras read by task_Thermal_Sensor; task_Trace prints their statistics
+extern ThermalArray thermal_array;
+
+/// Fires seen and not yet put out, filled by task_Thermal_Sensor and followed by task_Rotation_Base
+extern FireQueue fire_queue;
 
 #endif // _SHARES_H_
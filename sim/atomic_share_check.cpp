@@ -0,0 +1,147 @@
+/** @file atomic_share_check.cpp
+ *  Check of the change notification of an AtomicShare (see atomic_share.h)
+ *  in the virtual-time kernel. A waiting task has itself notified of every
+ *  change with notify() and blocks in wait(), while a writing task at a
+ *  lower priority puts a value into the share partway through the wait:
+ *
+ *  - changed  the writer puts a new value, and the waiter must wake at once
+ *             with it;
+ *  - same     the writer puts the value already there, which must send no
+ *             notification, so the waiter must sleep on to the end of its
+ *             wait and run no more often than with no put at all;
+ *  - timeout  the writer puts nothing, and the waiter must wake at the end
+ *             of its wait with the value unchanged.
+ *
+ *  Usage: atomic_share_check
+ *
+ *  Each result is printed as one line @c metric,value,unit like those of
+ *  firebot_bench. Exits with status 1 if any case went wrong.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Arduino.h>
+#include "atomic_share.h"
+#include "sim_kernel.h"
+
+/// The cases, each in a window of its own
+enum check_case
+{
+    CASE_CHANGED,                            ///< A put of a new value
+    CASE_SAME,                               ///< A put of the value already in the share
+    CASE_TIMEOUT,                            ///< No put at all
+    CASES
+};
+
+/// Printable names of the cases
+const char* const CASE_NAMES[CASES] = { "changed", "same", "timeout" };
+
+/// Value the waiter waits for a change from in each case
+const uint8_t CASE_OLD[CASES] = { 0, 1, 1 };
+
+/// Ticks from one case to the next, each starting on a multiple of this
+const TickType_t CASE_TICKS = 100;
+
+/// Ticks into a case at which the writer puts
+const TickType_t PUT_TICKS = 10;
+
+/// Longest the waiter waits in each case
+const TickType_t WAIT_TICKS = 50;
+
+/// Notification bit the waiter is sent by the share
+const uint32_t CHANGED_BIT = 0x01;
+
+/// The share under test
+static AtomicShare<uint8_t> share ("check", 0);
+
+/// What wait() returned in each case, and how long after it was called
+static uint8_t case_value[CASES];
+static uint64_t case_wait_us[CASES];
+
+
+/** @brief   Waiter task: waits on the share once at the start of each case.
+ */
+static void task_waiter (void*)
+{
+    share.notify (xTaskGetCurrentTaskHandle (), CHANGED_BIT);
+    TickType_t wake = 0;
+    for (uint8_t index = 0; index < CASES; index++)
+    {
+        vTaskDelayUntil (&wake, CASE_TICKS);
+        uint64_t start_us = sim_now_us ();
+        case_value[index] = share.wait (CASE_OLD[index], WAIT_TICKS);
+        case_wait_us[index] = sim_now_us () - start_us;
+    }
+    vTaskDelete (NULL);
+}
+
+
+/** @brief   Writer task: puts a new value, the same value or nothing partway into each case.
+ */
+static void task_writer (void*)
+{
+    TickType_t wake = PUT_TICKS;
+    for (uint8_t index = 0; index < CASES; index++)
+    {
+        vTaskDelayUntil (&wake, CASE_TICKS);
+        if (index == CASE_CHANGED || index == CASE_SAME)
+        {
+            share.put (1);
+        }
+    }
+    vTaskDelete (NULL);
+}
+
+
+int main (int argc, char**)
+{
+    if (argc > 1)
+    {
+        fprintf (stderr, "usage: atomic_share_check\n");
+        return 2;
+    }
+
+    xTaskCreate (task_waiter, "Waiter", 1000, NULL, 2, NULL);
+    xTaskCreate (task_writer, "Writer", 1000, NULL, 1, NULL);
+
+    // Run each case's window on its own so the context switches in it can be counted
+    uint32_t switches[CASES];
+    for (uint8_t index = 0; index < CASES; index++)
+    {
+        sim_run_until_us ((uint64_t)(index + 1) * CASE_TICKS * 1000);
+        uint32_t before = sim_context_switches ();
+        sim_run_until_us ((uint64_t)(index + 2) * CASE_TICKS * 1000);
+        switches[index] = sim_context_switches () - before;
+    }
+
+    uint32_t failures = 0;
+    for (uint8_t index = 0; index < CASES; index++)
+    {
+        // Only a change ends the wait early
+        uint64_t expected_us = (index == CASE_CHANGED ? PUT_TICKS : WAIT_TICKS) * 1000ULL;
+        uint8_t expected = index == CASE_TIMEOUT ? CASE_OLD[index] : 1;
+        if (case_wait_us[index] != expected_us || case_value[index] != expected)
+        {
+            fprintf (stderr, "%s: wait() returned %u after %llu us, expected %u after %llu us\n",
+                     CASE_NAMES[index], case_value[index], (unsigned long long)case_wait_us[index], expected,
+                     (unsigned long long)expected_us);
+            failures++;
+        }
+        printf ("atomic_share.%s_wait,%llu,us\n", CASE_NAMES[index], (unsigned long long)case_wait_us[index]);
+        printf ("atomic_share.%s_switches,%u,count\n", CASE_NAMES[index], switches[index]);
+    }
+
+    // A put of the same value which sent a notification would wake the waiter for nothing
+    if (switches[CASE_SAME] != switches[CASE_TIMEOUT])
+    {
+        fprintf (stderr, "same: %u context switches against %u with no put, so the put woke the waiter\n",
+                 switches[CASE_SAME], switches[CASE_TIMEOUT]);
+        failures++;
+    }
+    printf ("atomic_share.failures,%u,count\n", failures);
+    return failures > 0 ? 1 : 0;
+}
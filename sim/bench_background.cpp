@@ -0,0 +1,324 @@
+/** @file bench_background.cpp
+ *  Replay benchmark of fire detection by the learned background model in
+ *  background_model.cpp against the original fixed 60 degree C threshold.
+ *  For each scene it renders the frames the camera would see from the
+ *  turning turntable, 10 per second, with the same optics as the host
+ *  simulation, and replays them through both detectors exactly as
+ *  task_Thermal_Sensor runs them. Each trial turns for a while with no fire,
+ *  then lights one at a random bearing. It reports the false alarms in the
+ *  first 30 seconds, while the model is still learning, and per minute after
+ *  that until the fire is lit; how many fires were found; and how long after
+ *  the fire first came into view each detector noticed it.
+ *
+ *  Usage: background_bench [--trials N] [--seed S]
+ *
+ *  The turntable's real rate differs from the firmware's estimate by up to
+ *  one percent per trial, so the sectors slowly drift as they would on the
+ *  robot.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <Arduino.h>
+#include "hotspot.h"
+#include "background_model.h"
+#include "task_Rotation_Base.h"
+
+/// Absolute threshold of the original detector, 60 degrees C in 0.25 degree counts
+const int16_t THRESHOLD = 60 * 4;
+/// Angular size of one camera pixel
+const float PIXEL_DEG = 7.5f;
+/// Half the camera's horizontal field of view
+const float HALF_FOV_DEG = 30.0f;
+/// Time between frames
+const float FRAME_S = 0.1f;
+/// Time for the model to learn every sector, about two and a half turns, which is left out of the false alarm rate
+const float WARMUP_S = 30.0f;
+
+/// Something warm in the scene
+struct warm_object
+{
+    float bearing_deg;                       ///< Direction from the turntable's zero
+    float radius_deg;                        ///< Angular radius
+    float start_c;                           ///< Temperature at the start of the replay
+    float end_c;                             ///< Temperature at the end, e.g. a wall warming in the sun
+};
+
+/// One kind of room to replay
+struct scene
+{
+    const char* name;                        ///< Printable name
+    float ambient_c;                         ///< Temperature of everything else
+    std::vector<warm_object> objects;        ///< Warm things which are not fires
+    float fire_c;                            ///< Surface temperature of the fire
+    float fire_radius_deg;                   ///< Angular radius of the fire
+};
+
+/// What one detector did over all the trials of a scene
+struct tally
+{
+    uint32_t warmup_alarms = 0;              ///< Times it triggered with no fire while the model was learning
+    uint32_t false_alarms = 0;               ///< Times it started triggering with no fire after that
+    uint32_t detected = 0;                   ///< Fires found
+    std::vector<float> latencies_ms;         ///< From the fire coming into view to detection
+};
+
+
+/** @brief   Wraps an angle into -180 to 180 degrees.
+ */
+static float wrap_deg (float angle)
+{
+    angle = fmodf (angle + 180.0f, 360.0f);
+    return (angle < 0.0f ? angle + 360.0f : angle) - 180.0f;
+}
+
+
+/** @brief   Fraction of a Gaussian between two offsets, as in sim_world.cpp.
+ */
+static float gauss_span (float from, float to, float sigma)
+{
+    const float scale = 1.0f / (sigma * 1.41421356f);
+    return 0.5f * (erff (to * scale) - erff (from * scale));
+}
+
+
+/** @brief   Adds a disc of some temperature to a frame of floating point pixels.
+ */
+static void render_disc (float* temps, float ambient_c, float heading_deg,
+                         float bearing_deg, float radius_deg, float temp_c)
+{
+    float sigma = radius_deg * 0.70710678f;
+    float dx = wrap_deg (bearing_deg - heading_deg);
+    if (fabsf (dx) > HALF_FOV_DEG + 4.0f * radius_deg)
+    {
+        return;
+    }
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        float el_top = (4 - row) * PIXEL_DEG;
+        float mass_y = gauss_span (el_top - PIXEL_DEG, el_top, sigma);
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            float az_left = (col - 4) * PIXEL_DEG;
+            float mass = gauss_span (az_left - dx, az_left + PIXEL_DEG - dx, sigma) * mass_y;
+            float fill = mass * 6.2831853f * sigma * sigma / (PIXEL_DEG * PIXEL_DEG);
+            temps[row * 8 + col] += (temp_c - ambient_c) * (fill < 1.0f ? fill : 1.0f);
+        }
+    }
+}
+
+
+/** @brief   Replays one trial of a scene through both detectors.
+ *  @param   quiet_s How long to turn before the fire is lit
+ *  @param   fire_deg Bearing of the fire
+ *  @param   rate_error Real turntable rate divided by the firmware's estimate
+ */
+static void run_trial (const scene& room, std::mt19937& rng, float quiet_s, float fire_deg,
+                       float rate_error, float length_s, tally* p_absolute, tally* p_learned)
+{
+    std::normal_distribution<float> noise (0.0f, 0.15f);
+    BackgroundModel* p_model = new BackgroundModel;
+
+    float real_rate = TURNTABLE_DEG_PER_S * rate_error;
+    bool was_absolute = false;
+    bool was_learned = false;
+    bool found_absolute = false;
+    bool found_learned = false;
+    float in_view_s = -1.0f;
+    uint32_t frames = (uint32_t)(length_s / FRAME_S);
+
+    for (uint32_t frame = 0; frame < frames && !(found_absolute && found_learned); frame++)
+    {
+        float now_s = frame * FRAME_S;
+        float heading = real_rate * now_s;
+        float estimate = TURNTABLE_DEG_PER_S * now_s;
+        bool lit = now_s >= quiet_s;
+
+        float temps[64];
+        for (uint8_t pixel = 0; pixel < 64; pixel++)
+        {
+            temps[pixel] = room.ambient_c;
+        }
+        float progress = now_s / length_s;
+        for (const warm_object& object : room.objects)
+        {
+            float temp = object.start_c + (object.end_c - object.start_c) * progress;
+            render_disc (temps, room.ambient_c, heading, object.bearing_deg, object.radius_deg, temp);
+        }
+        if (lit)
+        {
+            render_disc (temps, room.ambient_c, heading, fire_deg, room.fire_radius_deg, room.fire_c);
+            if (in_view_s < 0.0f && fabsf (wrap_deg (fire_deg - heading)) <= HALF_FOV_DEG)
+            {
+                in_view_s = now_s;
+            }
+        }
+
+        int16_t pixels[64];
+        for (uint8_t pixel = 0; pixel < 64; pixel++)
+        {
+            float temp = temps[pixel] + noise (rng);
+            temp = temp < -20.0f ? -20.0f : (temp > 80.0f ? 80.0f : temp);
+            pixels[pixel] = (int16_t)lroundf (temp * 4.0f);
+        }
+
+        // Both detectors, exactly as task_Thermal_Sensor runs them
+        hotspot_result hotspot;
+        hotspot_find (pixels, THRESHOLD, &hotspot);
+        uint8_t sector = BackgroundModel::sector_of (estimate);
+        uint64_t mask = p_model->update (pixels, sector);
+        bool absolute = hotspot.hot_pixels > 0;
+        bool learned = p_model->is_warm (sector) ? mask != 0 : hotspot.hot_pixels > 0;
+
+        if (!lit && now_s < WARMUP_S)
+        {
+            p_absolute->warmup_alarms += absolute && !was_absolute;
+            p_learned->warmup_alarms += learned && !was_learned;
+        }
+        else if (!lit)
+        {
+            p_absolute->false_alarms += absolute && !was_absolute;
+            p_learned->false_alarms += learned && !was_learned;
+        }
+        else if (in_view_s >= 0.0f)
+        {
+            if (absolute && !found_absolute)
+            {
+                found_absolute = true;
+                p_absolute->detected++;
+                p_absolute->latencies_ms.push_back ((now_s - in_view_s) * 1000.0f);
+            }
+            if (learned && !found_learned)
+            {
+                found_learned = true;
+                p_learned->detected++;
+                p_learned->latencies_ms.push_back ((now_s - in_view_s) * 1000.0f);
+            }
+        }
+        was_absolute = absolute;
+        was_learned = learned;
+    }
+    delete p_model;
+}
+
+
+/** @brief   Prints one detector's line of the results table.
+ */
+static void print_tally (const char* mode, const tally& result, uint32_t trials, float quiet_minutes)
+{
+    float mean = 0.0f;
+    float worst = 0.0f;
+    for (float latency : result.latencies_ms)
+    {
+        mean += latency;
+        worst = latency > worst ? latency : worst;
+    }
+    if (!result.latencies_ms.empty ())
+    {
+        mean /= result.latencies_ms.size ();
+    }
+    printf ("  %-10s %10.2f %10.2f %9u/%-4u", mode, (float)result.warmup_alarms / trials,
+            result.false_alarms / quiet_minutes, result.detected, trials);
+    if (result.detected)
+    {
+        printf (" %10.0f %10.0f\n", mean, worst);
+    }
+    else
+    {
+        printf (" %10s %10s\n", "-", "-");
+    }
+}
+
+
+/** @brief   Times one background model update, to show it is constant per frame.
+ */
+static double time_update (void)
+{
+    BackgroundModel* p_model = new BackgroundModel;
+    int16_t pixels[64];
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        pixels[pixel] = (int16_t)(88 + pixel % 5);
+    }
+    const uint32_t updates = 200000;
+    volatile uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now ();
+    for (uint32_t update = 0; update < updates; update++)
+    {
+        pixels[update & 63] ^= 1;
+        sink = sink + p_model->update (pixels, (uint8_t)(update % BACKGROUND_SECTORS));
+    }
+    auto end = std::chrono::steady_clock::now ();
+    delete p_model;
+    return std::chrono::duration<double, std::nano> (end - start).count () / updates;
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t trials = 200;
+    uint32_t seed = 1;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp (argv[arg], "--trials") && arg + 1 < argc)
+        {
+            trials = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--seed") && arg + 1 < argc)
+        {
+            seed = (uint32_t)strtoul (argv[++arg], NULL, 0);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--trials N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const scene rooms[] =
+    {
+        { "room at 22 C, 250 C fire", 22.0f, { }, 250.0f, 4.0f },
+        { "sun-warmed wall and radiator, 250 C fire", 24.0f,
+          { { 120.0f, 25.0f, 64.0f, 70.0f }, { 250.0f, 6.0f, 63.0f, 63.0f } }, 250.0f, 4.0f },
+        { "cold room at 4 C, small 300 C fire", 4.0f, { }, 300.0f, 1.5f },
+    };
+
+    std::mt19937 rng (seed);
+    std::uniform_real_distribution<float> uniform (0.0f, 1.0f);
+    const float LENGTH_S = 120.0f;
+
+    printf ("%u trials per scene, %.0f s each\n", trials, LENGTH_S);
+    for (const scene& room : rooms)
+    {
+        tally absolute, learned;
+        float quiet_s_total = 0.0f;
+        for (uint32_t trial = 0; trial < trials; trial++)
+        {
+            float quiet_s = 60.0f + 30.0f * uniform (rng);
+            float fire_deg = 360.0f * uniform (rng);
+            float rate_error = 0.99f + 0.02f * uniform (rng);
+            quiet_s_total += quiet_s - WARMUP_S;
+            run_trial (room, rng, quiet_s, fire_deg, rate_error, LENGTH_S, &absolute, &learned);
+        }
+
+        printf ("\n%s\n", room.name);
+        printf ("  %-10s %10s %10s %14s %10s %10s\n", "detector", "warm-up", "false/min",
+                "fires found", "mean ms", "max ms");
+        print_tally ("absolute", absolute, trials, quiet_s_total / 60.0f);
+        print_tally ("background", learned, trials, quiet_s_total / 60.0f);
+    }
+
+    printf ("\nBackgroundModel::update: %.1f ns/frame, %u bytes\n", time_update (),
+            (unsigned)sizeof (BackgroundModel));
+    return 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Fire-reaction benchmark of the dual-core ESP32 mode (see task_table.h)
+# against all the tasks on one core, with and without a synthetic 30 ms of
+# extra processor time in the thermal task on every frame. Each run injects
+# a fire in front of the camera at a random point in the frame clock. For
+# each milestone the mean time is given with its jitter, the spread from the
+# earliest to the latest over the runs:
+#
+#   detect     injection to the turntable stopping for the fire
+#   aim        the turntable stopping to it being aimed
+#   resume     injection to the turntable scanning again after the spray
+#
+#   sim/bench_dual_core.sh BUILD_DIR [RUNS]
+#
+# BUILD_DIR holds firebot_sim, firebot_sim_dual_core, firebot_sim_loaded and
+# firebot_sim_dual_core_loaded.
+
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "usage: $0 BUILD_DIR [RUNS]" >&2
+    exit 2
+fi
+BUILD=$1
+RUNS=${2:-60}
+
+printf "%-8s %-6s %10s %10s %10s %10s %10s %10s\n" "load" "cores" \
+       "detect ms" "jitter" "aim ms" "jitter" "resume ms" "jitter"
+for load in none 30ms; do
+    for cores in 1 2; do
+        program=firebot_sim
+        [ $cores = 2 ] && program=${program}_dual_core
+        [ $load = 30ms ] && program=${program}_loaded
+        "$BUILD/$program" --runs "$RUNS" |
+            awk -v load=$load -v cores=$cores '
+                $1 == "motor1.drive(0)"  { detect = sprintf ("%10.1f %10.1f", $3, $4 - $2) }
+                $1 == "stop"             { aim = sprintf ("%10.1f %10.1f", $5, $6 - $4) }
+                $1 == "turntable" && $2 == "resume" { resume = sprintf ("%10.1f %10.1f", $4, $5 - $3) }
+                END { printf "%-8s %-6s %s %s %s\n", load, cores, detect, aim, resume }'
+    done
+done
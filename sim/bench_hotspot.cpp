@@ -0,0 +1,235 @@
+/** @file bench_hotspot.cpp
+ *  Microbenchmark and check of the hotspot detector in hotspot.cpp. It makes
+ *  a set of seeded random frames like the ones the camera produces, with a
+ *  few warm blobs of random size on a noisy room-temperature background plus
+ *  some hand-made corner cases, checks that hotspot_find() gives exactly the
+ *  same result as hotspot_find_reference() for every one of them, and then
+ *  times both over many passes through the set.
+ *
+ *  Usage: hotspot_bench [--frames N] [--passes P] [--seed S]
+ *
+ *  The program exits with status 1 if any result differs from the reference.
+ *  Build hotspot_bench_portable to time the plain C version instead of the
+ *  SIMD one on the same frames.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#if defined __x86_64__ || defined __i386__
+    #include <x86intrin.h>
+#endif
+
+#include "hotspot.h"
+
+/// Detection threshold used by the firmware, 60 degrees C in 0.25 degree counts
+const int16_t THRESHOLD = 60 * 4;
+
+
+/** @brief   Reads the CPU's cycle counter where there is one, for cycles per frame.
+ */
+static inline uint64_t cycles (void)
+{
+#if defined __x86_64__ || defined __i386__
+    return __rdtsc ();
+#else
+    return 0;
+#endif
+}
+
+
+/** @brief   Fills a frame with a noisy background and up to four warm blobs.
+ */
+static void make_frame (std::mt19937& rng, int16_t* pixels)
+{
+    std::uniform_real_distribution<float> uniform (0.0f, 1.0f);
+    std::normal_distribution<float> noise (0.0f, 0.6f);
+
+    float background = 15.0f + 20.0f * uniform (rng);
+    uint8_t blobs = (uint8_t)(rng () % 5);
+    float centre_x[4], centre_y[4], peak[4], width[4];
+    for (uint8_t blob = 0; blob < blobs; blob++)
+    {
+        centre_x[blob] = 8.0f * uniform (rng) - 0.5f;
+        centre_y[blob] = 8.0f * uniform (rng) - 0.5f;
+        peak[blob] = 20.0f + 60.0f * uniform (rng);
+        width[blob] = 0.4f + 1.5f * uniform (rng);
+    }
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            float temp = background + noise (rng);
+            for (uint8_t blob = 0; blob < blobs; blob++)
+            {
+                float dx = col - centre_x[blob];
+                float dy = row - centre_y[blob];
+                temp += peak[blob] * expf (-(dx * dx + dy * dy) / (2.0f * width[blob] * width[blob]));
+            }
+            // Clamp to the camera's -20 to 80 degree C range
+            temp = temp < -20.0f ? -20.0f : (temp > 80.0f ? 80.0f : temp);
+            pixels[row * 8 + col] = (int16_t)lroundf (temp * 4.0f);
+        }
+    }
+}
+
+
+/** @brief   Adds frames which stress the edges: empty, full, ties, checkerboards and wrap-around.
+ */
+static void add_corner_cases (std::vector<int16_t>& frames)
+{
+    int16_t frame[64];
+    auto add = [&] (void) { frames.insert (frames.end (), frame, frame + 64); };
+
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = 80;
+    add ();                                                     // Nothing hot
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = 320;
+    add ();                                                     // Everything hot, all tied
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = THRESHOLD;
+    add ();                                                     // Exactly at the threshold
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = ((pixel / 8 + pixel) & 1) ? 300 : 100;
+    add ();                                                     // Checkerboard, one blob by diagonals
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = (pixel % 8 == 0 || pixel % 8 == 7) ? 300 : -80;
+    add ();                                                     // Left and right columns must not join
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = (pixel % 2 == 0 && (pixel / 8) % 2 == 0) ? 250 : 0;
+    add ();                                                     // Sixteen separate single pixels
+    for (uint8_t pixel = 0; pixel < 64; pixel++) frame[pixel] = -80;
+    frame[63] = 320;
+    frame[7] = 320;
+    add ();                                                     // Tie between far corners
+}
+
+
+/** @brief   Prints both results when the fast detector disagrees with the reference.
+ */
+static void print_mismatch (size_t index, const hotspot_result& fast, const hotspot_result& reference)
+{
+    const hotspot_result* both[2] = { &fast, &reference };
+    printf ("Frame %zu differs from the reference:\n", index);
+    for (uint8_t which = 0; which < 2; which++)
+    {
+        const hotspot_result& r = *both[which];
+        printf ("  %-9s mask %016llx max %d at %u, %u hot, %u blobs, centroid (%u, %u)/256\n",
+                which ? "reference" : "fast", (unsigned long long)r.hot_mask, r.max_temp, r.max_pixel,
+                r.hot_pixels, r.blobs, r.centroid_col, r.centroid_row);
+    }
+}
+
+
+/** @brief   Times one version of the detector over every frame, several passes.
+ *  @return  Nanoseconds per frame; cycles per frame go in @c p_cycles
+ */
+static double time_detector (void (*detector)(const int16_t*, int16_t, hotspot_result*),
+                             const std::vector<int16_t>& frames, uint32_t passes, double* p_cycles)
+{
+    size_t count = frames.size () / 64;
+    std::vector<hotspot_result> results (count);
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now ();
+    uint64_t start_cycles = cycles ();
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        for (size_t index = 0; index < count; index++)
+        {
+            detector (&frames[index * 64], THRESHOLD, &results[index]);
+        }
+        sink = sink + results[pass % count].blobs;
+    }
+    uint64_t end_cycles = cycles ();
+    auto end = std::chrono::steady_clock::now ();
+
+    double total = (double)count * passes;
+    *p_cycles = (end_cycles - start_cycles) / total;
+    return std::chrono::duration<double, std::nano> (end - start).count () / total;
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t num_frames = 4096;
+    uint32_t passes = 200;
+    uint32_t seed = 1;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp (argv[arg], "--frames") && arg + 1 < argc)
+        {
+            num_frames = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--passes") && arg + 1 < argc)
+        {
+            passes = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--seed") && arg + 1 < argc)
+        {
+            seed = (uint32_t)strtoul (argv[++arg], NULL, 0);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--frames N] [--passes P] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng (seed);
+    std::vector<int16_t> frames;
+    add_corner_cases (frames);
+    while (frames.size () / 64 < num_frames)
+    {
+        int16_t frame[64];
+        make_frame (rng, frame);
+        frames.insert (frames.end (), frame, frame + 64);
+    }
+    size_t count = frames.size () / 64;
+
+    // Every field of every result must match the reference exactly
+    uint32_t mismatches = 0;
+    uint32_t with_fire = 0;
+    for (size_t index = 0; index < count; index++)
+    {
+        hotspot_result fast, reference;
+        hotspot_find (&frames[index * 64], THRESHOLD, &fast);
+        hotspot_find_reference (&frames[index * 64], THRESHOLD, &reference);
+        with_fire += reference.hot_pixels > 0;
+        if (fast.hot_mask != reference.hot_mask || fast.max_temp != reference.max_temp
+            || fast.max_pixel != reference.max_pixel || fast.hot_pixels != reference.hot_pixels
+            || fast.blobs != reference.blobs || fast.centroid_col != reference.centroid_col
+            || fast.centroid_row != reference.centroid_row)
+        {
+            if (mismatches++ < 5)
+            {
+                print_mismatch (index, fast, reference);
+            }
+        }
+    }
+
+#if defined HOTSPOT_PORTABLE
+    const char* version = "portable C";
+#elif defined __ARM_FEATURE_DSP
+    const char* version = "Cortex-M DSP";
+#elif defined __SSE2__
+    const char* version = "SSE2";
+#else
+    const char* version = "portable C";
+#endif
+    printf ("Checked %zu frames (%u with hot pixels) against the reference: %u mismatches\n",
+            count, with_fire, mismatches);
+
+    double fast_cycles, reference_cycles;
+    double fast_ns = time_detector (hotspot_find, frames, passes, &fast_cycles);
+    double reference_ns = time_detector (hotspot_find_reference, frames, passes, &reference_cycles);
+    printf ("hotspot_find (%s): %7.1f ns/frame %7.1f cycles/frame\n", version, fast_ns, fast_cycles);
+    printf ("hotspot_find_reference:   %7.1f ns/frame %7.1f cycles/frame\n", reference_ns, reference_cycles);
+    printf ("Speedup: %.2fx\n", reference_ns / fast_ns);
+
+    return mismatches ? 1 : 0;
+}
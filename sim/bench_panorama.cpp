@@ -0,0 +1,209 @@
+/** @file bench_panorama.cpp
+ *  Replay benchmark of the 360 degree thermal map in panorama.cpp. For each
+ *  trial it renders the frames the camera would see from the turning
+ *  turntable, 10 per second, with a warm object at a random bearing, and
+ *  blends them into a map exactly as task_Thermal_Sensor does. After the
+ *  first revolution it checks how far the map's hottest bearing is from the
+ *  object; during the second a second object is lit somewhere else, and at
+ *  its end it checks that the changed cells are the ones around the new
+ *  object, or around the old one where the estimated heading has drifted. It also times update(), hottest() and the change query.
+ *
+ *  Usage: panorama_bench [--trials N] [--seed S]
+ *
+ *  The turntable's real rate differs from the firmware's estimate by up to
+ *  one percent per trial, as in bench_background.cpp.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+
+#include <Arduino.h>
+#include "panorama.h"
+#include "task_Rotation_Base.h"
+
+/// Angular size of one camera pixel
+const float PIXEL_DEG = 7.5f;
+/// Time between frames
+const float FRAME_S = 0.1f;
+/// Temperature of the room
+const float AMBIENT_C = 22.0f;
+
+
+/** @brief   Wraps an angle into -180 to 180 degrees.
+ */
+static float wrap_deg (float angle)
+{
+    angle = fmodf (angle + 180.0f, 360.0f);
+    return (angle < 0.0f ? angle + 360.0f : angle) - 180.0f;
+}
+
+
+/** @brief   Renders one frame with warm discs of 4 degrees radius, as bench_background.cpp does.
+ */
+static void render (int16_t* pixels, std::mt19937& rng, float heading_deg,
+                    const float* bearings, const float* temps, uint8_t objects)
+{
+    std::normal_distribution<float> noise (0.0f, 0.15f);
+    const float sigma = 4.0f * 0.70710678f;
+    const float scale = 1.0f / (sigma * 1.41421356f);
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        float el_top = (4 - row) * PIXEL_DEG;
+        float mass_y = 0.5f * (erff (el_top * scale) - erff ((el_top - PIXEL_DEG) * scale));
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            float temp = AMBIENT_C;
+            for (uint8_t object = 0; object < objects; object++)
+            {
+                float dx = wrap_deg (bearings[object] - heading_deg);
+                float az_left = (col - 4) * PIXEL_DEG;
+                float mass = 0.5f * (erff ((az_left + PIXEL_DEG - dx) * scale) - erff ((az_left - dx) * scale)) * mass_y;
+                float fill = mass * 6.2831853f * sigma * sigma / (PIXEL_DEG * PIXEL_DEG);
+                temp += (temps[object] - AMBIENT_C) * (fill < 1.0f ? fill : 1.0f);
+            }
+            temp += noise (rng);
+            temp = temp < -20.0f ? -20.0f : (temp > 80.0f ? 80.0f : temp);
+            pixels[row * 8 + col] = (int16_t)lroundf (temp * 4.0f);
+        }
+    }
+}
+
+
+/** @brief   Times one call of a map operation, averaged over many calls.
+ */
+template <typename Operation>
+static double time_ns (Operation operation, uint32_t calls)
+{
+    auto start = std::chrono::steady_clock::now ();
+    for (uint32_t call = 0; call < calls; call++)
+    {
+        operation (call);
+    }
+    auto end = std::chrono::steady_clock::now ();
+    return std::chrono::duration<double, std::nano> (end - start).count () / calls;
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t trials = 200;
+    uint32_t seed = 1;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp (argv[arg], "--trials") && arg + 1 < argc)
+        {
+            trials = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--seed") && arg + 1 < argc)
+        {
+            seed = (uint32_t)strtoul (argv[++arg], NULL, 0);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--trials N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng (seed);
+    std::uniform_real_distribution<float> uniform (0.0f, 1.0f);
+    float error_total = 0.0f;
+    float error_worst = 0.0f;
+    uint32_t changes_new = 0;
+    uint32_t changes_drift = 0;
+    uint32_t changes_elsewhere = 0;
+    uint32_t missed = 0;
+
+    for (uint32_t trial = 0; trial < trials; trial++)
+    {
+        Panorama* p_map = new Panorama;
+        float bearings[2] = { 360.0f * uniform (rng), 0.0f };
+        float temps[2] = { 60.0f, 50.0f };
+        bearings[1] = fmodf (bearings[0] + 90.0f + 180.0f * uniform (rng), 360.0f);
+        float rate_error = 0.99f + 0.02f * uniform (rng);
+        float period_s = 360.0f / TURNTABLE_DEG_PER_S;
+
+        // One turn with only the first object, then one with both; the map
+        //     counts a revolution when the estimated heading passes zero
+        uint32_t frames = (uint32_t)(2.0f * period_s / FRAME_S);
+        for (uint32_t frame = 0; frame <= frames; frame++)
+        {
+            float now_s = frame * FRAME_S;
+            float heading = fmodf (TURNTABLE_DEG_PER_S * rate_error * now_s, 360.0f);
+            float estimate = fmodf (TURNTABLE_DEG_PER_S * now_s, 360.0f);
+            int16_t pixels[64];
+            render (pixels, rng, heading, bearings, temps, now_s >= period_s ? 2 : 1);
+            p_map->update (pixels, estimate);
+
+            if (frame + 1 == (uint32_t)(period_s / FRAME_S))
+            {
+                float found;
+                p_map->hottest (&found);
+                float error = fabsf (wrap_deg (found - bearings[0]));
+                error_total += error;
+                error_worst = error > error_worst ? error : error_worst;
+            }
+        }
+
+        // Every changed cell should be within two pixels of the new
+        //     object, or of the old one, which moves by the heading's drift
+        panorama_change changes[PANORAMA_COLUMNS * PANORAMA_ROWS];
+        uint16_t count = p_map->changed_since_last_revolution (changes, PANORAMA_COLUMNS * PANORAMA_ROWS);
+        missed += count == 0;
+        for (uint16_t change = 0; change < count; change++)
+        {
+            float bearing = (changes[change].column + 0.5f) * PANORAMA_DEG_PER_COLUMN;
+            if (fabsf (wrap_deg (bearing - bearings[1])) <= 2.0f * PIXEL_DEG)
+            {
+                changes_new++;
+            }
+            else if (fabsf (wrap_deg (bearing - bearings[0])) <= 2.0f * PIXEL_DEG)
+            {
+                changes_drift++;
+            }
+            else
+            {
+                changes_elsewhere++;
+            }
+        }
+        delete p_map;
+    }
+
+    printf ("%u trials, %u x %u map, %.2f deg per column\n", trials, PANORAMA_COLUMNS, PANORAMA_ROWS,
+            PANORAMA_DEG_PER_COLUMN);
+    printf ("%-28s %8.2f deg mean %8.2f deg max\n", "hottest bearing error", error_total / trials, error_worst);
+    printf ("%-28s %8.1f per trial at the new object, %.1f at the old one, %u elsewhere, %u trials saw none\n",
+            "cells changed", (float)changes_new / trials, (float)changes_drift / trials, changes_elsewhere, missed);
+
+    // Timing on a map which has seen every column
+    Panorama* p_map = new Panorama;
+    int16_t pixels[64];
+    for (uint8_t pixel = 0; pixel < 64; pixel++)
+    {
+        pixels[pixel] = (int16_t)(88 + pixel % 5);
+    }
+    volatile int32_t sink = 0;
+    double update_ns = time_ns ([&] (uint32_t call)
+    {
+        pixels[call & 63] ^= 1;
+        p_map->update (pixels, (call % 1200) * 0.3f);
+    }, 200000);
+    double hottest_ns = time_ns ([&] (uint32_t) { sink = sink + p_map->hottest (); }, 200000);
+    double changed_ns = time_ns ([&] (uint32_t) { sink = sink + p_map->changed_since_last_revolution (NULL, 0); },
+                                 200000);
+    delete p_map;
+
+    printf ("%-28s %8.1f ns\n", "Panorama::update", update_ns);
+    printf ("%-28s %8.1f ns\n", "Panorama::hottest", hottest_ns);
+    printf ("%-28s %8.1f ns\n", "changed_since_last_revolution", changed_ns);
+    printf ("%-28s %8u bytes\n", "sizeof (Panorama)", (unsigned)sizeof (Panorama));
+    return error_worst > 2.0f * PIXEL_DEG || changes_elsewhere > 0 || missed > 0 ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Time-to-detect benchmark of the heat-guided scan (scan_scheduler.h)
+# against the original constant-speed scan. Each run injects one growing
+# fire at a random bearing once the backgrounds have been learned, and the
+# time to detect is from the injection to the turntable stopping for it.
+#
+#   sim/bench_scan.sh BUILD_DIR [RUNS]
+#
+# BUILD_DIR holds firebot_sim and firebot_sim_constant_scan. The fire heats
+# up from ambient toward 300 degrees C at each of the rates listed below.
+
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "usage: $0 BUILD_DIR [RUNS]" >&2
+    exit 2
+fi
+BUILD=$1
+RUNS=${2:-60}
+
+printf "%-14s %-22s %10s %10s %10s\n" "growth C/s" "scan" "min ms" "mean ms" "max ms"
+for growth in 0.5 1 3 10; do
+    for program in firebot_sim firebot_sim_constant_scan; do
+        name=heat-guided
+        [ $program = firebot_sim_constant_scan ] && name=constant
+        "$BUILD/$program" --runs "$RUNS" --inject-ms 30000 --offset-spread-deg 360 --temp-c 300 \
+                          --growth-c-per-s $growth --timeout-ms 90000 |
+            awk -v growth=$growth -v name=$name '
+                $1 == "motor1.drive(0)" {
+                    printf "%-14s %-22s %10.0f %10.0f %10.0f%s\n", growth, name, $2, $3, $4,
+                           (NF > 4 ? "  some not detected in 90 s" : "")
+                }'
+    done
+done
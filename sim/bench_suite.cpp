@@ -0,0 +1,774 @@
+/** @file bench_suite.cpp
+ *  Host benchmark suite of the firmware's hot paths, run by bench_suite.sh
+ *  to catch performance regressions. It times, in host nanoseconds:
+ *
+ *  - the detection each thermal frame goes through in task_Thermal_Sensor:
+ *    the hotspot detector, the sub-pixel locator, the background model, the
+ *    scan scheduler and the thermal map, on rendered frames from a turning
+ *    turntable;
+ *  - the primitives tasks hand data through: trace_write() and
+ *    capture_write(), the trace ring with its writer and reader on two host
+ *    threads, the frame ring, and the Share and Queue wrappers with two
+ *    producer tasks and one consumer contending for them in the simulated
+ *    kernel;
+ *  - a get() and a put() of a one-byte Share and of the AtomicShare which
+ *    the firmware's flags and FSM state are kept in (see atomic_share.h);
+ *  - coding and decoding each frame of the live frame stream (see
+ *    frame_stream.h), with the bytes a frame takes and a check that every
+ *    decoded pixel is within half a quantization step of the original;
+ *  - one step of the dispatcher's state machine, from an event posted by an
+ *    interrupt to the motor command it leads to, through the firmware
+ *    running on the simulated kernel.
+ *
+ *  Usage: firebot_bench [--scale N]
+ *
+ *  Each result is printed as one line @c metric,value,unit so that the
+ *  script can compare it with a baseline. @c --scale multiplies the number
+ *  of iterations. The detection, the stream and the primitives of one task
+ *  are each timed in many short blocks, of which the fastest is printed, the
+ *  one least slowed by whatever else the host was doing. Each time is printed again divided by the time of one
+ *  step of a calibration loop timed at the start of the same process, as
+ *  @c metric.loops, which comes out much the same on a fast host and a slow
+ *  one. The Share and Queue wrappers are the ones from the
+ *  original ME507 library; the firmware hands its data through the rings
+ *  and the dispatcher's event queue instead, so those two numbers are the
+ *  cost of a hand-off through the simulated kernel, where every blocking
+ *  call is a host context switch. They are an upper bound on the target.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include <Arduino.h>
+#include <taskshare.h>
+#include <taskqueue.h>
+#include "hotspot.h"
+#include "upsample.h"
+#include "background_model.h"
+#include "scan_scheduler.h"
+#include "panorama.h"
+#include "frame_ring.h"
+#include "trace.h"
+#include "capture.h"
+#include "task_Dispatcher.h"
+#include "task_Rotation_Base.h"
+#include "shares.h"
+#include "atomic_share.h"
+#include "frame_stream.h"
+#include "sim_kernel.h"
+#include "sim_world.h"
+
+void setup ();
+
+/// Absolute threshold of the hotspot detector, 60 degrees C in 0.25 degree counts
+const int16_t THRESHOLD = 60 * 4;
+
+/// Number of different frames the detection benchmark cycles through
+const uint16_t FRAMES = 512;
+
+/// PWM pins which identify the two motors in the motor observer
+const int MOTOR1_PWM = PA7;
+const int MOTOR2_PWM = PB3;
+
+/// Items each producer task hands to the consumer in the Share and Queue benchmarks
+const uint32_t HANDOFF_ITEMS = 20000;
+
+/// Time between the events of one trip round the dispatcher's states
+const uint64_t FSM_STEP_US = 1000;
+
+/// Time from one trip round the dispatcher's states to the next, which is the time between camera reads
+const uint64_t FSM_CYCLE_US = 50000;
+
+/// Time into each cycle of the first event, after the camera read which starts the cycle has finished
+const uint64_t FSM_FIRST_US = 20000;
+
+/// Time from power-up allowed for the firmware to boot and arm, with room to spare
+const uint64_t FSM_BOOT_US = 6000000;
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+/** @brief   Returns the nanoseconds since a time.
+ */
+static double ns_since (bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano> (bench_clock::now () - start).count ();
+}
+
+
+/** @brief   Keeps the fastest of several timings of the same work.
+ *  @details A short benchmark on a busy host is slowed by whatever else runs
+ *           while it is timed; the fastest of many short timings is the one
+ *           least slowed, and is what the calibration loop is held to.
+ */
+struct fastest_time
+{
+    bench_clock::time_point start;           ///< When the timing running now started
+    double ns = 0.0;                         ///< Fastest timing so far, zero before the first
+    bool timed = false;                      ///< Whether any timing has ended yet
+
+    void begin (void)
+    {
+        start = bench_clock::now ();
+    }
+
+    void end (void)
+    {
+        double elapsed_ns = ns_since (start);
+        ns = (!timed || elapsed_ns < ns) ? elapsed_ns : ns;
+        timed = true;
+    }
+};
+
+
+/// Calls to a primitive in one timing of it, of which the fastest is reported
+const uint32_t BENCH_BLOCK = 10000;
+
+/// Steps of the calibration loop in one timing of it
+const uint32_t CALIBRATE_STEPS = 1000000;
+
+/// Timings of the calibration loop, of which the fastest is taken
+const uint8_t CALIBRATE_ROUNDS = 20;
+
+/// Nanoseconds per step of the calibration loop, timed once before the benchmarks
+static double loop_ns;
+
+
+/** @brief   Times a fixed loop of dependent multiplies and adds, the fastest of several tries.
+ *  @details Every host timing is also reported divided by this, which takes
+ *           out most of the difference between a fast host and a slow one, so
+ *           that those results can be held to a tolerance.
+ *  @return  Nanoseconds per step of the loop
+ */
+static double calibrate (void)
+{
+    double best_ns = 0.0;
+    uint32_t x = 1;
+    for (uint8_t round = 0; round < CALIBRATE_ROUNDS; round++)
+    {
+        auto start = bench_clock::now ();
+        for (uint32_t step = 0; step < CALIBRATE_STEPS; step++)
+        {
+            x = x * 1664525u + 1013904223u;
+            asm volatile ("" : "+r" (x));
+        }
+        double ns = ns_since (start);
+        best_ns = (round == 0 || ns < best_ns) ? ns : best_ns;
+    }
+    if (x == 0x5A5A5A5A)
+    {
+        printf ("#\n");
+    }
+    return best_ns / CALIBRATE_STEPS;
+}
+
+
+/** @brief   Prints one result for the script.
+ *  @details A host timing in nanoseconds is printed a second time in steps of
+ *           the calibration loop, with the unit @c loops, which is what the
+ *           script holds to a tolerance.
+ */
+static void report (const char* p_metric, double value, const char* p_unit)
+{
+    printf ("%s,%.3f,%s\n", p_metric, value, p_unit);
+    if (strcmp (p_unit, "ns") == 0)
+    {
+        printf ("%s.loops,%.3f,loops\n", p_metric, value / loop_ns);
+    }
+    fflush (stdout);
+}
+
+
+// ----------------------------------------------------------------------------
+// Detection per frame
+
+/// A frame rendered for the detection benchmark and the heading it was seen from
+struct bench_frame
+{
+    thermal_frame frame;                     ///< Pixels, filled in as task_Thermal_Sensor does
+    float heading_deg;                       ///< Turntable heading
+};
+
+/// Frames from one turn of the turntable, in the order they are replayed
+static bench_frame frames[FRAMES];
+
+/// The detectors, kept apart from the firmware's own
+static BackgroundModel bench_background;
+static ScanScheduler bench_scheduler;
+static Panorama bench_panorama;
+
+/// Every camera in the layout is being read
+const uint8_t BENCH_CAMERAS = (1 << THERMAL_SENSORS) - 1;
+
+
+/** @brief   Renders one turn of the turntable past a room at 22 C with a warm radiator and a small fire.
+ */
+static void render_frames (uint32_t seed)
+{
+    std::mt19937 random (seed);
+    std::normal_distribution<float> noise (0.0f, 0.15f);
+    for (uint16_t index = 0; index < FRAMES; index++)
+    {
+        bench_frame& entry = frames[index];
+        entry.heading_deg = 360.0f * index / FRAMES;
+        for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+        {
+            // Bearing of this pixel's column, 60 degrees over 8 columns
+            float bearing = entry.heading_deg - 30.0f + FRAME_DEG_PER_PIXEL * ((pixel & 7) + 0.5f);
+            float temp_c = 22.0f + noise (random);
+            float radiator = fabsf (remainderf (bearing - 90.0f, 360.0f));
+            temp_c += radiator < 20.0f ? 18.0f : 0.0f;
+            float fire = fabsf (remainderf (bearing - 250.0f, 360.0f));
+            temp_c += fire < 8.0f && (pixel >> 3) >= 3 && (pixel >> 3) <= 5 ? 180.0f : 0.0f;
+            entry.frame.pixels[pixel] = (int16_t)lroundf (temp_c * 4.0f);
+        }
+        entry.frame.sequence = index + 1;
+        entry.frame.sensor = 0;
+    }
+}
+
+
+/** @brief   Times each stage of the detection run on every frame, then all of them together.
+ */
+static void bench_detection (uint32_t passes)
+{
+    render_frames (1);
+    uint32_t sum = 0;
+
+    fastest_time hotspot;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        hotspot.begin ();
+        for (bench_frame& entry : frames)
+        {
+            hotspot_find (entry.frame.pixels, THRESHOLD, &entry.frame.hotspot);
+            sum += entry.frame.hotspot.blobs;
+        }
+        hotspot.end ();
+    }
+    report ("detect.hotspot", hotspot.ns / FRAMES, "ns");
+
+    static int16_t upsampled[UPSAMPLE_PIXELS];
+    fastest_time upsample;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        upsample.begin ();
+        for (bench_frame& entry : frames)
+        {
+            upsample_frame (entry.frame.pixels, upsampled);
+            upsample_peak (upsampled, &entry.frame.peak);
+            sum += entry.frame.peak.col;
+        }
+        upsample.end ();
+    }
+    report ("detect.upsample", upsample.ns / FRAMES, "ns");
+
+    fastest_time background;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        background.begin ();
+        for (bench_frame& entry : frames)
+        {
+            entry.frame.sector = BackgroundModel::sector_of (entry.heading_deg);
+            entry.frame.background_mask = bench_background.update (entry.frame.pixels, entry.frame.sector);
+            sum += bench_background.is_warm (entry.frame.sector);
+        }
+        background.end ();
+    }
+    report ("detect.background", background.ns / FRAMES, "ns");
+
+    fastest_time scheduler;
+    uint32_t now_ms = 0;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        scheduler.begin ();
+        for (bench_frame& entry : frames)
+        {
+            sum += bench_scheduler.update (&entry.frame, entry.heading_deg, now_ms, BENCH_CAMERAS);
+            now_ms += 100;
+        }
+        scheduler.end ();
+    }
+    report ("detect.scan_scheduler", scheduler.ns / FRAMES, "ns");
+
+    fastest_time panorama;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        panorama.begin ();
+        for (bench_frame& entry : frames)
+        {
+            bench_panorama.update (entry.frame.pixels, entry.heading_deg);
+        }
+        panorama.end ();
+    }
+    report ("detect.panorama", panorama.ns / FRAMES, "ns");
+
+    // Everything task_Thermal_Sensor does with a frame while scanning
+    fastest_time frame_time;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        frame_time.begin ();
+        for (bench_frame& entry : frames)
+        {
+            thermal_frame& frame = entry.frame;
+            hotspot_find (frame.pixels, THRESHOLD, &frame.hotspot);
+            upsample_frame (frame.pixels, upsampled);
+            upsample_peak (upsampled, &frame.peak);
+            frame.sector = BackgroundModel::sector_of (entry.heading_deg);
+            sum += bench_scheduler.update (&frame, entry.heading_deg, now_ms, BENCH_CAMERAS);
+            frame.background_mask = bench_background.update (frame.pixels, frame.sector,
+                                                             !bench_scheduler.is_interested ());
+            bench_panorama.update (frame.pixels, entry.heading_deg);
+            sum += bench_background.is_warm (frame.sector) ? frame.background_mask != 0 : frame.hotspot.hot_pixels > 0;
+            now_ms += 100;
+        }
+        frame_time.end ();
+    }
+    report ("detect.frame", frame_time.ns / FRAMES, "ns");
+
+    // Keep the results alive so the compiler can't leave the work out
+    if (sum == 0x5A5A5A5A)
+    {
+        printf ("#\n");
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// Primitives
+
+/** @brief   Times trace_write() and capture_write() into rings with room, emptied untimed between runs.
+ */
+static void bench_rings (uint32_t records)
+{
+    trace_begin ();
+    trace_ring& ring = trace_rings[TRACE_THERMAL];
+    fastest_time write;
+    for (uint32_t done = 0; done < records; done += TRACE_RING_SIZE)
+    {
+        write.begin ();
+        for (uint16_t count = 0; count < TRACE_RING_SIZE; count++)
+        {
+            trace_write (TRACE_THERMAL, TRACE_FRAME, 0, count);
+        }
+        write.end ();
+        __atomic_store_n (&ring.tail, __atomic_load_n (&ring.head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    }
+    report ("prim.trace_write", write.ns / TRACE_RING_SIZE, "ns");
+
+    // Only a running capture writes, so start one into a port that throws it away
+    int16_t pixels[FRAME_PIXELS] = { 0 };
+    capturing.put (true);
+    fastest_time capture;
+    for (uint32_t done = 0; done < records / 8; done += CAPTURE_RING_SIZE)
+    {
+        capture.begin ();
+        for (uint16_t count = 0; count < CAPTURE_RING_SIZE; count++)
+        {
+            capture_frame (0, pixels);
+        }
+        capture.end ();
+        __atomic_store_n (&capture_frames.tail, __atomic_load_n (&capture_frames.head, __ATOMIC_ACQUIRE),
+                          __ATOMIC_RELEASE);
+    }
+    capturing.put (false);
+    report ("prim.capture_frame", capture.ns / CAPTURE_RING_SIZE, "ns");
+
+    // The frame ring, written and read by one task in turn
+    static FrameRing ring_bench ("bench");
+    uint32_t sequence = 0;
+    fastest_time frame_ring;
+    for (uint32_t done = 0; done < records; done += BENCH_BLOCK)
+    {
+        frame_ring.begin ();
+        for (uint32_t count = 0; count < BENCH_BLOCK; count++)
+        {
+            thermal_frame* p_frame = ring_bench.begin_write ();
+            ring_bench.publish (p_frame, 12780);
+            const thermal_frame* p_read = ring_bench.acquire (sequence);
+            sequence = p_read->sequence;
+            ring_bench.release (p_read);
+        }
+        frame_ring.end ();
+    }
+    report ("prim.frame_ring", frame_ring.ns / BENCH_BLOCK, "ns");
+}
+
+
+/** @brief   Times records through one trace ring with its writer and reader on separate host threads.
+ *  @details The writer waits for room rather than dropping, so this is the
+ *           rate at which records get through a ring which both sides are
+ *           working on, the cache line of its indices going back and forth.
+ *           Each side gives up its time slice while it waits, so that on a host
+ *           with one core the other side gets to run.
+ */
+static void bench_ring_threads (uint32_t records)
+{
+    trace_begin ();
+    trace_ring& ring = trace_rings[TRACE_ROTATION];
+    std::atomic<uint32_t> errors (0);
+
+    auto start = bench_clock::now ();
+    std::thread reader ([&ring, &errors, records] ()
+    {
+        uint16_t expected = 0;
+        uint32_t received = 0;
+        while (received < records)
+        {
+            uint16_t head = __atomic_load_n (&ring.head, __ATOMIC_ACQUIRE);
+            uint16_t tail = ring.tail;
+            if (tail == head)
+            {
+                std::this_thread::yield ();
+            }
+            while (tail != head)
+            {
+                errors += ring.records[tail & (TRACE_RING_SIZE - 1)].value != expected++;
+                tail++;
+                received++;
+            }
+            __atomic_store_n (&ring.tail, tail, __ATOMIC_RELEASE);
+        }
+    });
+    for (uint32_t count = 0; count < records; count++)
+    {
+        while ((uint16_t)(ring.head - __atomic_load_n (&ring.tail, __ATOMIC_ACQUIRE)) >= TRACE_RING_SIZE)
+        {
+            std::this_thread::yield ();
+        }
+        trace_write (TRACE_ROTATION, TRACE_MOTOR, 1, (uint16_t)count);
+    }
+    reader.join ();
+    report ("prim.trace_ring_threads", ns_since (start) / records, "ns");
+    report ("prim.trace_ring_errors", errors, "count");
+}
+
+
+/** @brief   Times get() and put() of a one-byte Share and AtomicShare, outside any task.
+ *  @details The Share's calls go through the simulated kernel's queue, as they
+ *           go through the kernel's on the target; atomic_share_bench() gives
+ *           the same figures in cycles on the target.
+ */
+static void bench_shares (uint32_t accesses)
+{
+    static Share<uint8_t> share ("bench");
+    AtomicShare<uint8_t> atomic ("bench");
+    volatile uint8_t sink = 0;
+    fastest_time share_put, share_get, atomic_put, atomic_get;
+
+    for (uint32_t done = 0; done < accesses; done += BENCH_BLOCK)
+    {
+        share_put.begin ();
+        for (uint32_t count = 0; count < BENCH_BLOCK; count++)
+        {
+            share.put ((uint8_t)count);
+        }
+        share_put.end ();
+        share_get.begin ();
+        for (uint32_t count = 0; count < BENCH_BLOCK; count++)
+        {
+            sink = share.get ();
+        }
+        share_get.end ();
+
+        atomic_put.begin ();
+        for (uint32_t count = 0; count < BENCH_BLOCK; count++)
+        {
+            atomic.put ((uint8_t)count);
+        }
+        atomic_put.end ();
+        atomic_get.begin ();
+        for (uint32_t count = 0; count < BENCH_BLOCK; count++)
+        {
+            sink = atomic.get ();
+        }
+        atomic_get.end ();
+    }
+    report ("prim.share_put", share_put.ns / BENCH_BLOCK, "ns");
+    report ("prim.share_get", share_get.ns / BENCH_BLOCK, "ns");
+    report ("prim.atomic_share_put", atomic_put.ns / BENCH_BLOCK, "ns");
+    report ("prim.atomic_share_get", atomic_get.ns / BENCH_BLOCK, "ns");
+    (void)sink;
+}
+
+
+/** @brief   Times coding and decoding the frames of one turn of the turntable for the live stream.
+ *  @details The frames are coded one after another as task_Thermal_Sensor codes
+ *           them, a keyframe every FRAME_STREAM_KEY_INTERVAL frames, and decoded
+ *           as the receiver decodes them; a turning turntable is the hardest
+ *           case for the coder, as every frame differs from the last one.
+ */
+static void bench_stream (uint32_t passes)
+{
+    render_frames (1);
+    static uint8_t packets[FRAMES][FRAME_STREAM_MAX_PACKET];
+    static int16_t reference[FRAME_PIXELS];
+    size_t bytes = 0;
+
+    fastest_time encode;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        encode.begin ();
+        bytes = 0;
+        for (uint16_t index = 0; index < FRAMES; index++)
+        {
+            bytes += frame_stream_encode ((uint8_t)index, 0, index % FRAME_STREAM_KEY_INTERVAL == 0,
+                                          frames[index].frame.pixels, reference, index, packets[index]);
+        }
+        encode.end ();
+    }
+    report ("stream.encode", encode.ns / FRAMES, "ns");
+    report ("stream.bytes_per_frame", (double)bytes / FRAMES, "bytes");
+
+    // Decode, checking each packet, then each pixel against the frame it came from
+    uint32_t errors = 0;
+    frame_stream_frame frame;
+    fastest_time decode;
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        decode.begin ();
+        for (uint16_t index = 0; index < FRAMES; index++)
+        {
+            errors += frame_stream_check (packets[index], FRAME_STREAM_MAX_PACKET) == 0;
+            errors += !frame_stream_decode (packets[index], index ? frame.pixels : NULL, &frame);
+        }
+        decode.end ();
+    }
+    report ("stream.decode", decode.ns / FRAMES, "ns");
+    for (uint16_t index = 0; index < FRAMES; index++)
+    {
+        frame_stream_decode (packets[index], index ? frame.pixels : NULL, &frame);
+        for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+        {
+            int16_t error = frame.pixels[pixel] - frames[index].frame.pixels[pixel];
+            errors += error < -(1 << FRAME_STREAM_SHIFT) / 2 || error > (1 << FRAME_STREAM_SHIFT) / 2;
+        }
+    }
+    report ("stream.errors", errors, "count");
+}
+
+
+/// The hand-offs the producer and consumer tasks contend for
+static Share<uint32_t>* p_share;
+static Queue<uint32_t>* p_queue;
+
+/// Items the consumer has taken, and a checksum of them
+static uint32_t consumed;
+static uint32_t consumed_sum;
+
+
+/** @brief   Producer task: puts HANDOFF_ITEMS items into the queue or share, then ends.
+ */
+static void task_producer (void* p_params)
+{
+    bool use_queue = p_params != NULL;
+    for (uint32_t item = 1; item <= HANDOFF_ITEMS; item++)
+    {
+        if (use_queue)
+        {
+            p_queue->put (item);
+        }
+        else
+        {
+            p_share->put (item);
+            taskYIELD ();
+        }
+    }
+    vTaskDelete (NULL);
+}
+
+
+/** @brief   Consumer task: takes items until both producers are done, then ends.
+ *  @details From the queue every item is taken. A share holds only the latest
+ *           item, so the consumer reads it once each time it gets to run.
+ */
+static void task_consumer (void* p_params)
+{
+    bool use_queue = p_params != NULL;
+    uint32_t wanted = 2 * HANDOFF_ITEMS;
+    while (consumed < wanted)
+    {
+        consumed_sum += use_queue ? p_queue->get () : p_share->get ();
+        consumed++;
+        if (!use_queue)
+        {
+            taskYIELD ();
+        }
+    }
+    vTaskDelete (NULL);
+}
+
+
+/** @brief   Times items handed from two producer tasks to one consumer through a Queue or a Share.
+ *  @details Through the queue the consumer has the highest priority, so each
+ *           item wakes it; the producers share a priority and take turns.
+ *           Through the share, which never blocks, all three share a priority
+ *           and yield to each other after every item.
+ */
+static void bench_handoff (bool use_queue)
+{
+    Share<uint32_t> share ("bench");
+    Queue<uint32_t> queue (8, "bench");
+    p_share = &share;
+    p_queue = &queue;
+    consumed = 0;
+    consumed_sum = 0;
+    if (!use_queue)
+    {
+        share.put (0);
+    }
+    uint32_t switches = sim_context_switches ();
+    void* p_mode = use_queue ? (void*)1 : NULL;
+
+    auto start = bench_clock::now ();
+    xTaskCreate (task_consumer, "Consumer", 1000, p_mode, use_queue ? 3 : 2, NULL);
+    xTaskCreate (task_producer, "Producer1", 1000, p_mode, 2, NULL);
+    xTaskCreate (task_producer, "Producer2", 1000, p_mode, 2, NULL);
+    sim_run_for_us (1000);
+    double ns = ns_since (start);
+
+    const char* p_name = use_queue ? "prim.queue_handoff" : "prim.share_handoff";
+    char metric[48];
+    report (p_name, ns / consumed, "ns");
+    snprintf (metric, sizeof (metric), "%s_switches", p_name);
+    report (metric, (double)(sim_context_switches () - switches) / consumed, "count");
+}
+
+
+// ----------------------------------------------------------------------------
+// State machine step
+
+/// When the event being timed was posted, in virtual and host time; zero when none is waiting
+static uint64_t post_us;
+static bench_clock::time_point post_time;
+
+/// Host time of each step of the state machine, and the steps which got no motor command
+static double fsm_ns;
+static uint32_t fsm_steps;
+static uint32_t fsm_missed;
+
+
+/** @brief   Posts an event to the dispatcher from an interrupt and starts timing the step.
+ */
+static void post_event (firebot_event event)
+{
+    if (post_us != 0)
+    {
+        fsm_missed++;
+    }
+    post_us = sim_now_us ();
+    post_time = bench_clock::now ();
+    firebot_post_from_ISR (event);
+}
+
+
+/** @brief   Puts a fire in front of the nozzle into the fire queue, as a frame showing it would.
+ */
+static void queue_fire (void)
+{
+    int16_t pixels[FRAME_PIXELS];
+    uint64_t mask = 0;
+    for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+    {
+        bool hot = (pixel / 8 == 3 || pixel / 8 == 4) && (pixel % 8 == 3 || pixel % 8 == 4);
+        pixels[pixel] = hot ? 300 * 4 : 20 * 4;
+        mask |= (uint64_t)hot << pixel;
+    }
+    fire_queue.observe (pixels, mask, turntable_heading (), 0.0f, millis ());
+}
+
+
+/** @brief   Times trips round the dispatcher's states, driven by events posted from interrupts.
+ *  @details The firmware runs in a world where nothing moves, as in a replay,
+ *           so the only commands at the time of an event are the ones it leads
+ *           to: FIRE_SEEN and CARRIAGE_HOME command the turntable, AIMED and
+ *           LEVER_CLAMPED the extinguisher. A step ends at the first motor
+ *           command after its event, which the tasks give within a millisecond
+ *           of virtual time. The events are posted between
+ *           the thermal camera's reads, which take virtual time, so that no
+ *           step waits for one. Before each FIRE_SEEN a fire is put in the
+ *           fire queue, where the thermal task would have put it, for the
+ *           turntable to aim at.
+ */
+static void bench_fsm (uint32_t cycles)
+{
+    sim_motor_observer ([] (int pwm_pin, int)
+    {
+        if (post_us != 0 && (pwm_pin == MOTOR1_PWM || pwm_pin == MOTOR2_PWM))
+        {
+            fsm_ns += ns_since (post_time);
+            fsm_steps++;
+            post_us = 0;
+        }
+    });
+    sim_serial_sink ([] (uint8_t) { });
+    sim_world_config world;
+    world.replay = true;
+    sim_world_begin (world);
+    setup ();
+    sim_run_until_us (FSM_BOOT_US);
+
+    const firebot_event EVENTS[] = { EVENT_FIRE_SEEN, EVENT_AIMED, EVENT_LEVER_CLAMPED, EVENT_CARRIAGE_HOME };
+    uint32_t wrong_state = 0;
+    for (uint32_t cycle = 0; cycle < cycles; cycle++)
+    {
+        uint64_t at = sim_now_us () / FSM_CYCLE_US * FSM_CYCLE_US + FSM_FIRST_US;
+        for (firebot_event event : EVENTS)
+        {
+            sim_at_us (at, [event] ()
+            {
+                if (event == EVENT_FIRE_SEEN)
+                {
+                    queue_fire ();
+                }
+                post_event (event);
+            });
+            at += FSM_STEP_US;
+        }
+        sim_run_for_us (FSM_CYCLE_US);
+        wrong_state += firebot_get_state () != STATE_SCANNING;
+    }
+    fsm_missed += post_us != 0;
+
+    report ("fsm.step", fsm_steps ? fsm_ns / fsm_steps : 0.0, "ns");
+    report ("fsm.missed_steps", fsm_missed + wrong_state, "count");
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t scale = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--scale") == 0 && i + 1 < argc && atol (argv[i + 1]) > 0)
+        {
+            scale = (uint32_t)atol (argv[++i]);
+        }
+        else
+        {
+            fprintf (stderr, "usage: %s [--scale N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    loop_ns = calibrate ();
+    printf ("calibrate.step,%.3f,ns\n", loop_ns);
+    bench_detection (200 * scale);
+    bench_rings (2000000 * scale);
+    bench_ring_threads (200000 * scale);
+    bench_shares (2000000 * scale);
+    bench_stream (200 * scale);
+    bench_handoff (false);
+    bench_handoff (true);
+    bench_fsm (1000 * scale);
+    return 0;
+}
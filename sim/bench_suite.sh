@@ -0,0 +1,142 @@
+#!/bin/sh
+# Benchmark suite of FireBot, compared with a stored baseline to catch
+# performance regressions. It runs firebot_bench (see bench_suite.cpp), which
+# times the detection of each frame, one step of the dispatcher's state
+# machine and the primitives tasks hand data through in host nanoseconds,
+# and three scenarios of the whole firmware in firebot_sim, whose times are in
+# virtual milliseconds and come out the same on every host:
+#
+#   fire       a fire at full heat, from injection to the turntable stopping,
+#              aimed, the lever clamped, and the turntable scanning again,
+#              and the time from power-up to the firmware being armed
+#   growing    a fire growing at 3 C/s anywhere around the turntable, from
+#              injection to the turntable stopping for it
+#   multi      three fires burning at once around the turntable, until all
+#              are out, and how far the turntable turned meanwhile
+#
+#   sim/bench_suite.sh BUILD_DIR [--baseline FILE] [--csv FILE] [--save FILE] [--repeat N]
+#
+# Every result is a cost, so lower is better. With --baseline each result
+# is compared with the baseline's value and is a regression if it is more
+# than the baseline's tolerance in percent higher; a result with no
+# tolerance is only shown. The host timings are the fastest of --repeat
+# runs of firebot_bench (5 by default). In nanoseconds they move by more
+# than half between runs on a busy or different host, so they are only
+# shown; each is gated instead in steps of the calibration loop
+# firebot_bench times at its start (the .loops results), which take out
+# the speed of the host and stay within about a third of each other
+# between runs. --csv writes the results and the comparison as
+# metric,value,unit,baseline,change_pct,status. --save writes the results
+# as a new baseline, metric,value,unit,tolerance_pct, with no tolerance for
+# nanoseconds, 50 percent for calibration loops and 2 percent for the
+# virtual times and counts. Exits with status 1 if anything regressed or a
+# metric in the baseline is missing.
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 BUILD_DIR [--baseline FILE] [--csv FILE] [--save FILE] [--repeat N]" >&2
+    exit 2
+fi
+BUILD=$1
+shift
+BASELINE=
+CSV=
+SAVE=
+REPEAT=5
+while [ $# -gt 0 ]; do
+    case $1 in
+        --baseline) BASELINE=$2; shift 2 ;;
+        --csv)      CSV=$2; shift 2 ;;
+        --save)     SAVE=$2; shift 2 ;;
+        --repeat)   REPEAT=$2; shift 2 ;;
+        *) echo "usage: $0 BUILD_DIR [--baseline FILE] [--csv FILE] [--save FILE] [--repeat N]" >&2; exit 2 ;;
+    esac
+done
+if [ -z "$BASELINE$SAVE" ]; then
+    BASELINE=$(dirname "$0")/bench_baseline.csv
+fi
+
+RESULTS=$(mktemp)
+trap 'rm -f "$RESULTS"' EXIT
+
+# Host timings: the fastest of each, the counts from the last run
+i=0
+while [ $i -lt "$REPEAT" ]; do
+    "$BUILD/firebot_bench" || exit 1
+    i=$((i + 1))
+done | awk -F, '
+    !($1 in value) { order[++n] = $1 }
+    { timing = $3 == "ns" || $3 == "loops" }
+    !($1 in value) || (timing && $2 + 0 < value[$1]) || !timing { value[$1] = $2 + 0; unit[$1] = $3 }
+    END { for (i = 1; i <= n; i++) printf "%s,%.3f,%s\n", order[i], value[order[i]], unit[order[i]] }
+' > "$RESULTS"
+
+# Whole-firmware scenarios in virtual time; the mean column of each milestone
+"$BUILD/firebot_sim" --runs 20 --seed 1 | awk '
+    $1 == "motor1.drive(0)"            { printf "fire.detect,%.3f,ms\n", $3 }
+    $1 == "aimed"                      { printf "fire.aimed,%.3f,ms\n", $3 }
+    $1 == "fire" && $2 == "out"        { printf "fire.out,%.3f,ms\n", $4 }
+    $1 == "turntable" && $2 == "resume" { printf "fire.resume,%.3f,ms\n", $4 }
+    $1 == "clamp-unclamp"              { printf "fire.clamp_cycle,%.3f,ms\n", $4 }
+    $1 == "context" && $2 == "switches" { printf "fire.context_switches,%.1f,count\n", $3 }
+    $1 == "time" && $3 == "armed"      { printf "boot.armed,%.3f,ms\n", $5 }
+' >> "$RESULTS"
+"$BUILD/firebot_sim" --runs 20 --seed 1 --inject-ms 30000 --offset-spread-deg 360 --temp-c 300 \
+                     --growth-c-per-s 3 --timeout-ms 90000 | awk '
+    $1 == "motor1.drive(0)"            { printf "growing.detect,%.3f,ms\n", $3 }
+    $1 == "context" && $2 == "switches" { printf "growing.context_switches,%.1f,count\n", $3 }
+' >> "$RESULTS"
+"$BUILD/firebot_sim" --runs 10 --seed 1 --targets 3 --timeout-ms 120000 | awk '
+    $1 == "all" && $2 == "fires"       { printf "multi.all_out,%.3f,ms\n", $5 }
+    $1 == "turntable" && $2 == "travel" { printf "multi.travel,%.1f,deg\n", $3 }
+' >> "$RESULTS"
+
+if [ -n "$SAVE" ]; then
+    awk -F, 'BEGIN { print "metric,value,unit,tolerance_pct" }
+             { printf "%s,%s,%s,%s\n", $1, $2, $3, ($3 == "ns" ? "" : $3 == "loops" ? 50 : 2) }' "$RESULTS" > "$SAVE"
+    echo "saved $(wc -l < "$RESULTS") results to $SAVE"
+fi
+if [ -z "$BASELINE" ]; then
+    awk -F, '{ printf "%-28s %12s %s\n", $1, $2, $3 }' "$RESULTS"
+    exit 0
+fi
+if [ ! -r "$BASELINE" ]; then
+    echo "$0: can't read baseline $BASELINE" >&2
+    exit 2
+fi
+
+# Compare; the baseline is read first, then the results
+awk -F, -v csv="$CSV" '
+    BEGIN { if (csv != "") print "metric,value,unit,baseline,change_pct,status" > csv }
+    FNR == NR {
+        if (FNR > 1) { base[$1] = $2 + 0; tolerance[$1] = $4; listed[++listed_count] = $1 }
+        next
+    }
+    {
+        metric = $1; value = $2 + 0; seen[metric] = 1
+        status = "new"; change = ""
+        if (metric in base) {
+            change = base[metric] != 0 ? sprintf ("%.1f", 100 * (value - base[metric]) / base[metric]) : ""
+            status = "ok"
+            if (tolerance[metric] == "") status = "info"
+            else if (value > base[metric] * (1 + tolerance[metric] / 100)) {
+                status = "REGRESSED"; regressed++
+            }
+            else if (value < base[metric] * (1 - tolerance[metric] / 100)) status = "improved"
+        }
+        printf "%-28s %12s %-5s %12s %8s%%  %s\n", metric, $2, $3,
+               (metric in base ? base[metric] : "-"), (change == "" ? "-" : change), status
+        if (csv != "") printf "%s,%s,%s,%s,%s,%s\n", metric, $2, $3, (metric in base ? base[metric] : ""),
+                              change, status > csv
+    }
+    END {
+        for (i = 1; i <= listed_count; i++) {
+            if (!(listed[i] in seen)) {
+                printf "%-28s %12s %-5s %12s %8s   %s\n", listed[i], "-", "", base[listed[i]], "", "MISSING"
+                if (csv != "") printf "%s,,,%s,,MISSING\n", listed[i], base[listed[i]] > csv
+                regressed++
+            }
+        }
+        printf "%d regression%s against the baseline\n", regressed, regressed == 1 ? "" : "s"
+        exit regressed > 0
+    }
+' "$BASELINE" "$RESULTS"
@@ -0,0 +1,157 @@
+/** @file bench_trace.cpp
+ *  Microbenchmark of the trace log in trace.h. It times trace_write() into
+ *  a ring with room, into a full ring, where the record is dropped, and the
+ *  encoding of a record for the serial port as task_Trace does it. It also
+ *  checks that every record comes out of the ring in the order it went in
+ *  and that a full ring counts what it drops.
+ *
+ *  Usage: trace_bench [--records N]
+ *
+ *  On the host the time stamp is a call to micros() rather than one load of
+ *  the cycle counter, so these times are an upper bound for the same code
+ *  path; TRACE_WRITE_CYCLES in trace.h is the budget on the Cortex-M4.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#if defined __x86_64__ || defined __i386__
+    #include <x86intrin.h>
+#endif
+
+#include <Arduino.h>
+#include "trace.h"
+#include "panorama.h"
+#include "thermal_array.h"
+#include "task_Dispatcher.h"
+
+/// The thermal map task_Trace prints on request; main.cpp's isn't linked into the benchmark
+Panorama panorama;
+/// The cameras whose statistics task_Trace prints on request
+ThermalArray thermal_array;
+
+/** @brief   Stands in for the dispatcher's queue, which the boot report linked with task_Trace posts to.
+ */
+void firebot_post (firebot_event event)
+{
+    (void)event;
+}
+
+/** @brief   Reads the CPU's cycle counter where there is one, for cycles per record.
+ */
+static inline uint64_t cycles (void)
+{
+#if defined __x86_64__ || defined __i386__
+    return __rdtsc ();
+#else
+    return 0;
+#endif
+}
+
+
+/** @brief   Empties one ring the way task_Trace does, checking the order of the records.
+ *  @return  The number of records which came out of order
+ */
+static uint32_t drain (trace_ring& ring, uint16_t& expected, uint8_t* p_buffer)
+{
+    uint32_t errors = 0;
+    uint16_t head = __atomic_load_n (&ring.head, __ATOMIC_ACQUIRE);
+    uint16_t tail = ring.tail;
+    while (tail != head)
+    {
+        const trace_record& record = ring.records[tail & (TRACE_RING_SIZE - 1)];
+        errors += record.value != expected++;
+        trace_encode (TRACE_THERMAL, record, p_buffer);
+        tail++;
+        __atomic_store_n (&ring.tail, tail, __ATOMIC_RELEASE);
+    }
+    return errors;
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t records = 10000000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--records") == 0 && i + 1 < argc)
+        {
+            records = (uint32_t)atol (argv[++i]);
+        }
+        else
+        {
+            fprintf (stderr, "usage: %s [--records N]\n", argv[0]);
+            return 2;
+        }
+    }
+    records -= records % TRACE_RING_SIZE;
+
+    trace_begin ();
+    trace_ring& ring = trace_rings[TRACE_THERMAL];
+    uint8_t buffer[TRACE_FRAME_SIZE];
+    uint16_t expected = 0;
+    uint32_t errors = 0;
+
+    // Writes into a ring with room: fill it, then empty it untimed
+    double write_ns = 0.0;
+    uint64_t write_cycles = 0;
+    uint16_t value = 0;
+    for (uint32_t done = 0; done < records; done += TRACE_RING_SIZE)
+    {
+        auto start = std::chrono::steady_clock::now ();
+        uint64_t start_cycles = cycles ();
+        for (uint16_t count = 0; count < TRACE_RING_SIZE; count++)
+        {
+            trace_write (TRACE_THERMAL, TRACE_FRAME, 0, value++);
+        }
+        write_cycles += cycles () - start_cycles;
+        write_ns += std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+        errors += drain (ring, expected, buffer);
+    }
+
+    // Writes into a full ring, which are dropped
+    for (uint16_t count = 0; count < TRACE_RING_SIZE; count++)
+    {
+        trace_write (TRACE_THERMAL, TRACE_FRAME, 0, value++);
+    }
+    uint16_t dropped_before = ring.dropped;
+    auto start = std::chrono::steady_clock::now ();
+    uint64_t start_cycles = cycles ();
+    for (uint32_t count = 0; count < records; count++)
+    {
+        trace_write (TRACE_THERMAL, TRACE_FRAME, 0, 0);
+    }
+    uint64_t drop_cycles = cycles () - start_cycles;
+    double drop_ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+    bool dropped_ok = (uint16_t)(ring.dropped - dropped_before) == (uint16_t)records;
+    errors += drain (ring, expected, buffer);
+
+    // Encoding for the serial port
+    trace_record record = { 0, TRACE_FRAME, 0, 0 };
+    uint32_t sum = 0;
+    start = std::chrono::steady_clock::now ();
+    start_cycles = cycles ();
+    for (uint32_t count = 0; count < records; count++)
+    {
+        record.time = count;
+        trace_encode (TRACE_THERMAL, record, buffer);
+        sum += buffer[TRACE_FRAME_SIZE - 1];
+    }
+    uint64_t encode_cycles = cycles () - start_cycles;
+    double encode_ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+
+    printf ("trace log: %u records per test, ring of %u, %u byte records on the wire\n",
+            records, TRACE_RING_SIZE, TRACE_FRAME_SIZE);
+    printf ("%-22s %8.2f ns %8.1f cycles per record\n", "trace_write", write_ns / records,
+            (double)write_cycles / records);
+    printf ("%-22s %8.2f ns %8.1f cycles per record\n", "trace_write, ring full", drop_ns / records,
+            (double)drop_cycles / records);
+    printf ("%-22s %8.2f ns %8.1f cycles per record  (checksum total %u)\n", "trace_encode",
+            encode_ns / records, (double)encode_cycles / records, sum & 0xFF);
+    printf ("%-22s %8u out of order, drops %s\n", "check", errors, dropped_ok ? "counted" : "MISCOUNTED");
+    return errors == 0 && dropped_ok ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/** @file bench_upsample.cpp
+ *  Microbenchmark and accuracy check of the sub-pixel locator in
+ *  upsample.cpp. It renders seeded random frames of one small fire on a
+ *  noisy room-temperature background the way the simulated camera does,
+ *  each pixel taking the share of a Gaussian spot which falls on it, with
+ *  the fire anywhere in the frame to a fraction of a pixel. For every frame
+ *  it checks that upsample_frame() gives exactly the same 1024 pixels as
+ *  upsample_frame_reference(), and measures how far from the fire each way
+ *  of locating it lands:
+ *
+ *    pixel      the centre of the hottest camera pixel
+ *    centroid   the weighted centre of the pixels over the hotspot threshold,
+ *               or the hottest pixel if none is, which is how the turntable
+ *               was aimed before
+ *    sub-pixel  the weighted centre of the peak of the upsampled frame
+ *
+ *  It then times the upsampling and the peak fit.
+ *
+ *  Usage: upsample_bench [--frames N] [--passes P] [--seed S]
+ *
+ *  The program exits with status 1 if any upsampled frame differs from the
+ *  reference, or if the sub-pixel error in the middle of the frame is on
+ *  average more than UPSAMPLE_MEAN_LIMIT pixels. Build upsample_bench_portable
+ *  to time the plain C version instead of the SIMD one on the same frames.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "hotspot.h"
+#include "upsample.h"
+
+/// Detection threshold used by the firmware, 60 degrees C in 0.25 degree counts
+const int16_t THRESHOLD = 60 * 4;
+
+/// Degrees each camera pixel covers
+const float PIXEL_DEG = 7.5f;
+
+/// Most the mean sub-pixel error may be, in pixels, for fires at least a pixel from the edge
+const float UPSAMPLE_MEAN_LIMIT = 0.1f;
+
+/// One rendered frame and where the fire in it really is
+struct test_frame
+{
+    int16_t pixels[64];                      ///< The frame in 0.25 degree C counts
+    float col;                               ///< Fire's centre in camera pixels across, 0 being the middle of column 0
+    float row;                               ///< Fire's centre in camera pixels down
+};
+
+
+/** @brief   Fraction of a Gaussian's 1-D mass which falls between two offsets.
+ */
+static float gauss_span (float from, float to, float sigma)
+{
+    const float scale = 1.0f / (sigma * 1.41421356f);
+    return 0.5f * (erff (to * scale) - erff (from * scale));
+}
+
+
+/** @brief   Renders a frame of one fire, as sim_world.cpp does, at a random place.
+ */
+static void make_frame (std::mt19937& rng, test_frame* p_frame)
+{
+    std::uniform_real_distribution<float> uniform (0.0f, 1.0f);
+    std::normal_distribution<float> noise (0.0f, 0.15f);
+
+    float ambient = 18.0f + 10.0f * uniform (rng);
+    float fire = 150.0f + 250.0f * uniform (rng);
+    float radius_deg = 1.0f + 5.0f * uniform (rng);
+    p_frame->col = 8.0f * uniform (rng) - 0.5f;
+    p_frame->row = 8.0f * uniform (rng) - 0.5f;
+
+    // A uniform disc of radius r has the same area as a Gaussian with sigma r/sqrt(2)
+    float sigma = radius_deg * 0.70710678f / PIXEL_DEG;
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            float dx = p_frame->col - col;
+            float dy = p_frame->row - row;
+            float mass = gauss_span (-0.5f - dx, 0.5f - dx, sigma) * gauss_span (-0.5f - dy, 0.5f - dy, sigma);
+            float fill = mass * 6.2831853f * sigma * sigma;
+            float temp = ambient + (fire - ambient) * (fill < 1.0f ? fill : 1.0f) + noise (rng);
+            p_frame->pixels[row * 8 + col] = (int16_t)lroundf (temp * 4.0f);
+        }
+    }
+}
+
+
+/// Errors of one way of locating the fire, in pixels across
+struct locator_errors
+{
+    const char* name;                        ///< Name to print
+    std::vector<float> all;                  ///< Every frame
+    std::vector<float> middle;               ///< Frames with the fire at least a pixel from the edge
+};
+
+
+/** @brief   Returns the mean of a set of errors.
+ */
+static float mean_of (const std::vector<float>& errors)
+{
+    double sum = 0.0;
+    for (float error : errors)
+    {
+        sum += error;
+    }
+    return errors.empty () ? 0.0f : (float)(sum / errors.size ());
+}
+
+
+/** @brief   Prints the mean, 95th percentile and largest error, in pixels and degrees.
+ */
+static void print_errors (const char* name, std::vector<float> errors)
+{
+    std::sort (errors.begin (), errors.end ());
+    float mean = mean_of (errors);
+    float p95 = errors[errors.size () * 95 / 100];
+    float most = errors.back ();
+    printf ("  %-10s %6.3f px mean (%5.2f deg), %6.3f px 95%% (%5.2f deg), %6.3f px max (%5.2f deg)\n",
+            name, mean, mean * PIXEL_DEG, p95, p95 * PIXEL_DEG, most, most * PIXEL_DEG);
+}
+
+
+/** @brief   Times the upsampling and peak fit over every frame, several passes.
+ *  @return  Nanoseconds per frame
+ */
+static double time_upsample (void (*upsample)(const int16_t*, int16_t*), bool fit,
+                             const std::vector<test_frame>& frames, uint32_t passes)
+{
+    int16_t upsampled[UPSAMPLE_PIXELS];
+    subpixel_peak peak = { 0, 0, 0 };
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now ();
+    for (uint32_t pass = 0; pass < passes; pass++)
+    {
+        for (const test_frame& frame : frames)
+        {
+            upsample (frame.pixels, upsampled);
+            if (fit)
+            {
+                upsample_peak (upsampled, &peak);
+            }
+        }
+        sink = sink + upsampled[pass % UPSAMPLE_PIXELS] + peak.col;
+    }
+    auto end = std::chrono::steady_clock::now ();
+    return std::chrono::duration<double, std::nano> (end - start).count () / ((double)frames.size () * passes);
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t num_frames = 4096;
+    uint32_t passes = 50;
+    uint32_t seed = 1;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp (argv[arg], "--frames") && arg + 1 < argc)
+        {
+            num_frames = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--passes") && arg + 1 < argc)
+        {
+            passes = (uint32_t)atoi (argv[++arg]);
+        }
+        else if (!strcmp (argv[arg], "--seed") && arg + 1 < argc)
+        {
+            seed = (uint32_t)strtoul (argv[++arg], NULL, 0);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--frames N] [--passes P] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng (seed);
+    std::vector<test_frame> frames (num_frames);
+    for (test_frame& frame : frames)
+    {
+        make_frame (rng, &frame);
+    }
+
+    // Every upsampled pixel must match the reference exactly, and each way of
+    //     locating the fire is measured against where it really is
+    uint32_t mismatches = 0;
+    locator_errors locators[3] = { { "pixel", {}, {} }, { "centroid", {}, {} }, { "sub-pixel", {}, {} } };
+    for (size_t index = 0; index < frames.size (); index++)
+    {
+        const test_frame& frame = frames[index];
+        int16_t fast[UPSAMPLE_PIXELS];
+        int16_t reference[UPSAMPLE_PIXELS];
+        upsample_frame (frame.pixels, fast);
+        upsample_frame_reference (frame.pixels, reference);
+        if (memcmp (fast, reference, sizeof (fast)) != 0)
+        {
+            if (mismatches++ < 5)
+            {
+                uint16_t pixel = 0;
+                while (fast[pixel] == reference[pixel])
+                {
+                    pixel++;
+                }
+                printf ("Frame %zu differs from the reference at (%u, %u): %d, should be %d\n", index,
+                        pixel % UPSAMPLE_SIDE, pixel / UPSAMPLE_SIDE, fast[pixel], reference[pixel]);
+            }
+        }
+
+        hotspot_result hotspot;
+        hotspot_find (frame.pixels, THRESHOLD, &hotspot);
+        subpixel_peak peak;
+        upsample_peak (fast, &peak);
+
+        float found[3];
+        found[0] = hotspot.max_pixel % 8;
+        found[1] = hotspot.hot_pixels > 0 ? hotspot.centroid_col / 256.0f : found[0];
+        found[2] = peak.col / 256.0f;
+        bool middle = frame.col >= 0.5f && frame.col <= 6.5f && frame.row >= 0.5f && frame.row <= 6.5f;
+        for (uint8_t which = 0; which < 3; which++)
+        {
+            float error = fabsf (found[which] - frame.col);
+            locators[which].all.push_back (error);
+            if (middle)
+            {
+                locators[which].middle.push_back (error);
+            }
+        }
+    }
+
+#if defined UPSAMPLE_PORTABLE
+    const char* version = "portable C";
+#elif defined __ARM_FEATURE_DSP
+    const char* version = "Cortex-M DSP";
+#elif defined __SSE2__
+    const char* version = "SSE2";
+#else
+    const char* version = "portable C";
+#endif
+    printf ("Checked %zu frames against the reference: %u mismatches\n", frames.size (), mismatches);
+    printf ("Error across, fires at least a pixel from the edge (%zu frames):\n", locators[0].middle.size ());
+    for (const locator_errors& locator : locators)
+    {
+        print_errors (locator.name, locator.middle);
+    }
+    printf ("Error across, all frames:\n");
+    for (const locator_errors& locator : locators)
+    {
+        print_errors (locator.name, locator.all);
+    }
+
+    double fast_ns = time_upsample (upsample_frame, false, frames, passes);
+    double reference_ns = time_upsample (upsample_frame_reference, false, frames, passes);
+    double fit_ns = time_upsample (upsample_frame, true, frames, passes) - fast_ns;
+    printf ("upsample_frame (%s): %8.1f ns/frame\n", version, fast_ns);
+    printf ("upsample_frame_reference: %8.1f ns/frame\n", reference_ns);
+    printf ("upsample_peak:            %8.1f ns/frame\n", fit_ns);
+    printf ("Speedup: %.2fx\n", reference_ns / fast_ns);
+
+    float sub_pixel_mean = mean_of (locators[2].middle);
+    if (sub_pixel_mean > UPSAMPLE_MEAN_LIMIT)
+    {
+        printf ("Sub-pixel mean error %.3f px is over the limit of %.3f px\n", sub_pixel_mean, UPSAMPLE_MEAN_LIMIT);
+    }
+    return mismatches || sub_pixel_mean > UPSAMPLE_MEAN_LIMIT ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+/** @file capture_file.cpp
+ *  Memory-mapped reader for FireBot captures on the host.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "capture_file.h"
+
+
+CaptureFile::CaptureFile (void)
+{
+    p_bytes = NULL;
+    size = 0;
+    mapped = false;
+    memset (&header, 0, sizeof (header));
+    first = 0;
+    offset = 0;
+    last_us = 0;
+    started = false;
+    out_of_order = 0;
+}
+
+
+CaptureFile::~CaptureFile (void)
+{
+    close ();
+}
+
+
+/** @brief   Maps a capture file into memory and finds its header.
+ *  @return  false, with a message on stderr, if the file can't be mapped or holds no capture
+ */
+bool CaptureFile::open (const char* p_path)
+{
+    close ();
+    int fd = ::open (p_path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror (p_path);
+        return false;
+    }
+    struct stat status;
+    if (fstat (fd, &status) != 0 || status.st_size == 0)
+    {
+        fprintf (stderr, "%s: empty or unreadable\n", p_path);
+        ::close (fd);
+        return false;
+    }
+    void* p_map = mmap (NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close (fd);
+    if (p_map == MAP_FAILED)
+    {
+        perror (p_path);
+        return false;
+    }
+    // The records are read once from start to end
+    madvise (p_map, (size_t)status.st_size, MADV_SEQUENTIAL);
+    p_bytes = (const uint8_t*)p_map;
+    size = (size_t)status.st_size;
+    mapped = true;
+    if (!find_header ())
+    {
+        fprintf (stderr, "%s: no capture version %u found\n", p_path, CAPTURE_VERSION);
+        close ();
+        return false;
+    }
+    return true;
+}
+
+
+/** @brief   Reads a capture held in memory, which must outlive the reader's use of it.
+ *  @return  false if the buffer holds no capture
+ */
+bool CaptureFile::attach (const uint8_t* p_data, size_t bytes)
+{
+    close ();
+    p_bytes = p_data;
+    size = bytes;
+    return find_header ();
+}
+
+
+/** @brief   Undoes the mapping, if any.
+ */
+void CaptureFile::close (void)
+{
+    if (mapped)
+    {
+        munmap ((void*)p_bytes, size);
+    }
+    p_bytes = NULL;
+    size = 0;
+    mapped = false;
+    first = 0;
+    offset = 0;
+}
+
+
+/** @brief   Finds the first header of a version this reader knows and goes to the record after it.
+ */
+bool CaptureFile::find_header (void)
+{
+    for (size_t at = 0; at + sizeof (capture_header) <= size; at++)
+    {
+        if (memcmp (p_bytes + at, CAPTURE_MAGIC, sizeof (CAPTURE_MAGIC)) != 0)
+        {
+            continue;
+        }
+        memcpy (&header, p_bytes + at, sizeof (header));
+        if (header.version == CAPTURE_VERSION && header.header_bytes >= sizeof (header)
+            && at + header.header_bytes <= size)
+        {
+            first = at + header.header_bytes;
+            rewind ();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/** @brief   Goes back to the first record.
+ */
+void CaptureFile::rewind (void)
+{
+    offset = first;
+    started = false;
+    out_of_order = 0;
+}
+
+
+/** @brief   Hands out the next record.
+ *  @details Each time stamp is taken as the nearest time at or after the last
+ *           record's which has the same low 32 bits, so gaps of up to 71
+ *           minutes between records are followed. A record a little earlier
+ *           than the one before it is counted and given the earlier record's
+ *           time, so that times never go backward.
+ *  @return  false at the end of the capture, at a CAPTURE_END record, or at a
+ *           record cut short by the end of the file
+ */
+bool CaptureFile::next (capture_event& event)
+{
+    if (offset + sizeof (capture_record) > size)
+    {
+        return false;
+    }
+    memcpy (&event.record, p_bytes + offset, sizeof (event.record));
+    size_t payload = event.record.type >= CAPTURE_PAYLOAD ? event.record.value : 0;
+    if (event.record.type == CAPTURE_END || offset + sizeof (capture_record) + payload > size)
+    {
+        return false;
+    }
+    event.p_payload = payload ? p_bytes + offset + sizeof (capture_record) : NULL;
+    offset += sizeof (capture_record) + payload;
+
+    if (!started)
+    {
+        last_us = event.record.time_us;
+        started = true;
+    }
+    int32_t step = (int32_t)(event.record.time_us - (uint32_t)last_us);
+    if (step < 0)
+    {
+        out_of_order++;
+    }
+    else
+    {
+        last_us += (uint32_t)step;
+    }
+    event.time_us = last_us;
+    return true;
+}
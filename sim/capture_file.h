@@ -0,0 +1,70 @@
+/** @file capture_file.h
+ *  Reader for FireBot captures (see capture.h) on the host. A capture file
+ *  is mapped into memory rather than read, so a recording of many hours is
+ *  walked record by record without being copied, and the payload of each
+ *  frame is handed out as a pointer into the mapping. Bytes before the
+ *  capture header, such as the greeting and trace records the robot sent
+ *  before the capture started, are skipped. The 32 bit time stamps are
+ *  carried past their wrap-around into 64 bits.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _CAPTURE_FILE_H_
+#define _CAPTURE_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "capture.h"
+
+/// One record of a capture as the reader hands it out
+struct capture_event
+{
+    uint64_t time_us;                        ///< Time in microseconds, past the 32 bit wrap-around
+    capture_record record;                   ///< The record as it was sent
+    const uint8_t* p_payload;                ///< Its payload, or NULL if it has none
+};
+
+/** @brief   A capture mapped into memory, read one record at a time.
+ *  @details The same reader works on a capture held in memory, such as the
+ *           one the replayed firmware sends back.
+ */
+class CaptureFile
+{
+protected:
+    const uint8_t* p_bytes;                  ///< Start of the mapping or buffer
+    size_t size;                             ///< Bytes mapped
+    bool mapped;                             ///< Whether p_bytes is a mapping to be undone
+    capture_header header;                   ///< Header found in the file
+    size_t first;                            ///< Offset of the first record
+    size_t offset;                           ///< Offset of the next record
+    uint64_t last_us;                        ///< Time of the last record handed out
+    bool started;                            ///< Whether a record has been handed out since rewind()
+    uint32_t out_of_order;                   ///< Records earlier than the one before, given its time instead
+
+    bool find_header (void);
+
+public:
+    CaptureFile (void);
+    ~CaptureFile (void);
+
+    bool open (const char* p_path);
+    bool attach (const uint8_t* p_data, size_t bytes);
+    void close (void);
+
+    bool next (capture_event& event);
+    void rewind (void);
+
+    /// Returns the header of the capture
+    const capture_header& get_header (void) const { return header; }
+
+    /// Returns the number of bytes of records, from the first record to the end
+    size_t get_bytes (void) const { return size - first; }
+
+    /// Returns how many records so far had a time earlier than the one before
+    uint32_t get_out_of_order (void) const { return out_of_order; }
+};
+
+#endif // _CAPTURE_FILE_H_
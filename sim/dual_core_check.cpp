@@ -0,0 +1,214 @@
+/** @file dual_core_check.cpp
+ *  Check of the data the two cores of the dual-core ESP32 share, run with
+ *  the firmware's own code on real host threads at once rather than in the
+ *  virtual-time kernel, where only one task ever runs at a time. It is
+ *  built for two cores, so the lock in core_lock.h is a real spinlock.
+ *
+ *  - The frame ring: one thread writes frames as task_Thermal_Sensor does,
+ *    filling every pixel with the frame's timestamp, while two threads read
+ *    them as the motor tasks would. A frame whose pixels don't all match its
+ *    timestamp was written while it was being read, and a frame older than
+ *    the last one a reader saw came out of order.
+ *  - The fire queue: one thread adds fires at changing bearings while
+ *    another chooses, follows and finishes them. A fire with no number, a
+ *    bearing outside the circle or more fires than the queue holds is an
+ *    error.
+ *
+ *  Usage: dual_core_check [--seconds S]
+ *
+ *  Each thread gives up its time slice whenever it has nothing to do, so
+ *  that on a host with one core the others get to run; they are then
+ *  switched in the middle of whatever they are doing, which tries the
+ *  locks as hard as two cores would.
+ *
+ *  Each result is printed as one line @c metric,value,unit like those of
+ *  firebot_bench. Exits with status 1 if anything was wrong.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <Arduino.h>
+#include "frame_ring.h"
+#include "fire_queue.h"
+
+/// Errors found by all the threads
+static std::atomic<uint32_t> errors (0);
+
+/// Set when the threads should stop
+static std::atomic<bool> done (false);
+
+
+/** @brief   Prints one result.
+ */
+static void report (const char* p_metric, double value, const char* p_unit)
+{
+    printf ("%s,%.0f,%s\n", p_metric, value, p_unit);
+}
+
+
+/** @brief   Writes frames into the ring from one thread and reads them from two others.
+ */
+static void check_frame_ring (void)
+{
+    static FrameRing ring ("check");
+    std::atomic<uint32_t> read (0);
+
+    auto reader = [&read] ()
+    {
+        uint32_t last = 0;
+        while (!done)
+        {
+            const thermal_frame* p_frame = ring.acquire (last);
+            if (p_frame == NULL)
+            {
+                std::this_thread::yield ();
+                continue;
+            }
+            if (p_frame->sequence <= last)
+            {
+                errors++;
+            }
+            last = p_frame->sequence;
+            for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+            {
+                if (p_frame->pixels[pixel] != (int16_t)p_frame->timestamp_us)
+                {
+                    errors++;
+                    break;
+                }
+            }
+            ring.release (p_frame);
+            read++;
+        }
+    };
+    std::thread first (reader);
+    std::thread second (reader);
+
+    uint32_t written = 0;
+    while (!done)
+    {
+        // Let the readers in between frames, as the camera's frame period does
+        std::this_thread::yield ();
+        thermal_frame* p_frame = ring.begin_write ();
+        if (p_frame == NULL)
+        {
+            continue;
+        }
+        // Frames a period apart, so that the ring doesn't count any as dropped
+        uint32_t timestamp = (written + 1) * FRAME_PERIOD_US;
+        for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+        {
+            p_frame->pixels[pixel] = (int16_t)timestamp;
+        }
+        p_frame->timestamp_us = timestamp;
+        ring.publish (p_frame, 0);
+        written++;
+    }
+    first.join ();
+    second.join ();
+
+    report ("ring.frames_written", written, "count");
+    report ("ring.frames_read", read, "count");
+}
+
+
+/** @brief   Adds fires to the queue from one thread and engages them from another.
+ */
+static void check_fire_queue (void)
+{
+    static FireQueue queue;
+    std::atomic<uint32_t> engaged (0);
+
+    std::thread engager ([&engaged] ()
+    {
+        float heading = 0.0f;
+        while (!done)
+        {
+            fire_target target;
+            if (queue.size () > FIRE_QUEUE_SIZE)
+            {
+                errors++;
+            }
+            if (!queue.choose (heading, &target))
+            {
+                std::this_thread::yield ();
+                continue;
+            }
+            if (target.id == 0 || !(target.bearing_deg >= 0.0f && target.bearing_deg < 360.0f))
+            {
+                errors++;
+            }
+            heading = target.bearing_deg;
+            if (queue.get (target.id, &target) && target.id == 0)
+            {
+                errors++;
+            }
+            queue.finish ();
+            engaged++;
+        }
+    });
+
+    // A hot column which moves across the frame, and the heading the frame is from
+    int16_t pixels[FRAME_PIXELS];
+    uint32_t frames = 0;
+    while (!done)
+    {
+        std::this_thread::yield ();
+        uint8_t column = frames % 8;
+        uint64_t mask = 0;
+        for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+        {
+            pixels[pixel] = pixel % 8 == column ? 1200 : 88;
+            mask |= pixel % 8 == column ? (uint64_t)1 << pixel : 0;
+        }
+        queue.observe (pixels, mask, (frames * 37) % 360, 0.0f, frames);
+        frames++;
+    }
+    engager.join ();
+
+    report ("queue.frames_observed", frames, "count");
+    report ("queue.fires_engaged", engaged, "count");
+}
+
+
+int main (int argc, char** argv)
+{
+    double seconds = 2.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof (argv[++i]);
+        }
+        else
+        {
+            fprintf (stderr, "usage: %s [--seconds S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    auto run_for = [seconds] (void (*check) (void))
+    {
+        done = false;
+        std::thread timer ([seconds] ()
+        {
+            std::this_thread::sleep_for (std::chrono::duration<double> (seconds / 2));
+            done = true;
+        });
+        check ();
+        timer.join ();
+    };
+    run_for (check_frame_ring);
+    run_for (check_fire_queue);
+
+    report ("errors", errors, "count");
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/** @file frame_receive.cpp
+ *  Receiver for FireBot's live stream of thermal camera frames (see
+ *  frame_stream.h). It reads bytes from the robot's serial port, or written
+ *  by the host simulation with @c --stream and @c --trace, picks out the
+ *  stream's packets from among the trace records and text, rebuilds every
+ *  frame, and reports how much of the port the stream took.
+ *
+ *  Usage: frame_receive [--csv FILE] [FILE]
+ *
+ *  Without a file the stream is read from standard input. @c --csv writes
+ *  each rebuilt frame as one line: its time in microseconds, the camera,
+ *  1 for a keyframe, then the 64 pixels in degrees C, top row first.
+ *
+ *  When a sequence number is missing, packets were lost, so no camera has
+ *  a last frame to add differences to; each camera's frames are left out
+ *  until its next keyframe.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "frame_stream.h"
+#include "trace.h"
+
+/// Most cameras a packet can name
+const uint8_t MAX_CAMERAS = FRAME_STREAM_CAMERA + 1;
+
+/// What was received from one camera
+struct camera_counts
+{
+    uint32_t frames;                         ///< Frames rebuilt
+    uint32_t keyframes;                      ///< Of which keyframes
+    uint32_t waiting;                        ///< Frames left out while waiting for a keyframe
+    uint32_t first_us;                       ///< Time stamp of the first frame rebuilt
+    uint32_t last_us;                        ///< Time stamp of the last frame rebuilt
+};
+
+
+/** @brief   Checks whether a complete, valid trace record starts at @c p_bytes.
+ */
+static bool is_trace_frame (const uint8_t* p_bytes)
+{
+    if (p_bytes[0] != TRACE_SYNC_BYTE)
+    {
+        return false;
+    }
+    uint8_t sum = 0;
+    for (uint8_t index = 1; index < TRACE_FRAME_SIZE - 1; index++)
+    {
+        sum += p_bytes[index];
+    }
+    return (uint8_t)~sum == p_bytes[TRACE_FRAME_SIZE - 1];
+}
+
+
+int main (int argc, char** argv)
+{
+    const char* p_path = NULL;
+    const char* p_csv_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--csv") == 0 && i + 1 < argc)
+        {
+            p_csv_path = argv[++i];
+        }
+        else if (argv[i][0] == '-' || p_path != NULL)
+        {
+            fprintf (stderr, "usage: %s [--csv FILE] [FILE]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            p_path = argv[i];
+        }
+    }
+
+    FILE* p_file = p_path ? fopen (p_path, "rb") : stdin;
+    if (p_file == NULL)
+    {
+        perror (p_path);
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread (chunk, 1, sizeof (chunk), p_file)) > 0)
+    {
+        bytes.insert (bytes.end (), chunk, chunk + got);
+    }
+    if (p_file != stdin)
+    {
+        fclose (p_file);
+    }
+    FILE* p_csv = NULL;
+    if (p_csv_path != NULL && (p_csv = fopen (p_csv_path, "w")) == NULL)
+    {
+        perror (p_csv_path);
+        return 1;
+    }
+
+    // Each camera's last frame, and whether there is one to add differences to
+    static int16_t reference[MAX_CAMERAS][FRAME_PIXELS];
+    bool have_reference[MAX_CAMERAS] = { false };
+    camera_counts counts[MAX_CAMERAS] = { };
+
+    size_t stream_bytes = 0;
+    size_t key_bytes = 0;
+    size_t trace_bytes = 0;
+    size_t other_bytes = 0;
+    uint32_t packets = 0;
+    uint32_t lost = 0;
+    uint32_t bad = 0;
+    bool started = false;
+    uint8_t expected = 0;
+    uint64_t span_us = 0;
+    uint32_t last_us = 0;
+
+    size_t index = 0;
+    while (index < bytes.size ())
+    {
+        size_t available = bytes.size () - index;
+        uint16_t size = frame_stream_check (&bytes[index], available);
+        if (size == 0)
+        {
+            if (available >= TRACE_FRAME_SIZE && is_trace_frame (&bytes[index]))
+            {
+                trace_bytes += TRACE_FRAME_SIZE;
+                index += TRACE_FRAME_SIZE;
+            }
+            else
+            {
+                other_bytes++;
+                index++;
+            }
+            continue;
+        }
+        const uint8_t* p_packet = &bytes[index];
+        index += size;
+        stream_bytes += size;
+        packets++;
+
+        // A gap in the sequence numbers loses every camera its last frame
+        uint8_t sequence = p_packet[2];
+        if (started && sequence != expected)
+        {
+            lost += (uint8_t)(sequence - expected);
+            memset (have_reference, 0, sizeof (have_reference));
+        }
+        expected = sequence + 1;
+
+        frame_stream_frame frame;
+        uint8_t camera = p_packet[3] & FRAME_STREAM_CAMERA;
+        if (!frame_stream_decode (p_packet, have_reference[camera] ? reference[camera] : NULL, &frame))
+        {
+            if (frame.key)
+            {
+                bad++;
+            }
+            else
+            {
+                counts[camera].waiting++;
+            }
+            have_reference[camera] = false;
+            started = true;
+            continue;
+        }
+        memcpy (reference[camera], frame.pixels, sizeof (frame.pixels));
+        have_reference[camera] = true;
+
+        // Follow the time stamps through their wrap-around
+        if (started)
+        {
+            span_us += (uint32_t)(frame.timestamp_us - last_us);
+        }
+        last_us = frame.timestamp_us;
+        started = true;
+
+        camera_counts& count = counts[camera];
+        if (count.frames == 0)
+        {
+            count.first_us = frame.timestamp_us;
+        }
+        count.last_us = frame.timestamp_us;
+        count.frames++;
+        if (frame.key)
+        {
+            count.keyframes++;
+            key_bytes += size;
+        }
+
+        if (p_csv != NULL)
+        {
+            fprintf (p_csv, "%u,%u,%u", frame.timestamp_us, frame.camera, frame.key ? 1 : 0);
+            for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+            {
+                fprintf (p_csv, ",%.2f", frame.pixels[pixel] / 4.0);
+            }
+            fprintf (p_csv, "\n");
+        }
+    }
+    if (p_csv != NULL)
+    {
+        fclose (p_csv);
+    }
+
+    uint32_t frames = 0;
+    uint32_t keyframes = 0;
+    uint32_t waiting = 0;
+    for (uint8_t camera = 0; camera < MAX_CAMERAS; camera++)
+    {
+        const camera_counts& count = counts[camera];
+        frames += count.frames;
+        keyframes += count.keyframes;
+        waiting += count.waiting;
+        if (count.frames + count.waiting == 0)
+        {
+            continue;
+        }
+        double seconds = (uint32_t)(count.last_us - count.first_us) / 1e6;
+        printf ("camera %u: %u frames, %u keyframes, %u left out waiting for a keyframe, %.1f frames/s\n",
+                camera, count.frames, count.keyframes, count.waiting,
+                seconds > 0.0 ? (count.frames - 1) / seconds : 0.0);
+    }
+    if (packets == 0)
+    {
+        printf ("no stream packets among %zu bytes; was the stream started with 'f'?\n", bytes.size ());
+        return 1;
+    }
+
+    double seconds = span_us / 1e6;
+    double link_bytes_per_s = TRACE_BAUD_RATE / 10.0;
+    uint32_t deltas = frames - keyframes;
+    printf ("%u packets, %u lost, %u bad; %u frames rebuilt over %.1f s\n", packets, lost, bad, frames, seconds);
+    printf ("%.1f bytes per frame (keyframes %.1f, others %.1f) against %u raw, %.1f to 1\n",
+            frames ? (double)stream_bytes / packets : 0.0,
+            keyframes ? (double)key_bytes / keyframes : 0.0,
+            deltas ? (double)(stream_bytes - key_bytes) / deltas : 0.0,
+            (unsigned)(FRAME_PIXELS * sizeof (int16_t)),
+            (double)FRAME_PIXELS * sizeof (int16_t) * packets / stream_bytes);
+    if (seconds > 0.0)
+    {
+        printf ("stream %.0f bytes/s, %.1f%% of the %u baud port; trace log %.0f bytes/s, %.1f%%\n",
+                stream_bytes / seconds, 100.0 * stream_bytes / seconds / link_bytes_per_s, TRACE_BAUD_RATE,
+                trace_bytes / seconds, 100.0 * trace_bytes / seconds / link_bytes_per_s);
+    }
+    fprintf (stderr, "%zu bytes of other output\n", other_bytes);
+    return lost + bad + waiting > 0 ? 1 : 0;
+}
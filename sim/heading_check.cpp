@@ -0,0 +1,105 @@
+/** @file heading_check.cpp
+ *  Check of the turntable's dead-reckoned heading (see turntable_heading()
+ *  in task_Rotation_Base.cpp) over a long scan at one speed. The firmware
+ *  runs in an empty room, built with TURNTABLE_CONSTANT_SCAN so that the
+ *  turntable is never given a new speed, for longer than the 71.6 minutes
+ *  after which the 32 bit micros() wraps. Every second the change in the
+ *  firmware's heading is compared with the change in the simulated
+ *  turntable's angle; a time since the last drive command which wrapped
+ *  would make the heading jump by tens or hundreds of degrees.
+ *
+ *  Usage: heading_check [--minutes M]
+ *
+ *  Each result is printed as one line @c metric,value,unit like those of
+ *  firebot_bench. Exits with status 1 if the heading ever jumped.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <Arduino.h>
+#include "sim_kernel.h"
+#include "sim_world.h"
+#include "task_Rotation_Base.h"
+
+void setup ();
+
+/// Time between comparisons of the firmware's heading with the turntable's angle
+const uint64_t CHECK_STEP_US = 1000000;
+
+/// Most the two may disagree by over one step, in degrees; far more than rounding, far less than a wrap
+const float CHECK_TOLERANCE_DEG = 1.0f;
+
+/// Time from power-up before the first comparison, once the turntable is up to speed
+const uint64_t CHECK_START_US = 2000000;
+
+
+/** @brief   Wraps an angle to -180 to 180 degrees.
+ */
+static float wrap_deg (float deg)
+{
+    deg = fmodf (deg, 360.0f);
+    return deg > 180.0f ? deg - 360.0f : (deg < -180.0f ? deg + 360.0f : deg);
+}
+
+
+int main (int argc, char** argv)
+{
+    uint32_t minutes = 75;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--minutes") == 0 && i + 1 < argc && atol (argv[i + 1]) > 0)
+        {
+            minutes = (uint32_t)atol (argv[++i]);
+        }
+        else
+        {
+            fprintf (stderr, "usage: %s [--minutes M]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    sim_serial_sink ([] (uint8_t) { });
+    sim_world_config world;
+    sim_world_begin (world);
+    sim_set_cores (portNUM_PROCESSORS);
+    setup ();
+    sim_run_until_us (CHECK_START_US);
+
+    float heading = turntable_heading ();
+    float angle = sim_turntable_angle_deg ();
+    float worst_deg = 0.0f;
+    uint32_t jumps = 0;
+    uint64_t end_us = (uint64_t)minutes * 60 * 1000000;
+    while (sim_now_us () < end_us)
+    {
+        sim_run_for_us (CHECK_STEP_US);
+        float new_heading = turntable_heading ();
+        float new_angle = sim_turntable_angle_deg ();
+        float error = fabsf (wrap_deg ((new_heading - heading) - (new_angle - angle)));
+        if (error > worst_deg)
+        {
+            worst_deg = error;
+        }
+        if (error > CHECK_TOLERANCE_DEG)
+        {
+            if (jumps == 0)
+            {
+                fprintf (stderr, "heading jumped %.1f deg at %.1f min\n", error, sim_now_us () / 60e6);
+            }
+            jumps++;
+        }
+        heading = new_heading;
+        angle = new_angle;
+    }
+
+    printf ("heading.minutes,%u,min\n", minutes);
+    printf ("heading.worst_step_error,%.3f,deg\n", worst_deg);
+    printf ("heading.jumps,%u,count\n", jumps);
+    return jumps > 0 ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+/** @file Adafruit_AMG88xx.h
+ *  Host simulation stand-in for the Adafruit AMG88xx thermal camera library.
+ *  The public interface matches the library; behind it each object talks to
+ *  the simulated sensor at its I2C address in sim_world.cpp, which renders
+ *  the scene in front of the turntable at the sensor's 10 fps frame rate and
+ *  drives the INT line the way the real part does. Register accesses cost
+ *  the CPU time a blocking Wire transfer would take at the bus clock.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _ADAFRUIT_AMG88XX_H_
+#define _ADAFRUIT_AMG88XX_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/// Default I2C address of the AMG8833 (AD_SELECT high)
+#define AMG88xx_ADDRESS                 0x69
+/// Number of pixels in one frame
+#define AMG88xx_PIXEL_ARRAY_SIZE        64
+/// Degrees C per count of a pixel temperature register
+#define AMG88xx_PIXEL_TEMP_CONVERSION   .25
+/// Degrees C per count of the thermistor register
+#define AMG88xx_THERMISTOR_CONVERSION   .0625
+
+/// Interrupt modes of the sensor
+enum
+{
+    AMG88xx_DIFFERENCE = 0,
+    AMG88xx_ABSOLUTE_VALUE = 1
+};
+
+/** @brief   Driver for one AMG88xx sensor.
+ */
+class Adafruit_AMG88xx
+{
+public:
+    Adafruit_AMG88xx (void) : address (AMG88xx_ADDRESS), p_wire (&Wire) { }
+
+    bool begin (uint8_t addr = AMG88xx_ADDRESS, TwoWire* theWire = &Wire);
+
+    void readPixels (float* buf, uint8_t size = AMG88xx_PIXEL_ARRAY_SIZE);
+    float readThermistor (void);
+
+    void setMovingAverageMode (bool mode);
+
+    void enableInterrupt (void);
+    void disableInterrupt (void);
+    void setInterruptMode (uint8_t mode);
+    void getInterrupt (uint8_t* buf, uint8_t size = 8);
+    void clearInterrupt (void);
+    void setInterruptLevels (float high, float low);
+    void setInterruptLevels (float high, float low, float hysteresis);
+
+private:
+    uint8_t address;                         ///< I2C address given to begin()
+    TwoWire* p_wire;                         ///< Bus given to begin()
+
+    void write_register (uint8_t count);
+    void read_registers (uint8_t count);
+};
+
+#endif // _ADAFRUIT_AMG88XX_H_
@@ -0,0 +1,121 @@
+/** @file Arduino.h
+ *  Host simulation stand-in for the Arduino core. Pins are simulated levels
+ *  which the hardware models in sim_world.cpp drive and read, the time
+ *  functions report virtual time, and Serial writes to a configurable sink.
+ *  Like the ESP32 core, this header also brings in the RTOS API.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _ARDUINO_H_
+#define _ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/// Number of simulated GPIO pins, enough for ports A through H
+#define SIM_NUM_PINS    128
+
+/// STM32 pin names, numbered 16 to a port like the STM32 Arduino core
+enum sim_pin_name
+{
+    PA0 = 0x00, PA1, PA2, PA3, PA4, PA5, PA6, PA7, PA8, PA9, PA10, PA11, PA12, PA13, PA14, PA15,
+    PB0 = 0x10, PB1, PB2, PB3, PB4, PB5, PB6, PB7, PB8, PB9, PB10, PB11, PB12, PB13, PB14, PB15,
+    PC0 = 0x20, PC1, PC2, PC3, PC4, PC5, PC6, PC7, PC8, PC9, PC10, PC11, PC12, PC13, PC14, PC15,
+    PD0 = 0x30, PD1, PD2, PD3, PD4, PD5, PD6, PD7, PD8, PD9, PD10, PD11, PD12, PD13, PD14, PD15,
+    PH0 = 0x70, PH1
+};
+
+#define LOW             0
+#define HIGH            1
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define INPUT_PULLDOWN  3
+
+#define CHANGE          2
+#define FALLING         3
+#define RISING          4
+
+#define DEC             10
+#define HEX             16
+#define OCT             8
+#define BIN             2
+
+/// Limits a value to a range, as the Arduino core's macro does
+#define constrain(amt, low, high)   ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/// Every simulated pin can raise an interrupt, numbered the same as the pin
+#define digitalPinToInterrupt(p)    (p)
+
+void pinMode (uint32_t pin, uint32_t mode);
+void digitalWrite (uint32_t pin, uint32_t value);
+int digitalRead (uint32_t pin);
+void analogWrite (uint32_t pin, int value);
+void attachInterrupt (uint32_t interrupt_num, void (*callback) (void), uint32_t mode);
+void detachInterrupt (uint32_t interrupt_num);
+
+uint32_t millis (void);
+uint32_t micros (void);
+void delay (uint32_t ms);
+void delayMicroseconds (uint32_t us);
+
+/** @brief   Minimal version of the Arduino Print class.
+ *  @details Derived classes supply @c write(uint8_t); everything else is
+ *           formatted on top of it the way the Arduino core does.
+ */
+class Print
+{
+public:
+    virtual ~Print () { }
+    virtual size_t write (uint8_t c) = 0;
+    virtual size_t write (const uint8_t* p_buffer, size_t size);
+    size_t write (const char* p_str) { return write ((const uint8_t*)p_str, strlen (p_str)); }
+
+    size_t print (const char* p_str) { return write (p_str); }
+    size_t print (char c) { return write ((uint8_t)c); }
+    size_t print (unsigned char value, int base = DEC) { return print ((unsigned long)value, base); }
+    size_t print (int value, int base = DEC) { return print ((long)value, base); }
+    size_t print (unsigned int value, int base = DEC) { return print ((unsigned long)value, base); }
+    size_t print (long value, int base = DEC);
+    size_t print (unsigned long value, int base = DEC);
+    size_t print (double value, int digits = 2);
+
+    size_t println (void) { return write ("\r\n"); }
+    template <class T> size_t println (T value) { size_t n = print (value); return n + println (); }
+    template <class T> size_t println (T value, int format) { size_t n = print (value, format); return n + println (); }
+};
+
+/** @brief   Simulated UART. Bytes written go to the sink set by sim_serial_sink(),
+ *           and bytes queued with sim_serial_input() can be read.
+ */
+class HardwareSerial : public Print
+{
+protected:
+    unsigned long baud_rate;                 ///< Rate given to begin(), used for link-time estimates
+
+public:
+    HardwareSerial (void) : baud_rate (0) { }
+    void begin (unsigned long baud) { baud_rate = baud; }
+    unsigned long baud (void) const { return baud_rate; }
+    int available (void);
+    int read (void);
+    void flush (void) { }
+    operator bool (void) { return true; }
+    using Print::write;
+    size_t write (uint8_t c) override;
+};
+
+/// The serial port the firmware talks through
+extern HardwareSerial Serial;
+
+#endif // _ARDUINO_H_
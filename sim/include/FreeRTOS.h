@@ -0,0 +1,92 @@
+/** @file FreeRTOS.h
+ *  Host simulation stand-in for the FreeRTOS kernel configuration header.
+ *  It provides the port types and configuration constants used by the
+ *  FireBot tasks so that they compile unchanged on a Linux host. The kernel
+ *  behind it runs in virtual time; see sim_kernel.h.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _FREERTOS_H_
+#define _FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Tick counter type, 32 bits like the STM32 port
+typedef uint32_t TickType_t;
+/// Signed base type of the port
+typedef long BaseType_t;
+/// Unsigned base type of the port
+typedef unsigned long UBaseType_t;
+/// One word of task stack, as on the 32-bit target
+typedef uint32_t StackType_t;
+
+/// The simulated tick runs at 1 kHz, the same as the STM32 and ESP32 ports
+#define configTICK_RATE_HZ          1000
+/// Number of distinct task priorities
+#define configMAX_PRIORITIES        16
+/// Smallest stack the simulation will accept for a task, in words
+#define configMINIMAL_STACK_SIZE    128
+/// Most urgent NVIC priority from which an interrupt may call FreeRTOS, as in STM32FreeRTOS
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY    5
+/// Tasks and queues can be made in memory given by the caller
+#define configSUPPORT_STATIC_ALLOCATION     1
+/// Tasks and queues can be made from the heap, unless the firmware is built with this set to 0
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+    #define configSUPPORT_DYNAMIC_ALLOCATION    1
+#endif
+
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdFAIL                      pdFALSE
+#define pdPASS                      pdTRUE
+#define errQUEUE_FULL               ((BaseType_t)0)
+#define errQUEUE_EMPTY              ((BaseType_t)0)
+
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS          ((TickType_t)(1000 / configTICK_RATE_HZ))
+#define pdMS_TO_TICKS(xTimeInMs)    ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000))
+
+/// Cores the firmware is built for; 2 models the dual-core ESP32, whose tasks are pinned to cores
+#ifndef portNUM_PROCESSORS
+    #define portNUM_PROCESSORS      1
+#endif
+
+/// Core affinity of a task which may run on any core
+#define tskNO_AFFINITY              ((BaseType_t)0x7fffffff)
+
+// Tasks only give up the virtual CPUs inside kernel calls, so a critical
+// section never has anything to exclude in the virtual-time kernel
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskENTER_CRITICAL_FROM_ISR()       0
+#define taskEXIT_CRITICAL_FROM_ISR(x)       (void)(x)
+#define portYIELD_FROM_ISR(x)               (void)(x)
+#define portEND_SWITCHING_ISR(x)            (void)(x)
+
+#if portNUM_PROCESSORS > 1
+/** @brief   Spinlock taken with a critical section on a multi-core port.
+ *  @details A real spinlock, so that code which runs firmware on several host
+ *           threads at once (see dual_core_check.cpp) gets real exclusion.
+ */
+typedef struct
+{
+    volatile uint32_t locked;                ///< Nonzero while held
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED        { 0 }
+
+void vPortEnterCriticalSafe (portMUX_TYPE* mux);
+void vPortExitCriticalSafe (portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL_SAFE(mux)        vPortEnterCriticalSafe (mux)
+#define portEXIT_CRITICAL_SAFE(mux)         vPortExitCriticalSafe (mux)
+#define portENTER_CRITICAL_ISR(mux)         vPortEnterCriticalSafe (mux)
+#define portEXIT_CRITICAL_ISR(mux)          vPortExitCriticalSafe (mux)
+#endif
+
+#endif // _FREERTOS_H_
@@ -0,0 +1,32 @@
+/** @file PrintStream.h
+ *  Host simulation stand-in for the ME507 PrintStream library, which adds
+ *  C++ style @c << output to anything derived from Arduino's Print class.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _PRINTSTREAM_H_
+#define _PRINTSTREAM_H_
+
+#include <Arduino.h>
+
+/// Manipulator which ends a line, as in @c Serial << "Hi" << endl
+enum PrintStreamEndl { endl };
+
+/// Prints anything Print::print() understands
+template <class T>
+inline Print& operator<< (Print& stream, T value)
+{
+    stream.print (value);
+    return stream;
+}
+
+/// Ends the current line
+inline Print& operator<< (Print& stream, PrintStreamEndl)
+{
+    stream.println ();
+    return stream;
+}
+
+#endif // _PRINTSTREAM_H_
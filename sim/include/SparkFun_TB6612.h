@@ -0,0 +1,48 @@
+/** @file SparkFun_TB6612.h
+ *  Host simulation stand-in for the SparkFun TB6612FNG motor driver library.
+ *  The Motor class drives the same simulated pins the real library drives,
+ *  so the motor models in sim_world.cpp see exactly what the H-bridge would.
+ *  Every drive() call is also reported to the observer set with
+ *  sim_motor_observer() so that a run can time the firmware's commands.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _SPARKFUN_TB6612_H_
+#define _SPARKFUN_TB6612_H_
+
+#include <Arduino.h>
+
+/// Speed used by the library's one-argument helpers
+#define DEFAULTSPEED 255
+
+/** @brief   One channel of a TB6612FNG dual H-bridge.
+ */
+class Motor
+{
+public:
+    Motor (int In1pin, int In2pin, int PWMpin, int offset, int STBYpin);
+    void drive (int speed);
+    void drive (int speed, int duration);
+    void brake (void);
+    void standby (void);
+
+    /// PWM pin of this channel, which identifies the motor in the simulation
+    int pwm_pin (void) const { return PWM; }
+
+private:
+    int In1, In2, PWM, Offset, Standby;
+    void fwd (int speed);
+    void rev (int speed);
+};
+
+void forward (Motor motor1, Motor motor2, int speed);
+void forward (Motor motor1, Motor motor2);
+void back (Motor motor1, Motor motor2, int speed);
+void back (Motor motor1, Motor motor2);
+void left (Motor left, Motor right, int speed);
+void right (Motor left, Motor right, int speed);
+void brake (Motor motor1, Motor motor2);
+
+#endif // _SPARKFUN_TB6612_H_
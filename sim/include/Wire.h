@@ -0,0 +1,36 @@
+/** @file Wire.h
+ *  Host simulation stand-in for the Arduino I2C library. The simulated
+ *  devices talk to their models directly, so the bus object only keeps
+ *  the configuration the firmware gives it, and the HAL handle which the
+ *  STM32 core's Wire library hands out for transfers made without it.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _WIRE_H_
+#define _WIRE_H_
+
+#include <Arduino.h>
+#include "stm32yyxx_hal_i2c.h"
+
+/** @brief   Simulated I2C bus master.
+ */
+class TwoWire
+{
+protected:
+    uint32_t clock_hz;                       ///< Bus clock given to setClock()
+    I2C_HandleTypeDef handle;                ///< HAL handle of the peripheral
+
+public:
+    TwoWire (void) : clock_hz (100000), handle { I2C1, HAL_I2C_STATE_READY, HAL_I2C_ERROR_NONE, this, 0 } { }
+    void begin (void) { }
+    void setClock (uint32_t frequency) { clock_hz = frequency; }
+    uint32_t getClock (void) const { return clock_hz; }
+    I2C_HandleTypeDef* getHandle (void) { return &handle; }
+};
+
+/// The I2C bus the thermal camera is wired to
+extern TwoWire Wire;
+
+#endif // _WIRE_H_
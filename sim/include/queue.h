@@ -0,0 +1,47 @@
+/** @file queue.h
+ *  Host simulation stand-in for the FreeRTOS queue API. Queues copy items by
+ *  value into a ring buffer and block the calling task in virtual time, the
+ *  same way the kernel queues used by taskshare.h and taskqueue.h do.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include "FreeRTOS.h"
+
+/// Opaque handle to a simulated queue
+typedef struct sim_queue* QueueHandle_t;
+
+/// Memory for a queue's control block given to xQueueCreateStatic(), about the size of the target's
+typedef struct
+{
+    uint32_t reserved[20];
+} StaticQueue_t;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+QueueHandle_t xQueueCreate (UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+#endif
+QueueHandle_t xQueueCreateStatic (UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                  uint8_t* pucQueueStorage, StaticQueue_t* pxQueueBuffer);
+void vQueueDelete (QueueHandle_t xQueue);
+BaseType_t xQueueSendToBack (QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t xQueueSendToFront (QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t xQueueOverwrite (QueueHandle_t xQueue, const void* pvItemToQueue);
+BaseType_t xQueueReceive (QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait);
+BaseType_t xQueuePeek (QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait);
+BaseType_t xQueueSendToBackFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xQueueSendToFrontFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xQueueOverwriteFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xQueueReceiveFromISR (QueueHandle_t xQueue, void* pvBuffer, BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xQueuePeekFromISR (QueueHandle_t xQueue, void* pvBuffer);
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t xQueue);
+UBaseType_t uxQueueMessagesWaitingFromISR (QueueHandle_t xQueue);
+UBaseType_t uxQueueSpacesAvailable (QueueHandle_t xQueue);
+
+#define xQueueSend(q, item, ticks)              xQueueSendToBack (q, item, ticks)
+#define xQueueSendFromISR(q, item, woken)       xQueueSendToBackFromISR (q, item, woken)
+
+#endif // _QUEUE_H_
@@ -0,0 +1,98 @@
+/** @file stm32yyxx_hal_i2c.h
+ *  Host simulation stand-in for the part of the STM32 HAL's I2C driver
+ *  which the firmware uses directly: memory reads and writes started with
+ *  an interrupt-driven transfer, whose end is reported by a callback from
+ *  the I2C interrupt. Behind it is a mock of the bus in sim_devices.cpp:
+ *  each transfer takes the time its bits take at the bus clock, during
+ *  which the processor is free, and then the callback runs in interrupt
+ *  context with the simulated device's registers copied in or out. A device
+ *  which isn't wired at the address doesn't acknowledge it, and the
+ *  transfer ends with an error instead.
+ *
+ *  The NVIC priority the firmware gives the bus's interrupts is kept too,
+ *  and a transfer whose interrupt would be too urgent to call FreeRTOS
+ *  stops the simulation, as the Wire library's default priority would
+ *  sooner or later corrupt the kernel on the target.
+ *
+ *  On the target the Wire library brings these in through the Arduino core
+ *  and owns the handle; this stand-in is included by the simulated Wire.h.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _STM32YYXX_HAL_I2C_H_
+#define _STM32YYXX_HAL_I2C_H_
+
+#include <stdint.h>
+
+/// The HAL I2C driver is in the build, as it is in the STM32 Arduino core's
+#define HAL_I2C_MODULE_ENABLED
+
+/// Result of starting a HAL operation
+typedef enum
+{
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+/// State of an I2C handle; only the states the mock goes through
+typedef enum
+{
+    HAL_I2C_STATE_READY = 0x20,
+    HAL_I2C_STATE_BUSY_TX = 0x21,
+    HAL_I2C_STATE_BUSY_RX = 0x22
+} HAL_I2C_StateTypeDef;
+
+/// No error on the bus
+#define HAL_I2C_ERROR_NONE      0x00000000U
+/// The device didn't acknowledge
+#define HAL_I2C_ERROR_AF        0x00000004U
+/// Register addresses are one byte
+#define I2C_MEMADD_SIZE_8BIT    0x00000001U
+
+/// Interrupts of the one simulated I2C peripheral, numbered as on the STM32L4
+typedef enum
+{
+    I2C1_EV_IRQn = 31,
+    I2C1_ER_IRQn = 32
+} IRQn_Type;
+
+/// Registers of an I2C peripheral; the simulation has none, only the one peripheral
+typedef struct
+{
+    uint32_t priority[2];                    ///< Simulation only: NVIC priority of the event and error interrupts
+} I2C_TypeDef;
+
+/// The simulated I2C peripheral
+extern I2C_TypeDef sim_i2c1;
+#define I2C1 (&sim_i2c1)
+
+class TwoWire;
+
+/// Handle of one I2C peripheral
+typedef struct
+{
+    I2C_TypeDef* Instance;                   ///< The peripheral
+    volatile HAL_I2C_StateTypeDef State;     ///< Whether a transfer is running
+    volatile uint32_t ErrorCode;             ///< Why the last transfer failed
+    TwoWire* p_wire;                         ///< Simulation only: the bus, for its clock
+    uint32_t transfer;                       ///< Simulation only: transfers started, so an aborted one is ignored
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Abort_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress);
+uint32_t HAL_I2C_GetError (I2C_HandleTypeDef* hi2c);
+void HAL_NVIC_SetPriority (IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+
+// Called from the I2C interrupt; the HAL's versions do nothing and may be replaced
+extern "C" void HAL_I2C_MemRxCpltCallback (I2C_HandleTypeDef* hi2c);
+extern "C" void HAL_I2C_MemTxCpltCallback (I2C_HandleTypeDef* hi2c);
+extern "C" void HAL_I2C_ErrorCallback (I2C_HandleTypeDef* hi2c);
+
+#endif // _STM32YYXX_HAL_I2C_H_
@@ -0,0 +1,76 @@
+/** @file task.h
+ *  Host simulation stand-in for the FreeRTOS task API. Only the calls used by
+ *  the FireBot tasks are provided. Tasks run on a deterministic virtual-time
+ *  scheduler with fixed-priority preemption, implemented in sim_kernel.cpp.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASK_H_
+#define _TASK_H_
+
+#include "FreeRTOS.h"
+
+/// Opaque handle to a simulated task control block
+typedef struct sim_tcb* TaskHandle_t;
+
+/// Signature of a task function
+typedef void (*TaskFunction_t) (void*);
+
+/// Memory for a task control block given to xTaskCreateStatic(), about the size of the target's
+typedef struct
+{
+    uint32_t reserved[24];
+} StaticTask_t;
+
+/// What a task notification does to the receiving task's notification value
+typedef enum
+{
+    eNoAction = 0,                          ///< Wake the task without changing its value
+    eSetBits,                               ///< OR the given bits into the value
+    eIncrement,                             ///< Add one to the value
+    eSetValueWithOverwrite,                 ///< Replace the value
+    eSetValueWithoutOverwrite               ///< Replace the value only if the last one was taken
+} eNotifyAction;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+BaseType_t xTaskCreate (TaskFunction_t pxTaskCode, const char* pcName,
+                        uint32_t usStackDepth, void* pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t* pxCreatedTask);
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t pxTaskCode, const char* pcName,
+                                    uint32_t usStackDepth, void* pvParameters,
+                                    UBaseType_t uxPriority, TaskHandle_t* pxCreatedTask, BaseType_t xCoreID);
+#endif
+TaskHandle_t xTaskCreateStatic (TaskFunction_t pxTaskCode, const char* pcName,
+                                uint32_t ulStackDepth, void* pvParameters, UBaseType_t uxPriority,
+                                StackType_t* puxStackBuffer, StaticTask_t* pxTaskBuffer);
+TaskHandle_t xTaskCreateStaticPinnedToCore (TaskFunction_t pxTaskCode, const char* pcName,
+                                            uint32_t ulStackDepth, void* pvParameters, UBaseType_t uxPriority,
+                                            StackType_t* puxStackBuffer, StaticTask_t* pxTaskBuffer,
+                                            BaseType_t xCoreID);
+BaseType_t xPortGetCoreID (void);
+void vTaskDelete (TaskHandle_t xTask);
+void vTaskDelay (TickType_t xTicksToDelay);
+void vTaskDelayUntil (TickType_t* pxPreviousWakeTime, TickType_t xTimeIncrement);
+TickType_t xTaskGetTickCount (void);
+TickType_t xTaskGetTickCountFromISR (void);
+TaskHandle_t xTaskGetCurrentTaskHandle (void);
+const char* pcTaskGetName (TaskHandle_t xTask);
+UBaseType_t uxTaskGetStackHighWaterMark (TaskHandle_t xTask);
+void vTaskStartScheduler (void);
+void vPortYield (void);
+
+BaseType_t xTaskNotify (TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction);
+BaseType_t xTaskNotifyFromISR (TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction,
+                               BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xTaskNotifyWait (uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                            uint32_t* pulNotificationValue, TickType_t xTicksToWait);
+uint32_t ulTaskNotifyTake (BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+void vTaskNotifyGiveFromISR (TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken);
+
+#define xTaskNotifyGive(xTaskToNotify)  xTaskNotify ((xTaskToNotify), 0, eIncrement)
+
+#define taskYIELD()     vPortYield ()
+
+#endif // _TASK_H_
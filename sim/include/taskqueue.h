@@ -0,0 +1,95 @@
+/** @file taskqueue.h
+ *  Host simulation stand-in for the ME507 @c Queue template, a typed wrapper
+ *  around a FreeRTOS queue which passes items from one task to another.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASKQUEUE_H_
+#define _TASKQUEUE_H_
+
+#include <Arduino.h>
+
+/** @brief   First-in, first-out buffer of items passed between tasks.
+ */
+template <class DataType> class Queue
+{
+protected:
+    QueueHandle_t handle;                    ///< The FreeRTOS queue
+    const char* name;                        ///< Name for printouts
+    TickType_t ticks_to_wait;                ///< How long put() waits for space
+    UBaseType_t buf_size;                    ///< Number of items the queue can hold
+
+public:
+    /** @brief   Creates an empty queue.
+     *  @param   queue_size The number of items the queue can hold
+     *  @param   p_name A name for the queue, used in printouts
+     *  @param   wait_time How long put() waits for space before giving up
+     */
+    Queue (BaseType_t queue_size, const char* p_name = NULL, TickType_t wait_time = portMAX_DELAY)
+        : handle (xQueueCreate (queue_size, sizeof (DataType))), name (p_name),
+          ticks_to_wait (wait_time), buf_size (queue_size)
+    {
+    }
+
+    /// Puts an item at the back of the queue, waiting for space if needed
+    bool put (const DataType& item)
+    {
+        return xQueueSendToBack (handle, &item, ticks_to_wait) == pdPASS;
+    }
+
+    /// Puts an item at the front of the queue so it is the next one read
+    bool butt_in (const DataType& item)
+    {
+        return xQueueSendToFront (handle, &item, ticks_to_wait) == pdPASS;
+    }
+
+    /// Puts an item into the queue from within an interrupt service routine
+    bool ISR_put (const DataType& item)
+    {
+        BaseType_t woken = pdFALSE;
+        return xQueueSendToBackFromISR (handle, &item, &woken) == pdPASS;
+    }
+
+    /// Takes the oldest item out of the queue, waiting until there is one
+    void get (DataType& recv_item)
+    {
+        xQueueReceive (handle, &recv_item, portMAX_DELAY);
+    }
+
+    /// Takes the oldest item out of the queue and returns it
+    DataType get (void)
+    {
+        DataType recv_item;
+        get (recv_item);
+        return recv_item;
+    }
+
+    /// Takes the oldest item out of the queue from within an interrupt service routine
+    bool ISR_get (DataType& recv_item)
+    {
+        BaseType_t woken = pdFALSE;
+        return xQueueReceiveFromISR (handle, &recv_item, &woken) == pdPASS;
+    }
+
+    /// Copies the oldest item without removing it, waiting until there is one
+    void peek (DataType& recv_item)
+    {
+        xQueuePeek (handle, &recv_item, portMAX_DELAY);
+    }
+
+    bool any (void) { return uxQueueMessagesWaiting (handle) != 0; }
+    bool is_empty (void) { return uxQueueMessagesWaiting (handle) == 0; }
+    bool is_full (void) { return uxQueueSpacesAvailable (handle) == 0; }
+    UBaseType_t available (void) { return uxQueueMessagesWaiting (handle); }
+    UBaseType_t size (void) const { return buf_size; }
+
+    void operator<< (const DataType& item) { put (item); }
+    void operator>> (DataType& recv_item) { get (recv_item); }
+
+    /// Returns the name given to the constructor
+    const char* get_name (void) const { return name; }
+};
+
+#endif // _TASKQUEUE_H_
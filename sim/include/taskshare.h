@@ -0,0 +1,72 @@
+/** @file taskshare.h
+ *  Host simulation stand-in for the ME507 @c Share template. As in the
+ *  original library, a share is a one-item FreeRTOS queue which put()
+ *  overwrites and get() peeks, so a get() blocks until the first put().
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASKSHARE_H_
+#define _TASKSHARE_H_
+
+#include <Arduino.h>
+
+/** @brief   Data which one task writes and any number of tasks read.
+ */
+template <class DataType> class Share
+{
+protected:
+    QueueHandle_t queue;                     ///< One-item queue holding the data
+    const char* name;                        ///< Name for printouts
+
+public:
+    /** @brief   Creates a share with no data in it yet.
+     *  @param   p_name A name for the share, used in printouts
+     */
+    Share (const char* p_name = NULL)
+        : queue (xQueueCreate (1, sizeof (DataType))), name (p_name)
+    {
+    }
+
+    /// Writes new data into the share, replacing what was there
+    void put (DataType newData)
+    {
+        xQueueOverwrite (queue, &newData);
+    }
+
+    /// Writes new data into the share from within an interrupt service routine
+    void ISR_put (DataType newData)
+    {
+        BaseType_t woken = pdFALSE;
+        xQueueOverwriteFromISR (queue, &newData, &woken);
+    }
+
+    /// Reads the share, waiting until it has been written at least once
+    void get (DataType& recv_data)
+    {
+        xQueuePeek (queue, &recv_data, portMAX_DELAY);
+    }
+
+    /// Reads the share and returns its value
+    DataType get (void)
+    {
+        DataType recv_data;
+        get (recv_data);
+        return recv_data;
+    }
+
+    /// Reads the share from within an interrupt service routine
+    void ISR_get (DataType& recv_data)
+    {
+        xQueuePeekFromISR (queue, &recv_data);
+    }
+
+    void operator<< (DataType newData) { put (newData); }
+    void operator>> (DataType& recv_data) { get (recv_data); }
+
+    /// Returns the name given to the constructor
+    const char* get_name (void) const { return name; }
+};
+
+#endif // _TASKSHARE_H_
@@ -0,0 +1,65 @@
+#!/bin/sh
+# RAM budget report for a FireBot build. Lists the statically allocated RAM
+# of each task, from the TaskMemory objects in main.cpp, and of each
+# subsystem, from the symbols in the linked program, and checks the total
+# against the RAM of the microcontroller.
+#
+#   sim/ram_budget.sh PROGRAM [BUDGET_BYTES]
+#
+# PROGRAM is the linked firmware (firmware.elf) or a host simulation such as
+# firebot_sim_static. The budget defaults to the 96 KB of SRAM1 on an
+# STM32L476. Set NM to the toolchain's nm for the target, for example
+# NM=arm-none-eabi-nm. Only a build with configSUPPORT_DYNAMIC_ALLOCATION
+# set to 0 has the task stacks in its symbols; in other builds they come
+# from the heap and don't show here. In the host simulation pointers are
+# twice as big and the simulator's own variables land under "other", so
+# the numbers are a little high. Exits with status 1 if over budget.
+
+if [ $# -lt 1 ] || [ $# -gt 2 ]; then
+    echo "usage: $0 PROGRAM [BUDGET_BYTES]" >&2
+    exit 2
+fi
+PROGRAM=$1
+BUDGET=${2:-98304}
+NM=${NM:-nm}
+
+"$NM" -C -S -t d "$PROGRAM" | awk -v budget="$BUDGET" -v program="$PROGRAM" '
+    # Lines are: address size type name; only data and zeroed data use RAM
+    NF >= 4 && $3 ~ /^[bBdD]$/ {
+        size = $2 + 0
+        name = $4
+        for (i = 5; i <= NF; i++) name = name " " $i
+
+        if (name ~ /_memory$/)                              { sub (/_memory$/, "", name); task[name] += size; tasks += size }
+        else if (name ~ /^vApplicationGet[A-Za-z]*TaskMemory::/)
+        {
+            sub (/^vApplicationGet/, "", name); sub (/TaskMemory::.*/, "", name)
+            task[tolower (name) " (kernel)"] += size; tasks += size
+        }
+        else if (name ~ /^trace_/)                          { part["trace log"] += size }
+        else if (name ~ /^captur/)                          { part["capture"] += size }
+        else if (name ~ /^(frame_stream|stream)/)           { part["frame stream"] += size }
+        else if (name ~ /^(thermal_frames|thermal_array|background|panorama)$/) { part["thermal camera"] += size }
+        else if (name ~ /^event_queue/)                     { part["dispatcher events"] += size }
+        else if (name ~ /^boot_/)                           { part["boot"] += size }
+        else if (name ~ /_stats$|^task_stats_|^tick_offset/) { part["task statistics"] += size }
+        else                                                { part["other"] += size }
+        total += size
+    }
+    END {
+        printf "RAM budget of %s: %d bytes\n", program, budget
+        printf "Tasks, stack and control block:\n"
+        for (name in task) printf "  %-22s %7d\n", name, task[name] | "sort"
+        close ("sort")
+        printf "  %-22s %7d\n", "all tasks", tasks
+        printf "Subsystems:\n"
+        for (name in part) printf "  %-22s %7d\n", name, part[name] | "sort"
+        close ("sort")
+        printf "Total %d bytes, %.1f%% of the budget, %d bytes left for the heap and main stack\n",
+               total, 100.0 * total / budget, budget - total
+        if (total > budget)
+        {
+            printf "Over budget by %d bytes\n", total - budget
+            exit 1
+        }
+    }'
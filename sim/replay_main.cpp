@@ -0,0 +1,417 @@
+/** @file replay_main.cpp
+ *  Replays a FireBot capture (see capture.h) through the unmodified
+ *  firmware on the host. The capture file is mapped into memory and its
+ *  records are fed to the simulated hardware in virtual time: each camera
+ *  frame becomes the next frame of that camera, so task_Thermal_Sensor reads
+ *  exactly the recorded pixels, and each limit switch edge closes that
+ *  switch, so the extinguisher's state machine sees the recorded clamp and
+ *  home events. Nothing else moves. Because the simulation takes no time
+ *  for what the firmware does, an hour of recording replays in seconds.
+ *
+ *  Usage: firebot_replay [--dump] [--frames] FILE
+ *
+ *  The replayed firmware is itself asked for a capture, and what it decided
+ *  (every motor command, dispatcher event, stroke and interrupt table read)
+ *  is compared with what the recorded firmware decided over the time both
+ *  captures cover. A build whose thresholds or timing have been changed
+ *  shows where it first decides differently; the unchanged firmware should
+ *  make every decision the recording holds, at the same time to within the
+ *  alignment of its task periods with the recording's. The program exits
+ *  with 1 if the decisions differ. The speed of the replay is reported.
+ *
+ *  Each frame is shown to the cameras FRAME_LEAD_US before the time it was
+ *  published in the recording, which is before the firmware starts reading
+ *  it and after it read the frame before. The replay starts the firmware a
+ *  whole number of seconds before the first record, so that the phase of
+ *  every task period, each of which divides a second, is kept.
+ *
+ *  @c --dump prints the records of the capture as a timeline instead of
+ *  replaying it, leaving out frames unless @c --frames is given.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include <Arduino.h>
+#include "capture_file.h"
+#include "sim_kernel.h"
+#include "sim_world.h"
+#include "task_Dispatcher.h"
+
+void setup ();
+
+/// PWM pin of the extinguisher motor, which identifies motor2
+const int MOTOR2_PWM = PB3;
+
+/// How long before its recorded time a frame is shown to the cameras
+const uint64_t FRAME_LEAD_US = 25000;
+
+/// How far ahead of virtual time records are scheduled, which must be more than FRAME_LEAD_US
+const uint64_t REPLAY_LOOKAHEAD_US = 50000;
+
+/// Time from power-up allowed before the first record; ample for the firmware to boot and arm
+const uint64_t REPLAY_BOOT_US = 6000000;
+
+/// Printable names of the dispatcher's events
+const char* const EVENT_NAMES[] = { "FIRE_SEEN", "AIMED", "LEVER_CLAMPED", "CARRIAGE_HOME", "FIRE_GONE", "ARMED" };
+
+/// Printable names of the dispatcher's states
+const char* const STATE_NAMES[] = { "SCANNING", "AIMING", "SPRAYING", "UNCLAMPING", "BOOTING" };
+
+
+/** @brief   Returns a name from a table, or "?" if the index is out of range.
+ */
+template <size_t N>
+static const char* name_of (const char* const (&names)[N], unsigned index)
+{
+    return index < N ? names[index] : "?";
+}
+
+
+/** @brief   Prints one record of a capture as a line of text.
+ */
+static void print_event (const capture_event& event)
+{
+    const capture_record& r = event.record;
+    printf ("%12.3f ms  ", event.time_us / 1000.0);
+    switch (r.type)
+    {
+        case TRACE_DROPPED:
+            printf ("lost %u records from ring %u\n", r.value, r.arg);
+            break;
+        case TRACE_EVENT:
+            printf ("%s: %s -> %s\n", name_of (EVENT_NAMES, r.arg), name_of (STATE_NAMES, r.value & 0xFF),
+                    name_of (STATE_NAMES, r.value >> 8));
+            break;
+        case TRACE_MOTOR:
+            printf ("motor%u.drive(%d)\n", r.arg, (int16_t)r.value);
+            break;
+        case TRACE_SWITCH:
+            printf ("switch%u closed%s\n", r.arg, r.value ? "" : ", bounce ignored");
+            break;
+        case TRACE_AMG_INT:
+            printf ("threshold interrupt from camera %u\n", r.arg);
+            break;
+        case TRACE_FRAME:
+            printf ("frame read in %u us, %u hot pixels\n", r.value, r.arg);
+            break;
+        case TRACE_FRAME_TEMP:
+            printf ("frame: %u blobs, hottest %.2f C\n", r.arg, (int16_t)r.value / 4.0);
+            break;
+        case TRACE_FRAME_DROPPED:
+            printf ("frame dropped, no free buffer\n");
+            break;
+        case TRACE_FRAME_FAILED:
+            printf ("frame from camera %u failed on the bus, thrown away\n", (unsigned)r.arg);
+            break;
+        case TRACE_CAMERA_JOINED:
+            printf ("camera %u joined after %u %s\n", (unsigned)r.arg, r.value, r.value == 1 ? "try" : "tries");
+            break;
+        case TRACE_STROKE:
+            printf ("%s stroke took %u ms\n", r.arg == 1 ? "clamping" : "unclamping", r.value);
+            break;
+        case TRACE_PANORAMA:
+            printf ("turntable went round: %u cells changed, hottest at %.2f deg\n", r.arg, r.value / 100.0);
+            break;
+        case TRACE_TARGET:
+            printf ("aiming at the fire at %.2f deg, %u in the queue\n", r.value / 100.0, r.arg);
+            break;
+        case TRACE_BOOT:
+            printf ("%s ready after %u %s\n", r.arg == 1 ? "cameras" : r.arg == 2 ? "motors" : "switches",
+                    r.value, r.value == 1 ? "try" : "tries");
+            break;
+        case CAPTURE_FRAME:
+        {
+            int16_t pixels[64];
+            memcpy (pixels, event.p_payload, sizeof (pixels));
+            int16_t hottest = pixels[0];
+            for (uint8_t pixel = 1; pixel < 64; pixel++)
+            {
+                hottest = pixels[pixel] > hottest ? pixels[pixel] : hottest;
+            }
+            printf ("camera %u frame, hottest %.2f C\n", r.arg, hottest / 4.0);
+            break;
+        }
+        case CAPTURE_INTERRUPT:
+            printf ("camera %u interrupt table", r.arg);
+            for (uint16_t index = 0; index < r.value; index++)
+            {
+                printf (" %02x", event.p_payload[index]);
+            }
+            printf ("\n");
+            break;
+        default:
+            printf ("record type %u, %u, %u\n", r.type, r.arg, r.value);
+            break;
+    }
+}
+
+
+/** @brief   Returns whether a record is one of the firmware's decisions which a replay must repeat.
+ */
+static bool is_decision (const capture_record& record)
+{
+    return record.type == TRACE_EVENT || record.type == TRACE_MOTOR || record.type == TRACE_STROKE
+           || record.type == CAPTURE_INTERRUPT;
+}
+
+
+/** @brief   Returns whether two decisions are the same, apart from their times.
+ */
+static bool same_decision (const capture_event& a, const capture_event& b)
+{
+    if (a.record.type != b.record.type || a.record.arg != b.record.arg || a.record.value != b.record.value)
+    {
+        return false;
+    }
+    return a.record.type < CAPTURE_PAYLOAD || memcmp (a.p_payload, b.p_payload, a.record.value) == 0;
+}
+
+
+/** @brief   Collects the decisions in a capture.
+ *  @param   shift_us Added to each time, to put both captures on the same clock
+ */
+static std::vector<capture_event> decisions (CaptureFile& file, uint64_t shift_us)
+{
+    std::vector<capture_event> list;
+    capture_event event;
+    file.rewind ();
+    while (file.next (event))
+    {
+        if (is_decision (event.record))
+        {
+            event.time_us += shift_us;
+            list.push_back (event);
+        }
+    }
+    return list;
+}
+
+
+int main (int argc, char** argv)
+{
+    bool dump = false;
+    bool show_frames = false;
+    const char* p_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--dump") == 0)
+        {
+            dump = true;
+        }
+        else if (strcmp (argv[i], "--frames") == 0)
+        {
+            show_frames = true;
+        }
+        else if (argv[i][0] == '-' || p_path != NULL)
+        {
+            p_path = NULL;
+            break;
+        }
+        else
+        {
+            p_path = argv[i];
+        }
+    }
+    if (p_path == NULL)
+    {
+        fprintf (stderr, "usage: %s [--dump] [--frames] FILE\n", argv[0]);
+        return 2;
+    }
+
+    CaptureFile recording;
+    if (!recording.open (p_path))
+    {
+        return 1;
+    }
+    const capture_header& header = recording.get_header ();
+
+    // One pass to find the span of the capture and each camera's first frame
+    capture_event event;
+    uint64_t first_us = 0;
+    uint64_t last_us = 0;
+    uint32_t records = 0;
+    uint32_t frames = 0;
+    uint32_t switches = 0;
+    uint8_t cameras = header.cameras;
+    const uint8_t* p_first_frame[2] = { NULL, NULL };
+    while (recording.next (event))
+    {
+        first_us = records == 0 ? event.time_us : first_us;
+        last_us = event.time_us;
+        records++;
+        if (event.record.type == CAPTURE_FRAME)
+        {
+            frames++;
+            if (event.record.arg < 2 && p_first_frame[event.record.arg] == NULL)
+            {
+                p_first_frame[event.record.arg] = event.p_payload;
+                cameras = event.record.arg >= cameras ? event.record.arg + 1 : cameras;
+            }
+        }
+        switches += event.record.type == TRACE_SWITCH;
+        if (dump && (show_frames || (event.record.type != CAPTURE_FRAME && event.record.type != TRACE_FRAME
+                                     && event.record.type != TRACE_FRAME_TEMP)))
+        {
+            print_event (event);
+        }
+    }
+    printf ("%s: capture version %u, %u cameras, build flags 0x%03x, %u records over %.1f s: "
+            "%u frames, %u switch edges, %.0f kB\n", p_path, header.version, cameras, header.flags,
+            records, (last_us - first_us) / 1e6, frames, switches, recording.get_bytes () / 1e3);
+    if (recording.get_out_of_order () > 0)
+    {
+        printf ("%u records were earlier than the one before\n", recording.get_out_of_order ());
+    }
+    if (dump)
+    {
+        return 0;
+    }
+    if (cameras == 0)
+    {
+        printf ("The capture holds no frames to replay\n");
+        return 1;
+    }
+    if (header.flags != capture_build_flags ())
+    {
+        printf ("Warning: recorded with build flags 0x%03x, replaying with 0x%03x\n", header.flags,
+                capture_build_flags ());
+    }
+
+    // Move the recording back by whole seconds so the firmware has started just before it
+    uint64_t shift_us = first_us > REPLAY_BOOT_US ? (first_us - REPLAY_BOOT_US) / 1000000 * 1000000 : 0;
+
+    std::vector<uint8_t> replayed;
+    sim_serial_sink ([&] (uint8_t c) { replayed.push_back (c); });
+
+    // A switch stays closed until the firmware drives the carriage away from it
+    sim_motor_observer ([] (int pwm_pin, int speed)
+    {
+        if (pwm_pin == MOTOR2_PWM && speed < 0)
+        {
+            sim_world_replay_switch (1, false);
+        }
+        else if (pwm_pin == MOTOR2_PWM && speed > 0)
+        {
+            sim_world_replay_switch (2, false);
+        }
+    });
+
+    // Until the recording starts each camera shows its first recorded frame
+    sim_world_config world;
+    world.replay = true;
+    world.cameras = cameras;
+    sim_world_begin (world);
+    for (uint8_t camera = 0; camera < 2; camera++)
+    {
+        if (p_first_frame[camera] != NULL)
+        {
+            int16_t pixels[64];
+            memcpy (pixels, p_first_frame[camera], sizeof (pixels));
+            sim_world_replay_frame (camera, pixels);
+        }
+    }
+
+    auto wall_start = std::chrono::steady_clock::now ();
+    setup ();
+    sim_serial_input ("r");
+
+    // Schedule the records a little ahead of virtual time and run up to them
+    recording.rewind ();
+    bool more = recording.next (event);
+    while (more)
+    {
+        while (more && event.time_us - shift_us <= sim_now_us () + REPLAY_LOOKAHEAD_US)
+        {
+            uint64_t at = event.time_us - shift_us;
+            if (event.record.type == CAPTURE_FRAME && event.record.arg < cameras)
+            {
+                uint8_t camera = event.record.arg;
+                std::vector<int16_t> pixels (64);
+                memcpy (pixels.data (), event.p_payload, 64 * sizeof (int16_t));
+                at -= FRAME_LEAD_US;
+                sim_at_us (at > sim_now_us () ? at : sim_now_us (),
+                           [camera, pixels] () { sim_world_replay_frame (camera, pixels.data ()); });
+            }
+            else if (event.record.type == TRACE_SWITCH && (event.record.arg == 1 || event.record.arg == 2))
+            {
+                uint8_t which = event.record.arg;
+                sim_at_us (at > sim_now_us () ? at : sim_now_us (),
+                           [which] () { sim_world_replay_switch (which, true); });
+            }
+            more = recording.next (event);
+        }
+        if (more)
+        {
+            sim_run_until_us (event.time_us - shift_us - REPLAY_LOOKAHEAD_US);
+        }
+    }
+
+    // Let the firmware finish with the last records, then end its capture
+    sim_run_for_us (1000000);
+    sim_serial_input ("r");
+    sim_run_for_us (1000000);
+    double wall_s = std::chrono::duration<double> (std::chrono::steady_clock::now () - wall_start).count ();
+    double virtual_s = sim_now_us () / 1e6;
+    printf ("Replayed %.1f s in %.3f s of wall time, %.0f times real time\n", virtual_s, wall_s,
+            virtual_s / wall_s);
+
+    // Compare the decisions over the time both captures cover
+    CaptureFile again;
+    if (!again.attach (replayed.data (), replayed.size ()))
+    {
+        printf ("The replayed firmware sent no capture\n");
+        return 1;
+    }
+    std::vector<capture_event> expected = decisions (recording, 0);
+    std::vector<capture_event> actual = decisions (again, shift_us);
+    uint64_t from_us = (uint64_t)again.get_header ().start_us + shift_us;
+    from_us = from_us > first_us ? from_us : first_us;
+    size_t e = 0;
+    size_t a = 0;
+    while (e < expected.size () && expected[e].time_us < from_us)
+    {
+        e++;
+    }
+    while (a < actual.size () && actual[a].time_us < from_us)
+    {
+        a++;
+    }
+
+    uint32_t matched = 0;
+    uint32_t fires = 0;
+    uint64_t late_total = 0;
+    int64_t late_max = 0;
+    bool diverged = false;
+    for (; e < expected.size () && a < actual.size (); e++, a++)
+    {
+        if (!same_decision (expected[e], actual[a]))
+        {
+            printf ("Decisions differ after %u matched ones. Recorded:\n", matched);
+            print_event (expected[e]);
+            printf ("Replayed:\n");
+            print_event (actual[a]);
+            diverged = true;
+            break;
+        }
+        int64_t late = (int64_t)(actual[a].time_us - expected[e].time_us);
+        late = late < 0 ? -late : late;
+        late_total += (uint64_t)late;
+        late_max = late > late_max ? late : late_max;
+        matched++;
+        fires += expected[e].record.type == TRACE_EVENT && expected[e].record.arg == EVENT_FIRE_SEEN;
+    }
+    if (!diverged && e < expected.size ())
+    {
+        printf ("The replay ended %u decisions short of the recording\n", (unsigned)(expected.size () - e));
+        diverged = true;
+    }
+    printf ("%u decisions matched, %u of them fire events; times %.1f us apart on average, %.1f us at most\n",
+            matched, fires, matched ? (double)late_total / matched : 0.0, (double)late_max);
+    return diverged ? 1 : 0;
+}
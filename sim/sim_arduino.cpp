@@ -0,0 +1,284 @@
+/** @file sim_arduino.cpp
+ *  Simulated Arduino core for the host build: GPIO levels with pull
+ *  resistors and edge interrupts, virtual-time clocks and delays, and a
+ *  Serial port which hands its bytes to a sink and reads bytes queued by
+ *  the simulation.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <deque>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "sim_kernel.h"
+#include "sim_world.h"
+
+/// Everything known about one simulated pin
+struct sim_pin
+{
+    uint8_t mode;                            ///< INPUT, OUTPUT, INPUT_PULLUP or INPUT_PULLDOWN
+    uint8_t output;                          ///< Level written by digitalWrite()
+    bool driven;                             ///< Whether something outside the MCU drives the pin
+    uint8_t external;                        ///< Level driven from outside
+    int pwm;                                 ///< Duty written by analogWrite()
+    void (*p_isr) (void);                    ///< Attached interrupt, if any
+    uint32_t isr_mode;                       ///< RISING, FALLING or CHANGE
+};
+
+static sim_pin pins[SIM_NUM_PINS];           ///< All pins, zeroed at startup
+static std::function<void (uint8_t)> serial_sink;
+static std::deque<uint8_t> serial_input;     ///< Bytes waiting to be read from Serial
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+
+/** @brief   Level the MCU would read on a pin right now.
+ */
+static int pin_level (const sim_pin& pin)
+{
+    if (pin.mode == OUTPUT)
+    {
+        return pin.output;
+    }
+    if (pin.driven)
+    {
+        return pin.external;
+    }
+    return pin.mode == INPUT_PULLUP ? HIGH : LOW;
+}
+
+
+/** @brief   Runs a pin's interrupt if a level change matches its edge.
+ */
+static void check_edge (sim_pin& pin, int before)
+{
+    int after = pin_level (pin);
+    if (pin.p_isr == NULL || before == after)
+    {
+        return;
+    }
+    if (pin.isr_mode == CHANGE
+        || (pin.isr_mode == RISING && after == HIGH)
+        || (pin.isr_mode == FALLING && after == LOW))
+    {
+        pin.p_isr ();
+    }
+}
+
+
+void pinMode (uint32_t pin, uint32_t mode)
+{
+    if (pin < SIM_NUM_PINS)
+    {
+        pins[pin].mode = (uint8_t)mode;
+    }
+}
+
+
+void digitalWrite (uint32_t pin, uint32_t value)
+{
+    if (pin < SIM_NUM_PINS)
+    {
+        pins[pin].output = value ? HIGH : LOW;
+    }
+}
+
+
+int digitalRead (uint32_t pin)
+{
+    return pin < SIM_NUM_PINS ? pin_level (pins[pin]) : LOW;
+}
+
+
+void analogWrite (uint32_t pin, int value)
+{
+    if (pin < SIM_NUM_PINS)
+    {
+        pins[pin].pwm = value;
+    }
+}
+
+
+void attachInterrupt (uint32_t interrupt_num, void (*callback) (void), uint32_t mode)
+{
+    if (interrupt_num < SIM_NUM_PINS)
+    {
+        pins[interrupt_num].p_isr = callback;
+        pins[interrupt_num].isr_mode = mode;
+    }
+}
+
+
+void detachInterrupt (uint32_t interrupt_num)
+{
+    if (interrupt_num < SIM_NUM_PINS)
+    {
+        pins[interrupt_num].p_isr = NULL;
+    }
+}
+
+
+void sim_pin_drive (uint32_t pin, int level)
+{
+    int before = pin_level (pins[pin]);
+    pins[pin].driven = true;
+    pins[pin].external = level ? HIGH : LOW;
+    check_edge (pins[pin], before);
+}
+
+
+void sim_pin_release (uint32_t pin)
+{
+    int before = pin_level (pins[pin]);
+    pins[pin].driven = false;
+    check_edge (pins[pin], before);
+}
+
+
+int sim_pin_output (uint32_t pin)
+{
+    return pins[pin].mode == OUTPUT ? pins[pin].output : LOW;
+}
+
+
+int sim_pin_pwm (uint32_t pin)
+{
+    return pins[pin].pwm;
+}
+
+
+uint32_t millis (void)
+{
+    return (uint32_t)(sim_now_us () / 1000);
+}
+
+
+uint32_t micros (void)
+{
+    return (uint32_t)sim_now_us ();
+}
+
+
+void delay (uint32_t ms)
+{
+    // Inside a task the STM32 core's delay() sleeps through the RTOS; before
+    // the tasks exist it lets the hardware run for that long
+    if (sim_in_task ())
+    {
+        vTaskDelay (pdMS_TO_TICKS (ms));
+    }
+    else
+    {
+        sim_run_for_us ((uint64_t)ms * 1000);
+    }
+}
+
+
+void delayMicroseconds (uint32_t us)
+{
+    // A busy wait, so in a task it takes the processor for that long; before the
+    //     scheduler starts it takes no virtual time
+    if (sim_in_task ())
+    {
+        sim_cpu_us (us);
+    }
+}
+
+
+size_t Print::write (const uint8_t* p_buffer, size_t size)
+{
+    size_t count = 0;
+    while (size--)
+    {
+        count += write (*p_buffer++);
+    }
+    return count;
+}
+
+
+size_t Print::print (long value, int base)
+{
+    if (base == DEC && value < 0)
+    {
+        return print ('-') + print ((unsigned long)(-value), base);
+    }
+    return print ((unsigned long)value, base);
+}
+
+
+size_t Print::print (unsigned long value, int base)
+{
+    char buffer[8 * sizeof (long) + 1];
+    char* p_char = &buffer[sizeof (buffer) - 1];
+    *p_char = '\0';
+    if (base < 2)
+    {
+        base = DEC;
+    }
+    do
+    {
+        unsigned long digit = value % base;
+        *--p_char = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value);
+    return write (p_char);
+}
+
+
+size_t Print::print (double value, int digits)
+{
+    char buffer[48];
+    snprintf (buffer, sizeof (buffer), "%.*f", digits, value);
+    return write (buffer);
+}
+
+
+size_t HardwareSerial::write (uint8_t c)
+{
+    if (serial_sink)
+    {
+        serial_sink (c);
+    }
+    else
+    {
+        fputc (c, stdout);
+    }
+    return 1;
+}
+
+
+void sim_serial_sink (std::function<void (uint8_t)> sink)
+{
+    serial_sink = sink;
+}
+
+
+int HardwareSerial::available (void)
+{
+    return (int)serial_input.size ();
+}
+
+
+int HardwareSerial::read (void)
+{
+    if (serial_input.empty ())
+    {
+        return -1;
+    }
+    uint8_t c = serial_input.front ();
+    serial_input.pop_front ();
+    return c;
+}
+
+
+void sim_serial_input (const char* p_text)
+{
+    while (*p_text != '\0')
+    {
+        serial_input.push_back ((uint8_t)*p_text++);
+    }
+}
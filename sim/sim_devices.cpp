@@ -0,0 +1,519 @@
+/** @file sim_devices.cpp
+ *  Simulated versions of the SparkFun TB6612 and Adafruit AMG88xx libraries,
+ *  and a mock of the I2C bus behind the HAL's interrupt-driven transfers.
+ *  The Motor class is a pin-for-pin copy of the real library so the
+ *  H-bridge model sees the same levels; the camera driver reads and writes
+ *  the register state of the simulated sensor in sim_world.cpp, and so
+ *  does the bus mock, through a map of the sensor's registers.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "SparkFun_TB6612.h"
+#include "Adafruit_AMG88xx.h"
+#include "sim_kernel.h"
+#include "sim_world.h"
+
+/// CPU time the Wire library spends setting up each transaction, in microseconds
+const uint32_t I2C_TRANSACTION_OVERHEAD_US = 15;
+/// Largest transfer the Wire library's buffer allows; longer reads are split
+const uint8_t I2C_BUFFER_BYTES = 32;
+
+// ----------------------------------------------------------------------------
+// SparkFun_TB6612
+
+Motor::Motor (int In1pin, int In2pin, int PWMpin, int offset, int STBYpin)
+{
+    In1 = In1pin;
+    In2 = In2pin;
+    PWM = PWMpin;
+    Standby = STBYpin;
+    Offset = offset;
+
+    pinMode (In1, OUTPUT);
+    pinMode (In2, OUTPUT);
+    pinMode (PWM, OUTPUT);
+    pinMode (Standby, OUTPUT);
+}
+
+
+void Motor::drive (int speed)
+{
+    sim_motor_drive_hook (PWM, speed);
+
+    digitalWrite (Standby, HIGH);
+    speed = speed * Offset;
+    if (speed >= 0)
+    {
+        fwd (speed);
+    }
+    else
+    {
+        rev (-speed);
+    }
+}
+
+
+void Motor::drive (int speed, int duration)
+{
+    drive (speed);
+    delay (duration);
+}
+
+
+void Motor::fwd (int speed)
+{
+    digitalWrite (In1, HIGH);
+    digitalWrite (In2, LOW);
+    analogWrite (PWM, speed);
+}
+
+
+void Motor::rev (int speed)
+{
+    digitalWrite (In1, LOW);
+    digitalWrite (In2, HIGH);
+    analogWrite (PWM, speed);
+}
+
+
+void Motor::brake (void)
+{
+    digitalWrite (In1, HIGH);
+    digitalWrite (In2, HIGH);
+    analogWrite (PWM, 0);
+}
+
+
+void Motor::standby (void)
+{
+    digitalWrite (Standby, LOW);
+}
+
+
+void forward (Motor motor1, Motor motor2, int speed)
+{
+    motor1.drive (speed);
+    motor2.drive (speed);
+}
+
+
+void forward (Motor motor1, Motor motor2)
+{
+    forward (motor1, motor2, DEFAULTSPEED);
+}
+
+
+void back (Motor motor1, Motor motor2, int speed)
+{
+    int temp = abs (speed);
+    motor1.drive (-temp);
+    motor2.drive (-temp);
+}
+
+
+void back (Motor motor1, Motor motor2)
+{
+    back (motor1, motor2, DEFAULTSPEED);
+}
+
+
+void left (Motor left, Motor right, int speed)
+{
+    int temp = abs (speed) / 2;
+    left.drive (-temp);
+    right.drive (temp);
+}
+
+
+void right (Motor left, Motor right, int speed)
+{
+    int temp = abs (speed) / 2;
+    left.drive (temp);
+    right.drive (-temp);
+}
+
+
+void brake (Motor motor1, Motor motor2)
+{
+    motor1.brake ();
+    motor2.brake ();
+}
+
+
+// ----------------------------------------------------------------------------
+// Adafruit_AMG88xx
+
+/** @brief   Spends the time of a blocking write of @c count register bytes.
+ *  @details Address, register pointer and data at nine clocks a byte, plus
+ *           start and stop conditions.
+ */
+void Adafruit_AMG88xx::write_register (uint8_t count)
+{
+    uint32_t bits = 9 * (2 + count) + 2;
+    sim_cpu_us (I2C_TRANSACTION_OVERHEAD_US + bits * 1000000 / p_wire->getClock ());
+}
+
+
+/** @brief   Spends the time of a blocking read of @c count register bytes.
+ *  @details Each chunk is a register pointer write followed by a repeated
+ *           start and the read itself.
+ */
+void Adafruit_AMG88xx::read_registers (uint8_t count)
+{
+    while (count > 0)
+    {
+        uint8_t chunk = count < I2C_BUFFER_BYTES ? count : I2C_BUFFER_BYTES;
+        uint32_t bits = 9 * 2 + 9 * (1 + chunk) + 3;
+        sim_cpu_us (I2C_TRANSACTION_OVERHEAD_US + bits * 1000000 / p_wire->getClock ());
+        count -= chunk;
+    }
+}
+
+
+bool Adafruit_AMG88xx::begin (uint8_t addr, TwoWire* theWire)
+{
+    address = addr;
+    p_wire = theWire;
+    p_wire->begin ();
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg == NULL)
+    {
+        // The address byte isn't acknowledged
+        write_register (0);
+        return false;
+    }
+    // Normal mode, software reset, interrupts off, 10 fps, then let the part settle
+    write_register (1);
+    write_register (1);
+    write_register (1);
+    write_register (1);
+    p_amg->int_enabled = false;
+    p_amg->int_mode = AMG88xx_DIFFERENCE;
+    memset (p_amg->int_table, 0, sizeof (p_amg->int_table));
+    delay (100);
+    return true;
+}
+
+
+void Adafruit_AMG88xx::readPixels (float* buf, uint8_t size)
+{
+    read_registers (2 * (size < AMG88xx_PIXEL_ARRAY_SIZE ? size : AMG88xx_PIXEL_ARRAY_SIZE));
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    for (uint8_t i = 0; i < size && i < AMG88xx_PIXEL_ARRAY_SIZE; i++)
+    {
+        buf[i] = p_amg != NULL ? p_amg->pixels[i] * (float)AMG88xx_PIXEL_TEMP_CONVERSION : 0.0f;
+    }
+}
+
+
+float Adafruit_AMG88xx::readThermistor (void)
+{
+    read_registers (2);
+    // The board sits at room temperature in the simulation
+    return 22.0f;
+}
+
+
+void Adafruit_AMG88xx::setMovingAverageMode (bool mode)
+{
+    (void)mode;
+}
+
+
+void Adafruit_AMG88xx::enableInterrupt (void)
+{
+    write_register (1);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg != NULL)
+    {
+        p_amg->int_enabled = true;
+    }
+}
+
+
+void Adafruit_AMG88xx::disableInterrupt (void)
+{
+    write_register (1);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg != NULL)
+    {
+        p_amg->int_enabled = false;
+    }
+}
+
+
+void Adafruit_AMG88xx::setInterruptMode (uint8_t mode)
+{
+    write_register (1);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg != NULL)
+    {
+        p_amg->int_mode = mode;
+    }
+}
+
+
+void Adafruit_AMG88xx::getInterrupt (uint8_t* buf, uint8_t size)
+{
+    read_registers (size < 8 ? size : 8);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    for (uint8_t i = 0; i < size && i < 8; i++)
+    {
+        buf[i] = p_amg != NULL ? p_amg->int_table[i] : 0;
+    }
+}
+
+
+void Adafruit_AMG88xx::clearInterrupt (void)
+{
+    write_register (1);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg != NULL)
+    {
+        memset (p_amg->int_table, 0, sizeof (p_amg->int_table));
+        if (p_amg->int_asserted)
+        {
+            p_amg->int_asserted = false;
+            sim_pin_drive (p_amg->int_pin, HIGH);
+        }
+    }
+}
+
+
+void Adafruit_AMG88xx::setInterruptLevels (float high, float low)
+{
+    setInterruptLevels (high, low, high * .95f);
+}
+
+
+void Adafruit_AMG88xx::setInterruptLevels (float high, float low, float hysteresis)
+{
+    (void)hysteresis;
+    // Two bytes each for the upper, lower and hysteresis levels
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        write_register (1);
+    }
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    if (p_amg != NULL)
+    {
+        p_amg->int_high_c = high;
+        p_amg->int_low_c = low;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// Registers of the AMG88xx, for the bus mock
+
+/** @brief   Reads registers of a simulated camera the way the part answers a burst read.
+ *  @details The pixels and the thermistor are 12 bit values, low byte first;
+ *           registers the simulation doesn't keep read as zero.
+ */
+static void amg_read (const sim_amg88xx& amg, uint8_t reg, uint8_t* p_data, uint16_t bytes)
+{
+    for (uint16_t index = 0; index < bytes; index++, reg++)
+    {
+        uint8_t value = 0;
+        if (reg >= 0x80)
+        {
+            uint16_t pixel = (uint16_t)amg.pixels[(reg - 0x80) / 2] & 0x0FFF;
+            value = (reg & 1) ? (uint8_t)(pixel >> 8) : (uint8_t)pixel;
+        }
+        else if (reg >= 0x10 && reg < 0x18)
+        {
+            value = amg.int_table[reg - 0x10];
+        }
+        else if (reg == 0x03)
+        {
+            value = (amg.int_enabled ? 0x01 : 0) | (amg.int_mode ? 0x02 : 0);
+        }
+        else if (reg == 0x0E || reg == 0x0F)
+        {
+            // The board sits at room temperature, 22 C in 0.0625 degree counts
+            value = reg == 0x0E ? (uint8_t)(22 * 16) : (uint8_t)((22 * 16) >> 8);
+        }
+        p_data[index] = value;
+    }
+}
+
+
+/** @brief   Returns a 12 bit temperature register pair in degrees C at 0.25 degrees per count.
+ */
+static float amg_level (const uint8_t* p_low)
+{
+    int16_t counts = (int16_t)((uint16_t)(p_low[0] | (p_low[1] << 8)) << 4) >> 4;
+    return counts * 0.25f;
+}
+
+
+/** @brief   Writes registers of a simulated camera the way the part takes a burst write.
+ */
+static void amg_write (sim_amg88xx& amg, uint8_t reg, const uint8_t* p_data, uint16_t bytes)
+{
+    // The upper and lower levels as they are now, for a write which changes only some bytes
+    int16_t high = (int16_t)lroundf (amg.int_high_c * 4.0f);
+    int16_t low = (int16_t)lroundf (amg.int_low_c * 4.0f);
+    uint8_t levels[6] = { (uint8_t)high, (uint8_t)((high >> 8) & 0x0F), (uint8_t)low, (uint8_t)((low >> 8) & 0x0F), 0, 0 };
+    bool levels_written = false;
+    for (uint16_t index = 0; index < bytes; index++, reg++)
+    {
+        uint8_t value = p_data[index];
+        if (reg == 0x01 && (value == 0x3F || value == 0x30))
+        {
+            // Initial reset also turns the interrupt off; flag reset only clears the table
+            if (value == 0x3F)
+            {
+                amg.int_enabled = false;
+                amg.int_mode = AMG88xx_DIFFERENCE;
+            }
+            memset (amg.int_table, 0, sizeof (amg.int_table));
+            if (amg.int_asserted)
+            {
+                amg.int_asserted = false;
+                sim_pin_drive (amg.int_pin, HIGH);
+            }
+        }
+        else if (reg == 0x03)
+        {
+            amg.int_enabled = (value & 0x01) != 0;
+            amg.int_mode = (value & 0x02) ? AMG88xx_ABSOLUTE_VALUE : AMG88xx_DIFFERENCE;
+        }
+        else if (reg >= 0x08 && reg < 0x0E)
+        {
+            levels[reg - 0x08] = value;
+            levels_written = true;
+        }
+    }
+    if (levels_written)
+    {
+        amg.int_high_c = amg_level (&levels[0]);
+        amg.int_low_c = amg_level (&levels[2]);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// HAL I2C transfers
+
+/// CPU time the HAL spends setting up an interrupt-driven transfer, in microseconds
+const uint32_t I2C_IT_SETUP_US = 15;
+
+/// Priority the STM32 Wire library gives the I2C interrupts unless I2C_IRQ_PRIO is defined
+const uint32_t I2C_WIRE_IRQ_PRIO = 2;
+
+I2C_TypeDef sim_i2c1 = { { I2C_WIRE_IRQ_PRIO, I2C_WIRE_IRQ_PRIO } };
+
+/** @brief   Runs one memory read or write on the mock bus, ending in a callback from interrupt context.
+ *  @details The transfer takes a start, the address and register bytes, a
+ *           repeated start and the address again for a read, the data at
+ *           nine clocks a byte, and a stop. A camera which isn't wired at
+ *           the address leaves the address byte unacknowledged and the
+ *           transfer ends there with an error. The data is copied when the
+ *           transfer ends, as the last byte is when a real transfer does.
+ */
+static HAL_StatusTypeDef i2c_start (I2C_HandleTypeDef* hi2c, bool read, uint16_t DevAddress,
+                                    uint16_t MemAddress, uint8_t* pData, uint16_t Size)
+{
+    if (hi2c->State != HAL_I2C_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+    for (uint32_t priority : hi2c->Instance->priority)
+    {
+        if (priority < configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY)
+        {
+            fprintf (stderr, "I2C interrupt at NVIC priority %u may not call FreeRTOS\n", (unsigned)priority);
+            abort ();
+        }
+    }
+    hi2c->State = read ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    uint32_t transfer = ++hi2c->transfer;
+    sim_cpu_us (I2C_IT_SETUP_US);
+
+    uint8_t address = (uint8_t)(DevAddress >> 1);
+    sim_amg88xx* p_amg = sim_world_amg (address);
+    uint32_t bits = p_amg == NULL ? 9 + 2 : 9 * (2 + Size) + 2 + (read ? 9 + 1 : 0);
+    uint64_t end_us = sim_now_us () + (uint64_t)bits * 1000000 / hi2c->p_wire->getClock ();
+    sim_at_us (end_us, [hi2c, transfer, read, p_amg, MemAddress, pData, Size] ()
+    {
+        if (hi2c->transfer != transfer || hi2c->State == HAL_I2C_STATE_READY)
+        {
+            return;
+        }
+        hi2c->State = HAL_I2C_STATE_READY;
+        if (p_amg == NULL)
+        {
+            hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+            HAL_I2C_ErrorCallback (hi2c);
+        }
+        else if (read)
+        {
+            amg_read (*p_amg, (uint8_t)MemAddress, pData, Size);
+            HAL_I2C_MemRxCpltCallback (hi2c);
+        }
+        else
+        {
+            amg_write (*p_amg, (uint8_t)MemAddress, pData, Size);
+            HAL_I2C_MemTxCpltCallback (hi2c);
+        }
+    });
+    return HAL_OK;
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t* pData, uint16_t Size)
+{
+    (void)MemAddSize;
+    return i2c_start (hi2c, true, DevAddress, MemAddress, pData, Size);
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t* pData, uint16_t Size)
+{
+    (void)MemAddSize;
+    return i2c_start (hi2c, false, DevAddress, MemAddress, pData, Size);
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Master_Abort_IT (I2C_HandleTypeDef* hi2c, uint16_t DevAddress)
+{
+    (void)DevAddress;
+    if (hi2c->State == HAL_I2C_STATE_READY)
+    {
+        return HAL_ERROR;
+    }
+    hi2c->transfer++;
+    hi2c->State = HAL_I2C_STATE_READY;
+    return HAL_OK;
+}
+
+
+uint32_t HAL_I2C_GetError (I2C_HandleTypeDef* hi2c)
+{
+    return hi2c->ErrorCode;
+}
+
+
+void HAL_NVIC_SetPriority (IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)SubPriority;
+    sim_i2c1.priority[IRQn == I2C1_ER_IRQn] = PreemptPriority;
+}
+
+
+// The HAL's own callbacks do nothing; a driver which uses the transfers replaces them
+extern "C" __attribute__ ((weak)) void HAL_I2C_MemRxCpltCallback (I2C_HandleTypeDef* hi2c) { (void)hi2c; }
+extern "C" __attribute__ ((weak)) void HAL_I2C_MemTxCpltCallback (I2C_HandleTypeDef* hi2c) { (void)hi2c; }
+
+// The Wire library's error callback only restarts listening in slave mode
+extern "C" void HAL_I2C_ErrorCallback (I2C_HandleTypeDef* hi2c) { (void)hi2c; }
@@ -0,0 +1,993 @@
+/** @file sim_kernel.cpp
+ *  Virtual-time implementation of the FreeRTOS task and queue API for the
+ *  host simulation. Each task gets its own stack and ucontext. The scheduler
+ *  loop runs due events first, then the highest priority ready task until it
+ *  blocks, and otherwise jumps virtual time forward to the next event or
+ *  task wake-up. Ties between tasks of equal priority are broken by the order
+ *  in which they became ready, so a run never depends on host timing.
+ *
+ *  With more than one core (see sim_set_cores()) each core runs the highest
+ *  priority ready task it may run, and time spent computing in
+ *  sim_cpu_us() passes on every core at once, so a task pinned to one core
+ *  is never held up by a busy task on the other.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <ucontext.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <queue>
+#include <vector>
+
+// The kernel is built for as many cores as it can model; sim_set_cores() says how many a run uses
+#define portNUM_PROCESSORS  2
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "sim_kernel.h"
+
+/// Host stack given to every simulated task; host frames are far larger than on the target
+const size_t SIM_HOST_STACK_BYTES = 256 * 1024;
+
+/// Value host stacks are filled with, so that the deepest use can be found later
+const uint8_t SIM_STACK_FILL = 0xA5;
+
+/// Most cores the kernel can model, as many as the ESP32 has
+const uint8_t SIM_MAX_CORES = portNUM_PROCESSORS;
+
+/// What a simulated task is currently doing
+enum sim_task_state
+{
+    SIM_READY,                               ///< Runnable
+    SIM_DELAYED,                             ///< In vTaskDelay() or vTaskDelayUntil()
+    SIM_BLOCKED,                             ///< Waiting on a queue, possibly with a timeout
+    SIM_DELETED                              ///< Returned or deleted, never runs again
+};
+
+/// Which side of a queue a blocked task is waiting on
+enum sim_wait_kind
+{
+    SIM_WAIT_NONE,
+    SIM_WAIT_SEND,                           ///< Waiting for space
+    SIM_WAIT_RECEIVE,                        ///< Waiting for an item
+    SIM_WAIT_NOTIFY                          ///< Waiting for a direct task notification
+};
+
+/// Simulated task control block
+struct sim_tcb
+{
+    TaskFunction_t function;                 ///< Task function
+    void* p_params;                          ///< Parameter handed to the task function
+    const char* name;                        ///< Task name for printouts
+    UBaseType_t priority;                    ///< Fixed priority, higher runs first
+    BaseType_t affinity;                     ///< Core the task is pinned to, or tskNO_AFFINITY
+    uint8_t core;                            ///< Core the task last ran on
+    uint32_t stack_depth;                    ///< Stack size requested by the firmware, in words
+    uint8_t* p_stack;                        ///< Host stack
+    ucontext_t context;                      ///< Saved registers while not running
+    sim_task_state state;                    ///< Scheduling state
+    uint64_t wake_us;                        ///< Virtual time at which a delay or timeout ends
+    uint64_t ready_seq;                      ///< Order in which the task last became ready
+    sim_queue* p_wait_queue;                 ///< Queue the task is blocked on, if any
+    sim_wait_kind wait_kind;                 ///< Which side of the queue it waits for
+    bool timed_out;                          ///< Set when a blocking call ran out of time
+    uint64_t busy_left_us;                   ///< CPU time still owed to a sim_cpu_us() call
+    uint32_t notify_value;                   ///< Direct-to-task notification value
+    bool notify_pending;                     ///< A notification arrived and hasn't been taken
+};
+
+/// Simulated queue: a ring of fixed-size items copied by value
+struct sim_queue
+{
+    UBaseType_t length;                      ///< Maximum number of items
+    UBaseType_t item_size;                   ///< Size of one item in bytes
+    UBaseType_t head;                        ///< Index of the oldest item
+    UBaseType_t count;                       ///< Number of items held
+    uint8_t* p_storage;                      ///< length * item_size bytes
+    bool caller_storage;                     ///< p_storage belongs to whoever made the queue
+};
+
+/// A timed callback run in interrupt context
+struct sim_event
+{
+    uint64_t t_us;                           ///< When it is due
+    uint64_t seq;                            ///< Tie breaker, first scheduled runs first
+    std::function<void (void)> fn;           ///< What to do
+
+    bool operator> (const sim_event& other) const
+    {
+        return t_us != other.t_us ? t_us > other.t_us : seq > other.seq;
+    }
+};
+
+static uint64_t now_us = 0;                  ///< Virtual time
+static uint64_t next_seq = 0;                ///< Source of ordering numbers
+static uint32_t context_switches = 0;        ///< Switches between different tasks
+static std::vector<sim_tcb*> tasks;          ///< Every task ever created
+static sim_tcb* p_current = NULL;            ///< Running task, NULL in the scheduler
+static uint8_t cores = 1;                    ///< Cores tasks are shared out over
+static sim_tcb* p_last_run[SIM_MAX_CORES];   ///< Task which ran most recently on each core
+static ucontext_t scheduler_context;         ///< Where tasks return to when they block
+static std::priority_queue<sim_event, std::vector<sim_event>, std::greater<sim_event> > events;
+
+
+/** @brief   Entry point of every task's ucontext.
+ *  @details Calls the task function and, should it ever return, retires the
+ *           task the way vTaskDelete(NULL) would.
+ */
+static void task_trampoline (void)
+{
+    p_current->function (p_current->p_params);
+    vTaskDelete (NULL);
+}
+
+
+/** @brief   Hands the CPU from the running task back to the scheduler loop.
+ */
+static void switch_to_scheduler (void)
+{
+    sim_tcb* p_self = p_current;
+    swapcontext (&(p_self->context), &scheduler_context);
+}
+
+
+/** @brief   Marks a task runnable at the back of its priority level.
+ */
+static void make_ready (sim_tcb* p_task)
+{
+    p_task->state = SIM_READY;
+    p_task->p_wait_queue = NULL;
+    p_task->wait_kind = SIM_WAIT_NONE;
+    p_task->ready_seq = next_seq++;
+}
+
+
+/** @brief   Finds the task that FreeRTOS would run next on a core.
+ *  @param   core The core
+ *  @param   p_taken A task another core has already chosen, which this one can't run
+ *  @return  The highest priority ready task the core may run, or NULL if none is ready
+ */
+static sim_tcb* highest_ready (uint8_t core, const sim_tcb* p_taken = NULL)
+{
+    sim_tcb* p_best = NULL;
+    for (sim_tcb* p_task : tasks)
+    {
+        if (p_task->state != SIM_READY || p_task == p_taken
+            || (p_task->affinity != tskNO_AFFINITY && p_task->affinity != core))
+        {
+            continue;
+        }
+        if (p_best == NULL || p_task->priority > p_best->priority
+            || (p_task->priority == p_best->priority && p_task->ready_seq < p_best->ready_seq))
+        {
+            p_best = p_task;
+        }
+    }
+    return p_best;
+}
+
+
+/** @brief   Lets a newly readied higher priority task preempt the running one.
+ *  @details Called by task-level kernel calls after they unblock another task.
+ *           The caller stays ready and keeps its place in line. A task readied
+ *           on another core doesn't preempt the caller; it runs at the same
+ *           virtual time once the caller blocks or computes.
+ */
+static void preempt_if_needed (void)
+{
+    if (p_current == NULL)
+    {
+        return;
+    }
+    sim_tcb* p_best = highest_ready (p_current->core);
+    if (p_best != NULL && p_best->priority > p_current->priority)
+    {
+        switch_to_scheduler ();
+    }
+}
+
+
+/** @brief   Converts a relative timeout in ticks to an absolute wake time.
+ */
+static uint64_t deadline_after (TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return UINT64_MAX;
+    }
+    return (now_us / 1000 + (uint64_t)ticks) * 1000;
+}
+
+
+/** @brief   Wakes the longest-waiting, highest priority task blocked on a queue.
+ *  @return  True if the woken task outranks the running task
+ */
+static bool wake_one_waiter (sim_queue* p_queue, sim_wait_kind kind)
+{
+    sim_tcb* p_best = NULL;
+    for (sim_tcb* p_task : tasks)
+    {
+        if (p_task->state == SIM_BLOCKED && p_task->p_wait_queue == p_queue && p_task->wait_kind == kind)
+        {
+            if (p_best == NULL || p_task->priority > p_best->priority
+                || (p_task->priority == p_best->priority && p_task->ready_seq < p_best->ready_seq))
+            {
+                p_best = p_task;
+            }
+        }
+    }
+    if (p_best == NULL)
+    {
+        return false;
+    }
+    make_ready (p_best);
+    return p_current == NULL || p_best->priority > p_current->priority;
+}
+
+
+/** @brief   Blocks the running task on a queue, or on its notification if
+ *           @c p_queue is NULL, until woken or timed out.
+ *  @return  False if the wait ended because the timeout expired
+ */
+static bool block_on (sim_queue* p_queue, sim_wait_kind kind, uint64_t deadline)
+{
+    p_current->state = SIM_BLOCKED;
+    p_current->p_wait_queue = p_queue;
+    p_current->wait_kind = kind;
+    p_current->wake_us = deadline;
+    p_current->timed_out = false;
+    p_current->ready_seq = next_seq++;
+    switch_to_scheduler ();
+    return !p_current->timed_out;
+}
+
+
+// ----------------------------------------------------------------------------
+// Simulation control
+
+uint64_t sim_now_us (void)
+{
+    return now_us;
+}
+
+
+void sim_at_us (uint64_t t_us, std::function<void (void)> fn)
+{
+    sim_event event;
+    event.t_us = t_us < now_us ? now_us : t_us;
+    event.seq = next_seq++;
+    event.fn = fn;
+    events.push (event);
+}
+
+
+void sim_cpu_us (uint32_t us)
+{
+    if (p_current == NULL)
+    {
+        sim_run_for_us (us);
+        return;
+    }
+    if (us > 0)
+    {
+        p_current->busy_left_us = us;
+        switch_to_scheduler ();
+    }
+}
+
+
+bool sim_in_task (void)
+{
+    return p_current != NULL;
+}
+
+
+uint32_t sim_context_switches (void)
+{
+    return context_switches;
+}
+
+
+void sim_set_cores (uint8_t count)
+{
+    cores = count < 1 ? 1 : (count > SIM_MAX_CORES ? SIM_MAX_CORES : count);
+}
+
+
+void sim_run_until_us (uint64_t t_us)
+{
+    for (;;)
+    {
+        // Interrupts first: anything due now runs before any task does
+        if (!events.empty () && events.top ().t_us <= now_us)
+        {
+            sim_event event = events.top ();
+            events.pop ();
+            event.fn ();
+            continue;
+        }
+
+        // Delays and timeouts which have run out make their tasks ready
+        uint64_t next_wake = UINT64_MAX;
+        for (sim_tcb* p_task : tasks)
+        {
+            if (p_task->state == SIM_DELAYED || p_task->state == SIM_BLOCKED)
+            {
+                if (p_task->wake_us <= now_us)
+                {
+                    p_task->timed_out = (p_task->state == SIM_BLOCKED);
+                    make_ready (p_task);
+                }
+                else if (p_task->wake_us < next_wake)
+                {
+                    next_wake = p_task->wake_us;
+                }
+            }
+        }
+
+        // Each core picks its task; the first which has code to run now runs it
+        sim_tcb* p_chosen[SIM_MAX_CORES] = { };
+        sim_tcb* p_next = NULL;
+        uint64_t busy_left = UINT64_MAX;
+        for (uint8_t core = 0; core < cores; core++)
+        {
+            p_chosen[core] = highest_ready (core, core > 0 ? p_chosen[0] : NULL);
+            if (p_chosen[core] == NULL)
+            {
+                continue;
+            }
+            if (p_chosen[core]->busy_left_us == 0 && p_next == NULL)
+            {
+                p_next = p_chosen[core];
+                p_next->core = core;
+            }
+            else if (p_chosen[core]->busy_left_us > 0 && p_chosen[core]->busy_left_us < busy_left)
+            {
+                busy_left = p_chosen[core]->busy_left_us;
+            }
+        }
+        uint64_t next_event = events.empty () ? UINT64_MAX : events.top ().t_us;
+        if (p_next != NULL)
+        {
+            if (p_next != p_last_run[p_next->core])
+            {
+                context_switches++;
+            }
+            p_current = p_next;
+            p_last_run[p_next->core] = p_next;
+            swapcontext (&scheduler_context, &(p_next->context));
+            p_current = NULL;
+            continue;
+        }
+        if (busy_left != UINT64_MAX)
+        {
+            // The tasks are computing; let time pass until one finishes or something
+            // else (an event or a timeout) might need a core
+            uint64_t until = now_us + busy_left;
+            until = next_wake < until ? next_wake : until;
+            until = next_event < until ? next_event : until;
+            if (until > t_us)
+            {
+                until = t_us > now_us ? t_us : now_us;
+            }
+            bool still_busy = false;
+            for (uint8_t core = 0; core < cores; core++)
+            {
+                if (p_chosen[core] != NULL && p_chosen[core]->busy_left_us > 0)
+                {
+                    p_chosen[core]->busy_left_us -= until - now_us;
+                    still_busy = still_busy || p_chosen[core]->busy_left_us > 0;
+                }
+            }
+            now_us = until;
+            if (now_us >= t_us && still_busy)
+            {
+                return;
+            }
+            continue;
+        }
+
+        // Nothing to run, so skip ahead to whatever happens next
+        uint64_t next = next_wake < next_event ? next_wake : next_event;
+        if (next > t_us)
+        {
+            now_us = t_us > now_us ? t_us : now_us;
+            return;
+        }
+        now_us = next;
+    }
+}
+
+
+void sim_run_for_us (uint64_t dt_us)
+{
+    sim_run_until_us (now_us + dt_us);
+}
+
+
+// ----------------------------------------------------------------------------
+// Tasks
+
+BaseType_t xTaskCreate (TaskFunction_t pxTaskCode, const char* pcName,
+                        uint32_t usStackDepth, void* pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t* pxCreatedTask)
+{
+    return xTaskCreatePinnedToCore (pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority,
+                                    pxCreatedTask, tskNO_AFFINITY);
+}
+
+
+/** @brief   Creates a task which only ever runs on one core.
+ *  @details A core the kernel hasn't been given with sim_set_cores() is taken
+ *           to be core 0, so that firmware built for two cores still runs
+ *           on one.
+ */
+BaseType_t xTaskCreatePinnedToCore (TaskFunction_t pxTaskCode, const char* pcName,
+                                    uint32_t usStackDepth, void* pvParameters,
+                                    UBaseType_t uxPriority, TaskHandle_t* pxCreatedTask, BaseType_t xCoreID)
+{
+    sim_tcb* p_task = new sim_tcb ();
+    p_task->function = pxTaskCode;
+    p_task->p_params = pvParameters;
+    p_task->name = pcName;
+    p_task->priority = uxPriority < configMAX_PRIORITIES ? uxPriority : configMAX_PRIORITIES - 1;
+    p_task->affinity = (xCoreID == tskNO_AFFINITY || xCoreID < cores) ? xCoreID : 0;
+    p_task->core = p_task->affinity == tskNO_AFFINITY ? 0 : (uint8_t)p_task->affinity;
+    p_task->stack_depth = usStackDepth;
+    p_task->p_stack = (uint8_t*)malloc (SIM_HOST_STACK_BYTES);
+    if (p_task->p_stack == NULL)
+    {
+        delete p_task;
+        return pdFAIL;
+    }
+    memset (p_task->p_stack, SIM_STACK_FILL, SIM_HOST_STACK_BYTES);
+
+    getcontext (&(p_task->context));
+    p_task->context.uc_stack.ss_sp = p_task->p_stack;
+    p_task->context.uc_stack.ss_size = SIM_HOST_STACK_BYTES;
+    p_task->context.uc_link = NULL;
+    makecontext (&(p_task->context), task_trampoline, 0);
+
+    make_ready (p_task);
+    tasks.push_back (p_task);
+    if (pxCreatedTask != NULL)
+    {
+        *pxCreatedTask = p_task;
+    }
+    preempt_if_needed ();
+    return pdPASS;
+}
+
+
+/** @brief   Creates a task whose stack and control block the caller provides.
+ *  @details The task still runs on a host stack, because host frames wouldn't fit
+ *           in the target-sized buffer; the buffers are only there so the
+ *           firmware's RAM use is laid out as it is on the target.
+ */
+TaskHandle_t xTaskCreateStatic (TaskFunction_t pxTaskCode, const char* pcName,
+                                uint32_t ulStackDepth, void* pvParameters, UBaseType_t uxPriority,
+                                StackType_t* puxStackBuffer, StaticTask_t* pxTaskBuffer)
+{
+    if (puxStackBuffer == NULL || pxTaskBuffer == NULL)
+    {
+        return NULL;
+    }
+    TaskHandle_t handle = NULL;
+    xTaskCreate (pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &handle);
+    return handle;
+}
+
+
+/** @brief   Creates a task in memory the caller provides which only ever runs on one core.
+ */
+TaskHandle_t xTaskCreateStaticPinnedToCore (TaskFunction_t pxTaskCode, const char* pcName,
+                                            uint32_t ulStackDepth, void* pvParameters, UBaseType_t uxPriority,
+                                            StackType_t* puxStackBuffer, StaticTask_t* pxTaskBuffer,
+                                            BaseType_t xCoreID)
+{
+    if (puxStackBuffer == NULL || pxTaskBuffer == NULL)
+    {
+        return NULL;
+    }
+    TaskHandle_t handle = NULL;
+    xTaskCreatePinnedToCore (pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &handle, xCoreID);
+    return handle;
+}
+
+
+BaseType_t xPortGetCoreID (void)
+{
+    return p_current != NULL ? p_current->core : 0;
+}
+
+
+void vTaskDelete (TaskHandle_t xTask)
+{
+    sim_tcb* p_task = (xTask == NULL) ? p_current : xTask;
+    p_task->state = SIM_DELETED;
+    if (p_task == p_current)
+    {
+        // The stack is still in use, so it is leaked rather than freed
+        switch_to_scheduler ();
+    }
+}
+
+
+void vTaskDelay (TickType_t xTicksToDelay)
+{
+    if (p_current == NULL)
+    {
+        return;
+    }
+    if (xTicksToDelay == 0)
+    {
+        vPortYield ();
+        return;
+    }
+    p_current->state = SIM_DELAYED;
+    p_current->wake_us = deadline_after (xTicksToDelay);
+    switch_to_scheduler ();
+}
+
+
+void vTaskDelayUntil (TickType_t* pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+    TickType_t now_tick = xTaskGetTickCount ();
+    TickType_t wake_tick = *pxPreviousWakeTime + xTimeIncrement;
+    *pxPreviousWakeTime = wake_tick;
+
+    // Like the real kernel, a wake time already in the past doesn't block
+    int32_t ticks_left = (int32_t)(wake_tick - now_tick);
+    if (ticks_left > 0 && p_current != NULL)
+    {
+        p_current->state = SIM_DELAYED;
+        p_current->wake_us = deadline_after ((TickType_t)ticks_left);
+        switch_to_scheduler ();
+    }
+}
+
+
+TickType_t xTaskGetTickCount (void)
+{
+    return (TickType_t)(now_us / 1000);
+}
+
+
+TickType_t xTaskGetTickCountFromISR (void)
+{
+    return xTaskGetTickCount ();
+}
+
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void)
+{
+    return p_current;
+}
+
+
+const char* pcTaskGetName (TaskHandle_t xTask)
+{
+    sim_tcb* p_task = (xTask == NULL) ? p_current : xTask;
+    return p_task != NULL ? p_task->name : "";
+}
+
+
+/** @brief   Least free stack a task has had, in words of the stack size it was created with.
+ *  @details The host stack was filled when the task was created, so the deepest
+ *           byte it has used is the first one from the bottom that changed.
+ *           Host stack frames are larger than the target's, so this is an
+ *           underestimate of what the target would have free.
+ */
+UBaseType_t uxTaskGetStackHighWaterMark (TaskHandle_t xTask)
+{
+    sim_tcb* p_task = (xTask == NULL) ? p_current : xTask;
+    if (p_task == NULL)
+    {
+        return 0;
+    }
+    size_t untouched = 0;
+    while (untouched < SIM_HOST_STACK_BYTES && p_task->p_stack[untouched] == SIM_STACK_FILL)
+    {
+        untouched++;
+    }
+    size_t used_words = (SIM_HOST_STACK_BYTES - untouched + sizeof (StackType_t) - 1) / sizeof (StackType_t);
+    return used_words < p_task->stack_depth ? p_task->stack_depth - used_words : 0;
+}
+
+
+void vTaskStartScheduler (void)
+{
+    sim_run_until_us (UINT64_MAX);
+}
+
+
+void vPortYield (void)
+{
+    if (p_current == NULL)
+    {
+        return;
+    }
+    make_ready (p_current);
+    switch_to_scheduler ();
+}
+
+
+/** @brief   Takes a multi-core critical section's spinlock, spinning while another host thread holds it.
+ *  @details Tasks in the virtual-time kernel never switch inside a critical
+ *           section, so there the lock is always free; it only spins when
+ *           firmware runs on real host threads.
+ */
+void vPortEnterCriticalSafe (portMUX_TYPE* mux)
+{
+    while (__atomic_exchange_n (&(mux->locked), 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+        while (__atomic_load_n (&(mux->locked), __ATOMIC_RELAXED) != 0)
+        {
+        }
+    }
+}
+
+
+void vPortExitCriticalSafe (portMUX_TYPE* mux)
+{
+    __atomic_store_n (&(mux->locked), 0u, __ATOMIC_RELEASE);
+}
+
+
+// ----------------------------------------------------------------------------
+// Queues
+
+QueueHandle_t xQueueCreate (UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    sim_queue* p_queue = new sim_queue ();
+    p_queue->length = uxQueueLength;
+    p_queue->item_size = uxItemSize;
+    p_queue->head = 0;
+    p_queue->count = 0;
+    p_queue->p_storage = new uint8_t[uxQueueLength * uxItemSize];
+    return p_queue;
+}
+
+
+/** @brief   Creates a queue which keeps its items in storage the caller provides.
+ *  @details The simulated control block still comes from the host heap.
+ */
+QueueHandle_t xQueueCreateStatic (UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                  uint8_t* pucQueueStorage, StaticQueue_t* pxQueueBuffer)
+{
+    if (pucQueueStorage == NULL || pxQueueBuffer == NULL)
+    {
+        return NULL;
+    }
+    sim_queue* p_queue = new sim_queue ();
+    p_queue->length = uxQueueLength;
+    p_queue->item_size = uxItemSize;
+    p_queue->head = 0;
+    p_queue->count = 0;
+    p_queue->p_storage = pucQueueStorage;
+    p_queue->caller_storage = true;
+    return p_queue;
+}
+
+
+void vQueueDelete (QueueHandle_t xQueue)
+{
+    if (!xQueue->caller_storage)
+    {
+        delete[] xQueue->p_storage;
+    }
+    delete xQueue;
+}
+
+
+/** @brief   Copies an item into a queue which is known to have space.
+ */
+static void copy_in (sim_queue* p_queue, const void* p_item, bool to_front)
+{
+    UBaseType_t slot;
+    if (to_front)
+    {
+        p_queue->head = (p_queue->head + p_queue->length - 1) % p_queue->length;
+        slot = p_queue->head;
+    }
+    else
+    {
+        slot = (p_queue->head + p_queue->count) % p_queue->length;
+    }
+    memcpy (p_queue->p_storage + slot * p_queue->item_size, p_item, p_queue->item_size);
+    p_queue->count++;
+}
+
+
+/** @brief   Copies the oldest item out of a non-empty queue, optionally removing it.
+ */
+static void copy_out (sim_queue* p_queue, void* p_buffer, bool remove)
+{
+    memcpy (p_buffer, p_queue->p_storage + p_queue->head * p_queue->item_size, p_queue->item_size);
+    if (remove)
+    {
+        p_queue->head = (p_queue->head + 1) % p_queue->length;
+        p_queue->count--;
+    }
+}
+
+
+/** @brief   Common body of the task-level send calls.
+ */
+static BaseType_t queue_send (sim_queue* p_queue, const void* p_item, TickType_t ticks, bool to_front)
+{
+    uint64_t deadline = deadline_after (ticks);
+    for (;;)
+    {
+        if (p_queue->count < p_queue->length)
+        {
+            copy_in (p_queue, p_item, to_front);
+            wake_one_waiter (p_queue, SIM_WAIT_RECEIVE);
+            preempt_if_needed ();
+            return pdPASS;
+        }
+        if (ticks == 0 || p_current == NULL || !block_on (p_queue, SIM_WAIT_SEND, deadline))
+        {
+            return errQUEUE_FULL;
+        }
+    }
+}
+
+
+/** @brief   Common body of the task-level receive and peek calls.
+ */
+static BaseType_t queue_receive (sim_queue* p_queue, void* p_buffer, TickType_t ticks, bool remove)
+{
+    uint64_t deadline = deadline_after (ticks);
+    for (;;)
+    {
+        if (p_queue->count > 0)
+        {
+            copy_out (p_queue, p_buffer, remove);
+            if (remove)
+            {
+                wake_one_waiter (p_queue, SIM_WAIT_SEND);
+            }
+            else
+            {
+                // A peek leaves the item in place for any other reader
+                wake_one_waiter (p_queue, SIM_WAIT_RECEIVE);
+            }
+            preempt_if_needed ();
+            return pdPASS;
+        }
+        if (ticks == 0 || p_current == NULL || !block_on (p_queue, SIM_WAIT_RECEIVE, deadline))
+        {
+            return errQUEUE_EMPTY;
+        }
+    }
+}
+
+
+BaseType_t xQueueSendToBack (QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait)
+{
+    return queue_send (xQueue, pvItemToQueue, xTicksToWait, false);
+}
+
+
+BaseType_t xQueueSendToFront (QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait)
+{
+    return queue_send (xQueue, pvItemToQueue, xTicksToWait, true);
+}
+
+
+BaseType_t xQueueOverwrite (QueueHandle_t xQueue, const void* pvItemToQueue)
+{
+    xQueue->count = 0;
+    return queue_send (xQueue, pvItemToQueue, 0, false);
+}
+
+
+BaseType_t xQueueReceive (QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait)
+{
+    return queue_receive (xQueue, pvBuffer, xTicksToWait, true);
+}
+
+
+BaseType_t xQueuePeek (QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait)
+{
+    return queue_receive (xQueue, pvBuffer, xTicksToWait, false);
+}
+
+
+BaseType_t xQueueSendToBackFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken)
+{
+    if (xQueue->count >= xQueue->length)
+    {
+        return errQUEUE_FULL;
+    }
+    copy_in (xQueue, pvItemToQueue, false);
+    bool woken = wake_one_waiter (xQueue, SIM_WAIT_RECEIVE);
+    if (pxHigherPriorityTaskWoken != NULL && woken)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+
+BaseType_t xQueueSendToFrontFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken)
+{
+    if (xQueue->count >= xQueue->length)
+    {
+        return errQUEUE_FULL;
+    }
+    copy_in (xQueue, pvItemToQueue, true);
+    bool woken = wake_one_waiter (xQueue, SIM_WAIT_RECEIVE);
+    if (pxHigherPriorityTaskWoken != NULL && woken)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+
+BaseType_t xQueueOverwriteFromISR (QueueHandle_t xQueue, const void* pvItemToQueue, BaseType_t* pxHigherPriorityTaskWoken)
+{
+    xQueue->count = 0;
+    return xQueueSendToBackFromISR (xQueue, pvItemToQueue, pxHigherPriorityTaskWoken);
+}
+
+
+BaseType_t xQueueReceiveFromISR (QueueHandle_t xQueue, void* pvBuffer, BaseType_t* pxHigherPriorityTaskWoken)
+{
+    if (xQueue->count == 0)
+    {
+        return errQUEUE_EMPTY;
+    }
+    copy_out (xQueue, pvBuffer, true);
+    bool woken = wake_one_waiter (xQueue, SIM_WAIT_SEND);
+    if (pxHigherPriorityTaskWoken != NULL && woken)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+
+BaseType_t xQueuePeekFromISR (QueueHandle_t xQueue, void* pvBuffer)
+{
+    if (xQueue->count == 0)
+    {
+        return errQUEUE_EMPTY;
+    }
+    copy_out (xQueue, pvBuffer, false);
+    return pdPASS;
+}
+
+
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t xQueue)
+{
+    return xQueue->count;
+}
+
+
+UBaseType_t uxQueueMessagesWaitingFromISR (QueueHandle_t xQueue)
+{
+    return xQueue->count;
+}
+
+
+UBaseType_t uxQueueSpacesAvailable (QueueHandle_t xQueue)
+{
+    return xQueue->length - xQueue->count;
+}
+
+
+// ----------------------------------------------------------------------------
+// Direct-to-task notifications
+
+/** @brief   Applies a notification to a task and wakes it if it is waiting for one.
+ *  @return  pdFAIL only for eSetValueWithoutOverwrite on a value not yet taken
+ */
+static BaseType_t notify (sim_tcb* p_task, uint32_t value, eNotifyAction action, bool* p_woken)
+{
+    *p_woken = false;
+    switch (action)
+    {
+        case eSetBits:
+            p_task->notify_value |= value;
+            break;
+        case eIncrement:
+            p_task->notify_value++;
+            break;
+        case eSetValueWithOverwrite:
+            p_task->notify_value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (p_task->notify_pending)
+            {
+                return pdFAIL;
+            }
+            p_task->notify_value = value;
+            break;
+        default:
+            break;
+    }
+    p_task->notify_pending = true;
+
+    if (p_task->state == SIM_BLOCKED && p_task->wait_kind == SIM_WAIT_NOTIFY)
+    {
+        make_ready (p_task);
+        *p_woken = p_current == NULL || p_task->priority > p_current->priority;
+    }
+    return pdPASS;
+}
+
+
+BaseType_t xTaskNotify (TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction)
+{
+    bool woken;
+    BaseType_t result = notify (xTaskToNotify, ulValue, eAction, &woken);
+    preempt_if_needed ();
+    return result;
+}
+
+
+BaseType_t xTaskNotifyFromISR (TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction,
+                               BaseType_t* pxHigherPriorityTaskWoken)
+{
+    bool woken;
+    BaseType_t result = notify (xTaskToNotify, ulValue, eAction, &woken);
+    if (pxHigherPriorityTaskWoken != NULL && woken)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return result;
+}
+
+
+void vTaskNotifyGiveFromISR (TaskHandle_t xTaskToNotify, BaseType_t* pxHigherPriorityTaskWoken)
+{
+    xTaskNotifyFromISR (xTaskToNotify, 0, eIncrement, pxHigherPriorityTaskWoken);
+}
+
+
+BaseType_t xTaskNotifyWait (uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                            uint32_t* pulNotificationValue, TickType_t xTicksToWait)
+{
+    if (!p_current->notify_pending)
+    {
+        p_current->notify_value &= ~ulBitsToClearOnEntry;
+        if (xTicksToWait > 0)
+        {
+            block_on (NULL, SIM_WAIT_NOTIFY, deadline_after (xTicksToWait));
+        }
+    }
+    if (pulNotificationValue != NULL)
+    {
+        *pulNotificationValue = p_current->notify_value;
+    }
+    if (!p_current->notify_pending)
+    {
+        return pdFALSE;
+    }
+    p_current->notify_value &= ~ulBitsToClearOnExit;
+    p_current->notify_pending = false;
+    return pdTRUE;
+}
+
+
+uint32_t ulTaskNotifyTake (BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    if (p_current->notify_value == 0 && xTicksToWait > 0)
+    {
+        block_on (NULL, SIM_WAIT_NOTIFY, deadline_after (xTicksToWait));
+    }
+    uint32_t value = p_current->notify_value;
+    if (value != 0)
+    {
+        p_current->notify_value = xClearCountOnExit ? 0 : value - 1;
+    }
+    p_current->notify_pending = false;
+    return value;
+}
@@ -0,0 +1,51 @@
+/** @file sim_kernel.h
+ *  Control interface of the virtual-time kernel behind the host simulation.
+ *  The kernel implements the FreeRTOS task and queue calls in task.h and
+ *  queue.h on top of ucontext coroutines. Only one task runs at a time on
+ *  the host and task code takes no virtual time, so a run is fully
+ *  deterministic and goes as fast as the host can execute it. Hardware
+ *  models schedule timed events which run in interrupt context between task
+ *  switches.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _SIM_KERNEL_H_
+#define _SIM_KERNEL_H_
+
+#include <stdint.h>
+#include <functional>
+
+/// Current virtual time in microseconds since the simulation started
+uint64_t sim_now_us (void);
+
+/// Schedules @c fn to run in interrupt context at virtual time @c t_us
+void sim_at_us (uint64_t t_us, std::function<void (void)> fn);
+
+/// Runs tasks and events until virtual time @c t_us has been reached
+void sim_run_until_us (uint64_t t_us);
+
+/// Runs tasks and events for @c dt_us microseconds of virtual time
+void sim_run_for_us (uint64_t dt_us);
+
+/** @brief   Makes the running task compute for @c us microseconds of virtual time.
+ *  @details The time counts as CPU time: higher priority tasks and events can
+ *           preempt it, and lower priority tasks don't run until it is done.
+ *           Device models use this for work such as blocking I2C transfers.
+ */
+void sim_cpu_us (uint32_t us);
+
+/// True while a simulated task (rather than an event or setup()) is running
+bool sim_in_task (void);
+
+/// Number of times the kernel has switched from one task to a different one
+uint32_t sim_context_switches (void);
+
+/** @brief   Sets how many cores the tasks are shared out over, 1 (the default) or 2.
+ *  @details Call before any task is made. Firmware built for the dual-core
+ *           ESP32 passes portNUM_PROCESSORS.
+ */
+void sim_set_cores (uint8_t count);
+
+#endif // _SIM_KERNEL_H_
@@ -0,0 +1,782 @@
+/** @file sim_main.cpp
+ *  Host simulation of FireBot. This program runs the unmodified firmware
+ *  (main.cpp and all five task files) against the simulated hardware in
+ *  virtual time, injects a hotspot in front of the thermal camera, and
+ *  reports how long the fire path took: from injection to the turntable
+ *  stopping with @c motor1.drive(0) and to the extinguisher starting to
+ *  clamp, plus the rest of the clamp and unclamp cycle. It
+ *  also reports when the turntable was last stopped before spraying, which
+ *  is when it finished aiming at the fire, and how far off the nozzle was.
+ *  Last comes each task's run-time statistics (see task_stats.h) over the
+ *  whole of every run.
+ *
+ *  Usage: firebot_sim [--runs N] [--seed S] [--inject-ms T] [--offset-deg D]
+ *                     [--offset-spread-deg W] [--temp-c C] [--radius-deg R] [--growth-c-per-s G]
+ *                     [--timeout-ms T] [--fires F] [--targets N] [--cameras C] [--serial]
+ *                     [--trace FILE] [--capture FILE] [--stream] [--cameras-ready-ms T]
+ *                     [--late-camera-ms T]
+ *
+ *  With @c --growth-c-per-s the hotspot starts at ambient temperature and
+ *  heats up at that rate until it reaches @c --temp-c, like a fire which is
+ *  still growing; the turntable stopping then measures the time to detect.
+ *
+ *  With @c --fires greater than one, each run puts out that many fires one
+ *  after another, a second after each cycle ends, so that the extinguisher
+ *  can learn its stroke timing (see stroke_profile.h); the milestones are
+ *  those of the first fire, and the clamp and unclamp cycle time and how
+ *  fast the carriage hit each switch are also given for the later fires.
+ *
+ *  With @c --targets greater than one, that many fires burn at once: the
+ *  first as usual and the rest at bearings drawn from the seed, spread
+ *  around the turntable at least MIN_TARGET_APART_DEG apart. The run goes
+ *  on until all of them are out, and the time that took and how far the
+ *  turntable turned on the way are reported. The aim error is then to
+ *  whichever fire the nozzle was nearest.
+ *
+ *  @c --cameras sets how many thermal cameras answer on the bus, the front
+ *  one first, so that running with fewer than the firmware expects can be
+ *  tried. Each camera's frame rate and share of the bus are reported.
+ *
+ *  The time from power-up to the firmware being armed (see boot.h) is
+ *  reported for every run. @c --cameras-ready-ms keeps the cameras from
+ *  answering for that long after power-up, as after a power blip, so that
+ *  the firmware's retries can be seen to pick them up. @c --late-camera-ms
+ *  does the same for the last camera alone, which comes up after FireBot
+ *  has been armed with the others and must then join them.
+ *
+ *  With @c --runs greater than one, each run is done in a fresh child
+ *  process so that no firmware state carries over, and the injection time
+ *  and camera frame phase are drawn from the seed so that the runs sample
+ *  every alignment of hotspot, frame clock and task periods. The hotspot's
+ *  bearing is also spread over @c --offset-spread-deg beyond @c --offset-deg.
+ *  @c --trace saves what the firmware wrote to the serial port, which is
+ *  mostly the binary trace log, for trace_decode; with several runs the
+ *  file holds the last one. With @c --trace or @c --serial, the firmware is
+ *  also sent an 's' after the fire cycle so that its own statistics report
+ *  appears in the output.
+ *
+ *  @c --capture asks the firmware for a capture (see capture.h) from the
+ *  start of the run, by sending it an 'r' as it starts and another after
+ *  the fire cycle, and saves what it sent like @c --trace does, so that
+ *  replay_main.cpp can play the run back.
+ *
+ *  @c --stream starts the live frame stream (see frame_stream.h) as the
+ *  run starts, by sending the firmware an 'f', so that the file saved with
+ *  @c --trace holds every camera frame for frame_receive.cpp to rebuild.
+ *
+ *  The switch1 -> reversal and switch2 -> stop rows are the time the firmware
+ *  takes to act on a limit switch. With interrupt-driven switches they come
+ *  out as zero, as nothing here charges time for the interrupt, the task
+ *  notification or the switch to the extinguisher task; trace_decode gives
+ *  the real figures from a trace of the robot.
+ *
+ *  Built with @c portNUM_PROCESSORS set to 2, the firmware is run as on the
+ *  dual-core ESP32, each task on the core the task table pins it to.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <Arduino.h>
+#include "shares.h"
+#include "sim_kernel.h"
+#include "sim_world.h"
+#include "task_stats.h"
+#include "boot.h"
+
+void setup ();
+
+/// PWM pin of the turntable motor, which identifies motor1
+const int MOTOR1_PWM = PA7;
+/// PWM pin of the extinguisher motor, which identifies motor2
+const int MOTOR2_PWM = PB3;
+
+/// Milestones of one fire cycle, in microseconds after the hotspot was injected
+enum sim_milestone
+{
+    TURNTABLE_STOP,                          ///< motor1.drive(0)
+    AIMED,                                   ///< Last motor1.drive(0) before spraying
+    SPRAY_START,                             ///< First motor2.drive() forward, the start of clamping
+    UNCLAMP_START,                           ///< First motor2.drive() backward, the start of unclamping
+    EXTINGUISHER_HOME,                       ///< motor2.drive(0)
+    TURNTABLE_RESUME,                        ///< First motor1.drive() forward after the carriage is home
+    FIRE_OUT,                                ///< Hotspot put out by the spray
+    SWITCH1_CLOSED,                          ///< Carriage reached the clamped limit switch
+    SWITCH2_CLOSED,                          ///< Carriage got back to the home limit switch
+    REVERSAL_LATENCY,                        ///< From switch 1 closing to the start of unclamping
+    STOP_LATENCY,                            ///< From switch 2 closing to motor2.drive(0)
+    AIM_TIME,                                ///< From the turntable stopping to it being aimed
+    ALL_OUT,                                 ///< Last of the fires put out
+    NUM_MILESTONES
+};
+
+/// Printable names of the milestones
+const char* const MILESTONE_NAMES[NUM_MILESTONES] =
+{
+    "motor1.drive(0)",
+    "aimed",
+    "clamp start",
+    "unclamp start",
+    "motor2.drive(0)",
+    "turntable resume",
+    "fire out",
+    "switch1 closed",
+    "switch2 closed",
+    "switch1 -> reversal",
+    "switch2 -> stop",
+    "stop -> aimed",
+    "all fires out"
+};
+
+/// Most fires put out in one run
+const uint8_t SIM_MAX_FIRES = 16;
+
+/// Most fires burning at once
+const uint8_t SIM_MAX_TARGETS = 8;
+
+/// Least angle between fires burning at once, so that one spray can't put out two
+const float MIN_TARGET_APART_DEG = 20.0f;
+
+/// Settings of one simulated run
+struct sim_scenario
+{
+    uint64_t inject_us = 8000000;            ///< When the hotspot appears
+    float offset_deg = 0.0f;                 ///< Bearing of the hotspot relative to the camera axis
+    float offset_spread_deg = 0.0f;          ///< Width of the range of bearings over many runs
+    float temp_c = 300.0f;                   ///< Hotspot temperature
+    float radius_deg = 4.0f;                 ///< Hotspot angular radius
+    float growth_c_per_s = 0.0f;             ///< How fast the hotspot heats up, 0 to appear fully grown
+    uint64_t timeout_us = 30000000;          ///< Give up this long after injection
+    uint8_t fires = 1;                       ///< Fires to put out one after another
+    uint8_t targets = 1;                     ///< Fires burning at once
+    float target_deg[SIM_MAX_TARGETS] = { }; ///< Bearing of each fire after the first from the first
+    bool echo_serial = false;                ///< Copy firmware Serial output to stderr
+    const char* p_trace_path = NULL;         ///< File to save firmware Serial output in, if any
+    bool capture = false;                    ///< Whether the firmware is asked to record a capture
+    bool stream = false;                     ///< Whether the firmware is asked for the live frame stream
+    sim_world_config world;                  ///< Plant constants
+};
+
+/// What one run measured; milestones not reached are left at UINT64_MAX
+struct sim_result
+{
+    uint64_t milestone_us[NUM_MILESTONES];
+    float aim_error_deg;                     ///< Nozzle to hotspot angle with the lever clamped, NAN if never
+    float travel_deg;                        ///< How far the turntable turned, either way, until the fires were out
+    uint64_t end_stop_us;                    ///< Time spent driving into a hard stop
+    uint8_t cycles;                          ///< Clamp and unclamp cycles finished
+    uint32_t cycle_us[SIM_MAX_FIRES];        ///< Each cycle's time from clamping to stopping back home
+    float impact_mm_s[SIM_MAX_FIRES][2];     ///< Each cycle's carriage speed as switch 1 and switch 2 closed
+    uint32_t context_switches;               ///< Task switches from injection to the end of the cycle
+    uint64_t armed_us;                       ///< Time from power-up to armed, UINT64_MAX if never
+    frame_ring_stats frames;                 ///< Frame streaming counters at the end of the run
+    thermal_sensor_stats cameras[THERMAL_SENSORS]; ///< Each camera's counters at the end of the run
+    uint32_t camera_ms;                      ///< Time the camera counters were kept for
+    uint8_t task_count;                      ///< Number of tasks keeping statistics
+    task_stats_data tasks[TASK_STATS_MAX];   ///< Each task's statistics at the end of the run
+};
+
+
+/** @brief   Runs the firmware through one fire cycle.
+ */
+static sim_result run_scenario (const sim_scenario& scenario)
+{
+    sim_result result;
+    for (uint8_t i = 0; i < NUM_MILESTONES; i++)
+    {
+        result.milestone_us[i] = UINT64_MAX;
+    }
+    bool injected = false;
+    uint64_t inject_at = 0;
+    uint64_t last_stop = UINT64_MAX;
+    int spot = -1;
+    uint64_t clamp_at = UINT64_MAX;
+    result.aim_error_deg = NAN;
+    result.travel_deg = 0.0f;
+    result.cycles = 0;
+
+    // Only the first of each command after the injection counts
+    sim_motor_observer ([&] (int pwm_pin, int speed)
+    {
+        if (!injected)
+        {
+            return;
+        }
+        // Every clamp and unclamp cycle counts toward the cycle times
+        if (pwm_pin == MOTOR2_PWM && speed > 0 && clamp_at == UINT64_MAX)
+        {
+            clamp_at = sim_now_us ();
+        }
+        else if (pwm_pin == MOTOR2_PWM && speed == 0 && clamp_at != UINT64_MAX && result.cycles < SIM_MAX_FIRES)
+        {
+            if (result.cycles == 0)
+            {
+                for (uint8_t which = 1; which <= 2; which++)
+                {
+                    uint64_t closed = sim_switch_closed_us (which);
+                    if (closed != UINT64_MAX && closed >= inject_at)
+                    {
+                        result.milestone_us[which == 1 ? SWITCH1_CLOSED : SWITCH2_CLOSED] = closed - inject_at;
+                    }
+                }
+            }
+            result.cycle_us[result.cycles] = (uint32_t)(sim_now_us () - clamp_at);
+            result.impact_mm_s[result.cycles][0] = sim_switch_speed_mm_s (1);
+            result.impact_mm_s[result.cycles][1] = sim_switch_speed_mm_s (2);
+            result.cycles++;
+            clamp_at = UINT64_MAX;
+        }
+
+        int which = -1;
+        if (pwm_pin == MOTOR1_PWM && speed == 0)
+        {
+            which = TURNTABLE_STOP;
+        }
+        else if (pwm_pin == MOTOR2_PWM && speed > 0)
+        {
+            which = SPRAY_START;
+        }
+        else if (pwm_pin == MOTOR2_PWM && speed < 0)
+        {
+            which = UNCLAMP_START;
+        }
+        else if (pwm_pin == MOTOR2_PWM && speed == 0)
+        {
+            which = EXTINGUISHER_HOME;
+        }
+        else if (pwm_pin == MOTOR1_PWM && speed > 0 && result.milestone_us[EXTINGUISHER_HOME] != UINT64_MAX)
+        {
+            which = TURNTABLE_RESUME;
+        }
+        if (which == TURNTABLE_STOP)
+        {
+            last_stop = sim_now_us () - inject_at;
+        }
+        if (which >= 0 && result.milestone_us[which] == UINT64_MAX)
+        {
+            result.milestone_us[which] = sim_now_us () - inject_at;
+            if (which == SPRAY_START)
+            {
+                result.milestone_us[AIMED] = last_stop;
+            }
+            else if (which == UNCLAMP_START)
+            {
+                // The lever is fully clamped, so this is where the spray goes
+                for (uint8_t target = 0; target < scenario.targets; target++)
+                {
+                    float error = fmodf (sim_world_hotspot (spot + target).bearing_deg
+                                         - sim_turntable_angle_deg (), 360.0f);
+                    error = error > 180.0f ? error - 360.0f : (error < -180.0f ? error + 360.0f : error);
+                    if (isnan (result.aim_error_deg) || fabsf (error) < result.aim_error_deg)
+                    {
+                        result.aim_error_deg = fabsf (error);
+                    }
+                }
+            }
+        }
+    });
+    FILE* p_trace = scenario.p_trace_path ? fopen (scenario.p_trace_path, "wb") : NULL;
+    sim_serial_sink ([&] (uint8_t c)
+    {
+        if (scenario.echo_serial)
+        {
+            fputc (c, stderr);
+        }
+        if (p_trace != NULL)
+        {
+            fputc (c, p_trace);
+        }
+    });
+
+    sim_world_begin (scenario.world);
+    sim_set_cores (portNUM_PROCESSORS);
+    setup ();
+    if (scenario.capture)
+    {
+        sim_serial_input ("r");
+    }
+    if (scenario.stream)
+    {
+        sim_serial_input ("f");
+    }
+
+    sim_run_until_us (scenario.inject_us);
+    uint32_t switches_before = sim_context_switches ();
+    result.armed_us = boot_is_armed () ? boot_armed_us () : UINT64_MAX;
+    inject_at = sim_now_us ();
+    spot = sim_world_add_hotspot (sim_turntable_angle_deg () + scenario.offset_deg,
+                                      scenario.temp_c, scenario.radius_deg);
+    sim_world_grow_hotspot (spot, scenario.growth_c_per_s);
+    for (uint8_t target = 1; target < scenario.targets; target++)
+    {
+        int other = sim_world_add_hotspot (sim_world_hotspot (spot).bearing_deg + scenario.target_deg[target],
+                                           scenario.temp_c, scenario.radius_deg);
+        sim_world_grow_hotspot (other, scenario.growth_c_per_s);
+    }
+    injected = true;
+
+    // Step in whole ticks until the turntable is turning again, or with several fires
+    //     until they are all out, or time runs out
+    auto all_out = [&] ()
+    {
+        for (uint8_t target = 0; target < scenario.targets; target++)
+        {
+            if (sim_world_hotspot (spot + target).lit)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    float angle = sim_turntable_angle_deg ();
+    while ((scenario.targets > 1 ? !all_out () : result.milestone_us[TURNTABLE_RESUME] == UINT64_MAX)
+           && sim_now_us () - inject_at < scenario.timeout_us)
+    {
+        sim_run_for_us (1000);
+        result.travel_deg += fabsf (sim_turntable_angle_deg () - angle);
+        angle = sim_turntable_angle_deg ();
+    }
+
+    // Put out any more fires, each in front of the camera a second after the last cycle ended
+    for (uint8_t fire = 1; fire < scenario.fires && result.cycles == fire; fire++)
+    {
+        sim_run_for_us (1000000);
+        sim_world_add_hotspot (sim_turntable_angle_deg () + scenario.offset_deg, scenario.temp_c, scenario.radius_deg);
+        uint64_t start = sim_now_us ();
+        while (result.cycles == fire && sim_now_us () - start < scenario.timeout_us)
+        {
+            sim_run_for_us (1000);
+        }
+    }
+
+    if (!sim_world_hotspot (spot).lit)
+    {
+        result.milestone_us[FIRE_OUT] = sim_world_hotspot (spot).extinguished_us - inject_at;
+    }
+    if (all_out ())
+    {
+        result.milestone_us[ALL_OUT] = 0;
+        for (uint8_t target = 0; target < scenario.targets; target++)
+        {
+            uint64_t out = sim_world_hotspot (spot + target).extinguished_us - inject_at;
+            result.milestone_us[ALL_OUT] = out > result.milestone_us[ALL_OUT] ? out : result.milestone_us[ALL_OUT];
+        }
+    }
+    // The switches are looked at as the first cycle ends; if it never did, look now
+    for (uint8_t which = 1; which <= 2 && result.cycles == 0; which++)
+    {
+        uint64_t closed = sim_switch_closed_us (which);
+        if (closed != UINT64_MAX && closed >= inject_at)
+        {
+            result.milestone_us[which == 1 ? SWITCH1_CLOSED : SWITCH2_CLOSED] = closed - inject_at;
+        }
+    }
+    // Time from each switch closing to the firmware acting on it
+    if (result.milestone_us[SWITCH1_CLOSED] != UINT64_MAX && result.milestone_us[UNCLAMP_START] != UINT64_MAX)
+    {
+        result.milestone_us[REVERSAL_LATENCY] = result.milestone_us[UNCLAMP_START] - result.milestone_us[SWITCH1_CLOSED];
+    }
+    if (result.milestone_us[SWITCH2_CLOSED] != UINT64_MAX && result.milestone_us[EXTINGUISHER_HOME] != UINT64_MAX)
+    {
+        result.milestone_us[STOP_LATENCY] = result.milestone_us[EXTINGUISHER_HOME] - result.milestone_us[SWITCH2_CLOSED];
+    }
+    if (result.milestone_us[AIMED] != UINT64_MAX)
+    {
+        result.milestone_us[AIM_TIME] = result.milestone_us[AIMED] - result.milestone_us[TURNTABLE_STOP];
+    }
+    result.end_stop_us = sim_end_stop_us ();
+    result.context_switches = sim_context_switches () - switches_before;
+    result.frames = thermal_frames.get_stats ();
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        result.cameras[sensor] = thermal_array.get_stats (sensor);
+    }
+    result.camera_ms = millis () - thermal_array.get_start_ms ();
+
+    // End the capture, then ask the firmware for its statistics report, which comes
+    //     out with the trace log
+    if (scenario.capture)
+    {
+        sim_serial_input ("r");
+        sim_run_for_us (1000000);
+    }
+    if (scenario.p_trace_path != NULL || scenario.echo_serial)
+    {
+        sim_serial_input ("s");
+        sim_run_for_us (1000000);
+    }
+    result.task_count = TaskStats::count ();
+    for (uint8_t index = 0; index < result.task_count; index++)
+    {
+        result.tasks[index] = TaskStats::get_task (index)->get ();
+    }
+    if (p_trace != NULL)
+    {
+        fclose (p_trace);
+    }
+    return result;
+}
+
+
+/** @brief   Runs a scenario in a child process so each run starts from power-up.
+ */
+static bool run_isolated (const sim_scenario& scenario, sim_result& result)
+{
+    int fds[2];
+    if (pipe (fds) != 0)
+    {
+        return false;
+    }
+    fflush (stdout);
+    pid_t pid = fork ();
+    if (pid == 0)
+    {
+        close (fds[0]);
+        sim_result child = run_scenario (scenario);
+        ssize_t written = write (fds[1], &child, sizeof (child));
+        _exit (written == (ssize_t)sizeof (child) ? 0 : 1);
+    }
+    close (fds[1]);
+    ssize_t got = read (fds[0], &result, sizeof (result));
+    close (fds[0]);
+    int status = 0;
+    waitpid (pid, &status, 0);
+    return pid > 0 && got == (ssize_t)sizeof (result) && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+}
+
+
+/** @brief   Uniform random number below @c limit from a seeded generator.
+ */
+static uint32_t draw (uint32_t& state, uint32_t limit)
+{
+    state = state * 1664525u + 1013904223u;
+    return (uint32_t)(((uint64_t)(state >> 8) * limit) >> 24);
+}
+
+
+int main (int argc, char** argv)
+{
+    sim_scenario scenario;
+    uint32_t runs = 1;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* p_arg = argv[i];
+        const char* p_value = (i + 1 < argc) ? argv[i + 1] : "0";
+        if (strcmp (p_arg, "--runs") == 0)             { runs = (uint32_t)atoi (p_value); i++; }
+        else if (strcmp (p_arg, "--seed") == 0)        { seed = (uint32_t)atoi (p_value); i++; }
+        else if (strcmp (p_arg, "--inject-ms") == 0)   { scenario.inject_us = (uint64_t)atoll (p_value) * 1000; i++; }
+        else if (strcmp (p_arg, "--offset-deg") == 0)  { scenario.offset_deg = (float)atof (p_value); i++; }
+        else if (strcmp (p_arg, "--offset-spread-deg") == 0) { scenario.offset_spread_deg = (float)atof (p_value); i++; }
+        else if (strcmp (p_arg, "--temp-c") == 0)      { scenario.temp_c = (float)atof (p_value); i++; }
+        else if (strcmp (p_arg, "--radius-deg") == 0)  { scenario.radius_deg = (float)atof (p_value); i++; }
+        else if (strcmp (p_arg, "--timeout-ms") == 0)  { scenario.timeout_us = (uint64_t)atoll (p_value) * 1000; i++; }
+        else if (strcmp (p_arg, "--growth-c-per-s") == 0) { scenario.growth_c_per_s = (float)atof (p_value); i++; }
+        else if (strcmp (p_arg, "--fires") == 0)       { scenario.fires = (uint8_t)atoi (p_value); i++; }
+        else if (strcmp (p_arg, "--targets") == 0)     { scenario.targets = (uint8_t)atoi (p_value); i++; }
+        else if (strcmp (p_arg, "--cameras") == 0)     { scenario.world.cameras = (uint8_t)atoi (p_value); i++; }
+        else if (strcmp (p_arg, "--serial") == 0)      { scenario.echo_serial = true; }
+        else if (strcmp (p_arg, "--trace") == 0)       { scenario.p_trace_path = p_value; i++; }
+        else if (strcmp (p_arg, "--stream") == 0)      { scenario.stream = true; }
+        else if (strcmp (p_arg, "--cameras-ready-ms") == 0)
+        {
+            scenario.world.cameras_ready_us = (uint64_t)atoll (p_value) * 1000;
+            i++;
+        }
+        else if (strcmp (p_arg, "--late-camera-ms") == 0)
+        {
+            scenario.world.late_camera_us = (uint64_t)atoll (p_value) * 1000;
+            i++;
+        }
+        else if (strcmp (p_arg, "--capture") == 0)
+        {
+            scenario.p_trace_path = p_value;
+            scenario.capture = true;
+            i++;
+        }
+        else
+        {
+            fprintf (stderr, "usage: %s [--runs N] [--seed S] [--inject-ms T] [--offset-deg D]\n"
+                             "       [--offset-spread-deg W] [--temp-c C] [--radius-deg R] [--growth-c-per-s G]\n"
+                             "       [--timeout-ms T] [--fires F] [--targets N] [--cameras C] [--serial]\n"
+                             "       [--trace FILE] [--capture FILE] [--stream] [--cameras-ready-ms T]\n"
+                             "       [--late-camera-ms T]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (runs == 0)
+    {
+        runs = 1;
+    }
+    if (scenario.fires == 0 || scenario.fires > SIM_MAX_FIRES)
+    {
+        scenario.fires = scenario.fires == 0 ? 1 : SIM_MAX_FIRES;
+    }
+    if (scenario.targets == 0 || scenario.targets > SIM_MAX_TARGETS)
+    {
+        scenario.targets = scenario.targets == 0 ? 1 : SIM_MAX_TARGETS;
+    }
+    scenario.world.seed = seed;
+
+    uint64_t sum[NUM_MILESTONES] = { 0 };
+    uint64_t low[NUM_MILESTONES];
+    uint64_t high[NUM_MILESTONES] = { 0 };
+    uint32_t reached[NUM_MILESTONES] = { 0 };
+    uint64_t end_stop_sum = 0;
+    uint64_t armed_sum = 0;
+    uint64_t armed_low = UINT64_MAX;
+    uint64_t armed_high = 0;
+    uint32_t armed_count = 0;
+    uint64_t cycle_sum[2] = { 0 };           // First cycle of each run, and all later cycles
+    uint32_t cycle_low[2] = { UINT32_MAX, UINT32_MAX };
+    uint32_t cycle_high[2] = { 0 };
+    uint32_t cycle_count[2] = { 0 };
+    double impact_sum[2][2] = { { 0.0 } };
+    float aim_sum = 0.0f;
+    float aim_max = 0.0f;
+    uint32_t aimed = 0;
+    double travel_sum = 0.0;
+    uint64_t switch_sum = 0;
+    uint64_t frame_sum = 0;
+    uint64_t dropped_sum = 0;
+    uint64_t i2c_sum = 0;
+    uint32_t i2c_max = 0;
+    uint64_t camera_frames[THERMAL_SENSORS] = { 0 };
+    uint64_t camera_bus_us[THERMAL_SENSORS] = { 0 };
+    uint64_t camera_cpu_us[THERMAL_SENSORS] = { 0 };
+    uint64_t camera_failed[THERMAL_SENSORS] = { 0 };
+    uint64_t camera_ms = 0;
+    uint8_t task_count = 0;
+    task_stats_data tasks[TASK_STATS_MAX];
+    memset (tasks, 0, sizeof (tasks));
+    for (uint8_t m = 0; m < NUM_MILESTONES; m++)
+    {
+        low[m] = UINT64_MAX;
+    }
+
+    uint32_t rng = seed;
+    for (uint32_t run = 0; run < runs; run++)
+    {
+        sim_scenario this_run = scenario;
+        sim_result result;
+        bool ok;
+
+        // The other fires each go somewhere in an equal share of the circle, away from
+        //     its edges so that no two are too close
+        float share_deg = 360.0f / scenario.targets;
+        for (uint8_t target = 1; target < scenario.targets; target++)
+        {
+            this_run.target_deg[target] = share_deg * target + MIN_TARGET_APART_DEG / 2
+                                          + draw (rng, 1000) * 0.001f * (share_deg - MIN_TARGET_APART_DEG);
+        }
+        if (runs == 1)
+        {
+            result = run_scenario (this_run);
+            ok = true;
+        }
+        else
+        {
+            // Spread the injection over one task period and the camera over one frame,
+            //     and vary the screw speed by up to 5% so strokes end at any phase
+            this_run.inject_us += draw (rng, 100000);
+            this_run.world.frame_phase_us = draw (rng, 100000);
+            this_run.world.back_frame_phase_us = draw (rng, 100000);
+            this_run.world.screw_speed_scale = 0.95f + draw (rng, 1000) * 0.0001f;
+            this_run.world.seed = seed + run;
+            this_run.offset_deg += draw (rng, 1000) * 0.001f * scenario.offset_spread_deg;
+            ok = run_isolated (this_run, result);
+        }
+        if (!ok)
+        {
+            fprintf (stderr, "run %u failed\n", run);
+            return 1;
+        }
+        for (uint8_t m = 0; m < NUM_MILESTONES; m++)
+        {
+            uint64_t t = result.milestone_us[m];
+            if (t == UINT64_MAX)
+            {
+                continue;
+            }
+            reached[m]++;
+            sum[m] += t;
+            low[m] = t < low[m] ? t : low[m];
+            high[m] = t > high[m] ? t : high[m];
+        }
+        end_stop_sum += result.end_stop_us;
+        if (result.armed_us != UINT64_MAX)
+        {
+            armed_sum += result.armed_us;
+            armed_low = result.armed_us < armed_low ? result.armed_us : armed_low;
+            armed_high = result.armed_us > armed_high ? result.armed_us : armed_high;
+            armed_count++;
+        }
+        for (uint8_t cycle = 0; cycle < result.cycles; cycle++)
+        {
+            uint8_t later = cycle > 0;
+            uint32_t t = result.cycle_us[cycle];
+            cycle_sum[later] += t;
+            cycle_low[later] = t < cycle_low[later] ? t : cycle_low[later];
+            cycle_high[later] = t > cycle_high[later] ? t : cycle_high[later];
+            cycle_count[later]++;
+            impact_sum[later][0] += result.impact_mm_s[cycle][0];
+            impact_sum[later][1] += result.impact_mm_s[cycle][1];
+        }
+        if (!isnan (result.aim_error_deg))
+        {
+            aimed++;
+            aim_sum += result.aim_error_deg;
+            aim_max = result.aim_error_deg > aim_max ? result.aim_error_deg : aim_max;
+        }
+        switch_sum += result.context_switches;
+        travel_sum += result.travel_deg;
+        frame_sum += result.frames.frames;
+        dropped_sum += result.frames.dropped;
+        i2c_sum += result.frames.i2c_total_us;
+        i2c_max = result.frames.i2c_max_us > i2c_max ? result.frames.i2c_max_us : i2c_max;
+        for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+        {
+            camera_frames[sensor] += result.cameras[sensor].frames;
+            camera_bus_us[sensor] += result.cameras[sensor].bus_us;
+            camera_cpu_us[sensor] += result.cameras[sensor].cpu_us;
+            camera_failed[sensor] += result.cameras[sensor].failed;
+        }
+        camera_ms += result.camera_ms;
+
+        // Every run makes the same tasks in the same order, so their statistics add up by index
+        task_count = result.task_count;
+        for (uint8_t index = 0; index < task_count; index++)
+        {
+            task_stats_data& total = tasks[index];
+            const task_stats_data& one = result.tasks[index];
+            if (one.name[0] != '\0')
+            {
+                memcpy (total.name, one.name, sizeof (total.name));
+                total.stack_free = (total.runs == 0 || one.stack_free < total.stack_free) ? one.stack_free
+                                                                                           : total.stack_free;
+            }
+            total.runs += one.runs;
+            total.exec_total_us += one.exec_total_us;
+            total.exec_max_us = one.exec_max_us > total.exec_max_us ? one.exec_max_us : total.exec_max_us;
+            total.response_max_us = one.response_max_us > total.response_max_us ? one.response_max_us
+                                                                               : total.response_max_us;
+            total.elapsed_us += one.elapsed_us;
+            total.late_max_us = one.late_max_us > total.late_max_us ? one.late_max_us : total.late_max_us;
+            for (uint8_t bin = 0; bin < TASK_LATE_BINS; bin++)
+            {
+                total.late_bins[bin] += one.late_bins[bin];
+            }
+            total.periodic = total.periodic || one.periodic;
+        }
+    }
+
+    printf ("FireBot host simulation: %u run%s, seed %u, %u core%s\n", runs, runs == 1 ? "" : "s", seed,
+            (unsigned)portNUM_PROCESSORS, portNUM_PROCESSORS == 1 ? "" : "s");
+    printf ("%-22s %10s %10s %10s  (ms after hotspot injection, or between events)\n", "", "min", "mean", "max");
+    for (uint8_t m = 0; m < NUM_MILESTONES; m++)
+    {
+        if (reached[m] == 0)
+        {
+            printf ("%-22s %10s %10s %10s\n", MILESTONE_NAMES[m], "-", "-", "-");
+            continue;
+        }
+        printf ("%-22s %10.3f %10.3f %10.3f%s\n", MILESTONE_NAMES[m], low[m] / 1000.0,
+                sum[m] / 1000.0 / reached[m], high[m] / 1000.0,
+                reached[m] < runs ? "  (not reached in every run)" : "");
+    }
+    if (armed_count > 0)
+    {
+        printf ("%-22s %10.3f %10.3f %10.3f  (ms after power-up%s)\n", "time to armed", armed_low / 1000.0,
+                armed_sum / 1000.0 / armed_count, armed_high / 1000.0,
+                armed_count < runs ? "; not armed in every run" : "");
+    }
+    else
+    {
+        printf ("%-22s %10s %10s %10s  (not armed before the hotspot)\n", "time to armed", "-", "-", "-");
+    }
+    if (aimed)
+    {
+        printf ("%-22s %10.2f deg mean, %.2f deg max\n", "aim error", aim_sum / aimed, aim_max);
+    }
+    const char* const CYCLE_NAMES[2] = { "clamp-unclamp cycle", "later cycles" };
+    for (uint8_t later = 0; later < 2; later++)
+    {
+        if (cycle_count[later] == 0)
+        {
+            continue;
+        }
+        printf ("%-22s %10.3f %10.3f %10.3f  (ms; switches hit at %.2f and %.2f mm/s)\n", CYCLE_NAMES[later],
+                cycle_low[later] / 1000.0, cycle_sum[later] / 1000.0 / cycle_count[later],
+                cycle_high[later] / 1000.0, impact_sum[later][0] / cycle_count[later],
+                impact_sum[later][1] / cycle_count[later]);
+    }
+    printf ("%-22s %10.3f ms per run\n", "end-stop time", end_stop_sum / 1000.0 / runs);
+    printf ("%-22s %10.1f per run\n", "context switches", (double)switch_sum / runs);
+    printf ("%-22s %10.1f deg per run\n", "turntable travel", travel_sum / runs);
+    printf ("%-22s %10.1f per run, %.1f dropped\n", "frames streamed", (double)frame_sum / runs,
+            (double)dropped_sum / runs);
+    printf ("%-22s %10.3f ms mean, %.3f ms max\n", "frame I2C time",
+            frame_sum ? i2c_sum / 1000.0 / frame_sum : 0.0, i2c_max / 1000.0);
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        char name[24];
+        snprintf (name, sizeof (name), "camera 0x%02x", THERMAL_SENSOR_LAYOUT[sensor].address);
+        printf ("%-22s %10.2f fps, bus %.2f%% busy, %.1f us of processor per frame, %.1f failed per run\n", name,
+                camera_ms ? camera_frames[sensor] * 1000.0 / camera_ms : 0.0,
+                camera_ms ? camera_bus_us[sensor] / (camera_ms * 10.0) : 0.0,
+                camera_frames[sensor] ? (double)camera_cpu_us[sensor] / camera_frames[sensor] : 0.0,
+                (double)camera_failed[sensor] / runs);
+    }
+
+
+    printf ("\n%-16s %8s %9s %9s %9s %9s %6s %11s  %s\n", "task", "runs", "mean us", "max us", "resp max",
+            "late max", "cpu %", "stack free", "late start histogram");
+    for (uint8_t index = 0; index < task_count; index++)
+    {
+        const task_stats_data& total = tasks[index];
+        if (total.name[0] == '\0')
+        {
+            continue;
+        }
+        printf ("%-16s %8u %9.1f %9u %9u ", total.name, total.runs,
+                total.runs ? (double)total.exec_total_us / total.runs : 0.0, total.exec_max_us,
+                total.response_max_us);
+        if (total.periodic)
+        {
+            printf ("%9u ", total.late_max_us);
+        }
+        else
+        {
+            printf ("%9s ", "-");
+        }
+        printf ("%6.2f %11u ",
+                total.elapsed_us ? 100.0 * total.exec_total_us / total.elapsed_us : 0.0,
+                total.stack_free);
+        if (total.periodic)
+        {
+            for (uint8_t bin = 0; bin < TASK_LATE_BINS; bin++)
+            {
+                printf (" %u", total.late_bins[bin]);
+            }
+        }
+        printf ("\n");
+    }
+    printf ("%-16s late start histogram bins end at", "");
+    for (uint8_t bin = 0; bin < TASK_LATE_BINS - 1; bin++)
+    {
+        printf (" %u", TASK_LATE_BIN_US[bin]);
+    }
+    printf (" us; stack free is in target words, measured on the host\n");
+    printf ("%-16s mean, max and cpu %% leave out the time a task spent blocked waiting for hardware;"
+            " resp max counts it\n", "");
+
+    return reached[SPRAY_START] == runs ? 0 : 1;
+}
@@ -0,0 +1,463 @@
+/** @file sim_world.cpp
+ *  Models of the FireBot hardware for the host simulation. The wiring below
+ *  mirrors the pin #defines in the task files. The turntable motor is a
+ *  first-order speed response which friction holds still at low PWM, the
+ *  extinguisher carriage moves with the lead screw and closes its limit
+ *  switches at either end of the stroke, and each camera renders each hotspot
+ *  as a Gaussian blob averaged over every pixel's field of view, captured at
+ *  the AMG88xx's 10 fps frame rate.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "sim_kernel.h"
+#include "sim_world.h"
+
+// Wiring of the assembly, the same as the #defines in the firmware
+const uint32_t WIRE_AIN1 = PA8;              ///< Turntable motor direction input 1
+const uint32_t WIRE_AIN2 = PB10;             ///< Turntable motor direction input 2
+const uint32_t WIRE_PWMA = PA7;              ///< Turntable motor speed
+const uint32_t WIRE_BIN1 = PB5;              ///< Extinguisher motor direction input 1
+const uint32_t WIRE_BIN2 = PA10;             ///< Extinguisher motor direction input 2
+const uint32_t WIRE_PWMB = PB3;              ///< Extinguisher motor speed
+const uint32_t WIRE_STBY = PB4;              ///< Driver standby, shared by both channels
+const uint32_t WIRE_SWITCH1 = PA9;           ///< Limit switch at the fully clamped end of the stroke
+const uint32_t WIRE_SWITCH2 = PB6;           ///< Limit switch at the home end of the stroke
+
+/// Where each camera is wired and which way it looks, as in thermal_array.h
+struct sim_camera_wiring
+{
+    uint8_t address;                         ///< I2C address
+    uint32_t int_pin;                        ///< Interrupt output
+    float offset_deg;                        ///< Direction it looks, forward of the nozzle
+};
+const sim_camera_wiring WIRE_CAMERAS[] = { { 0x69, PC7, 0.0f }, { 0x68, PC8, 180.0f } };
+const uint8_t SIM_CAMERAS = sizeof (WIRE_CAMERAS) / sizeof (WIRE_CAMERAS[0]);
+
+/// Time between camera frames at the sensor's native 10 fps
+const uint32_t AMG_FRAME_US = 100000;
+/// Horizontal and vertical field of view of one pixel, in degrees
+const float AMG_PIXEL_DEG = 7.5f;
+
+static sim_world_config config;              ///< Constants given to sim_world_begin()
+static std::vector<sim_hotspot> hotspots;    ///< The scene
+static sim_amg88xx amgs[SIM_CAMERAS];        ///< The cameras on the bus
+static double turntable_deg = 0.0;           ///< Turntable angle, in double so that hours of turning keep their small steps
+static float turntable_dps = 0.0f;           ///< Turntable rate
+static float carriage_mm = 0.0f;             ///< Carriage position, 0 at the home switch
+static float carriage_mm_s = 0.0f;           ///< Carriage speed
+static uint64_t end_stop_us = 0;             ///< Time spent driving into a hard stop
+static uint32_t noise_state = 1;             ///< Pixel noise generator state
+static bool switch_pressed[2];               ///< Settled state of the two limit switches
+static uint64_t switch_closed_us[2] = { UINT64_MAX, UINT64_MAX };
+static float switch_speed_mm_s[2];           ///< Carriage speed when each switch last closed
+static std::function<void (int, int)> motor_observer;
+
+
+/** @brief   Signed speed, -1 to 1, that one channel of the H-bridge is driving.
+ */
+static float bridge_output (uint32_t in1, uint32_t in2, uint32_t pwm)
+{
+    if (sim_pin_output (WIRE_STBY) == LOW)
+    {
+        return 0.0f;
+    }
+    float duty = sim_pin_pwm (pwm) / 255.0f;
+    int a = sim_pin_output (in1);
+    int b = sim_pin_output (in2);
+    if (a == HIGH && b == LOW)
+    {
+        return duty;
+    }
+    if (a == LOW && b == HIGH)
+    {
+        return -duty;
+    }
+    return 0.0f;
+}
+
+
+/** @brief   Wraps an angle into the range -180 to 180 degrees.
+ */
+static float wrap_deg (float angle)
+{
+    angle = fmodf (angle + 180.0f, 360.0f);
+    if (angle < 0.0f)
+    {
+        angle += 360.0f;
+    }
+    return angle - 180.0f;
+}
+
+
+/** @brief   Zero-mean Gaussian noise from a seeded generator, so runs repeat exactly.
+ */
+static float noise (float sigma)
+{
+    float sum = 0.0f;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        noise_state = noise_state * 1664525u + 1013904223u;
+        sum += (noise_state >> 8) / 16777216.0f;
+    }
+    // The sum of four uniforms has variance 1/3
+    return (sum - 2.0f) * 1.7320508f * sigma;
+}
+
+
+/** @brief   Sets the contact level of a limit switch; pressed pulls the input low.
+ */
+static void switch_contact (uint32_t pin, bool closed)
+{
+    if (closed)
+    {
+        sim_pin_drive (pin, LOW);
+    }
+    else
+    {
+        sim_pin_release (pin);
+    }
+}
+
+
+/** @brief   Presses or releases a limit switch, with contact bounce.
+ *  @details The contacts meet at once, then chatter open and closed
+ *           @c switch_bounces times before settling, like a real microswitch.
+ */
+static void set_switch (uint8_t index, uint32_t pin, bool pressed)
+{
+    if (pressed == switch_pressed[index])
+    {
+        return;
+    }
+    switch_pressed[index] = pressed;
+    uint64_t now = sim_now_us ();
+    if (pressed)
+    {
+        switch_closed_us[index] = now;
+        switch_speed_mm_s[index] = fabsf (carriage_mm_s);
+    }
+    switch_contact (pin, pressed);
+
+    uint32_t edges = 2 * config.switch_bounces;
+    for (uint32_t k = 1; k <= edges; k++)
+    {
+        bool level = (k % 2 == 0) ? pressed : !pressed;
+        sim_at_us (now + (uint64_t)k * config.switch_bounce_us / edges,
+                   [pin, level] (void) { switch_contact (pin, level); });
+    }
+}
+
+
+/** @brief   Advances the motors and switches by one plant step.
+ */
+static void step_plant (void)
+{
+    float dt = config.plant_step_us * 1e-6f;
+
+    // Turntable: first-order response toward the commanded rate, or toward
+    //     standing still if the PWM is too low to overcome friction
+    float drive = bridge_output (WIRE_AIN1, WIRE_AIN2, WIRE_PWMA);
+    float command_dps = fabsf (drive) < config.turntable_deadband ? 0.0f : drive * config.turntable_max_dps;
+    turntable_dps += (command_dps - turntable_dps) * dt / (config.turntable_tau_s + dt);
+    turntable_deg += turntable_dps * dt;
+
+    // Extinguisher carriage: the lead screw moves it with the motor, whose speed
+    //     follows the PWM with a first-order lag; a hard stop halts it at once
+    float screw_mm_s = bridge_output (WIRE_BIN1, WIRE_BIN2, WIRE_PWMB) * config.screw_max_mm_s * config.screw_speed_scale;
+    carriage_mm_s += (screw_mm_s - carriage_mm_s) * dt / (config.screw_tau_s + dt);
+    carriage_mm += carriage_mm_s * dt;
+    float far_stop = config.stroke_mm + config.overtravel_mm;
+    float near_stop = -config.overtravel_mm;
+    if (carriage_mm >= far_stop || carriage_mm <= near_stop)
+    {
+        carriage_mm = carriage_mm > far_stop ? far_stop : (carriage_mm < near_stop ? near_stop : carriage_mm);
+        carriage_mm_s = 0.0f;
+        if (screw_mm_s != 0.0f)
+        {
+            end_stop_us += config.plant_step_us;
+        }
+    }
+
+    // Limit switches pull their inputs to ground while pressed
+    bool clamped = carriage_mm >= config.stroke_mm;
+    set_switch (0, WIRE_SWITCH1, clamped);
+    set_switch (1, WIRE_SWITCH2, carriage_mm <= 0.0f);
+
+    // With the lever clamped, whatever the nozzle points at gets put out
+    if (clamped)
+    {
+        for (sim_hotspot& spot : hotspots)
+        {
+            if (spot.lit && fabsf (wrap_deg (spot.bearing_deg - turntable_deg)) <= config.nozzle_half_angle_deg)
+            {
+                spot.lit = false;
+                spot.extinguished_us = sim_now_us ();
+            }
+        }
+    }
+
+    sim_at_us (sim_now_us () + config.plant_step_us, step_plant);
+}
+
+
+/** @brief   Fraction of a Gaussian's 1-D mass which falls between two offsets.
+ */
+static float gauss_span (float from, float to, float sigma)
+{
+    const float scale = 1.0f / (sigma * 1.41421356f);
+    return 0.5f * (erff (to * scale) - erff (from * scale));
+}
+
+
+static void update_interrupt (sim_amg88xx& amg);
+
+
+/** @brief   Captures one camera frame and updates the interrupt output.
+ *  @param   camera Index of the camera in WIRE_CAMERAS
+ */
+static void capture_frame (uint8_t camera)
+{
+    sim_amg88xx& amg = amgs[camera];
+    memcpy (amg.previous, amg.pixels, sizeof (amg.pixels));
+
+    // A growing hotspot heats up steadily until it reaches its full temperature
+    std::vector<float> spot_c (hotspots.size ());
+    for (size_t index = 0; index < hotspots.size (); index++)
+    {
+        const sim_hotspot& spot = hotspots[index];
+        float grown = config.ambient_c + spot.growth_c_per_s * (sim_now_us () - spot.added_us) * 1e-6f;
+        spot_c[index] = (spot.growth_c_per_s > 0.0f && grown < spot.temp_c) ? grown : spot.temp_c;
+    }
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        // Row 0 is the top of the image
+        float el_top = (4 - row) * AMG_PIXEL_DEG;
+        for (uint8_t col = 0; col < 8; col++)
+        {
+            float az_left = (col - 4) * AMG_PIXEL_DEG;
+            float temp = config.ambient_c;
+            for (size_t index = 0; index < hotspots.size (); index++)
+            {
+                const sim_hotspot& spot = hotspots[index];
+                if (!spot.lit)
+                {
+                    continue;
+                }
+                // A uniform disc of radius r has the same area as a Gaussian with sigma r/sqrt(2)
+                float sigma = spot.radius_deg * 0.70710678f;
+                float dx = wrap_deg (spot.bearing_deg - turntable_deg - WIRE_CAMERAS[camera].offset_deg);
+                float dy = spot.elevation_deg;
+                float mass = gauss_span (az_left - dx, az_left + AMG_PIXEL_DEG - dx, sigma)
+                           * gauss_span (el_top - AMG_PIXEL_DEG - dy, el_top - dy, sigma);
+                float fill = mass * 6.2831853f * sigma * sigma / (AMG_PIXEL_DEG * AMG_PIXEL_DEG);
+                temp += (spot_c[index] - config.ambient_c) * (fill < 1.0f ? fill : 1.0f);
+            }
+            temp += noise (config.sensor_noise_c);
+            amg.pixels[row * 8 + col] = (int16_t)lroundf (temp * 4.0f);
+        }
+    }
+    amg.frames++;
+    update_interrupt (amg);
+
+    sim_at_us (sim_now_us () + AMG_FRAME_US, [camera] () { capture_frame (camera); });
+}
+
+
+/** @brief   Latches the pixels of a new frame which cross the interrupt levels and pulls INT low.
+ */
+static void update_interrupt (sim_amg88xx& amg)
+{
+    if (amg.int_enabled)
+    {
+        bool any = false;
+        for (uint8_t i = 0; i < 64; i++)
+        {
+            float value = amg.pixels[i] * 0.25f;
+            if (amg.int_mode == 0)
+            {
+                value -= amg.previous[i] * 0.25f;
+            }
+            if (value > amg.int_high_c || value < amg.int_low_c)
+            {
+                amg.int_table[i / 8] |= (uint8_t)(1 << (i % 8));
+                any = true;
+            }
+        }
+        if (any && !amg.int_asserted)
+        {
+            amg.int_asserted = true;
+            sim_pin_drive (amg.int_pin, LOW);
+        }
+    }
+}
+
+
+void sim_world_begin (const sim_world_config& new_config)
+{
+    config = new_config;
+    noise_state = config.seed;
+
+    // Each camera breakout pulls INT up
+    memset (amgs, 0, sizeof (amgs));
+    for (uint8_t camera = 0; camera < SIM_CAMERAS; camera++)
+    {
+        sim_amg88xx& amg = amgs[camera];
+        amg.present = camera < config.cameras;
+        amg.int_pin = WIRE_CAMERAS[camera].int_pin;
+        amg.int_mode = 1;
+        sim_pin_drive (amg.int_pin, HIGH);
+    }
+
+    // When replaying a capture the frames and switch edges come from it, and
+    //     nothing moves
+    if (config.replay)
+    {
+        // Until the capture's first frame the cameras show an empty room, so that
+        //     they pass the firmware's self-test
+        for (uint8_t camera = 0; camera < SIM_CAMERAS; camera++)
+        {
+            for (uint8_t i = 0; i < 64; i++)
+            {
+                amgs[camera].pixels[i] = (int16_t)lroundf ((config.ambient_c + noise (config.sensor_noise_c)) * 4.0f);
+            }
+        }
+        switch_pressed[0] = false;
+        switch_pressed[1] = false;
+        switch_contact (WIRE_SWITCH1, false);
+        switch_contact (WIRE_SWITCH2, false);
+        return;
+    }
+
+    // The switches start out released, with the carriage home
+    switch_pressed[0] = false;
+    switch_pressed[1] = true;
+    switch_contact (WIRE_SWITCH1, false);
+    switch_contact (WIRE_SWITCH2, true);
+
+    sim_at_us (sim_now_us () + config.plant_step_us, step_plant);
+    sim_at_us (sim_now_us () + config.frame_phase_us, [] () { capture_frame (0); });
+    if (config.cameras > 1)
+    {
+        sim_at_us (sim_now_us () + config.back_frame_phase_us, [] () { capture_frame (1); });
+    }
+}
+
+
+void sim_world_replay_frame (uint8_t camera, const int16_t* pixels)
+{
+    sim_amg88xx& amg = amgs[camera];
+    memcpy (amg.previous, amg.pixels, sizeof (amg.pixels));
+    memcpy (amg.pixels, pixels, sizeof (amg.pixels));
+    amg.frames++;
+    update_interrupt (amg);
+}
+
+
+void sim_world_replay_switch (uint8_t which, bool closed)
+{
+    // Closing a switch which is already closed opens it for an instant first,
+    //     so that every recorded edge, bounces included, is an edge again
+    uint32_t pin = which == 1 ? WIRE_SWITCH1 : WIRE_SWITCH2;
+    if (closed && switch_pressed[which - 1])
+    {
+        switch_contact (pin, false);
+    }
+    switch_pressed[which - 1] = closed;
+    switch_contact (pin, closed);
+}
+
+
+sim_amg88xx* sim_world_amg (uint8_t address)
+{
+    for (uint8_t camera = 0; camera < SIM_CAMERAS; camera++)
+    {
+        if (address == WIRE_CAMERAS[camera].address && amgs[camera].present
+            && sim_now_us () >= config.cameras_ready_us
+            && (camera + 1 != config.cameras || sim_now_us () >= config.late_camera_us))
+        {
+            return &amgs[camera];
+        }
+    }
+    return NULL;
+}
+
+
+int sim_world_add_hotspot (float bearing_deg, float temp_c, float radius_deg, float elevation_deg)
+{
+    sim_hotspot spot;
+    spot.bearing_deg = bearing_deg;
+    spot.elevation_deg = elevation_deg;
+    spot.temp_c = temp_c;
+    spot.radius_deg = radius_deg;
+    spot.growth_c_per_s = 0.0f;
+    spot.added_us = sim_now_us ();
+    spot.lit = true;
+    spot.extinguished_us = 0;
+    hotspots.push_back (spot);
+    return (int)hotspots.size () - 1;
+}
+
+
+void sim_world_grow_hotspot (int index, float c_per_s)
+{
+    hotspots[index].growth_c_per_s = c_per_s;
+}
+
+
+const sim_hotspot& sim_world_hotspot (int index)
+{
+    return hotspots[index];
+}
+
+
+float sim_turntable_angle_deg (void)
+{
+    return (float)turntable_deg;
+}
+
+
+float sim_carriage_mm (void)
+{
+    return carriage_mm;
+}
+
+
+uint64_t sim_end_stop_us (void)
+{
+    return end_stop_us;
+}
+
+
+uint64_t sim_switch_closed_us (uint8_t which)
+{
+    return (which == 1 || which == 2) ? switch_closed_us[which - 1] : UINT64_MAX;
+}
+
+
+float sim_switch_speed_mm_s (uint8_t which)
+{
+    return (which == 1 || which == 2) ? switch_speed_mm_s[which - 1] : 0.0f;
+}
+
+
+void sim_motor_observer (std::function<void (int pwm_pin, int speed)> observer)
+{
+    motor_observer = observer;
+}
+
+
+void sim_motor_drive_hook (int pwm_pin, int speed)
+{
+    if (motor_observer)
+    {
+        motor_observer (pwm_pin, speed);
+    }
+}
@@ -0,0 +1,137 @@
+/** @file sim_world.h
+ *  Simulated FireBot hardware for the host build: the pins, the turntable
+ *  and lead-screw motors behind the TB6612 driver, the two limit switches,
+ *  and the AMG88xx cameras looking at a scene with injectable hotspots. The
+ *  plant is stepped by a periodic event in virtual time and talks to the
+ *  firmware only through simulated pins and the device stand-ins. When a
+ *  capture is replayed (see replay_main.cpp) nothing moves; the cameras show
+ *  the recorded frames and the switches close at the recorded times.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _SIM_WORLD_H_
+#define _SIM_WORLD_H_
+
+#include <stdint.h>
+#include <functional>
+
+#include <Arduino.h>
+
+/// Physical constants of the simulated assembly
+struct sim_world_config
+{
+    float ambient_c = 22.0f;                 ///< Temperature of everything that isn't on fire
+    float sensor_noise_c = 0.15f;            ///< Standard deviation of pixel noise
+    float turntable_max_dps = 30.0f;         ///< Turntable rate at full PWM, degrees per second
+    float turntable_tau_s = 0.08f;           ///< Time constant of the turntable speed response
+    float turntable_deadband = 0.12f;        ///< Fraction of full PWM below which friction holds the turntable still
+    float screw_max_mm_s = 8.0f;             ///< Lead-screw carriage speed at full PWM
+    float screw_speed_scale = 1.0f;          ///< Run-to-run variation of the screw speed, e.g. battery sag
+    float screw_tau_s = 0.04f;               ///< Time constant of the carriage speed response
+    float stroke_mm = 12.0f;                 ///< Carriage travel from the home switch to the lever switch
+    float overtravel_mm = 1.5f;              ///< Travel past either switch before the hard stop
+    float nozzle_half_angle_deg = 10.0f;     ///< Hotspots this close to the nozzle axis are put out
+    uint8_t switch_bounces = 2;              ///< Times a limit switch chatters open before it settles
+    uint32_t switch_bounce_us = 800;         ///< How long the chatter lasts
+    uint8_t cameras = 2;                     ///< Cameras on the bus: the front one, then the one looking backward
+    uint64_t cameras_ready_us = 0;           ///< Until this long after power-up the cameras don't answer, as after a power blip
+    uint64_t late_camera_us = 0;             ///< Until this long after power-up the last camera doesn't answer, as one which comes up late
+    uint32_t frame_phase_us = 0;             ///< Offset of the front camera's free-running frame clock
+    uint32_t back_frame_phase_us = 50000;    ///< Offset of the back camera's frame clock
+    uint32_t plant_step_us = 100;            ///< Integration step of the motor models
+    uint32_t seed = 1;                       ///< Seed for the pixel noise
+    bool replay = false;                     ///< Frames and switch edges come from sim_world_replay_*() instead of the plant
+};
+
+/// A hot object somewhere around the turntable
+struct sim_hotspot
+{
+    float bearing_deg;                       ///< Direction of the hotspot relative to the turntable's zero
+    float elevation_deg;                     ///< Height above the camera's axis
+    float temp_c;                            ///< Surface temperature, once fully grown
+    float growth_c_per_s;                    ///< How fast it heats up from ambient, 0 if it starts fully grown
+    uint64_t added_us;                       ///< When it was added to the scene
+    float radius_deg;                        ///< Angular radius as seen from the camera
+    bool lit;                                ///< False once it has been put out
+    uint64_t extinguished_us;                ///< When it was put out
+};
+
+/// Register-level state of one simulated AMG88xx, shared with the library stand-in
+struct sim_amg88xx
+{
+    bool present;                            ///< Whether the part answers at its address
+    uint32_t int_pin;                        ///< MCU pin the INT output is wired to
+    int16_t pixels[64];                      ///< Latest frame in 0.25 degree C counts
+    int16_t previous[64];                    ///< Frame before that, for difference mode
+    bool int_enabled;                        ///< INTC register: INT output enabled
+    uint8_t int_mode;                        ///< INTC register: absolute or difference mode
+    float int_high_c;                        ///< Upper interrupt level
+    float int_low_c;                         ///< Lower interrupt level
+    uint8_t int_table[8];                    ///< Interrupt table, one bit per pixel
+    bool int_asserted;                       ///< INT output currently pulled low
+    uint32_t frames;                         ///< Frames captured since power-up
+};
+
+/// Finds the simulated camera at an I2C address, or NULL if none is wired there
+sim_amg88xx* sim_world_amg (uint8_t address);
+
+/// Powers up the simulated hardware and starts stepping the plant
+void sim_world_begin (const sim_world_config& config);
+
+/// Makes a camera's next frame the given pixels, in 0.25 degree C counts, when replaying a capture
+void sim_world_replay_frame (uint8_t camera, const int16_t* pixels);
+
+/// Closes or opens limit switch 1 (clamped) or 2 (home) when replaying a capture
+void sim_world_replay_switch (uint8_t which, bool closed);
+
+/// Adds a hotspot to the scene and returns its index
+int sim_world_add_hotspot (float bearing_deg, float temp_c, float radius_deg, float elevation_deg = 0.0f);
+
+/// Makes a hotspot grow from ambient temperature toward its full temperature at a given rate
+void sim_world_grow_hotspot (int index, float c_per_s);
+
+/// Looks at a hotspot added with sim_world_add_hotspot()
+const sim_hotspot& sim_world_hotspot (int index);
+
+/// Current turntable angle in degrees, unwrapped
+float sim_turntable_angle_deg (void);
+
+/// Current lead-screw carriage position in millimeters from the home switch
+float sim_carriage_mm (void);
+
+/// Total time either motor spent pushing against a hard stop, in microseconds
+uint64_t sim_end_stop_us (void);
+
+/// When limit switch 1 (clamped) or 2 (home) last closed, UINT64_MAX if never
+uint64_t sim_switch_closed_us (uint8_t which);
+
+/// How fast the carriage was moving when limit switch 1 or 2 last closed, in millimeters per second
+float sim_switch_speed_mm_s (uint8_t which);
+
+/// Sets a function called with the PWM pin and speed of every Motor::drive()
+void sim_motor_observer (std::function<void (int pwm_pin, int speed)> observer);
+
+/// Reports a Motor::drive() call to the observer; used by the Motor stand-in
+void sim_motor_drive_hook (int pwm_pin, int speed);
+
+/// Drives an input pin from outside the MCU, firing any attached interrupt on an edge
+void sim_pin_drive (uint32_t pin, int level);
+
+/// Stops driving an input pin so that its pull resistor sets the level
+void sim_pin_release (uint32_t pin);
+
+/// Level the firmware is driving on an output pin
+int sim_pin_output (uint32_t pin);
+
+/// Duty cycle last written to a pin with analogWrite()
+int sim_pin_pwm (uint32_t pin);
+
+/// Sets where bytes written to Serial go; the default prints them to stdout
+void sim_serial_sink (std::function<void (uint8_t)> sink);
+
+/// Queues bytes for the firmware to read from Serial, as if typed into a terminal
+void sim_serial_input (const char* p_text);
+
+#endif // _SIM_WORLD_H_
@@ -0,0 +1,594 @@
+/** @file task_rta.cpp
+ *  Schedulability analysis of FireBot's tasks. It takes the table of tasks
+ *  (see task_table.h), with each task's priority, period and deadline, and
+ *  the most processor time one run of each task takes, and works out by
+ *  response-time analysis the longest any run of each task can take from
+ *  being woken to finishing, counting the time taken by every task which
+ *  can preempt it. From those it works out the worst case of the fire path
+ *  end to end: from the thermal camera finishing a frame with a fire in it
+ *  to the turntable stopping and to the extinguisher motor being driven.
+ *  Last it tries every priority order the table's compile-time check allows
+ *  and every thermal camera period, and recommends the ones which make the
+ *  fire path shortest while every task still meets its deadline.
+ *
+ *  Usage: task_rta [--stats FILE] [--exec "TASK=US"] [--blocking-us B]
+ *
+ *  Without @c --stats the execution times are the budgets in the task
+ *  table. With it they are read from the task statistics report the
+ *  firmware prints when sent an 's' (see task_stats.h), from a log of the
+ *  robot's serial port or from a file written by firebot_sim with
+ *  @c --trace. Each task's longest run replaces its budget, except where
+ *  the report shows no time at all, which is what the host simulation
+ *  shows for code it doesn't charge for. The cameras' lines of the same
+ *  report give the time the thermal task spends blocked on the bus, which
+ *  is taken out of its run time. @c --exec sets one task's execution time
+ *  by hand, and may be given more than once. @c --blocking-us is the
+ *  longest a task can be held up by a lower priority one, in a critical
+ *  section or an interrupt.
+ *
+ *  The analysis is the usual one for fixed priority preemptive scheduling:
+ *  a task's response time R is the least solution of
+ *
+ *    R = C + S + B + sum over tasks j of equal or higher priority of ceil ((R + J_j) / T_j) C_j
+ *
+ *  where C is the task's execution time, S the time it is blocked waiting
+ *  on hardware, B the blocking by lower priority tasks and T_j the period,
+ *  or for a task woken by events the shortest time between them. A task
+ *  which blocks on hardware part way through a run can come back to
+ *  preempt lower priority tasks sooner than its period after its last run
+ *  did; that is counted as a release jitter J_j of its blocked time. Tasks
+ *  of equal priority share the processor round robin, so each counts as
+ *  preempting the other. The execution times of the tasks on the Cortex-M4
+ *  are in the task statistics report; the analysis is only as good as
+ *  them, and should be run again with a fresh report after any change to
+ *  a task.
+ *
+ *  The program exits with status 1 if a task can miss its deadline.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include "task_table.h"
+
+/// Ticks between frames of one AMG8833, which makes ten a second; reading it more often gets the same frame
+const TickType_t CAMERA_FRAME_TICKS = 100;
+
+/// Bus time of one frame read: 128 bytes and their acknowledgements at 100 kHz
+const uint32_t FRAME_BUS_US = 12800;
+
+/// Default for the longest a task can be held up by a lower priority one, in microseconds
+const uint32_t DEFAULT_BLOCKING_US = 50;
+
+/// Response times are given up on past this many periods, for tasks with no deadline
+const uint32_t UNBOUNDED_PERIODS = 100;
+
+/// One task as the analysis sees it
+struct rta_task
+{
+    const char* p_name;                      ///< Task name, as in the task table and the statistics report
+    uint32_t priority;                       ///< The task's priority
+    uint64_t period_us;                      ///< Period, or shortest time between the events which wake it
+    uint64_t deadline_us;                    ///< Longest a run may take from waking to finishing; 0 for none
+    uint64_t exec_us;                        ///< Processor time of one run
+    uint64_t suspend_us;                     ///< Time one run spends blocked waiting on hardware
+    const char* p_source;                    ///< Where the execution time came from
+    uint64_t response_us;                    ///< Worst case response time, filled in by analyse()
+    bool meets_deadline;                     ///< Whether the response time is within the deadline
+};
+
+
+/** @brief   Fills in the tasks from the task table, with the table's execution time budgets.
+ *  @param   tasks The tasks, in the order of firebot_task
+ */
+static void load_table (rta_task* tasks)
+{
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        const task_spec& spec = FIREBOT_TASKS[index];
+        rta_task& task = tasks[index];
+        task.p_name = spec.p_name;
+        task.priority = spec.priority;
+        task.period_us = (uint64_t)spec.period * TASK_US_PER_TICK;
+        task.deadline_us = (uint64_t)spec.deadline * TASK_US_PER_TICK;
+        task.exec_us = spec.wcet_us;
+        task.suspend_us = 0;
+        task.p_source = "budget";
+        task.response_us = 0;
+        task.meets_deadline = false;
+    }
+
+#ifdef AMG88XX_ASYNC
+    // The thermal task is blocked while the I2C interrupt reads each frame
+    tasks[TASK_THERMAL].suspend_us = FRAME_BUS_US > THERMAL_READ_US ? FRAME_BUS_US - THERMAL_READ_US : 0;
+#endif
+}
+
+
+/** @brief   Finds a task by the name it has in the task table.
+ *  @return  Its index, or TASK_COUNT if there is no such task
+ */
+static uint8_t find_task (const rta_task* tasks, const char* p_name, size_t length)
+{
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        if (strlen (tasks[index].p_name) == length && strncmp (tasks[index].p_name, p_name, length) == 0)
+        {
+            return index;
+        }
+    }
+    return TASK_COUNT;
+}
+
+
+/** @brief   Reads the execution times in a task statistics report.
+ *  @details Lines of the report look like
+ *           "Thermal Sensor: 136 runs, 352/410 us mean/max, response 11835 us max, ..." and
+ *           "Camera 0x69 at 0 deg: 68 frames, ... read 11835 us mean, 11835 us max, 15 us of processor",
+ *           and may be anywhere in the file among other text and binary
+ *           trace records. If the report was printed more than once, each
+ *           task's last line counts, and the longest read of any camera.
+ *  @param   p_path The file
+ *  @param   tasks The tasks, whose execution times are replaced
+ *  @return  true if the file could be read and had a report in it
+ */
+static bool read_stats (const char* p_path, rta_task* tasks)
+{
+    FILE* p_file = fopen (p_path, "rb");
+    if (p_file == NULL)
+    {
+        perror (p_path);
+        return false;
+    }
+
+    uint32_t run_max_us[TASK_COUNT] = { };
+    bool found[TASK_COUNT] = { };
+    uint32_t blocked_us = 0;
+    bool cameras = false;
+
+    std::string line;
+    int byte;
+    do
+    {
+        byte = fgetc (p_file);
+        if (byte != '\n' && byte != EOF)
+        {
+            line += (char)byte;
+            continue;
+        }
+
+        // A task's line: its name, a colon, its runs and its mean and longest run
+        for (uint8_t index = 0; index < TASK_COUNT; index++)
+        {
+            std::string key = std::string (tasks[index].p_name) + ": ";
+            size_t at = line.find (key);
+            unsigned runs, mean_us, max_us;
+            if (at != std::string::npos
+                && sscanf (line.c_str () + at + key.size (), "%u runs, %u/%u us mean/max", &runs, &mean_us, &max_us) == 3)
+            {
+                run_max_us[index] = max_us;
+                found[index] = true;
+            }
+        }
+
+        // A camera's line: the longest frame read, less the processor time of a read, is the
+        //     longest the thermal task is blocked on the bus in one run
+        size_t at = line.find ("Camera 0x");
+        size_t read_at = line.find (", read ");
+        unsigned mean_us, max_us, cpu_us;
+        if (at != std::string::npos && read_at != std::string::npos
+            && sscanf (line.c_str () + read_at, ", read %u us mean, %u us max, %u us of processor",
+                       &mean_us, &max_us, &cpu_us) == 3)
+        {
+            blocked_us = std::max (blocked_us, max_us > cpu_us ? max_us - cpu_us : 0);
+            cameras = true;
+        }
+
+        line.clear ();
+    }
+    while (byte != EOF);
+    fclose (p_file);
+
+    bool any = false;
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        any = any || found[index];
+    }
+    if (!any)
+    {
+        fprintf (stderr, "%s: no task statistics report found\n", p_path);
+        return false;
+    }
+
+    if (cameras)
+    {
+#ifdef AMG88XX_ASYNC
+        tasks[TASK_THERMAL].suspend_us = blocked_us;
+#else
+        tasks[TASK_THERMAL].suspend_us = 0;
+#endif
+    }
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        // A task's longest run already leaves out the time it was blocked on hardware
+        if (found[index] && run_max_us[index] > 0)
+        {
+            tasks[index].exec_us = run_max_us[index];
+            tasks[index].p_source = "measured";
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Works out every task's worst case response time.
+ *  @param   tasks The tasks, whose response times are filled in
+ *  @param   blocking_us Longest a task can be held up by a lower priority one
+ *  @return  true if every task with a deadline meets it
+ */
+static bool analyse (rta_task* tasks, uint32_t blocking_us)
+{
+    bool all_met = true;
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        rta_task& task = tasks[index];
+
+        // Only a task with one of lower priority under it can be held up by one
+        uint64_t blocking = 0;
+        for (uint8_t other = 0; other < TASK_COUNT; other++)
+        {
+            if (tasks[other].priority < task.priority)
+            {
+                blocking = blocking_us;
+            }
+        }
+
+        // Start from the task's own time and add the preemptions which fit in it until
+        //     nothing more fits, or until it is past any chance of meeting the deadline
+        uint64_t limit = task.deadline_us ? task.deadline_us : task.period_us * UNBOUNDED_PERIODS;
+        uint64_t response = task.exec_us + task.suspend_us + blocking;
+        uint64_t previous = 0;
+        while (response != previous && response <= limit)
+        {
+            previous = response;
+            response = task.exec_us + task.suspend_us + blocking;
+            for (uint8_t other = 0; other < TASK_COUNT; other++)
+            {
+                const rta_task& preemptor = tasks[other];
+                if (other == index || preemptor.priority < task.priority || preemptor.period_us == 0)
+                {
+                    continue;
+                }
+                uint64_t arrivals = (previous + preemptor.suspend_us + preemptor.period_us - 1) / preemptor.period_us;
+                response += arrivals * preemptor.exec_us;
+            }
+        }
+        task.response_us = response;
+        task.meets_deadline = task.deadline_us ? response <= task.deadline_us : response <= limit;
+        all_met = all_met && task.meets_deadline;
+    }
+    return all_met;
+}
+
+
+/** @brief   Works out the worst case of the fire path from the tasks' response times.
+ *  @details The times are from the moment a camera finishes a frame with a
+ *           fire in it. The thermal task may only get to it in that
+ *           camera's next slot, a whole THERMAL_SENSOR_PERIOD later, and
+ *           then each task on the path may take its whole response time.
+ *           While aiming the turntable waits for the next frame from the
+ *           same camera, since the others don't show the fire; the time is
+ *           for a fire already in the middle of that frame, and each further
+ *           correction the turntable makes adds another camera period.
+ *  @param   tasks The tasks with their response times
+ *  @param   print Whether to print each stage
+ *  @return  Microseconds from the frame to the extinguisher motor being driven
+ */
+static uint64_t fire_path (const rta_task* tasks, bool print)
+{
+    const rta_task& thermal = tasks[TASK_THERMAL];
+    const rta_task& dispatcher = tasks[TASK_DISPATCHER];
+    const rta_task& rotation = tasks[TASK_ROTATION];
+    const rta_task& extinguisher = tasks[TASK_EXTINGUISHER];
+
+    uint64_t camera_period = thermal.period_us * THERMAL_SENSORS;
+    uint64_t read = camera_period;
+    uint64_t seen = read + thermal.response_us;
+    uint64_t stopped = seen + dispatcher.response_us + rotation.response_us;
+#ifdef TURNTABLE_STOP_IN_PLACE
+    uint64_t aimed = stopped;
+#else
+    uint64_t next_frame = std::max (stopped, read + camera_period + thermal.response_us);
+    uint64_t aimed = next_frame + rotation.response_us;
+#endif
+    uint64_t commanded = aimed + dispatcher.response_us;
+    uint64_t driven = commanded + extinguisher.response_us;
+
+    if (print)
+    {
+        printf ("\nFire path, worst case from a camera frame with a fire in it:\n");
+        printf ("  %-56s %10.3f ms\n", "Thermal Sensor reads the frame in its next slot", read / 1000.0);
+        printf ("  %-56s %10.3f ms\n", "Thermal Sensor finds the fire, posts FIRE_SEEN", seen / 1000.0);
+        printf ("  %-56s %10.3f ms\n", "Dispatcher notifies Rotation, which stops the turntable", stopped / 1000.0);
+#ifndef TURNTABLE_STOP_IN_PLACE
+        printf ("  %-56s %10.3f ms\n", "the next frame is published", next_frame / 1000.0);
+        printf ("  %-56s %10.3f ms\n", "Rotation finds the fire in the middle, posts AIMED", aimed / 1000.0);
+#endif
+        printf ("  %-56s %10.3f ms\n", "Dispatcher notifies Extinguisher", commanded / 1000.0);
+        printf ("  %-56s %10.3f ms\n", "Extinguisher drives the carriage motor", driven / 1000.0);
+#ifndef TURNTABLE_STOP_IN_PLACE
+        printf ("  each further aiming correction adds up to %.3f ms, plus the time the turntable takes to turn\n",
+                camera_period / 1000.0);
+#endif
+    }
+    return driven;
+}
+
+
+/** @brief   Prints every task's times and response time.
+ */
+static void print_tasks (const rta_task* tasks, uint32_t blocking_us)
+{
+    printf ("Response-time analysis of %u tasks, %u us blocking by lower priority tasks\n",
+            (unsigned)TASK_COUNT, blocking_us);
+    printf ("%-16s %4s %10s %10s %10s %10s %-9s %12s  %s\n", "task", "prio", "period us", "deadline",
+            "exec us", "blocked us", "from", "response us", "");
+    double utilisation = 0.0;
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        const rta_task& task = tasks[index];
+        printf ("%-16s %4u %10llu ", task.p_name, task.priority, (unsigned long long)task.period_us);
+        if (task.deadline_us)
+        {
+            printf ("%10llu ", (unsigned long long)task.deadline_us);
+        }
+        else
+        {
+            printf ("%10s ", "-");
+        }
+        printf ("%10llu %10llu %-9s %12llu  %s\n", (unsigned long long)task.exec_us,
+                (unsigned long long)task.suspend_us, task.p_source, (unsigned long long)task.response_us,
+                task.meets_deadline ? (task.deadline_us ? "ok" : "") : (task.deadline_us ? "MISSES DEADLINE" : "unbounded"));
+        utilisation += task.period_us ? (double)task.exec_us / task.period_us : 0.0;
+    }
+    printf ("Processor utilisation %.2f%%\n", utilisation * 100.0);
+}
+
+
+/** @brief   Checks a priority order against the deadline-monotonic check in task_table.h.
+ *  @param   priorities A priority for each task
+ *  @return  true if the firmware would build with the tasks given those priorities
+ */
+static bool order_allowed (const uint32_t* priorities)
+{
+    task_spec specs[TASK_COUNT];
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        specs[index] = FIREBOT_TASKS[index];
+        specs[index].priority = priorities[index];
+    }
+    for (uint8_t first = 0; first < TASK_COUNT; first++)
+    {
+        for (uint8_t second = 0; second < TASK_COUNT; second++)
+        {
+            if (!deadline_ordered (specs[first], specs[second]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Sets every task's thermal camera period, which the rotation task shares.
+ *  @param   tasks The tasks
+ *  @param   period Ticks in which every camera is read once, as THERMAL_SENSOR_PERIOD
+ */
+static void set_thermal_period (rta_task* tasks, TickType_t period)
+{
+    uint64_t slot_us = (uint64_t)(period / THERMAL_SENSORS) * TASK_US_PER_TICK;
+    tasks[TASK_THERMAL].period_us = tasks[TASK_THERMAL].deadline_us = slot_us;
+    tasks[TASK_ROTATION].period_us = tasks[TASK_ROTATION].deadline_us = slot_us;
+}
+
+
+/** @brief   Finds the priorities and thermal camera period with the shortest fire path.
+ *  @details Every order of the priorities of the tasks with deadlines is
+ *           tried which keeps the same set of priority numbers and passes
+ *           the check in task_table.h; task_Trace stays where it is. The
+ *           thermal period is tried from the shortest in which every task
+ *           still meets its deadline up, but never shorter than the cameras
+ *           make new frames. Among equally short fire paths the priorities
+ *           closest to the present ones win.
+ *  @param   tasks The tasks as they are now
+ *  @param   blocking_us Longest a task can be held up by a lower priority one
+ */
+static void recommend (const rta_task* tasks, uint32_t blocking_us)
+{
+    // The priority numbers now in use, given out in every order to the tasks with deadlines
+    std::vector<uint8_t> ordered;
+    std::vector<uint32_t> numbers;
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        if (tasks[index].deadline_us)
+        {
+            ordered.push_back (index);
+            numbers.push_back (tasks[index].priority);
+        }
+    }
+    std::sort (numbers.begin (), numbers.end ());
+
+    // The shortest thermal period in which the present priorities meet every deadline
+    TickType_t shortest = 0;
+    for (TickType_t period = THERMAL_SENSORS; period <= THERMAL_SENSOR_PERIOD * 10; period += THERMAL_SENSORS)
+    {
+        rta_task trial[TASK_COUNT];
+        std::copy (tasks, tasks + TASK_COUNT, trial);
+        set_thermal_period (trial, period);
+        if (analyse (trial, blocking_us))
+        {
+            shortest = period;
+            break;
+        }
+    }
+    TickType_t camera_bound = CAMERA_FRAME_TICKS;
+    TickType_t best_period = std::max (shortest, camera_bound);
+
+    uint64_t best_latency = UINT64_MAX;
+    uint32_t best_changes = UINT32_MAX;
+    uint32_t best_priorities[TASK_COUNT];
+    uint32_t tried = 0;
+    uint32_t allowed = 0;
+    std::vector<uint32_t> order (numbers);
+    do
+    {
+        uint32_t priorities[TASK_COUNT];
+        uint32_t changes = 0;
+        for (uint8_t index = 0; index < TASK_COUNT; index++)
+        {
+            priorities[index] = tasks[index].priority;
+        }
+        for (size_t place = 0; place < ordered.size (); place++)
+        {
+            priorities[ordered[place]] = order[place];
+            changes += order[place] != tasks[ordered[place]].priority;
+        }
+        tried++;
+        if (!order_allowed (priorities))
+        {
+            continue;
+        }
+        allowed++;
+
+        rta_task trial[TASK_COUNT];
+        std::copy (tasks, tasks + TASK_COUNT, trial);
+        for (uint8_t index = 0; index < TASK_COUNT; index++)
+        {
+            trial[index].priority = priorities[index];
+        }
+        set_thermal_period (trial, best_period);
+        if (!analyse (trial, blocking_us))
+        {
+            continue;
+        }
+        uint64_t latency = fire_path (trial, false);
+        if (latency < best_latency || (latency == best_latency && changes < best_changes))
+        {
+            best_latency = latency;
+            best_changes = changes;
+            std::copy (priorities, priorities + TASK_COUNT, best_priorities);
+        }
+    }
+    while (std::next_permutation (order.begin (), order.end ()));
+
+    printf ("\nRecommendation, from %u priority orders of which %u pass the check in task_table.h:\n", tried, allowed);
+    if (best_latency == UINT64_MAX)
+    {
+        printf ("  no order meets every deadline; shorten the execution times or lengthen the periods\n");
+        return;
+    }
+    for (uint8_t index = 0; index < TASK_COUNT; index++)
+    {
+        printf ("  %-16s priority %u", tasks[index].p_name, best_priorities[index]);
+        if (best_priorities[index] != tasks[index].priority)
+        {
+            printf (" (now %u)", tasks[index].priority);
+        }
+        printf ("\n");
+    }
+    printf ("  THERMAL_SENSOR_PERIOD %u ticks", (unsigned)best_period);
+    if (best_period != THERMAL_SENSOR_PERIOD)
+    {
+        printf (" (now %u)", (unsigned)THERMAL_SENSOR_PERIOD);
+    }
+    if (shortest == 0)
+    {
+        printf ("; the present priorities miss a deadline at every period tried\n");
+    }
+    else if (shortest < camera_bound)
+    {
+        printf ("; the tasks would meet their deadlines at %u, but the cameras only make a frame every %u\n",
+                (unsigned)shortest, (unsigned)camera_bound);
+    }
+    else
+    {
+        printf ("; the shortest in which every task meets its deadline\n");
+    }
+
+    rta_task now[TASK_COUNT];
+    std::copy (tasks, tasks + TASK_COUNT, now);
+    if (analyse (now, blocking_us))
+    {
+        printf ("  fire path %.3f ms, against %.3f ms now\n", best_latency / 1000.0, fire_path (now, false) / 1000.0);
+    }
+    else
+    {
+        printf ("  fire path %.3f ms, with every task meeting its deadline, which they don't now\n",
+                best_latency / 1000.0);
+    }
+}
+
+
+int main (int argc, char** argv)
+{
+    rta_task tasks[TASK_COUNT];
+    load_table (tasks);
+    uint32_t blocking_us = DEFAULT_BLOCKING_US;
+
+    // The statistics are read first, so that execution times given by hand override them
+    //     whatever order the arguments come in
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp (argv[arg], "--stats") && arg + 1 < argc)
+        {
+            if (!read_stats (argv[++arg], tasks))
+            {
+                return 2;
+            }
+        }
+    }
+    for (int arg = 1; arg < argc; arg++)
+    {
+        const char* p_equals = arg + 1 < argc ? strrchr (argv[arg + 1], '=') : NULL;
+        if (!strcmp (argv[arg], "--stats") && arg + 1 < argc)
+        {
+            arg++;
+        }
+        else if (!strcmp (argv[arg], "--exec") && p_equals != NULL)
+        {
+            const char* p_name = argv[++arg];
+            uint8_t index = find_task (tasks, p_name, p_equals - p_name);
+            if (index == TASK_COUNT)
+            {
+                fprintf (stderr, "No task named \"%.*s\"\n", (int)(p_equals - p_name), p_name);
+                return 2;
+            }
+            tasks[index].exec_us = strtoull (p_equals + 1, NULL, 0);
+            tasks[index].p_source = "given";
+        }
+        else if (!strcmp (argv[arg], "--blocking-us") && arg + 1 < argc)
+        {
+            blocking_us = (uint32_t)strtoul (argv[++arg], NULL, 0);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--stats FILE] [--exec \"TASK=US\"] [--blocking-us B]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool all_met = analyse (tasks, blocking_us);
+    print_tasks (tasks, blocking_us);
+    fire_path (tasks, true);
+    recommend (tasks, blocking_us);
+    return all_met ? 0 : 1;
+}
@@ -0,0 +1,410 @@
+/** @file trace_decode.cpp
+ *  Decoder for FireBot's binary trace log (see trace.h). It reads bytes
+ *  captured from the robot's serial port, or written by the host simulation
+ *  with @c --trace, finds the records among any text printed to the same
+ *  port, puts the records from all of the rings in time order and prints
+ *  them as a timeline in milliseconds since the robot started.
+ *
+ *  Usage: trace_decode [--frames] [FILE]
+ *
+ *  Without a file the stream is read from standard input. Frame statistics
+ *  come ten times a second and are left out unless @c --frames is given.
+ *  Lines of text found between the records, such as the greeting and the
+ *  task statistics report, are printed at the time of the drain they came
+ *  with. Packets of the live frame stream (see frame_stream.h) are skipped;
+ *  frame_receive.cpp decodes those.
+ *
+ *  After the timeline comes the latency of each limit switch: the time from
+ *  an edge the dispatcher acted on to the motor2 command it led to, which
+ *  is the interrupt, the notification and the switch to the extinguisher
+ *  task as they took on the robot. The host simulation charges no time for
+ *  any of those, so in a trace from it these come out as zero. Built with
+ *  LIMIT_SWITCH_POLLING the edge is recorded when the polling task sees it,
+ *  so the wait for the poll is left out.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include "trace.h"
+#include "task_Dispatcher.h"
+#include "frame_stream.h"
+
+/// Printable names of the record sources
+const char* const SOURCE_NAMES[TRACE_DRAIN + 1] =
+{
+    "Dispatcher", "Rotation", "Thermal", "Extinguisher", "Switch1", "Switch2", "AMG0 ISR", "AMG1 ISR", "Trace"
+};
+
+/// Printable names of the dispatcher's events
+const char* const EVENT_NAMES[] = { "FIRE_SEEN", "AIMED", "LEVER_CLAMPED", "CARRIAGE_HOME", "FIRE_GONE", "ARMED" };
+
+/// Printable names of the dispatcher's states
+const char* const STATE_NAMES[] = { "SCANNING", "AIMING", "SPRAYING", "UNCLAMPING", "BOOTING" };
+
+/// Limit switches whose latency to the next motor2 command is summed up
+const uint8_t SWITCHES = 2;
+
+/// One decoded record with its time stamp carried past the 32 bit wrap-around
+struct timeline_entry
+{
+    uint64_t time;                           ///< Clock counts since the robot started
+    uint32_t clock_mhz;                      ///< Clock counts per microsecond
+    uint8_t source;                          ///< A trace_source
+    trace_record record;                     ///< The record as sent, or type TRACE_TYPES for text
+    std::string text;                        ///< A line of text printed to the port
+};
+
+
+/** @brief   Returns a name from a table, or "?" if the index is out of range.
+ */
+template <size_t N>
+static const char* name_of (const char* const (&names)[N], unsigned index)
+{
+    return index < N ? names[index] : "?";
+}
+
+
+/** @brief   Checks whether a complete, valid record starts at @c p_bytes.
+ */
+static bool is_frame (const uint8_t* p_bytes)
+{
+    if (p_bytes[0] != TRACE_SYNC_BYTE || p_bytes[1] > TRACE_DRAIN || p_bytes[6] >= TRACE_TYPES)
+    {
+        return false;
+    }
+    uint8_t sum = 0;
+    for (uint8_t index = 1; index < TRACE_FRAME_SIZE - 1; index++)
+    {
+        sum += p_bytes[index];
+    }
+    return (uint8_t)~sum == p_bytes[TRACE_FRAME_SIZE - 1];
+}
+
+
+/** @brief   Prints one line of the timeline.
+ *  @param   entry The record to print
+ *  @param   p_next The next record from the same source, or NULL
+ *  @return  true if @c p_next was printed as part of this line
+ */
+static bool print_entry (const timeline_entry& entry, const timeline_entry* p_next)
+{
+    const trace_record& r = entry.record;
+    printf ("%12.3f ms  %-12s  ", entry.time / (double)entry.clock_mhz / 1000.0, SOURCE_NAMES[entry.source]);
+    bool used_next = false;
+    switch (r.type)
+    {
+        case TRACE_DROPPED:
+            printf ("lost %u records from %s\n", r.value, r.arg <= TRACE_DRAIN ? SOURCE_NAMES[r.arg] : "?");
+            break;
+        case TRACE_EVENT:
+        {
+            unsigned from = r.value & 0xFF;
+            unsigned to = r.value >> 8;
+            if (from == to)
+            {
+                printf ("%s ignored in %s\n", name_of (EVENT_NAMES, r.arg), name_of (STATE_NAMES, from));
+            }
+            else
+            {
+                printf ("%s: %s -> %s\n", name_of (EVENT_NAMES, r.arg), name_of (STATE_NAMES, from),
+                        name_of (STATE_NAMES, to));
+            }
+            break;
+        }
+        case TRACE_MOTOR:
+            printf ("motor%u.drive(%d)\n", r.arg, (int16_t)r.value);
+            break;
+        case TRACE_SWITCH:
+            printf ("switch%u closed%s\n", r.arg, r.value ? "" : ", bounce ignored");
+            break;
+        case TRACE_AMG_INT:
+            printf ("threshold interrupt from camera %u\n", r.arg);
+            break;
+        case TRACE_FRAME:
+            printf ("frame read in %u us, %u hot pixels", r.value, r.arg);
+            if (p_next != NULL && p_next->record.type == TRACE_FRAME_TEMP)
+            {
+                printf (", %u blobs, hottest %.2f C", p_next->record.arg, (int16_t)p_next->record.value / 4.0);
+                used_next = true;
+            }
+            printf ("\n");
+            break;
+        case TRACE_FRAME_TEMP:
+            printf ("frame: %u blobs, hottest %.2f C\n", r.arg, (int16_t)r.value / 4.0);
+            break;
+        case TRACE_FRAME_DROPPED:
+            printf ("frame dropped, no free buffer\n");
+            break;
+        case TRACE_FRAME_FAILED:
+            printf ("frame from camera %u failed on the bus, thrown away\n", (unsigned)r.arg);
+            break;
+        case TRACE_CAMERA_JOINED:
+            printf ("camera %u joined after %u %s\n", (unsigned)r.arg, r.value, r.value == 1 ? "try" : "tries");
+            break;
+        case TRACE_STROKE:
+        {
+            // The cycle is the clamping stroke before this one plus this one
+            static unsigned clamp_ms = 0;
+            if (r.arg == 1)
+            {
+                clamp_ms = r.value;
+                printf ("clamping stroke took %u ms\n", r.value);
+            }
+            else
+            {
+                printf ("unclamping stroke took %u ms, clamp and unclamp cycle %u ms\n", r.value, clamp_ms + r.value);
+            }
+            break;
+        }
+        case TRACE_PANORAMA:
+            printf ("turntable went round: %u cells changed, hottest at %.2f deg\n", r.arg, r.value / 100.0);
+            break;
+        case TRACE_TARGET:
+            printf ("aiming at the fire at %.2f deg, %u in the queue\n", r.value / 100.0, r.arg);
+            break;
+        case TRACE_BOOT:
+            printf ("%s ready after %u %s\n", r.arg == 1 ? "cameras" : r.arg == 2 ? "motors" : "switches",
+                    r.value, r.value == 1 ? "try" : "tries");
+            break;
+        case TRACE_TYPES:
+            printf ("%s\n", entry.text.c_str ());
+            break;
+        default:
+            printf ("record type %u, %u, %u\n", r.type, r.arg, r.value);
+            break;
+    }
+    return used_next;
+}
+
+
+/** @brief   Finds the first record at or after a time of a given type and argument.
+ *  @details Records with the same time stamp may be in either order, so the
+ *           search starts at the first of them.
+ *  @return  Index of the record, or the size of the timeline if there is none
+ */
+static size_t find_from (const std::vector<timeline_entry>& timeline, uint64_t time, uint8_t type, uint8_t arg)
+{
+    size_t index = std::lower_bound (timeline.begin (), timeline.end (), time,
+                                     [] (const timeline_entry& entry, uint64_t at) { return entry.time < at; })
+                   - timeline.begin ();
+    while (index < timeline.size () && !(timeline[index].record.type == type && timeline[index].record.arg == arg))
+    {
+        index++;
+    }
+    return index;
+}
+
+
+/** @brief   Prints how long after each limit switch edge the motor2 command it led to came.
+ *  @details An edge counts if it was passed on to the dispatcher and the
+ *           dispatcher acted on it: LEVER_CLAMPED after switch 1 and
+ *           CARRIAGE_HOME after switch 2 changed its state. The command is
+ *           the first motor2 command from then on, the extinguisher
+ *           reversing after switch 1 and stopping after switch 2.
+ *  @param   timeline The records in time order
+ */
+static void print_switch_latency (const std::vector<timeline_entry>& timeline)
+{
+    const uint8_t SWITCH_EVENTS[SWITCHES] = { EVENT_LEVER_CLAMPED, EVENT_CARRIAGE_HOME };
+    uint32_t count[SWITCHES] = { };
+    double sum_us[SWITCHES] = { };
+    double low_us[SWITCHES] = { };
+    double high_us[SWITCHES] = { };
+    for (const timeline_entry& press : timeline)
+    {
+        const trace_record& r = press.record;
+        if (r.type != TRACE_SWITCH || r.value == 0 || r.arg < 1 || r.arg > SWITCHES)
+        {
+            continue;
+        }
+        uint8_t which = r.arg - 1;
+        size_t event = find_from (timeline, press.time, TRACE_EVENT, SWITCH_EVENTS[which]);
+        if (event == timeline.size () || (timeline[event].record.value & 0xFF) == (timeline[event].record.value >> 8))
+        {
+            continue;
+        }
+        size_t command = find_from (timeline, timeline[event].time, TRACE_MOTOR, 2);
+        if (command == timeline.size ())
+        {
+            continue;
+        }
+        double us = (double)(timeline[command].time - press.time) / press.clock_mhz;
+        low_us[which] = (count[which] == 0 || us < low_us[which]) ? us : low_us[which];
+        high_us[which] = us > high_us[which] ? us : high_us[which];
+        sum_us[which] += us;
+        count[which]++;
+    }
+    for (uint8_t which = 0; which < SWITCHES; which++)
+    {
+        if (count[which] > 0)
+        {
+            printf ("switch%u -> motor2: %u presses, %.1f/%.1f/%.1f us min/mean/max\n", which + 1, count[which],
+                    low_us[which], sum_us[which] / count[which], high_us[which]);
+        }
+    }
+}
+
+
+int main (int argc, char** argv)
+{
+    bool show_frames = false;
+    const char* p_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--frames") == 0)
+        {
+            show_frames = true;
+        }
+        else if (argv[i][0] == '-' || p_path != NULL)
+        {
+            fprintf (stderr, "usage: %s [--frames] [FILE]\n", argv[0]);
+            return 2;
+        }
+        else
+        {
+            p_path = argv[i];
+        }
+    }
+
+    FILE* p_file = p_path ? fopen (p_path, "rb") : stdin;
+    if (p_file == NULL)
+    {
+        perror (p_path);
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread (chunk, 1, sizeof (chunk), p_file)) > 0)
+    {
+        bytes.insert (bytes.end (), chunk, chunk + got);
+    }
+    if (p_file != stdin)
+    {
+        fclose (p_file);
+    }
+
+    // Find the records. Each run of task_Trace starts with a sync record; the sync
+    //     time stamps are followed through their wrap-around, and every other record
+    //     is placed relative to the sync record sent just before it
+    std::vector<timeline_entry> timeline;
+    uint64_t sync_time = 0;
+    uint32_t sync_raw = 0;
+    uint32_t clock_mhz = 0;
+    size_t skipped = 0;
+    size_t before_sync = 0;
+    size_t stream_bytes = 0;
+    uint32_t lost = 0;
+    std::string line;
+    size_t index = 0;
+    while (index <= bytes.size ())
+    {
+        bool frame = bytes.size () - index >= TRACE_FRAME_SIZE && is_frame (&bytes[index]);
+        uint16_t packet = frame || index == bytes.size () ? 0
+                          : frame_stream_check (&bytes[index], bytes.size () - index);
+
+        // Text ends at a line break, a record, a stream packet or the end of the stream
+        if (frame || packet > 0 || index == bytes.size () || bytes[index] == '\n')
+        {
+            while (!line.empty () && (line.back () == '\r' || line.back () == ' '))
+            {
+                line.pop_back ();
+            }
+            if (!line.empty ())
+            {
+                timeline_entry entry;
+                entry.time = sync_time;
+                entry.clock_mhz = clock_mhz ? clock_mhz : 1;
+                entry.source = TRACE_DRAIN;
+                entry.record = { 0, TRACE_TYPES, 0, 0 };
+                entry.text = line;
+                timeline.push_back (entry);
+            }
+            line.clear ();
+        }
+        if (index == bytes.size ())
+        {
+            break;
+        }
+        if (packet > 0)
+        {
+            stream_bytes += packet;
+            index += packet;
+            continue;
+        }
+        if (!frame)
+        {
+            if (bytes[index] >= ' ' && bytes[index] < 0x7F)
+            {
+                line += (char)bytes[index];
+            }
+            skipped++;
+            index++;
+            continue;
+        }
+        timeline_entry entry;
+        entry.source = bytes[index + 1];
+        memcpy (&entry.record, &bytes[index + 2], sizeof (trace_record));
+        index += TRACE_FRAME_SIZE;
+
+        if (entry.record.type == TRACE_SYNC)
+        {
+            sync_time = clock_mhz == 0 ? entry.record.time : sync_time + (uint32_t)(entry.record.time - sync_raw);
+            sync_raw = entry.record.time;
+            clock_mhz = entry.record.arg ? entry.record.arg : 1;
+            continue;
+        }
+        if (clock_mhz == 0)
+        {
+            before_sync++;
+            continue;
+        }
+        if (entry.record.type == TRACE_DROPPED)
+        {
+            lost += entry.record.value;
+        }
+        int64_t offset = (int32_t)(entry.record.time - sync_raw);
+        entry.time = (int64_t)sync_time + offset < 0 ? 0 : sync_time + offset;
+        entry.clock_mhz = clock_mhz;
+        if (!show_frames && (entry.record.type == TRACE_FRAME || entry.record.type == TRACE_FRAME_TEMP))
+        {
+            continue;
+        }
+        timeline.push_back (entry);
+    }
+
+    // The rings are sent one after another, so put the records back in time order
+    std::stable_sort (timeline.begin (), timeline.end (),
+                      [] (const timeline_entry& a, const timeline_entry& b) { return a.time < b.time; });
+
+    std::vector<bool> printed (timeline.size (), false);
+    for (size_t i = 0; i < timeline.size (); i++)
+    {
+        if (printed[i])
+        {
+            continue;
+        }
+        size_t next = i + 1;
+        while (next < timeline.size () && timeline[next].source != timeline[i].source)
+        {
+            next++;
+        }
+        if (print_entry (timeline[i], next < timeline.size () ? &timeline[next] : NULL))
+        {
+            printed[next] = true;
+        }
+    }
+    print_switch_latency (timeline);
+    fprintf (stderr, "%zu lines, %u records lost to full rings, %zu bytes of frame stream, %zu bytes of other output, "
+             "%zu records before the first sync\n", timeline.size (), lost, stream_bytes, skipped, before_sync);
+    return 0;
+}
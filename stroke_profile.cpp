@@ -0,0 +1,92 @@
+/** @file stroke_profile.cpp
+ *  This file contains the learned stroke timing which the extinguisher task
+ *  uses to slow the carriage down just before each limit switch.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+
+#include "stroke_profile.h"          // Header for the stroke timing
+
+
+/** @brief   Creates a profile which has not yet seen a stroke.
+ */
+StrokeProfile::StrokeProfile (void)
+{
+    mean_us = 0;
+    deviation_us = 0;
+    samples = 0;
+}
+
+
+/** @brief   Returns how long the next stroke should run at full speed.
+ *  @return  Microseconds from starting the motor to slowing it to STROKE_CREEP_PWM,
+ *           or UINT32_MAX to run at full speed until the switch closes
+ */
+uint32_t StrokeProfile::fast_us (void) const
+{
+    if (samples == 0)
+    {
+        return UINT32_MAX;
+    }
+    uint32_t margin = STROKE_DEVIATIONS * deviation_us;
+    if (margin < STROKE_MIN_MARGIN_US)
+    {
+        margin = STROKE_MIN_MARGIN_US;
+    }
+    return mean_us > margin ? mean_us - margin : 0;
+}
+
+
+/** @brief   Learns from a finished stroke.
+ *  @details The part of the stroke spent creeping covered only
+ *           STROKE_CREEP_PWM / STROKE_FAST_PWM of the distance it would have at
+ *           full speed, so the stroke's full speed time is the fast part plus
+ *           that fraction of the rest. The time the motor takes to slow down is
+ *           left out, which makes the estimate a little short and so errs
+ *           toward slowing down early. After the first stroke, a stroke more
+ *           than twice as long or short as the average, such as one which
+ *           stalled, is only counted as twice or half as long.
+ *  @param   fast_us How long the stroke ran at full speed; anything longer than
+ *           @c total_us means it never slowed down
+ *  @param   total_us How long the stroke took from starting the motor to its switch closing
+ */
+void StrokeProfile::learn (uint32_t fast_us, uint32_t total_us)
+{
+    if (fast_us > total_us)
+    {
+        fast_us = total_us;
+    }
+    uint32_t full_speed_us = fast_us + (total_us - fast_us) * STROKE_CREEP_PWM / STROKE_FAST_PWM;
+
+    if (samples == 0)
+    {
+        // The first stroke is all there is to go on, so the next one slows down
+        //     STROKE_MIN_MARGIN_US early until the deviation has been measured. If
+        //     that is too late, the stroke only meets its switch at full speed
+        mean_us = full_speed_us;
+        deviation_us = 0;
+    }
+    else
+    {
+        if (full_speed_us > 2 * mean_us)
+        {
+            full_speed_us = 2 * mean_us;
+        }
+        else if (full_speed_us < mean_us / 2)
+        {
+            full_speed_us = mean_us / 2;
+        }
+        int32_t error = (int32_t)(full_speed_us - mean_us);
+        uint32_t distance = error < 0 ? -error : error;
+        mean_us = (uint32_t)((int32_t)mean_us + (error >> STROKE_MEAN_SHIFT));
+        deviation_us = (uint32_t)((int32_t)deviation_us
+                                  + (((int32_t)distance - (int32_t)deviation_us) >> STROKE_DEVIATION_SHIFT));
+    }
+    if (samples < UINT32_MAX)
+    {
+        samples++;
+    }
+}
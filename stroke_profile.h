@@ -0,0 +1,64 @@
+/** @file stroke_profile.h
+ *  This file contains the learned timing of the extinguisher carriage's
+ *  strokes. The carriage runs at full speed through the part of a stroke
+ *  which is known to be clear, then slows to a creep just before the limit
+ *  switch is expected to close, so that it reaches the lever quickly but
+ *  meets the switch, and the hard stop behind it, gently.
+ *
+ *  Where to slow down is learned from the strokes before. Each stroke's
+ *  duration is turned into the time it would have taken at full speed all
+ *  the way, and a moving average and mean deviation of that time are kept,
+ *  the way TCP estimates a round trip time. The next stroke slows down a
+ *  margin of a few deviations before the average, but never less than
+ *  STROKE_MIN_MARGIN_US before it. Until a stroke has been measured, and
+ *  whenever the switch closes before the creep starts, the stroke simply
+ *  runs at full speed onto the switch as the constant-speed FSM always did.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _STROKE_PROFILE_H_
+#define _STROKE_PROFILE_H_
+
+#include <stdint.h>
+
+/// Motor PWM through the clear part of a stroke
+const int16_t STROKE_FAST_PWM = 255;
+
+/// Motor PWM for the last part of a stroke, onto the limit switch
+const int16_t STROKE_CREEP_PWM = 128;
+
+/// Least time at full speed, in microseconds, left between the start of the creep and the switch
+const uint32_t STROKE_MIN_MARGIN_US = 60000;
+
+/// The creep starts this many mean deviations before the switch is expected
+const uint8_t STROKE_DEVIATIONS = 4;
+
+/// Each stroke moves the average by 1/2^STROKE_MEAN_SHIFT of the way
+const uint8_t STROKE_MEAN_SHIFT = 3;
+
+/// Each stroke moves the mean deviation by 1/2^STROKE_DEVIATION_SHIFT of the way
+const uint8_t STROKE_DEVIATION_SHIFT = 2;
+
+/** @brief   Learned timing of one direction of the carriage's stroke.
+ *  @details All times are in microseconds from the motor being started.
+ */
+class StrokeProfile
+{
+protected:
+    uint32_t mean_us;                        ///< Average stroke time at full speed
+    uint32_t deviation_us;                   ///< Average distance of a stroke from mean_us
+    uint32_t samples;                        ///< Strokes learned so far
+
+public:
+    StrokeProfile (void);
+
+    uint32_t fast_us (void) const;
+    void learn (uint32_t fast_us, uint32_t total_us);
+
+    /// Returns the expected stroke time at full speed, or 0 before any stroke has been learned
+    uint32_t expected_us (void) const { return mean_us; }
+};
+
+#endif // _STROKE_PROFILE_H_
@@ -0,0 +1,204 @@
+/** @file task_Dispatcher.cpp
+ *  This task holds FireBot's state machine. It sleeps until an event is
+ *  posted to its queue, makes the state transition the event calls for, and
+ *  notifies the task which owns the motor that has to change. Its states
+ *  and the events which move between them are:
+ *
+ *      BOOTING    --armed-->           SCANNING    (turntable starts scanning)
+ *      SCANNING   --fire seen-->       AIMING      (turntable stops and aims)
+ *      AIMING     --aimed-->           SPRAYING    (carriage drives toward the lever)
+ *      SPRAYING   --lever clamped-->   UNCLAMPING  (carriage reverses)
+ *      UNCLAMPING --carriage home-->   SCANNING    (carriage stops, turntable resumes)
+ *
+ *  unless more fires are waiting in the fire queue (see fire_queue.h), when
+ *  the carriage coming home or the fire being aimed at going out goes
+ *  straight to AIMING at the next one:
+ *
+ *      UNCLAMPING --carriage home-->   AIMING      (carriage stops, turntable turns to the next fire)
+ *      AIMING     --fire gone-->       AIMING      (turntable turns to the next fire)
+ *      AIMING     --fire gone-->       SCANNING    (no fire left; turntable resumes)
+ *
+ *  FireBot starts in BOOTING, where nothing moves until every part has
+ *  passed its self-test (see boot.h). Any other event is ignored, which
+ *  takes care of a fire seen before FireBot is armed, of a second sighting
+ *  of the same fire and of contact bounce as a limit switch opens again. Every
+ *  event and the transition it caused goes into the trace log.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "task_Dispatcher.h"         // Header for the dispatcher task
+#include "task_Rotation_Base.h"      // Header for turntable rotation task module
+#include "task_Extinguisher.h"       // Header for extinguisher task module
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "shares.h"                  // Header for the fire queue
+#include "atomic_share.h"            // Header for the share the state is kept in
+
+/// Number of events which can wait in the queue; there are never more than a few
+const UBaseType_t EVENT_QUEUE_SIZE = 8;
+
+/// Queue of events posted to the dispatcher
+QueueHandle_t event_queue = NULL;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+/// Storage for the events waiting in event_queue, in a build without a heap
+static uint8_t event_queue_storage[EVENT_QUEUE_SIZE * sizeof (firebot_event)];
+
+/// Control block of event_queue, in a build without a heap
+static StaticQueue_t event_queue_control;
+#endif
+
+/// The current state, written only by the dispatcher and readable by any task without a lock
+AtomicShare<firebot_state> current_state ("state", STATE_BOOTING);
+
+/// Run-time statistics of the dispatcher task
+TaskStats dispatcher_stats;
+
+
+/** @brief   Creates the event queue.
+ *  @details Must be called in setup() before the limit switch interrupts are
+ *           attached or any task is started.
+ */
+void firebot_events_begin (void)
+{
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+    event_queue = xQueueCreateStatic (EVENT_QUEUE_SIZE, sizeof (firebot_event), event_queue_storage,
+                                      &event_queue_control);
+#else
+    event_queue = xQueueCreate (EVENT_QUEUE_SIZE, sizeof (firebot_event));
+#endif
+}
+
+
+/** @brief   Posts an event to the dispatcher from a task.
+ *  @details Never blocks; the queue is long enough that an event can only be
+ *           lost if the dispatcher has stopped running.
+ *  @param   event The event
+ */
+void firebot_post (firebot_event event)
+{
+    xQueueSendToBack (event_queue, &event, 0);
+}
+
+
+/** @brief   Posts an event to the dispatcher from an interrupt service routine.
+ *  @details The dispatcher has the highest priority, so it runs as soon as
+ *           the interrupt returns.
+ *  @param   event The event
+ */
+void firebot_post_from_ISR (firebot_event event)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+    xQueueSendToBackFromISR (event_queue, &event, &higher_priority_woken);
+    portYIELD_FROM_ISR (higher_priority_woken);
+}
+
+
+/** @brief   Returns what FireBot is doing.
+ */
+firebot_state firebot_get_state (void)
+{
+    return current_state.get ();
+}
+
+
+/** @brief   This is the task function that runs FireBot's state machine.
+ *  @details The task waits on the event queue without a timeout, so it only
+ *           runs when something has happened.
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+void task_Dispatcher (void* p_params)
+{
+    (void)p_params;                             // Shuts up a compiler warning
+
+    for (;;)
+    {
+        firebot_event event;
+        xQueueReceive (event_queue, &event, portMAX_DELAY);
+        dispatcher_stats.begin_run ();
+        firebot_state old_state = current_state.get ();
+
+        switch (old_state)
+        {
+            case STATE_BOOTING:
+                if (event == EVENT_ARMED)
+                {
+                    current_state.put (STATE_SCANNING);
+                    xTaskNotify (rotation_handle, ROTATION_RESUME, eSetBits);
+                }
+                break;
+
+            case STATE_SCANNING:
+                if (event == EVENT_FIRE_SEEN)
+                {
+                    current_state.put (STATE_AIMING);
+                    xTaskNotify (rotation_handle, ROTATION_AIM, eSetBits);
+                }
+                break;
+
+            case STATE_AIMING:
+                if (event == EVENT_AIMED)
+                {
+                    current_state.put (STATE_SPRAYING);
+                    xTaskNotify (extinguisher_handle, EXTINGUISHER_CLAMP, eSetBits);
+                }
+#ifndef FIRE_SINGLE_TARGET
+                else if (event == EVENT_FIRE_GONE)
+                {
+                    // Aim at the next fire in the queue if there is one, or else scan again
+                    fire_queue.finish ();
+                    if (fire_queue.size () > 0)
+                    {
+                        xTaskNotify (rotation_handle, ROTATION_AIM, eSetBits);
+                    }
+                    else
+                    {
+                        current_state.put (STATE_SCANNING);
+                        xTaskNotify (rotation_handle, ROTATION_RESUME, eSetBits);
+                    }
+                }
+#endif
+                break;
+
+            case STATE_SPRAYING:
+                if (event == EVENT_LEVER_CLAMPED)
+                {
+                    current_state.put (STATE_UNCLAMPING);
+                    xTaskNotify (extinguisher_handle, EXTINGUISHER_UNCLAMP, eSetBits);
+                }
+                break;
+
+            case STATE_UNCLAMPING:
+                if (event == EVENT_CARRIAGE_HOME)
+                {
+                    firebot_state next_state = STATE_SCANNING;
+                    xTaskNotify (extinguisher_handle, EXTINGUISHER_STOP, eSetBits);
+#ifndef FIRE_SINGLE_TARGET
+                    // The fire just sprayed leaves the queue; if others are waiting, the
+                    //     turntable turns straight to the next one
+                    fire_queue.finish ();
+                    if (fire_queue.size () > 0)
+                    {
+                        next_state = STATE_AIMING;
+                    }
+#endif
+                    current_state.put (next_state);
+                    xTaskNotify (rotation_handle, next_state == STATE_AIMING ? ROTATION_AIM : ROTATION_RESUME,
+                                 eSetBits);
+                }
+                break;
+        }
+
+        // Log every event with the state it found and the state it left
+        trace_write (TRACE_DISPATCHER, TRACE_EVENT, event, (uint16_t)(old_state | (current_state.get () << 8)));
+        dispatcher_stats.end_run ();
+    }
+}
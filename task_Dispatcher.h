@@ -0,0 +1,62 @@
+/** @file task_Dispatcher.h
+ *  This task holds FireBot's one state machine. The other tasks and the limit
+ *  switch interrupts post events to it, such as "a fire was seen" or "the
+ *  lever is clamped", and it decides what happens next and tells the task
+ *  which owns each motor what to do with a direct task notification. Every
+ *  task blocks until it is told something, so nothing waits for a polling
+ *  period and no task reads shared state that hasn't changed.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASK_DISPATCHER_H_
+#define _TASK_DISPATCHER_H_
+
+#include <stdint.h>
+
+/// Things that happen to FireBot, posted to the dispatcher
+enum firebot_event : uint8_t
+{
+    EVENT_FIRE_SEEN,                         ///< The thermal camera found a fire
+    EVENT_AIMED,                             ///< The turntable points at the fire
+    EVENT_LEVER_CLAMPED,                     ///< Limit switch 1 closed: the extinguisher lever is fully pressed
+    EVENT_CARRIAGE_HOME,                     ///< Limit switch 2 closed: the carriage is back home
+    EVENT_FIRE_GONE,                         ///< The fire being aimed at is no longer seen
+    EVENT_ARMED                              ///< Every part passed its boot self-test (see boot.h)
+};
+
+/// What FireBot is doing
+enum firebot_state : uint8_t
+{
+    STATE_SCANNING,                          ///< Turning and looking for fires
+    STATE_AIMING,                            ///< Turning to point the nozzle at a fire
+    STATE_SPRAYING,                          ///< Driving the carriage to clamp the lever
+    STATE_UNCLAMPING,                        ///< Driving the carriage back home
+    STATE_BOOTING                            ///< Bringing up and testing the hardware; nothing moves
+};
+
+// Notification bits with which the dispatcher tells tasks what to do
+/// task_Rotation_Base: stop and aim at the fire
+const uint32_t ROTATION_AIM = 0x01;
+/// task_Rotation_Base: start turning and scanning again
+const uint32_t ROTATION_RESUME = 0x02;
+/// task_Rotation_Base: a new thermal frame has been published
+const uint32_t ROTATION_FRAME = 0x04;
+/// task_Rotation_Base: the scan scheduler has chosen a new scan speed
+const uint32_t ROTATION_SCAN = 0x08;
+/// task_Extinguisher: drive the carriage toward the lever
+const uint32_t EXTINGUISHER_CLAMP = 0x01;
+/// task_Extinguisher: drive the carriage back home
+const uint32_t EXTINGUISHER_UNCLAMP = 0x02;
+/// task_Extinguisher: stop the carriage
+const uint32_t EXTINGUISHER_STOP = 0x04;
+
+void firebot_post (firebot_event event);
+void firebot_post_from_ISR (firebot_event event);
+firebot_state firebot_get_state (void);
+void firebot_events_begin (void);
+
+void task_Dispatcher (void* p_params);
+
+#endif // _TASK_DISPATCHER_H_
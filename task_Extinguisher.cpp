@@ -8,6 +8,22 @@
  *  is pressed.  At this point, the motor stops rotating, and the assembly is reset,
  *  thus ready to extinguish another fire. The motor which rotates the turntable 
  *  resumes rotation.
+ *
+ *  The FSM itself is run by task_Dispatcher, which tells this task to clamp,
+ *  unclamp or stop with a direct task notification. The two limit switches
+ *  post their events to the dispatcher from their interrupts (see
+ *  MicroSwitch1.cpp), so the motor reverses or stops as soon as a switch
+ *  closes rather than on the next period of a polling task.
+ *
+ *  At power-up the task tests the limit switches (see boot.h) before it
+ *  takes any command.
+ *
+ *  Each stroke runs at full speed through the clear part of its travel and
+ *  creeps onto its limit switch, slowing down where the strokes before it
+ *  say the switch is about to close (see stroke_profile.h). Defining
+ *  EXTINGUISHER_CONSTANT_PWM at build time brings back the original
+ *  constant 250 PWM strokes. Either way, the time each stroke took is
+ *  written to the trace log.
  * 
  *  @author  Hunter Brooks & William Dorosk
  *  @date    20 Nov 2021 File Created
@@ -21,31 +37,52 @@
     #include <STM32FreeRTOS.h>
 #endif
 
-#include "taskshare.h"               // Header for inter-task shared data
-#include "taskqueue.h"               // Header for inter-task data queues 
-#include "shares.h"                  // Header for shares
 #include "SparkFun_TB6612.h"         // Header for the methods provided by the motor driver manufacturer
-#include "task_Rotation_Base.h"      // Header for extinguisher task module
+#include "task_Extinguisher.h"       // Header for extinguisher task module
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "stroke_profile.h"          // Header for the learned stroke timing
+#include "pin_map.h"                 // Header for the pins the motor driver and limit switches are wired to
+#include "boot.h"                    // Header for the boot self-test and retries
 
-/// The number of RTOS ticks between runs of the extinguisher task
-const TickType_t Extinguisher_PERIOD = 100;
+/// An object of class Motor for the motor that actuates the fire extinguisher
+Motor motor2 = Motor(CARRIAGE_MOTOR_PINS.in1, CARRIAGE_MOTOR_PINS.in2, CARRIAGE_MOTOR_PINS.pwm,
+                     CARRIAGE_MOTOR_PINS.offset, CARRIAGE_MOTOR_PINS.standby);
 
-// Define the pins that will be used to integrate the  motor driver to the Nucleo
+/// Handle of this task, saved by setup() so that the dispatcher can notify it
+TaskHandle_t extinguisher_handle = NULL;
 
-/// One of the two inputs that determines the direction
-#define BIN1 PB5
-/// One of the two inputs that determines the direction
-#define BIN2 PA10  
-/// PWM input that controls the speed 
-#define PWMB PB3  
-/// Allows the H-bridges to work when high (has a pulldown resistor so it must actively pulled high)  
-#define STBY PB4    
+/// Run-time statistics of this task
+TaskStats extinguisher_stats;
 
-/// This constant is used to allow motor configuration to line up with function names like "forward" within Motor class.  Value can be 1 or -1
-const int offsetB = 1;
+/// Learned timing of the stroke from home to the lever switch
+StrokeProfile clamp_profile;
 
-/// An object of class Motor for the motor that actuates the fire extinguisher
-Motor motor2 = Motor(BIN1, BIN2, PWMB, offsetB, STBY);
+/// Learned timing of the stroke from the lever switch back home
+StrokeProfile unclamp_profile;
+
+/// Microseconds in one RTOS tick
+const uint32_t EXTINGUISHER_US_PER_TICK = 1000000 / configTICK_RATE_HZ;
+
+/** @brief   Sets the carriage motor's speed and logs the command.
+ *  @param   speed The speed from -255 to 255, as for Motor::drive()
+ */
+static void drive_carriage (int speed)
+{
+    motor2.drive(speed);
+    trace_write (TRACE_EXTINGUISHER, TRACE_MOTOR, 2, (uint16_t)speed);
+}
+
+/** @brief   Logs how long a stroke took, from starting the motor to its switch closing.
+ *  @param   which 1 for the clamping stroke, 2 for the unclamping stroke
+ *  @param   stroke_us The stroke's duration
+ */
+static void trace_stroke (uint8_t which, uint32_t stroke_us)
+{
+    uint32_t stroke_ms = stroke_us / 1000;
+    trace_write (TRACE_EXTINGUISHER, TRACE_STROKE, which, (uint16_t)(stroke_ms > UINT16_MAX ? UINT16_MAX : stroke_ms));
+}
 
 /** @brief   This is the task function that actuates the fire extinguisher to extinguish the detected fire
  *  @details This task consists of an FSM which extinguishes a fire when one is detected. When a fire is 
@@ -61,61 +98,134 @@ Motor motor2 = Motor(BIN1, BIN2, PWMB, offsetB, STBY);
 void task_Extinguisher (void* p_params)
 {
     (void)p_params;                             // Shuts up a compiler warning
-    
-    // initialize each local variable value to zero
-    uint8_t start_extinguish = 0;    // variable that determines if the motor has started moving toward extinguisher
-    uint8_t start_unclamp = 0;       // variable that determines if the motor has reversed direction from extinguisher
 
-    // Initialise the xLastWakeTime variable with the current time.
-    // It will be used to run the task at precise intervals
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+    // Test the limit switches: the carriage can't be pressing the lever and be home
+    //     at once, so both reading closed means a short or a missing pull-up. While
+    //     they do, try again after a growing wait (see boot.h)
+    BootRetry retry;
+    while (digitalRead (MICROSWITCH1_PIN) == LOW && digitalRead (MICROSWITCH2_PIN) == LOW)
+    {
+        retry.wait ();
+    }
+    boot_passed (BOOT_SWITCHES, TRACE_EXTINGUISHER, retry.get_tries ());
+
+#ifdef EXTINGUISHER_CONSTANT_PWM
+    uint32_t stroke_start_us = 0;               // When the current stroke's motor was started
 
     for (;;)
     {
-        // What follows is an FSM for the extinguish operation.  The function of each state is as follows:
-        //     (1) - Begin motor rotation toward extinguisher
-        //     (2) - Reverse motor rotation direction after the extinguisher lever has been fully compressed
-        //     (3) - Halt motor rotation, set restart_program share value to one that notifies turntable rotation task to resume
-        //           rotation and reset the share values to zero
-        //     (0) - Intermediate state where the task sits until another fire is detected          
-
-        if (state_extinguish.get() == 1)  //share
+        // The dispatcher runs the FSM for the extinguish operation and tells this task
+        //     what to do with the carriage motor at each step:
+        //     (clamp)   - Begin motor rotation toward extinguisher
+        //     (unclamp) - Reverse motor rotation direction after the extinguisher lever has been fully compressed
+        //     (stop)    - Halt motor rotation once the carriage is back home
+        //     Between commands the task sleeps without using any processor time
+        uint32_t commands = 0;
+        xTaskNotifyWait (0, EXTINGUISHER_CLAMP | EXTINGUISHER_UNCLAMP | EXTINGUISHER_STOP,
+                         &commands, portMAX_DELAY);
+        extinguisher_stats.begin_run ();
+
+        if (commands & EXTINGUISHER_CLAMP)
         {
-            if (start_extinguish == 0) 
-            {
-                motor2.drive(250);
-                start_extinguish = 1; 
-            }
-            else
-            {
-            }
+            stroke_start_us = micros ();
+            drive_carriage (250);
         }
-        else if (state_extinguish.get() == 2)  //share
+        if (commands & EXTINGUISHER_UNCLAMP)
         {
-            if (start_unclamp == 0)
-            {
-                motor2.drive(-250);
-                start_unclamp = 1;
-            }
-            else
+            uint32_t now = micros ();
+            trace_stroke (1, now - stroke_start_us);
+            stroke_start_us = now;
+            drive_carriage (-250);
+        }
+        if (commands & EXTINGUISHER_STOP)
+        {
+            trace_stroke (2, micros () - stroke_start_us);
+            drive_carriage (0);
+        }
+        extinguisher_stats.end_run ();
+    }
+#else
+    StrokeProfile* p_stroke = NULL;             // Timing of the stroke under way, NULL when stopped
+    int16_t direction = 0;                      // 1 while clamping, -1 while unclamping
+    uint32_t stroke_start_us = 0;               // When the current stroke's motor was started
+    uint32_t fast_us = UINT32_MAX;              // How long the current stroke runs at full speed
+    bool creeping = false;                      // Whether the current stroke has slowed down
+    uint32_t creep_us = 0;                      // When the current stroke slowed down, from its start
+
+    for (;;)
+    {
+        // The dispatcher runs the FSM for the extinguish operation and tells this task
+        //     what to do with the carriage motor at each step:
+        //     (clamp)   - Begin motor rotation toward extinguisher
+        //     (unclamp) - Reverse motor rotation direction after the extinguisher lever has been fully compressed
+        //     (stop)    - Halt motor rotation once the carriage is back home
+        //     During a stroke the task also wakes when it is time to slow down;
+        //     otherwise it sleeps without using any processor time
+        TickType_t wait = portMAX_DELAY;
+        if (p_stroke != NULL && !creeping && fast_us != UINT32_MAX)
+        {
+            uint32_t elapsed = micros () - stroke_start_us;
+            wait = elapsed >= fast_us ? 0
+                   : (fast_us - elapsed + EXTINGUISHER_US_PER_TICK - 1) / EXTINGUISHER_US_PER_TICK;
+        }
+        uint32_t commands = 0;
+        BaseType_t notified = xTaskNotifyWait (0, EXTINGUISHER_CLAMP | EXTINGUISHER_UNCLAMP | EXTINGUISHER_STOP,
+                                               &commands, wait);
+        extinguisher_stats.begin_run ();
+        uint32_t now = micros ();
+
+        // No command came before the switch is due, so creep the rest of the way onto it
+        if (notified == pdFALSE)
+        {
+            if (p_stroke != NULL && !creeping)
             {
+                // The wakeup is rounded up to a tick and may come late, so keep when it really came
+                creeping = true;
+                creep_us = now - stroke_start_us;
+                drive_carriage (direction * STROKE_CREEP_PWM);
             }
-        }     
-        else if (state_extinguish.get() == 3)  //share
+            extinguisher_stats.end_run ();
+            continue;
+        }
+
+        // A switch closing ends the stroke toward it, so learn how long that stroke took
+        if ((commands & (EXTINGUISHER_UNCLAMP | EXTINGUISHER_STOP)) && p_stroke != NULL)
         {
-            motor2.drive(0);           
-            start_extinguish = 0; //
-            start_unclamp = 0;
-            restart_program.put(1);  //share
-            state_extinguish.put(0);  //share
-            fire_detected.put(0);
+            uint32_t stroke_us = now - stroke_start_us;
+            p_stroke->learn (creeping ? creep_us : UINT32_MAX, stroke_us);
+            trace_stroke (direction > 0 ? 1 : 2, stroke_us);
+            p_stroke = NULL;
+        }
+
+        if (commands & EXTINGUISHER_CLAMP)
+        {
+            p_stroke = &clamp_profile;
+            direction = 1;
+        }
+        if (commands & EXTINGUISHER_UNCLAMP)
+        {
+            p_stroke = &unclamp_profile;
+            direction = -1;
+        }
+        if (commands & EXTINGUISHER_STOP)
+        {
+            p_stroke = NULL;
+            direction = 0;
+        }
+
+        if (p_stroke != NULL)
+        {
+            stroke_start_us = now;
+            fast_us = p_stroke->fast_us ();
+            creeping = fast_us == 0;
+            creep_us = 0;
+            drive_carriage (direction * (creeping ? STROKE_CREEP_PWM : STROKE_FAST_PWM));
         }
         else
         {
+            drive_carriage (0);
         }
-        // This type of delay waits until it has been the given number of RTOS
-        // ticks since the task previously began running. This prevents timing
-        // inaccuracy due to not accounting for how long the task took to run
-        vTaskDelayUntil (&xLastWakeTime, Extinguisher_PERIOD);
+        extinguisher_stats.end_run ();
     }
+#endif
 }
@@ -13,4 +13,7 @@
  *  @date   20 Nov 2021 Created file
  */
 
+/// Handle of the extinguisher task, which the dispatcher notifies
+extern TaskHandle_t extinguisher_handle;
+
 void task_Extinguisher (void* p_params);
@@ -0,0 +1,446 @@
+/** @file task_Rotation_Base.cpp
+ *  This task rotates the turntable which holds the rest of the assembly while a fire has not been
+ *  detected by the thermal camera.  The turntable is rotated with a high torque motor.  When a 
+ *  fire is detected, this motor's rotation is halted while the fire is extinguished.  When 
+ *  extinguished, the motor's rotation resumes.
+ *
+ *  Before the extinguisher is started, the turntable is aimed at the fire:
+ *  the task follows the hottest point in the newest thermal frames, found
+ *  to a fraction of a pixel (see upsample.h), and turns back or forward until it is in the middle of the camera's view,
+ *  which is where the nozzle points. A fire seen by a camera which looks
+ *  another way (see thermal_array.h) is first turned toward at full speed
+ *  until the front camera sees it. Defining TURNTABLE_STOP_IN_PLACE at
+ *  build time restores the original behavior of spraying wherever the
+ *  turntable stopped.
+ *
+ *  The fire aimed at is the one chosen from the queue of fires seen (see
+ *  fire_queue.h), which may not be the one just seen, and it is followed by
+ *  its bearing in the queue from frame to frame, so that another fire in
+ *  the same frame doesn't pull the aim away from it. The hottest point of
+ *  a frame is still used for the aim when it is close enough to that
+ *  bearing to be the same fire. If the fire goes out or turns out not to
+ *  be there while the turntable is aiming, the dispatcher is told so that
+ *  it can send the turntable on to the next one. Defining
+ *  FIRE_SINGLE_TARGET at build time aims at the hottest point of the frame
+ *  which saw a fire, as before.
+ *
+ *  While scanning, the turntable turns at the speed chosen by the scan
+ *  scheduler (see scan_scheduler.h): fast past sectors where nothing is
+ *  changing and slowly past sectors which are getting warmer. Defining
+ *  TURNTABLE_CONSTANT_SCAN at build time restores the original constant
+ *  250 PWM.
+ *
+ *  There is no encoder on the turntable, so its heading is found by dead
+ *  reckoning: every drive command is logged with the time it was given,
+ *  and the heading is the heading at the last command plus the rate for
+ *  that command times the time since (see turntable_heading()).
+ *
+ *  At power-up the task tests the motor driver (see boot.h) and leaves the
+ *  turntable still until task_Dispatcher tells it to start scanning once
+ *  FireBot is armed.
+ *
+ *  The task doesn't run on a period. It sleeps until task_Dispatcher tells
+ *  it to aim or to resume turning, until the thermal camera task tells it
+ *  the scan speed has changed, and while aiming, until the thermal camera
+ *  task tells it a new frame is ready.
+ * 
+ *  @author  Hunter Brooks & William Dorosk
+ *  @date    20 Nov 2021 File Created
+ *  @date    2  Dec 2021 Finalized file
+ */
+
+// To begin, #include the necessary libraries for this task
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "shares.h"                  // Header for shares
+#include "thermal_array.h"           // Header for the directions the cameras look
+#include "SparkFun_TB6612.h"         // Header for the methods provided by the motor driver manufacturer
+#include "task_Rotation_Base.h"      // Header for turntable rotation task module
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "pin_map.h"                 // Header for the pins the motor driver is wired to
+#include "boot.h"                    // Header for saying the motor driver is ready
+
+/// Turntable PWM per degree between the hotspot and the middle of the camera's view
+const float AIM_GAIN = 20.0f;
+
+/// Lowest PWM which is sure to turn the turntable against its friction
+const int AIM_MIN_PWM = 40;
+
+/// Aiming is finished when the hotspot is within this many degrees of the middle of the view
+const float AIM_TOLERANCE_DEG = 2.0f;
+
+/// If the turntable isn't aimed after this many ticks, the fire is sprayed anyway
+const TickType_t AIM_TIMEOUT = 3000;
+
+/// An object of class Motor for the motor that rotates the turntable
+Motor motor1 = Motor(TURNTABLE_MOTOR_PINS.in1, TURNTABLE_MOTOR_PINS.in2, TURNTABLE_MOTOR_PINS.pwm,
+                     TURNTABLE_MOTOR_PINS.offset, TURNTABLE_MOTOR_PINS.standby);
+
+/// Handle of this task, saved by setup() so that the dispatcher and the thermal camera task can notify it
+TaskHandle_t rotation_handle = NULL;
+
+/// Run-time statistics of this task
+TaskStats rotation_stats;
+
+/// Turntable heading in degrees, 0 to 360, when the dead reckoning was last brought up to date
+static float command_heading_deg = 0.0f;
+/// Value of micros() when the dead reckoning was last brought up to date
+static uint32_t command_us = 0;
+/// Speed motor1 was last given
+static int command_speed = 0;
+/// Guards the last command against tasks on the other core, which may call turntable_heading()
+static CoreLock command_lock;
+
+/** @brief   Moves the heading at the last command on to now, at the speed last given.
+ *  @details Must be called with command_lock held. Doing this on every look at
+ *           the heading, and not only when the speed changes, keeps the time
+ *           since the last re-basing short; during a long scan at one speed
+ *           micros() - command_us would otherwise wrap after about 71.6
+ *           minutes and throw the heading hundreds of degrees off.
+ *  @return  The heading in degrees, 0 to 360
+ */
+static float advance_heading (void)
+{
+    uint32_t now = micros ();
+    float heading = command_heading_deg
+                  + TURNTABLE_DEG_PER_S * command_speed / 250.0f * (uint32_t)(now - command_us) * 1e-6f;
+    heading = fmodf (heading, 360.0f);
+    command_heading_deg = heading < 0.0f ? heading + 360.0f : heading;
+    command_us = now;
+    return command_heading_deg;
+}
+
+/** @brief   Estimates the turntable's heading by dead reckoning from the drive commands.
+ *  @details The turntable is taken to turn at TURNTABLE_DEG_PER_S for each 250
+ *           of PWM from the moment a command is given, which leaves out its
+ *           speeding up and slowing down and the friction which holds it still
+ *           at very low PWM. May be called from any task; the camera task
+ *           calls it for every frame, which keeps the dead reckoning re-based.
+ *  @return  The heading in degrees, 0 to 360, counted from where it was at power-up
+ */
+float turntable_heading (void)
+{
+    command_lock.enter ();
+    float heading = advance_heading ();
+    command_lock.exit ();
+    return heading;
+}
+
+/** @brief   Sets the turntable motor's speed and logs the command.
+ *  @param   speed The speed from -255 to 255, as for Motor::drive()
+ */
+static void drive_turntable (int speed)
+{
+    command_lock.enter ();
+    advance_heading ();
+    command_speed = speed;
+    command_lock.exit ();
+
+    motor1.drive(speed);
+    trace_write (TRACE_ROTATION, TRACE_MOTOR, 1, (uint16_t)speed);
+}
+
+/** @brief   Returns the speed to turn at while scanning for fires.
+ */
+static int scan_speed (void)
+{
+#ifdef TURNTABLE_CONSTANT_SCAN
+    return 250;
+#else
+    return scan_scheduler.get_pwm ();
+#endif
+}
+
+#ifndef TURNTABLE_STOP_IN_PLACE
+/// Half the angle one camera sees across, in degrees
+const float AIM_HALF_VIEW_DEG = 4.0f * FRAME_DEG_PER_PIXEL;
+
+/** @brief   Finds how far the fire is from where the nozzle points.
+ *  @details Uses the frame's hottest point, found to a fraction of a pixel
+ *           from the frame scaled up to 32x32 (see upsample.h). Defining
+ *           AIM_PIXEL_CENTROID at build time uses the centre of the pixels
+ *           above the hotspot threshold instead, as before, or the hottest
+ *           pixel's column for a fire found by the background model which
+ *           doesn't reach that threshold. The
+ *           angle is measured from the middle of the front camera's view, so a
+ *           fire seen by a camera which looks another way is that camera's
+ *           direction away, less than half a turn either way.
+ *  @param   p_frame The thermal frame to look at
+ *  @return  The angle from the nozzle to the fire in degrees, positive if the
+ *           turntable must turn forward to reach it
+ */
+static float aim_error_deg (const thermal_frame* p_frame)
+{
+#ifdef AIM_PIXEL_CENTROID
+    float column;
+    if (p_frame->hotspot.hot_pixels > 0)
+    {
+        column = p_frame->hotspot.centroid_col / 256.0f;
+    }
+    else
+    {
+        column = p_frame->hotspot.max_pixel % 8;
+    }
+#else
+    float column = p_frame->peak.col / 256.0f;
+#endif
+    float error = THERMAL_SENSOR_LAYOUT[p_frame->sensor].offset_deg + (column - 3.5f) * FRAME_DEG_PER_PIXEL;
+    return error > 180.0f ? error - 360.0f : error;
+}
+
+/** @brief   Returns true if a frame shows something hot enough to be the fire.
+ */
+static bool shows_fire (const thermal_frame* p_frame)
+{
+    return p_frame->hotspot.hot_pixels > 0 || p_frame->background_mask != 0;
+}
+
+#ifndef FIRE_SINGLE_TARGET
+/** @brief   Returns an angle wrapped into -180 to 180 degrees.
+ */
+static float wrap_deg (float angle_deg)
+{
+    angle_deg = fmodf (angle_deg, 360.0f);
+    return angle_deg > 180.0f ? angle_deg - 360.0f : (angle_deg < -180.0f ? angle_deg + 360.0f : angle_deg);
+}
+
+/** @brief   Finds how far a fire from the queue is from where the nozzle points.
+ *  @details The fire's bearing in the queue is good to a few degrees. If the
+ *           frame's hottest point is close enough to it to be the same fire,
+ *           it is used instead, as it is found to a fraction of a pixel.
+ *  @param   p_frame The newest thermal frame
+ *  @param   target The fire, as last seen
+ *  @param   p_error Where to put the angle from the nozzle to the fire, as from aim_error_deg()
+ *  @return  true if the fire is in the view of the camera the frame came from
+ */
+static bool target_error_deg (const thermal_frame* p_frame, const fire_target& target, float* p_error)
+{
+    float error = wrap_deg (target.bearing_deg - turntable_heading ());
+    if (fabsf (wrap_deg (error - THERMAL_SENSOR_LAYOUT[p_frame->sensor].offset_deg)) > AIM_HALF_VIEW_DEG)
+    {
+        return false;
+    }
+    float peak = aim_error_deg (p_frame);
+    if (shows_fire (p_frame) && fabsf (wrap_deg (peak - error)) <= FIRE_MERGE_DEG)
+    {
+        error = peak;
+    }
+    *p_error = error;
+    return true;
+}
+#endif
+
+/** @brief   Turns at full speed toward a fire outside the front camera's view.
+ *  @param   error_deg The angle to the fire, as from aim_error_deg()
+ *  @return  How long aiming may take, AIM_TIMEOUT plus the time the turn takes
+ */
+static TickType_t turn_toward (float error_deg)
+{
+    drive_turntable (error_deg < 0.0f ? -250 : 250);
+    return AIM_TIMEOUT + (TickType_t)(fabsf (error_deg) * 1000.0f / TURNTABLE_DEG_PER_S);
+}
+#endif
+
+/** @brief   This is the task function that controlls the rotation of the motor that turns the turntable.
+ *  @details This task rotates the turntable which holds the rest of the assembly while a fire has not been
+ *           detected by the thermal camera.  The turntable is rotated with a high torque motor.  When a 
+ *           fire is detected, this motor's rotation is halted while the fire is extinguished.  When 
+ *           extinguished, the motor's rotation resumes.
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+
+void task_Rotation_Base (void* p_params)
+{
+    (void)p_params;          // Shuts up a compiler warning
+
+    // Bring up the motor driver: stopping the turntable takes it out of standby. The
+    //     TB6612 has no fault or current output and the turntable no encoder, so
+    //     there is nothing to test, and the motors count as ready on the first try
+    //     (see boot.h). The turntable starts turning once the dispatcher says
+    //     FireBot is armed
+    drive_turntable (0);
+    boot_passed (BOOT_MOTORS, TRACE_ROTATION, 1);
+    bool scanning = false;              // true while turning to look for fires
+
+#ifndef TURNTABLE_STOP_IN_PLACE
+    bool aiming = false;                // true while turning to put the fire in the middle of the view
+    bool turning_round = false;         // true while turning toward a fire seen by another camera
+    TickType_t aim_start = 0;           // when aiming began
+    TickType_t aim_timeout = 0;         // how long aiming may take
+    uint32_t aim_frame = 0;             // sequence number of the last frame used for aiming
+#ifndef FIRE_SINGLE_TARGET
+    uint8_t target_id = 0;              // the fire in the queue being aimed at
+#endif
+#endif
+
+    for (;;)
+    {
+        // The task sleeps until the dispatcher tells it to aim at a fire or to resume turning
+        //     once the fire is out, or the thermal camera task tells it to change its scan
+        //     speed. While aiming it also wakes for each new thermal frame, and when aiming
+        //     has taken too long
+        TickType_t wait = portMAX_DELAY;
+#ifndef TURNTABLE_STOP_IN_PLACE
+        if (aiming)
+        {
+            TickType_t elapsed = xTaskGetTickCount () - aim_start;
+            wait = elapsed < aim_timeout ? aim_timeout - elapsed : 0;
+        }
+#endif
+        uint32_t commands = 0;
+        xTaskNotifyWait (0, ROTATION_AIM | ROTATION_RESUME | ROTATION_FRAME | ROTATION_SCAN, &commands, wait);
+        rotation_stats.begin_run ();
+
+        // If a fire is detected, the turntable motor will halt rotation, the turntable will be
+        //     aimed at the fire, and then the dispatcher will be told to start the extinguisher
+        if (commands & ROTATION_AIM)
+        {
+            scanning = false;
+            drive_turntable (0);
+#ifdef TURNTABLE_STOP_IN_PLACE
+            firebot_post (EVENT_AIMED);
+#else
+            aiming = true;
+            turning_round = false;
+            aim_start = xTaskGetTickCount ();
+            aim_timeout = AIM_TIMEOUT;
+
+            // Skip the frame in which the fire was seen; it was taken while the turntable
+            //     was still turning, and it would still coast a little way after that.
+            //     If a camera looking another way saw it, start turning toward it now
+            const thermal_frame* p_seen = thermal_frames.acquire ();
+            aim_frame = 0;
+#ifdef FIRE_SINGLE_TARGET
+            if (p_seen != NULL)
+            {
+                aim_frame = p_seen->sequence;
+                float error = aim_error_deg (p_seen);
+                if (shows_fire (p_seen) && fabsf (error) > AIM_HALF_VIEW_DEG)
+                {
+                    turning_round = true;
+                    aim_timeout = turn_toward (error);
+                }
+                thermal_frames.release (p_seen);
+            }
+#else
+            if (p_seen != NULL)
+            {
+                aim_frame = p_seen->sequence;
+                thermal_frames.release (p_seen);
+            }
+
+            // Choose the fire to put out next from the queue, and turn toward it at once
+            //     if it is outside the front camera's view
+            fire_target target;
+            if (fire_queue.choose (turntable_heading (), &target))
+            {
+                target_id = target.id;
+                trace_write (TRACE_ROTATION, TRACE_TARGET, fire_queue.size (), (uint16_t)(target.bearing_deg * 100.0f));
+                float error = wrap_deg (target.bearing_deg - turntable_heading ());
+                if (fabsf (error) > AIM_HALF_VIEW_DEG)
+                {
+                    turning_round = true;
+                    aim_timeout = turn_toward (error);
+                }
+            }
+            else
+            {
+                aiming = false;
+                firebot_post (EVENT_FIRE_GONE);
+            }
+#endif
+#endif
+        }
+
+        // Once the fire is out, the turntable resumes its rotation
+        if (commands & ROTATION_RESUME)
+        {
+            scanning = true;
+            drive_turntable (scan_speed ());
+        }
+        else if ((commands & ROTATION_SCAN) && scanning)
+        {
+            // A change of scan speed which comes just after a fire is seen is ignored
+            drive_turntable (scan_speed ());
+        }
+
+#ifndef TURNTABLE_STOP_IN_PLACE
+        if (aiming)
+        {
+            // Each new frame sets the turntable's speed in proportion to how far the
+            //     fire is from the middle of the view, until it is close enough. While
+            //     turning toward a fire another camera saw, frames which don't show it
+            //     are passed over, and aiming is given the time the turn takes
+            const thermal_frame* p_frame = thermal_frames.acquire (aim_frame);
+            bool timed_out = xTaskGetTickCount () - aim_start >= aim_timeout;
+            bool aimed = timed_out;
+            if (p_frame != NULL)
+            {
+                aim_frame = p_frame->sequence;
+#ifdef FIRE_SINGLE_TARGET
+                float error = aim_error_deg (p_frame);
+                bool usable = shows_fire (p_frame) || (p_frame->sensor == 0 && !turning_round);
+#else
+                // Only a frame from a camera which should see the fire is any use. If the
+                //     fire has left the queue it has gone out or wasn't there
+                float error = 0.0f;
+                bool usable = false;
+                fire_target target;
+                if (fire_queue.get (target_id, &target))
+                {
+                    usable = target_error_deg (p_frame, target, &error);
+                }
+                else
+                {
+                    aimed = false;
+                    aiming = false;
+                    drive_turntable (0);
+                    firebot_post (EVENT_FIRE_GONE);
+                }
+#endif
+                thermal_frames.release (p_frame);
+
+                if (usable && fabsf (error) > AIM_HALF_VIEW_DEG)
+                {
+                    if (!turning_round)
+                    {
+                        turning_round = true;
+                        aim_timeout = turn_toward (error);
+                    }
+                }
+                else if (usable)
+                {
+                    turning_round = false;
+                    if (fabsf (error) <= AIM_TOLERANCE_DEG)
+                    {
+                        aimed = true;
+                    }
+                    else if (!timed_out)
+                    {
+                        int speed = (int)(error * AIM_GAIN);
+                        speed = constrain (speed, -250, 250);
+                        if (abs (speed) < AIM_MIN_PWM)
+                        {
+                            speed = speed < 0 ? -AIM_MIN_PWM : AIM_MIN_PWM;
+                        }
+                        drive_turntable (speed);
+                    }
+                }
+            }
+            if (aimed)
+            {
+                drive_turntable (0);
+                aiming = false;
+                firebot_post (EVENT_AIMED);
+            }
+        }
+#endif
+        rotation_stats.end_run ();
+    }
+}
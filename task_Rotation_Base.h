@@ -8,4 +8,17 @@
  *  @date   20 Nov 2021 Created file
  */
 
+#ifndef _TASK_ROTATION_BASE_H_
+#define _TASK_ROTATION_BASE_H_
+
+/// Approximate rate of the turntable when driven at 250, in degrees per second
+const float TURNTABLE_DEG_PER_S = 29.4f;
+
+/// Handle of the turntable rotation task, which the dispatcher and the thermal camera task notify
+extern TaskHandle_t rotation_handle;
+
+float turntable_heading (void);
+
 void task_Rotation_Base (void* p_params);
+
+#endif // _TASK_ROTATION_BASE_H_
@@ -0,0 +1,350 @@
+/** @file task_Thermal_Sensor.cpp
+ *  This task continuously uses the thermal camera to scan for temperatures
+ *  within the view of the lense when a fire is not being extinguished. 
+ *  If a temperature above 140 degrees Fahrenheit is measured, an interrupt 
+ *  is generated which raises the value of a share from 0 to 1, thus allowing
+ *  the other tasks to take the appropriate actions.
+ *
+ *  Every period the task also streams the full 8x8 frame into the
+ *  thermal_frames ring (see frame_ring.h) with a timestamp, so that other
+ *  tasks can use the temperatures without reading the camera themselves.
+ *  Each frame carries the result of the software hotspot detector in
+ *  hotspot.cpp, which runs next to the sensor's own threshold interrupt,
+ *  and where its hottest point is to a fraction of a pixel, found from the
+ *  frame scaled up to 32x32 (see upsample.h).
+ *
+ *  A fire is detected by comparing each frame with a learned background
+ *  (see background_model.h) for the part of the circle the turntable is
+ *  pointing into, so that warm surfaces which are always there don't
+ *  trigger the extinguisher. Until a sector's background has been learned
+ *  the fixed TEMP_INT_HIGH threshold is used there. Defining
+ *  THERMAL_ABSOLUTE_MODE at build time restores the original detection by
+ *  the sensor's absolute threshold interrupt alone. Either way, a fire is
+ *  reported by posting an event to task_Dispatcher rather than through a
+ *  share. Every frame, whatever FireBot is doing, also updates the queue of
+ *  fires seen and not yet put out (see fire_queue.h). The statistics of
+ *  each frame go into the trace log.
+ *
+ *  While scanning, each frame also goes to the scan scheduler (see
+ *  scan_scheduler.h), which tells task_Rotation_Base to slow the turntable
+ *  down through sectors which are getting warmer. Defining
+ *  TURNTABLE_CONSTANT_SCAN at build time keeps the turntable at one speed.
+ *
+ *  At power-up the task starts and tests the cameras, trying again after a
+ *  growing wait while none answers (see boot.h), and nothing it sees is
+ *  acted on until FireBot is armed. There may be more than one camera (see
+ *  thermal_array.h). The task's period is split into a slot for each camera
+ *  which answered at power-up, and each slot reads one frame from one
+ *  camera. Every camera's frames go through the same steps with the heading
+ *  the camera was looking along, each camera keeping its own background, so
+ *  a fire seen by any of them is reported the same way. The frames are read
+ *  with a driver which blocks this task rather than the processor while the
+ *  bytes go over the bus (see amg88xx_async.h), so tasks of lower priority
+ *  run during the reads. While a capture is being recorded (see capture.h)
+ *  every frame and interrupt table read also goes into it.
+ *
+ *  Defining THERMAL_SYNTHETIC_LOAD_US at build time makes every frame take
+ *  that many more microseconds of processor time, as heavier detection
+ *  would, so that how much it holds up the motors can be measured with the
+ *  tasks on one core and on two (see sim/bench_dual_core.sh).
+ * 
+ *  @author  Hunter Brooks & William Dorosk
+ *  @date    20 Nov 2021 File Created
+ *  @date    2  Dec 2021 Finalized file
+ */
+
+// To begin, #include the necessary libraries for this task
+#include <Arduino.h>
+#include <PrintStream.h>
+#include <Wire.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "shares.h"                  // Header for shares
+#include "thermal_array.h"          // Header for the thermal cameras on the I2C bus
+#include "background_model.h"        // Header for the learned background of each pixel
+#include "upsample.h"                // Header for the sub-pixel locator
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
+#include "task_Thermal_Sensor.h"     // Header for thermal camera task module
+#include "trace.h"                   // Header for the trace log
+#include "capture.h"                 // Header for the recording of frames for replay on the host
+#include "frame_stream.h"            // Header for the live stream of frames
+#include "task_stats.h"              // Header for the task statistics
+#include "task_table.h"              // Header for the camera task's period
+#include "atomic_share.h"            // Header for the flags the camera interrupts raise
+#include "boot.h"                    // Header for the boot self-test and retries
+
+// Any reading on any pixel above TEMP_INT_HIGH in degrees C, or under TEMP_INT_LOW in degrees C will trigger an interrupt
+/// Specified temperature threshold, Triggers at any temperature above 140F
+#define TEMP_INT_HIGH 60
+/// Specified temperature threshold, Triggers at any temperature below 59F
+#define TEMP_INT_LOW 15
+
+// Code provided from thermal camera manufacturer
+/// Variable for each camera that keeps track if interrupt was triggered or not
+AtomicShare<bool> intReceived[THERMAL_SENSORS];
+/// Array of temperature data that is filled by thermal camera
+uint8_t pixelInts[8];  
+
+/// What each pixel of each camera normally sees in each sector of the turntable's circle
+BackgroundModel background[THERMAL_SENSORS];
+
+/// Run-time statistics of this task
+TaskStats thermal_stats;
+
+/// Each frame scaled up to 32x32 for the sub-pixel locator; kept off the task's stack
+static int16_t upsampled[UPSAMPLE_PIXELS];
+
+/** @brief   Interrupt subroutine function provided by thermal camera manufacturer
+ *           that runs when interrupt is detected. This is intended to be short.
+ *           There is one for each camera's INT pin, and each writes a trace ring
+ *           of its own, since one camera's interrupt can break into the other's
+ */
+template <uint8_t SENSOR>
+void AMG88xx_ISR() 
+{
+  intReceived[SENSOR].ISR_put (true);
+  trace_write ((trace_source)(TRACE_AMG_ISR + SENSOR), TRACE_AMG_INT, SENSOR);
+}
+
+/// Interrupt subroutine of each camera in THERMAL_SENSOR_LAYOUT
+static void (* const amg_isrs[])(void) =
+{
+    AMG88xx_ISR<0>,
+#ifndef THERMAL_SINGLE_SENSOR
+    AMG88xx_ISR<1>,
+#endif
+};
+static_assert (THERMAL_SENSORS == sizeof (amg_isrs) / sizeof (amg_isrs[0]), "each camera needs an ISR");
+static_assert (TRACE_AMG_ISR + THERMAL_SENSORS <= TRACE_RINGS, "each camera's ISR needs a trace ring of its own");
+
+/** @brief   Sets up a camera's threshold interrupt and attaches its ISR to its INT pin.
+ *  @param   sensor The camera, which must be in the timetable
+ */
+static void start_interrupt (uint8_t sensor)
+{
+    pinMode(THERMAL_SENSOR_LAYOUT[sensor].int_pin, INPUT);
+
+    //set the levels, set to absolue value mode and enable interrupts
+    thermal_array.setup_interrupt (sensor, TEMP_INT_HIGH, TEMP_INT_LOW);
+
+    //attach to our Interrupt Service Routine (ISR)
+    attachInterrupt(digitalPinToInterrupt(THERMAL_SENSOR_LAYOUT[sensor].int_pin), amg_isrs[sensor], FALLING);
+}
+
+/** @brief   This is the task function that controls the thermal camera which takes temperature measurements
+ *  @details This task continuously uses the thermal camera to scan for temperatures
+ *           within the view of the lense when a fire is not being extinguished. 
+ *           If a temperature above 140 degrees Fahrenheit is measured, an interrupt 
+ *           is generated which raises the value of a share from 0 to 1, thus allowing
+ *           the other tasks to take the appropriate actions.
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+
+void task_Thermal_Sensor (void* p_params)
+{
+    (void)p_params;                             // Shuts up a compiler warning
+
+    // The majority of what follows has been provided by the thermal camera manufacturer.
+    //     FireBot carries on with the cameras which answer and pass their self-test, as
+    //     long as there is one. While there is none, such as just after a power blip,
+    //     the cameras are tried again after a growing wait rather than given up on
+    BootRetry retry;
+    uint8_t found;
+    while ((found = thermal_array.begin ()) == 0)
+        {
+        if (retry.get_tries () == 1)
+            {
+            Serial.println("Could not find a valid AMG88xx sensor, check wiring! Still trying");
+            }
+        retry.wait ();
+        }
+    if (found < THERMAL_SENSORS)
+        {
+        Serial.println("Not every AMG88xx sensor answered, carrying on without it");
+        }
+
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        if (thermal_array.is_present (sensor))
+        {
+            start_interrupt (sensor);
+        }
+    }
+
+    // Each camera is read once per THERMAL_SENSOR_PERIOD, in its own slot
+    TickType_t slot_period = THERMAL_SENSOR_PERIOD / found;
+
+    // The cameras are ready; FireBot is armed once the motors and switches are too
+    boot_passed (BOOT_CAMERAS, TRACE_THERMAL, retry.get_tries ());
+
+    // Initialise the xLastWakeTime variable with the current time.
+    // It will be used to run the task at precise intervals
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    for (;;)
+    {
+        thermal_stats.begin_run (xLastWakeTime);
+
+        // If a fire is being extinguished, the thermal camera does not take temperature measurements
+        // If a fire isn't being extinguished, the thermal camera takes temperature measurements and tells
+        //     the dispatcher if a fire is detected
+        // Read the whole frame of the camera whose slot this is into a free buffer
+        //     of the frame ring and publish it. Each sensor makes a new frame every
+        //     100 ms, the same as the time between its slots. If every buffer is still
+        //     in use by a reader, the frame is dropped unread. If the read fails on
+        //     the bus the buffer still holds an old frame, so it isn't published or
+        //     looked at, and the camera is tried again in its next slot
+        uint8_t sensor = thermal_array.next_sensor ();
+        thermal_frame* p_frame = thermal_frames.begin_write ();
+        bool no_buffer = p_frame == NULL;
+        uint32_t bus_us = 0;
+        if (p_frame != NULL)
+        {
+            bool good = thermal_array.read (sensor, p_frame->pixels, &bus_us);
+            thermal_stats.blocked (thermal_array.get_wait_us (sensor));
+            if (!good)
+            {
+                trace_write (TRACE_THERMAL, TRACE_FRAME_FAILED, sensor);
+                p_frame = NULL;
+            }
+        }
+        if (p_frame != NULL)
+        {
+            p_frame->timestamp_us = micros ();
+            p_frame->sensor = sensor;
+            // Run the software hotspot detector on the frame with the same
+            //     threshold as the sensor's interrupt, so readers get the hottest
+            //     pixel, centroid and number of blobs along with the pixels
+            hotspot_find (p_frame->pixels, (int16_t)(TEMP_INT_HIGH * 4), &p_frame->hotspot);
+
+            // Scale the frame up and find its hottest point to a fraction of a pixel,
+            //     which is what the turntable aims at
+            upsample_frame (p_frame->pixels, upsampled);
+            upsample_peak (upsampled, &p_frame->peak);
+
+            // Compare the frame with the background of the sector the camera is
+            //     looking into. The background isn't learned while a fire is being
+            //     put out, because the turntable is stopped and the scene is changing
+            float heading = turntable_heading ();
+            float offset = THERMAL_SENSOR_LAYOUT[sensor].offset_deg;
+            p_frame->sector = BackgroundModel::sector_of (heading + offset);
+            bool learn = firebot_get_state () == STATE_SCANNING;
+#ifndef TURNTABLE_CONSTANT_SCAN
+            // Let the scan scheduler choose the turntable's speed from the frame, and
+            //     tell the rotation task if it has changed. Nor is the background learned
+            //     from a sector which is getting warmer, so that a growing fire which the
+            //     turntable is slowly passing isn't taken into it before it is detected
+            if (learn)
+            {
+                int16_t old_pwm = scan_scheduler.get_pwm ();
+                uint8_t cameras = thermal_array.get_present_mask ();
+                if (scan_scheduler.update (p_frame, heading, millis (), cameras) != old_pwm)
+                {
+                    xTaskNotify (rotation_handle, ROTATION_SCAN, eSetBits);
+                }
+                learn = !scan_scheduler.is_interested ();
+            }
+#endif
+            p_frame->background_mask = background[sensor].update (p_frame->pixels, p_frame->sector, learn);
+#ifdef THERMAL_SYNTHETIC_LOAD_US
+            delayMicroseconds (THERMAL_SYNTHETIC_LOAD_US);
+#endif
+#ifndef FIRE_SINGLE_TARGET
+            // Every frame updates the queue of fires, with the same test for a fire as
+            //     below: well above the learned background, or above the absolute
+            //     threshold where no background has been learned yet
+            uint64_t fire_mask = background[sensor].is_warm (p_frame->sector) ? p_frame->background_mask
+                                                                                : p_frame->hotspot.hot_mask;
+            fire_queue.observe (p_frame->pixels, fire_mask, heading, offset, millis ());
+#endif
+
+            // Blend the frame into the map of the whole room while scanning. Each time
+            //     round, log the hottest bearing and how much has changed
+            if (firebot_get_state () == STATE_SCANNING)
+            {
+                uint16_t revolution = panorama.get_revolution ();
+                panorama.update (p_frame->pixels, heading, offset);
+                if (panorama.get_revolution () != revolution)
+                {
+                    float bearing;
+                    panorama.hottest (&bearing);
+                    uint16_t changed = panorama.changed_since_last_revolution (NULL, 0);
+                    trace_write (TRACE_THERMAL, TRACE_PANORAMA, changed > UINT8_MAX ? UINT8_MAX : changed,
+                                 (uint16_t)(bearing * 100.0f));
+                }
+            }
+            thermal_frames.publish (p_frame, bus_us);
+            capture_frame (sensor, p_frame->pixels);
+            stream_frame (sensor, p_frame->pixels, p_frame->timestamp_us);
+            trace_write (TRACE_THERMAL, TRACE_FRAME, p_frame->hotspot.hot_pixels, (uint16_t)bus_us);
+            trace_write (TRACE_THERMAL, TRACE_FRAME_TEMP, p_frame->hotspot.blobs,
+                         (uint16_t)p_frame->hotspot.max_temp);
+
+            // While the turntable is aiming at a fire it waits for each new frame
+            if (firebot_get_state () == STATE_AIMING)
+            {
+                xTaskNotify (rotation_handle, ROTATION_FRAME, eSetBits);
+            }
+        }
+        else if (no_buffer)
+        {
+            trace_write (TRACE_THERMAL, TRACE_FRAME_DROPPED);
+        }
+
+        if (firebot_get_state () != STATE_SCANNING)
+        {
+        }
+        else 
+        {
+#ifdef THERMAL_ABSOLUTE_MODE
+            if(intReceived[sensor].get ())
+            {
+                thermal_array.read_interrupt (sensor, pixelInts);
+                thermal_stats.blocked (thermal_array.get_wait_us (sensor));
+                capture_interrupt (sensor, pixelInts);
+                firebot_post (EVENT_FIRE_SEEN);
+                
+                //clear the interrupt so we can get the next one!
+                thermal_array.clear_interrupt (sensor);
+                thermal_stats.blocked (thermal_array.get_wait_us (sensor));
+                intReceived[sensor].put (false);
+             }
+#else
+            // A fire is something well above the learned background; where there is
+            //     no background yet, anything above the absolute threshold counts
+            if (p_frame != NULL)
+            {
+                bool fire = background[sensor].is_warm (p_frame->sector) ? p_frame->background_mask != 0
+                                                                         : p_frame->hotspot.hot_pixels > 0;
+                if (fire)
+                {
+                    firebot_post (EVENT_FIRE_SEEN);
+                }
+            }
+#endif
+        }
+        // A camera which wasn't there at boot, such as one which came up late after
+        //     a power blip, goes on being tried with the same growing wait, and one
+        //     which passes gets a slot of its own from the next slot on
+        for (uint8_t late = 0; late < THERMAL_SENSORS; late++)
+        {
+            uint32_t wait_us;
+            bool joined = thermal_array.retry (late, &wait_us);
+            thermal_stats.blocked (wait_us);
+            if (joined)
+            {
+                start_interrupt (late);
+                slot_period = THERMAL_SENSOR_PERIOD / thermal_array.get_count ();
+                trace_write (TRACE_THERMAL, TRACE_CAMERA_JOINED, late, thermal_array.get_tries (late));
+            }
+        }
+        thermal_stats.end_run ();
+
+        // This type of delay waits until it has been the given number of RTOS
+        // ticks since the task previously began running. This prevents timing
+        // inaccuracy due to not accounting for how long the task took to run
+        vTaskDelayUntil (&xLastWakeTime, slot_period);
+    }
+}
@@ -0,0 +1,82 @@
+/** @file task_memory.h
+ *  This file contains the memory each FireBot task is made in. In a static
+ *  allocation build, one where FreeRTOSConfig.h sets
+ *  configSUPPORT_DYNAMIC_ALLOCATION to 0 and configSUPPORT_STATIC_ALLOCATION
+ *  to 1, a TaskMemory object holds the task's stack and control block, so
+ *  every byte of RAM the tasks use is placed by the linker and shows up in
+ *  the RAM budget report (see sim/ram_budget.sh). Otherwise the object is
+ *  empty and the task is made from the FreeRTOS heap, as it always was.
+ *
+ *  Where the kernel runs on more than one core, as on the dual-core ESP32,
+ *  each task is pinned to the core it is given, which stays the one it runs
+ *  on; elsewhere the core is ignored.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASK_MEMORY_H_
+#define _TASK_MEMORY_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0 && configSUPPORT_STATIC_ALLOCATION != 1
+    #error "A build without dynamic allocation needs configSUPPORT_STATIC_ALLOCATION set to 1"
+#endif
+
+/// Whether the kernel has more than one core to pin tasks to
+#if defined portNUM_PROCESSORS && portNUM_PROCESSORS > 1
+    #define TASK_PINNED_TO_CORE
+#endif
+
+/// Units of stack depth in one 32 bit word: xTaskCreate() counts words on the STM32 and bytes on the ESP32
+const uint32_t STACK_DEPTH_PER_WORD = sizeof (uint32_t) / sizeof (StackType_t);
+
+/** @brief   Stack and control block for one task.
+ *  @details Made at file scope, so that the linker places it in RAM.
+ *  @tparam  STACK_WORDS Stack size in 32 bit words
+ */
+template <uint32_t STACK_WORDS>
+class TaskMemory
+{
+protected:
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+    StackType_t stack[STACK_WORDS * STACK_DEPTH_PER_WORD];   ///< The task's stack
+    StaticTask_t tcb;                                        ///< The task's control block
+#endif
+
+public:
+    /** @brief   Creates the task in this memory, or from the heap in a dynamic build.
+     *  @param   function The task function
+     *  @param   p_name Task name for debugging printouts
+     *  @param   priority The task's priority
+     *  @param   core The core to pin the task to, if the kernel has more than one
+     *  @return  The new task's handle, or NULL if it couldn't be made
+     */
+    TaskHandle_t create (TaskFunction_t function, const char* p_name, UBaseType_t priority, BaseType_t core = 0)
+    {
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0 && defined TASK_PINNED_TO_CORE
+        return xTaskCreateStaticPinnedToCore (function, p_name, STACK_WORDS * STACK_DEPTH_PER_WORD, NULL,
+                                              priority, stack, &tcb, core);
+#elif configSUPPORT_DYNAMIC_ALLOCATION == 0
+        (void)core;
+        return xTaskCreateStatic (function, p_name, STACK_WORDS * STACK_DEPTH_PER_WORD, NULL,
+                                  priority, stack, &tcb);
+#elif defined TASK_PINNED_TO_CORE
+        TaskHandle_t handle = NULL;
+        xTaskCreatePinnedToCore (function, p_name, STACK_WORDS * STACK_DEPTH_PER_WORD, NULL, priority,
+                                 &handle, core);
+        return handle;
+#else
+        (void)core;
+        TaskHandle_t handle = NULL;
+        xTaskCreate (function, p_name, STACK_WORDS * STACK_DEPTH_PER_WORD, NULL, priority, &handle);
+        return handle;
+#endif
+    }
+};
+
+#endif // _TASK_MEMORY_H_
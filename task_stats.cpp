@@ -0,0 +1,242 @@
+/** @file task_stats.cpp
+ *  This file contains the run-time statistics kept by each task and the
+ *  serial report which prints them.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "task_stats.h"              // Header for the task statistics
+#include "core_lock.h"               // Header for the lock which also holds off the other core
+
+/// Microseconds in one RTOS tick
+const uint32_t US_PER_TICK = 1000000 / configTICK_RATE_HZ;
+
+/// Every task's statistics, in the order their objects were constructed
+static TaskStats* task_stats_list[TASK_STATS_MAX];
+
+/// Number of entries in task_stats_list
+static uint8_t task_stats_count = 0;
+
+/// Value of micros() when the tick count was zero, as near as has been seen so far
+static uint32_t tick_offset_us = 0;
+
+/// Whether tick_offset_us has been set
+static bool tick_offset_known = false;
+
+/// Guards every task's statistics and the tick offset against the other tasks and core
+static CoreLock stats_lock;
+
+/// Value of micros() when stats_clock_us() was last called
+static uint32_t clock_last_us = 0;
+
+/// Microseconds since power-up at the last call of stats_clock_us()
+static uint64_t clock_total_us = 0;
+
+
+/** @brief   Returns the microseconds since power-up on a clock which doesn't wrap.
+ *  @details micros() wraps after 71.6 minutes, after which a time since the
+ *           first run taken from it would start again from zero. Each call
+ *           adds the time since the one before, which is right as long as
+ *           some task runs at least once in that time; the periodic tasks
+ *           run many times a second. Must be called with stats_lock held.
+ */
+static uint64_t stats_clock_us (void)
+{
+    uint32_t now = micros ();
+    clock_total_us += (uint32_t)(now - clock_last_us);
+    clock_last_us = now;
+    return clock_total_us;
+}
+
+
+/** @brief   Creates empty statistics and adds them to the list which is reported.
+ *  @details Objects are made at file scope before setup() runs, so adding to
+ *           the list needs no protection. Objects beyond TASK_STATS_MAX still
+ *           work but aren't reported.
+ */
+TaskStats::TaskStats (void)
+{
+    memset (&data, 0, sizeof (data));
+    handle = NULL;
+    run_start_us = 0;
+    run_blocked_us = 0;
+    first_start_us = 0;
+
+    if (task_stats_count < TASK_STATS_MAX)
+    {
+        task_stats_list[task_stats_count++] = this;
+    }
+}
+
+
+/** @brief   Marks the start of a run of a task which waits for events.
+ */
+void TaskStats::begin_run (void)
+{
+    run_start_us = micros ();
+    run_blocked_us = 0;
+    if (handle == NULL)
+    {
+        handle = xTaskGetCurrentTaskHandle ();
+        strncpy (data.name, pcTaskGetName (handle), TASK_STATS_NAME_SIZE - 1);
+        stats_lock.enter ();
+        first_start_us = stats_clock_us ();
+        stats_lock.exit ();
+    }
+}
+
+
+/** @brief   Marks the start of a run of a periodic task and how late it started.
+ *  @details The tick count and micros() don't start together, so the time of
+ *           tick zero is taken from the earliest any periodic task has started
+ *           relative to its tick. Tasks usually wake right on the tick, so this
+ *           is soon accurate to a few microseconds; runs measured before then
+ *           may be counted a little later than they were.
+ *  @param   due_tick The tick the task was meant to wake at, which is the value
+ *           of the xLastWakeTime variable given to vTaskDelayUntil()
+ */
+void TaskStats::begin_run (TickType_t due_tick)
+{
+    begin_run ();
+    data.periodic = true;
+
+    uint32_t offset_us = run_start_us - due_tick * US_PER_TICK;
+    stats_lock.enter ();
+    if (!tick_offset_known || (int32_t)(offset_us - tick_offset_us) < 0)
+    {
+        tick_offset_us = offset_us;
+        tick_offset_known = true;
+    }
+    uint32_t late_us = offset_us - tick_offset_us;
+
+    uint8_t bin = 0;
+    while (bin < TASK_LATE_BINS - 1 && late_us >= TASK_LATE_BIN_US[bin])
+    {
+        bin++;
+    }
+    data.late_bins[bin]++;
+    if (late_us > data.late_max_us)
+    {
+        data.late_max_us = late_us;
+    }
+    stats_lock.exit ();
+}
+
+
+/** @brief   Counts time in the current run which the task spent blocked waiting for hardware.
+ *  @details Other tasks have the processor while this one waits, so the time
+ *           is left out of the run's time and the task's share of the
+ *           processor; it still counts in the run's response time.
+ *  @param   wait_us How long the task was blocked, in microseconds
+ */
+void TaskStats::blocked (uint32_t wait_us)
+{
+    run_blocked_us += wait_us;
+}
+
+
+/** @brief   Marks the end of a run, just before the task waits again.
+ */
+void TaskStats::end_run (void)
+{
+    uint32_t now = micros ();
+    uint32_t response_us = now - run_start_us;
+    uint32_t exec_us = response_us > run_blocked_us ? response_us - run_blocked_us : 0;
+
+    stats_lock.enter ();
+    data.runs++;
+    data.exec_total_us += exec_us;
+    if (exec_us > data.exec_max_us)
+    {
+        data.exec_max_us = exec_us;
+    }
+    if (response_us > data.response_max_us)
+    {
+        data.response_max_us = response_us;
+    }
+    data.elapsed_us = stats_clock_us () - first_start_us;
+    stats_lock.exit ();
+}
+
+
+/** @brief   Returns a consistent copy of the statistics with the stack high-water mark filled in.
+ */
+task_stats_data TaskStats::get (void)
+{
+    stats_lock.enter ();
+    task_stats_data copy = data;
+    stats_lock.exit ();
+
+    if (handle != NULL)
+    {
+        copy.stack_free = uxTaskGetStackHighWaterMark (handle);
+    }
+    return copy;
+}
+
+
+/** @brief   Returns the number of tasks keeping statistics.
+ */
+uint8_t TaskStats::count (void)
+{
+    return task_stats_count;
+}
+
+
+/** @brief   Returns one task's statistics.
+ *  @param   index Which task, from 0 to count() - 1
+ *  @return  A pointer to the statistics, or NULL if there is no such task
+ */
+TaskStats* TaskStats::get_task (uint8_t index)
+{
+    return index < task_stats_count ? task_stats_list[index] : NULL;
+}
+
+
+/** @brief   Prints every task's statistics, one line per task.
+ *  @details Each line gives the task's runs, its mean and longest run time
+ *           not counting the time it was blocked, its longest response time
+ *           if that was longer, for periodic tasks its latest start and the
+ *           histogram of start times over the bins of TASK_LATE_BIN_US, the
+ *           share of the processor it has used, and its stack high-water
+ *           mark. Tasks which haven't run yet are left out.
+ *  @param   printer The serial port or other stream to print to
+ */
+void task_stats_report (Print& printer)
+{
+    printer << "Task stats at " << millis () << " ms" << endl;
+    for (uint8_t index = 0; index < task_stats_count; index++)
+    {
+        task_stats_data stats = task_stats_list[index]->get ();
+        if (stats.name[0] == '\0')
+        {
+            continue;
+        }
+        uint32_t mean_us = stats.runs ? (uint32_t)(stats.exec_total_us / stats.runs) : 0;
+        uint32_t load = stats.elapsed_us ? (uint32_t)(stats.exec_total_us * 1000 / stats.elapsed_us) : 0;
+
+        printer << stats.name << ": " << stats.runs << " runs, " << mean_us << "/"
+                << stats.exec_max_us << " us mean/max";
+        if (stats.response_max_us > stats.exec_max_us)
+        {
+            printer << ", response " << stats.response_max_us << " us max";
+        }
+        if (stats.periodic)
+        {
+            printer << ", late " << stats.late_max_us << " us max [";
+            for (uint8_t bin = 0; bin < TASK_LATE_BINS; bin++)
+            {
+                printer << stats.late_bins[bin] << (bin < TASK_LATE_BINS - 1 ? " " : "]");
+            }
+        }
+        printer << ", cpu " << load / 10 << "." << load % 10 << "%, stack "
+                << stats.stack_free << " free" << endl;
+    }
+}
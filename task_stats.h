@@ -0,0 +1,90 @@
+/** @file task_stats.h
+ *  This file contains the run-time statistics each task keeps about itself:
+ *  how many times it has run, how long each run took, how late each run of a
+ *  periodic task started after the tick vTaskDelayUntil() was meant to wake
+ *  it at, the share of the processor it has used, and the least free stack
+ *  it has ever had. The numbers are meant for choosing task periods,
+ *  priorities and stack sizes from measurements rather than guesses.
+ *
+ *  A task calls begin_run() when it wakes and end_run() before it sleeps
+ *  again. The time between the two is the run's response time. It includes
+ *  any time the task spent blocked in the run waiting for hardware, such as
+ *  a frame coming in over the I2C bus, when other tasks had the processor;
+ *  a task which blocks like this says how long with blocked(), and that
+ *  time is left out of its run times and its share of the processor. What
+ *  is left still includes any time taken by interrupts and higher priority
+ *  tasks which ran in between, so it is never less than the execution time;
+ *  for the highest priority task the two are the same.
+ *
+ *  Sending the letter 's' to the serial port prints a short report of every
+ *  task's statistics; see task_stats_report().
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASK_STATS_H_
+#define _TASK_STATS_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+/// Most tasks whose statistics can be kept
+const uint8_t TASK_STATS_MAX = 8;
+
+/// Number of bins in the histogram of how late periodic runs start
+const uint8_t TASK_LATE_BINS = 8;
+
+/// Upper ends of the lateness bins in microseconds; the last bin holds anything later
+const uint32_t TASK_LATE_BIN_US[TASK_LATE_BINS - 1] = { 50, 100, 200, 500, 1000, 2000, 5000 };
+
+/// Longest task name kept, including the terminating zero
+const uint8_t TASK_STATS_NAME_SIZE = 16;
+
+/// What is known about one task; plain data, so it can be copied anywhere
+struct task_stats_data
+{
+    char name[TASK_STATS_NAME_SIZE];         ///< Task name, as given to xTaskCreate(); empty until the first run
+    uint32_t runs;                           ///< Number of completed runs
+    uint32_t exec_max_us;                    ///< Longest run, not counting the time it was blocked
+    uint64_t exec_total_us;                  ///< Time spent in all runs, not counting the time they were blocked
+    uint32_t response_max_us;                ///< Longest run from begin_run() to end_run(), blocked time included
+    uint64_t elapsed_us;                     ///< Time from the first run beginning to the last one ending
+    uint32_t late_max_us;                    ///< Latest start of a periodic run
+    uint32_t late_bins[TASK_LATE_BINS];      ///< Periodic runs by how late they started
+    uint32_t stack_free;                     ///< Least free stack so far in words, from uxTaskGetStackHighWaterMark()
+    bool periodic;                           ///< Whether the task runs from vTaskDelayUntil()
+};
+
+/** @brief   Run-time statistics of one task, kept by the task itself.
+ *  @details Each task has one of these at file scope. Only the task writes to
+ *           it; any task may read it with get().
+ */
+class TaskStats
+{
+protected:
+    task_stats_data data;                    ///< The statistics
+    TaskHandle_t handle;                     ///< The task, found on its first run; NULL before it
+    uint32_t run_start_us;                   ///< When the current run began
+    uint32_t run_blocked_us;                 ///< Time the current run has been blocked so far
+    uint64_t first_start_us;                 ///< When the first run began, on the 64 bit clock
+
+public:
+    TaskStats (void);
+
+    void begin_run (void);
+    void begin_run (TickType_t due_tick);
+    void blocked (uint32_t wait_us);
+    void end_run (void);
+
+    task_stats_data get (void);
+
+    static uint8_t count (void);
+    static TaskStats* get_task (uint8_t index);
+};
+
+void task_stats_report (Print& printer);
+
+#endif // _TASK_STATS_H_
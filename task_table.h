@@ -0,0 +1,258 @@
+/** @file task_table.h
+ *  This file contains the table of FireBot's tasks: each task's function,
+ *  name, priority and stack size, how often it can be woken, how soon it
+ *  must have finished once woken, and the most processor time one run may
+ *  take. setup() creates every task from its line of the table, and the
+ *  periodic tasks take their periods from here, so a task's timing is
+ *  written in one place.
+ *
+ *  The table is checked when the firmware is compiled, so that a retuned
+ *  period or priority which would let a task miss its deadline stops the
+ *  build. Two things are checked:
+ *
+ *   - Priorities are in deadline-monotonic order: a task with a shorter
+ *     deadline never has a lower priority than one with a longer deadline.
+ *     This is rate-monotonic order for a task whose deadline is its period,
+ *     and lets the tasks which react to events, whose deadlines are much
+ *     shorter than the time between events, sit above the periodic ones.
+ *     task_Trace has no deadline; it only uses time nobody else wants, so
+ *     it must have the lowest priority of all.
+ *
+ *   - The tasks' density, the sum of each one's execution time divided by
+ *     its deadline, is within the Liu and Layland bound n(2^(1/n) - 1) for
+ *     n tasks. A task set under the bound meets every deadline under fixed
+ *     priority scheduling whatever the phasing of the tasks.
+ *
+ *  The execution times are budgets, not measurements: the host simulation
+ *  doesn't count the processor time of the firmware's own code. Each is
+ *  well over what the task does in one run on the Cortex-M4, and should be
+ *  checked against the longest run in the task statistics report (see
+ *  task_stats.h) on the robot after any change to a task. The bound is
+ *  only a quick check which passes some task sets that could still miss a
+ *  deadline, and fails some that couldn't. sim/task_rta.cpp does the full
+ *  response-time analysis of this table with the times in that report,
+ *  and works out the worst case of the fire path from camera to
+ *  extinguisher.
+ *
+ *  On a dual-core ESP32 each task is also pinned to one core (see
+ *  task_memory.h): reading the thermal cameras and looking for fires in the
+ *  frames, whose processor time grows with every camera and every step of
+ *  detection, run on SENSING_CORE, and the dispatcher and the tasks which
+ *  drive the motors run on ACTUATION_CORE, so that detection never holds up
+ *  a motor command however heavy it gets. The checks above still hold for
+ *  each core, as the tasks on one core are a part of the whole table.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TASK_TABLE_H_
+#define _TASK_TABLE_H_
+
+#include <Arduino.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "task_Rotation_Base.h"      // Header for turntable rotation task module
+#include "task_Thermal_Sensor.h"     // Header for thermal camera task module
+#include "task_Extinguisher.h"       // Header for extinguisher task module
+#include "task_Dispatcher.h"         // Header for the dispatcher which runs the FSM
+#include "MircroSwitch1.h"           // Header for micro limit switch 1 task module
+#include "MicroSwitch2.h"            // Header for micro limit switch 2 task module
+#include "trace.h"                   // Header for the trace log's drain period
+#include "thermal_array.h"           // Header for the number of cameras and how they are read
+#include "task_memory.h"             // Header for the memory tasks are made in
+
+/// Microseconds in one RTOS tick
+constexpr uint32_t TASK_US_PER_TICK = 1000000 / configTICK_RATE_HZ;
+
+/// The number of RTOS ticks in which the thermal camera task reads every camera once
+constexpr TickType_t THERMAL_SENSOR_PERIOD = 100;
+
+/// The number of RTOS ticks between runs of each limit switch polling task
+constexpr TickType_t MICROSWITCH_PERIOD = 100;
+
+/// Core the thermal cameras are read and their frames searched for fires on, in a dual-core build
+constexpr BaseType_t SENSING_CORE = 0;
+
+/// Core the dispatcher and the motor tasks run on, in a dual-core build
+constexpr BaseType_t ACTUATION_CORE = 1;
+
+/// Shortest time between two events posted to the dispatcher, in ticks: the switches' debounce time
+constexpr TickType_t EVENT_MIN_SPACING = 5;
+
+#ifdef AMG88XX_ASYNC
+/// Processor time of one frame read; the transfer itself runs from the I2C interrupt
+constexpr uint32_t THERMAL_READ_US = 50;
+#else
+/// Processor time of one frame read, which waits in a loop for all 128 bytes at 100 kHz
+constexpr uint32_t THERMAL_READ_US = 12800;
+#endif
+
+/// What is known about one task before it is created
+struct task_spec
+{
+    TaskFunction_t function;                 ///< The task function
+    const char* p_name;                      ///< Task name for debugging printouts
+    UBaseType_t priority;                    ///< The task's priority
+    uint32_t stack_words;                    ///< Stack size in 32 bit words
+    TickType_t period;                       ///< Period, or for a task woken by events the shortest time between them, in ticks
+    TickType_t deadline;                     ///< Longest a run may take from waking to finishing, in ticks; 0 for none
+    uint32_t wcet_us;                        ///< Budget of processor time for one run, in microseconds
+    BaseType_t core;                         ///< Core the task is pinned to in a dual-core build
+};
+
+/// Index of each task in FIREBOT_TASKS
+enum firebot_task : uint8_t
+{
+    TASK_DISPATCHER,
+    TASK_ROTATION,
+    TASK_THERMAL,
+    TASK_EXTINGUISHER,
+    TASK_TRACE,
+#ifdef LIMIT_SWITCH_POLLING
+    TASK_SWITCH1,
+    TASK_SWITCH2,
+#endif
+    TASK_COUNT                               ///< Number of tasks
+};
+
+// Stack sizes in 32 bit words. Each is twice the most the host simulation has seen
+//     the task use, plus 128 words for the saved processor and floating point
+//     registers and for library code the simulation doesn't model, rounded up to
+//     a multiple of 64 words. The stack used in the simulation was (in words):
+//     Dispatcher 46, Rotation 70, Thermal Sensor 294, Extinguisher 58, Trace 186
+//     while printing the task statistics, and 54 for each polled limit switch.
+//     Check them against the high-water marks in the task statistics report
+//     after any change to a task
+//
+// Deadlines in ticks. The dispatcher must act on an event within a tick, a
+//     polling task must pass on what it read within two, and the carriage
+//     motor must have its command before the next event can come. The camera
+//     and turntable tasks must be done with one frame before the next is read
+
+/// FireBot's tasks, in the order of firebot_task
+constexpr task_spec FIREBOT_TASKS[] =
+{
+    // Runs the FSM, making each state transition as soon as an event is posted.
+    //     It has the highest priority so that no event waits
+    { task_Dispatcher, "Dispatcher", 6, 256, EVENT_MIN_SPACING, 1, 100, ACTUATION_CORE },
+
+    // Rotates the turntable while a fire has not been detected, and aims it at one
+    //     which has; woken for each new frame at most
+    { task_Rotation_Base, "Rotation", 1, 320, THERMAL_SENSOR_PERIOD / THERMAL_SENSORS,
+      THERMAL_SENSOR_PERIOD / THERMAL_SENSORS, 500, ACTUATION_CORE },
+
+    // Reads one camera in each slot of its period and looks for fires in the frame
+    { task_Thermal_Sensor, "Thermal Sensor", 2, 768, THERMAL_SENSOR_PERIOD / THERMAL_SENSORS,
+      THERMAL_SENSOR_PERIOD / THERMAL_SENSORS, THERMAL_READ_US + 1000, SENSING_CORE },
+
+    // Actuates the motor that compresses the lever of the fire extinguisher when told to
+    { task_Extinguisher, "Extinguisher", 3, 256, EVENT_MIN_SPACING, EVENT_MIN_SPACING, 200, ACTUATION_CORE },
+
+    // Sends the trace log over the serial port when nothing else is running; it is
+    //     with the cameras so that its printing never delays the motors
+    { task_Trace, "Trace", 0, 512, TRACE_DRAIN_PERIOD, 0, 0, SENSING_CORE },
+
+#ifdef LIMIT_SWITCH_POLLING
+    // Reads the switch which closes when the lever is fully pressed
+    { MicroSwitch1, "MicroSwitch1", 4, 256, MICROSWITCH_PERIOD, 2, 50, ACTUATION_CORE },
+
+    // Reads the switch which closes when the carriage is back home
+    { MicroSwitch2, "MicroSwitch2", 5, 256, MICROSWITCH_PERIOD, 2, 50, ACTUATION_CORE },
+#endif
+};
+
+static_assert (sizeof (FIREBOT_TASKS) / sizeof (FIREBOT_TASKS[0]) == TASK_COUNT,
+               "FIREBOT_TASKS must have one line for each firebot_task");
+
+/** @brief   Checks that one task's priority is in deadline-monotonic order with another's.
+ *  @param   higher A task
+ *  @param   lower Another task
+ *  @return  true unless @c higher has a higher priority than @c lower and a longer
+ *           deadline, or has no deadline while @c lower has one
+ */
+constexpr bool deadline_ordered (const task_spec& higher, const task_spec& lower)
+{
+    return higher.priority <= lower.priority || lower.deadline == 0
+           || (higher.deadline != 0 && higher.deadline <= lower.deadline);
+}
+
+/** @brief   Checks the order of every pair of tasks from one on.
+ *  @param   first The first task to compare with all the others
+ *  @param   second The task to compare it with
+ */
+constexpr bool tasks_ordered (uint8_t first = 0, uint8_t second = 0)
+{
+    return first >= TASK_COUNT ? true
+           : second >= TASK_COUNT ? tasks_ordered (first + 1, 0)
+           : deadline_ordered (FIREBOT_TASKS[first], FIREBOT_TASKS[second]) && tasks_ordered (first, second + 1);
+}
+
+/** @brief   Checks that every task can finish within its period.
+ *  @param   task The first task to check
+ */
+constexpr bool deadlines_within_periods (uint8_t task = 0)
+{
+    return task >= TASK_COUNT ? true
+           : FIREBOT_TASKS[task].deadline <= FIREBOT_TASKS[task].period
+             && (uint64_t)FIREBOT_TASKS[task].wcet_us <= (uint64_t)FIREBOT_TASKS[task].deadline * TASK_US_PER_TICK
+             && deadlines_within_periods (task + 1);
+}
+
+/** @brief   Adds up the density of the tasks with deadlines.
+ *  @param   task The first task to add
+ *  @return  The sum of execution time over deadline, in parts per million
+ */
+constexpr uint64_t task_density_ppm (uint8_t task = 0)
+{
+    return task >= TASK_COUNT ? 0
+           : (FIREBOT_TASKS[task].deadline == 0 ? 0
+              : (uint64_t)FIREBOT_TASKS[task].wcet_us * 1000000
+                / ((uint64_t)FIREBOT_TASKS[task].deadline * TASK_US_PER_TICK))
+             + task_density_ppm (task + 1);
+}
+
+/** @brief   Counts the tasks with deadlines.
+ *  @param   task The first task to count
+ */
+constexpr uint8_t tasks_with_deadlines (uint8_t task = 0)
+{
+    return task >= TASK_COUNT ? 0
+           : (FIREBOT_TASKS[task].deadline != 0 ? 1 : 0) + tasks_with_deadlines (task + 1);
+}
+
+/// The Liu and Layland bound n(2^(1/n) - 1) for 1 to 8 tasks, in parts per million, rounded down
+constexpr uint32_t LIU_LAYLAND_BOUND_PPM[] =
+{
+    1000000, 828427, 779763, 756828, 743491, 734772, 728626, 724061
+};
+
+static_assert (tasks_with_deadlines () >= 1 && tasks_with_deadlines () <= 8,
+               "LIU_LAYLAND_BOUND_PPM covers 1 to 8 tasks");
+static_assert (tasks_ordered (),
+               "task priorities must be in deadline-monotonic order; see FIREBOT_TASKS in task_table.h");
+static_assert (deadlines_within_periods (),
+               "each task's deadline must be within its period and longer than its execution time");
+static_assert (task_density_ppm () <= LIU_LAYLAND_BOUND_PPM[tasks_with_deadlines () - 1],
+               "the tasks could miss their deadlines; check the periods and execution times in FIREBOT_TASKS");
+
+/// The memory task TASK is made in; see task_memory.h
+template <uint8_t TASK>
+using TaskMemoryOf = TaskMemory<FIREBOT_TASKS[TASK].stack_words>;
+
+/** @brief   Creates a task in its memory from its line of FIREBOT_TASKS.
+ *  @tparam  TASK Which task, one of firebot_task
+ *  @param   memory The memory made for it
+ *  @return  The new task's handle, or NULL if it couldn't be made
+ */
+template <uint8_t TASK>
+TaskHandle_t task_create (TaskMemoryOf<TASK>& memory)
+{
+    static_assert (TASK < TASK_COUNT, "no such task");
+    return memory.create (FIREBOT_TASKS[TASK].function, FIREBOT_TASKS[TASK].p_name, FIREBOT_TASKS[TASK].priority,
+                          FIREBOT_TASKS[TASK].core);
+}
+
+#endif // _TASK_TABLE_H_
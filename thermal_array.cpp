@@ -0,0 +1,339 @@
+/** @file thermal_array.cpp
+ *  This file contains the array of thermal cameras which share the I2C bus
+ *  and are read one frame at a time in turn by task_Thermal_Sensor.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#include <string.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "thermal_array.h"           // Header for the camera array
+
+/// RTOS ticks a camera takes to settle after its reset before it gives real frames
+const TickType_t CAMERA_SETTLE_TICKS = pdMS_TO_TICKS (100);
+
+/** @brief   Creates an array in which no camera has been found yet.
+ */
+ThermalArray::ThermalArray (void)
+{
+    memset (present, 0, sizeof (present));
+    memset (stats, 0, sizeof (stats));
+    memset (settling, 0, sizeof (settling));
+    memset (reset_tick, 0, sizeof (reset_tick));
+    p_bus = &Wire;
+    count = 0;
+    next = 0;
+    start_ms = 0;
+}
+
+
+/** @brief   Starts every camera in THERMAL_SENSOR_LAYOUT and tests each one which answers.
+ *  @details A camera which doesn't answer at its address, or fails its
+ *           self-test, is left out of the timetable, so FireBot still runs
+ *           with the cameras it has. With the interrupt-driven driver every
+ *           camera is reset first and then they all settle together, which
+ *           saves 100 ms for each camera after the first. Each camera left
+ *           out waits BOOT_RETRY_FIRST before retry() tries it again.
+ *  @param   p_wire The I2C bus the cameras are on
+ *  @return  The number of cameras which answered and passed
+ */
+uint8_t ThermalArray::begin (TwoWire* p_wire)
+{
+    count = 0;
+    p_bus = p_wire;
+#ifdef AMG88XX_ASYNC
+    bool answered = false;
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        present[sensor] = sensors[sensor].begin (THERMAL_SENSOR_LAYOUT[sensor].address, p_wire, false);
+        answered = answered || present[sensor];
+    }
+    if (answered)
+    {
+        delay (100);
+    }
+#else
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        present[sensor] = sensors[sensor].begin (THERMAL_SENSOR_LAYOUT[sensor].address, p_wire);
+    }
+#endif
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        present[sensor] = present[sensor] && self_test (sensor);
+        count += present[sensor];
+        if (!present[sensor])
+        {
+            retries[sensor] = BootRetry ();
+            retries[sensor].failed ();
+            settling[sensor] = false;
+        }
+    }
+    start_ms = millis ();
+    return count;
+}
+
+
+/** @brief   Tries again to bring up a camera which isn't in the timetable.
+ *  @details Call this for each missing camera between frames, as often as
+ *           convenient. When the wait since the last try is over the camera
+ *           is reset, without waiting for it to settle; once it has settled,
+ *           at a later call, it is self-tested, and if it passes it joins
+ *           the timetable from the next call of next_sensor(). Each failure
+ *           doubles the wait, up to BOOT_RETRY_MAX, so a camera which stays
+ *           missing costs one failed transfer every second or so.
+ *  @param   sensor The camera to try
+ *  @param   p_wait_us Where to put the time the task spent blocked on the bus, 0 if it wasn't used
+ *  @return  true if the camera has just joined the timetable
+ */
+bool ThermalArray::retry (uint8_t sensor, uint32_t* p_wait_us)
+{
+    *p_wait_us = 0;
+    if (present[sensor])
+    {
+        return false;
+    }
+    if (settling[sensor])
+    {
+        if ((TickType_t)(xTaskGetTickCount () - reset_tick[sensor]) < CAMERA_SETTLE_TICKS)
+        {
+            return false;
+        }
+        settling[sensor] = false;
+        bool passed = self_test (sensor);
+        *p_wait_us = get_wait_us (sensor);
+        if (passed)
+        {
+            lock.enter ();
+            present[sensor] = true;
+            count++;
+            lock.exit ();
+            return true;
+        }
+        retries[sensor].failed ();
+        return false;
+    }
+    if (!retries[sensor].is_due ())
+    {
+        return false;
+    }
+#ifdef AMG88XX_ASYNC
+    settling[sensor] = sensors[sensor].begin (THERMAL_SENSOR_LAYOUT[sensor].address, p_bus, false);
+#else
+    settling[sensor] = sensors[sensor].begin (THERMAL_SENSOR_LAYOUT[sensor].address, p_bus);
+#endif
+    *p_wait_us = get_wait_us (sensor);
+    reset_tick[sensor] = xTaskGetTickCount ();
+    if (!settling[sensor])
+    {
+        retries[sensor].failed ();
+    }
+    return false;
+}
+
+
+/** @brief   Checks that a camera which answered gives real frames.
+ *  @details One frame is read and must not have every pixel the same: a part
+ *           still in reset or which hasn't made its first frame reads all
+ *           zeros, and a bus with a stuck line reads all ones, where a real
+ *           scene always has some noise. The frame isn't counted in the
+ *           statistics.
+ *  @param   sensor The camera to test
+ *  @return  true if the camera passed
+ */
+bool ThermalArray::self_test (uint8_t sensor)
+{
+    int16_t pixels[FRAME_PIXELS];
+#ifdef AMG88XX_ASYNC
+    if (!sensors[sensor].read_frame (pixels))
+    {
+        return false;
+    }
+#else
+    sensors[sensor].readPixels (pixel_temps);
+    for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+    {
+        pixels[pixel] = (int16_t)lroundf (pixel_temps[pixel] * 4.0f);
+    }
+#endif
+    for (uint8_t pixel = 1; pixel < FRAME_PIXELS; pixel++)
+    {
+        if (pixels[pixel] != pixels[0])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/** @brief   Returns the camera whose slot comes next, taking the cameras in turn.
+ *  @details Only call this once begin() has found at least one camera.
+ */
+uint8_t ThermalArray::next_sensor (void)
+{
+    while (!present[next])
+    {
+        next = (next + 1) % THERMAL_SENSORS;
+    }
+    uint8_t sensor = next;
+    next = (next + 1) % THERMAL_SENSORS;
+    return sensor;
+}
+
+
+/** @brief   Returns one bit for each camera in the timetable, bit 0 for the first in THERMAL_SENSOR_LAYOUT.
+ */
+uint8_t ThermalArray::get_present_mask (void) const
+{
+    uint8_t mask = 0;
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        mask |= present[sensor] ? 1 << sensor : 0;
+    }
+    return mask;
+}
+
+
+/** @brief   Reads one whole frame from a camera in a single burst.
+ *  @details A frame which can't be read, because the camera has stopped
+ *           answering, leaves the buffer as it was, which is an old frame
+ *           and perhaps one from another camera; the caller must not use it.
+ *           Such reads are counted apart from the frames. The Adafruit
+ *           library doesn't say whether a read worked, so with it every
+ *           read counts as one.
+ *  @param   sensor The camera to read
+ *  @param   p_pixels Where to put the 64 pixels, in 0.25 degree C counts
+ *  @param   p_bus_us Where to put the time the read took on the bus, in microseconds
+ *  @return  true if the frame was read
+ */
+bool ThermalArray::read (uint8_t sensor, int16_t* p_pixels, uint32_t* p_bus_us)
+{
+    uint32_t start_us = micros ();
+#ifdef AMG88XX_ASYNC
+    bool good = sensors[sensor].read_frame (p_pixels);
+    uint32_t bus_us = micros () - start_us;
+    uint32_t cpu_us = bus_us - sensors[sensor].get_wait_us ();
+#else
+    sensors[sensor].readPixels (pixel_temps);
+    bool good = true;
+    uint32_t bus_us = micros () - start_us;
+    uint32_t cpu_us = bus_us;
+
+    for (uint8_t pixel = 0; pixel < FRAME_PIXELS; pixel++)
+    {
+        p_pixels[pixel] = (int16_t)lroundf (pixel_temps[pixel] * 4.0f);
+    }
+#endif
+
+    lock.enter ();
+    thermal_sensor_stats& counters = stats[sensor];
+    if (good)
+    {
+        counters.frames++;
+        counters.bus_us += bus_us;
+        counters.bus_max_us = bus_us > counters.bus_max_us ? bus_us : counters.bus_max_us;
+        counters.cpu_us += cpu_us;
+    }
+    else
+    {
+        counters.failed++;
+    }
+    lock.exit ();
+
+    *p_bus_us = bus_us;
+    return good;
+}
+
+
+/** @brief   Sets a camera's interrupt levels and turns its INT output on in absolute mode.
+ *  @param   sensor The camera
+ *  @param   high_c Pixels above this, in degrees C, set the interrupt
+ *  @param   low_c Pixels below this, in degrees C, set the interrupt
+ */
+void ThermalArray::setup_interrupt (uint8_t sensor, float high_c, float low_c)
+{
+    // The hysteresis is the one the Adafruit library uses when it isn't given
+#ifdef AMG88XX_ASYNC
+    sensors[sensor].set_interrupt_levels (high_c, low_c, high_c * 0.95f);
+    sensors[sensor].enable_interrupt (true);
+#else
+    sensors[sensor].setInterruptLevels (high_c, low_c);
+    sensors[sensor].setInterruptMode (AMG88xx_ABSOLUTE_VALUE);
+    sensors[sensor].enableInterrupt ();
+#endif
+}
+
+
+/** @brief   Reads a camera's interrupt table, one bit for each pixel past a level.
+ *  @param   sensor The camera
+ *  @param   p_table Where to put the 8 bytes of the table
+ */
+void ThermalArray::read_interrupt (uint8_t sensor, uint8_t* p_table)
+{
+#ifdef AMG88XX_ASYNC
+    sensors[sensor].read_interrupt (p_table);
+#else
+    sensors[sensor].getInterrupt (p_table);
+#endif
+}
+
+
+/** @brief   Clears a camera's interrupt table so that its INT output can fall again.
+ */
+void ThermalArray::clear_interrupt (uint8_t sensor)
+{
+#ifdef AMG88XX_ASYNC
+    sensors[sensor].clear_interrupt ();
+#else
+    sensors[sensor].clearInterrupt ();
+#endif
+}
+
+
+/** @brief   Returns a consistent copy of one camera's counters.
+ */
+thermal_sensor_stats ThermalArray::get_stats (uint8_t sensor)
+{
+    lock.enter ();
+    thermal_sensor_stats copy = stats[sensor];
+    lock.exit ();
+
+    return copy;
+}
+
+
+/** @brief   Prints each camera's frame rate and share of the bus, one line each.
+ *  @param   printer The serial port or other stream to print to
+ */
+void ThermalArray::print_stats (Print& printer)
+{
+    uint32_t elapsed_ms = millis () - start_ms;
+    uint32_t bus_total_us = 0;
+    for (uint8_t sensor = 0; sensor < THERMAL_SENSORS; sensor++)
+    {
+        printer << "Camera 0x";
+        printer.print (THERMAL_SENSOR_LAYOUT[sensor].address, HEX);
+        printer << " at " << (int)THERMAL_SENSOR_LAYOUT[sensor].offset_deg << " deg: ";
+        if (!present[sensor])
+        {
+            printer << "not found" << endl;
+            continue;
+        }
+        thermal_sensor_stats copy = get_stats (sensor);
+        bus_total_us += copy.bus_us;
+        float fps = elapsed_ms ? copy.frames * 1000.0f / elapsed_ms : 0.0f;
+        float busy = elapsed_ms ? copy.bus_us / (elapsed_ms * 10.0f) : 0.0f;
+        printer << copy.frames << " frames, " << fps << " fps, bus " << busy << "% busy, read "
+                << (copy.frames ? copy.bus_us / copy.frames : 0) << " us mean, " << copy.bus_max_us
+                << " us max, " << (copy.frames ? copy.cpu_us / copy.frames : 0) << " us of processor, "
+                << copy.failed << " reads failed" << endl;
+    }
+    printer << "Cameras: bus " << (elapsed_ms ? bus_total_us / (elapsed_ms * 10.0f) : 0.0f) << "% busy" << endl;
+}
@@ -0,0 +1,146 @@
+/** @file thermal_array.h
+ *  This file contains the array of AMG88xx thermal cameras which share the
+ *  I2C bus. The AMG8833 answers at 0x69 or 0x68 depending on its AD_SELECT
+ *  pin, so two of them can sit on one bus; FireBot has one looking the way
+ *  the nozzle points and one looking the opposite way, so that the whole
+ *  circle is seen in half a turn of the turntable. The cameras are listed
+ *  in THERMAL_SENSOR_LAYOUT with their address, their INT pin and the
+ *  direction they look relative to the nozzle. Defining
+ *  THERMAL_SINGLE_SENSOR at build time leaves only the front camera.
+ *
+ *  Frame reads are scheduled on a timetable rather than made together: the
+ *  camera task's period is split into one slot per camera and each slot
+ *  reads one whole frame in a single burst, so the bus is never held for
+ *  longer than one frame and lower priority tasks get the processor between
+ *  the reads. The array counts the frames read from each camera and the
+ *  time spent on the bus, from which it reports each camera's frame rate
+ *  and its share of the bus.
+ *
+ *  The cameras are driven by Amg88xxAsync (see amg88xx_async.h), which
+ *  blocks the camera task on a notification while the I2C interrupt runs
+ *  each transfer, so the processor goes to lower priority tasks during
+ *  the reads. The array also counts the processor time each read took,
+ *  which is the bus time less the time the task was blocked. Defining
+ *  THERMAL_BLOCKING_I2C at build time goes back to the Adafruit library,
+ *  whose reads keep the processor busy for all of their bus time.
+ *
+ *  At power-up each camera which answers must also pass a self-test, giving
+ *  a frame whose pixels aren't all the same, before it is put in the
+ *  timetable. begin() may be called again while no camera has passed, as
+ *  task_Thermal_Sensor does with a growing wait between tries (see boot.h).
+ *  After that, retry() is called for each camera which isn't in the
+ *  timetable, between frames; it resets the camera, and once it has
+ *  settled tests it, with the same growing wait between tries, and a
+ *  camera which passes joins the timetable.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _THERMAL_ARRAY_H_
+#define _THERMAL_ARRAY_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_AMG88xx.h>        // Header for the methods provided by the thermal camera manufacturer
+
+#include "amg88xx_async.h"           // Header for the camera driver which doesn't keep the processor busy
+#include "frame_ring.h"              // Header for the frame size
+#include "core_lock.h"               // Header for the lock which also holds off the other core
+#include "boot.h"                    // Header for the growing wait between tries at a missing camera
+
+/// Where one thermal camera is wired and which way it looks
+struct thermal_sensor_config
+{
+    uint8_t address;                         ///< I2C address, 0x69 with AD_SELECT high or 0x68 with it low
+    uint32_t int_pin;                        ///< MCU pin its INT output is wired to
+    float offset_deg;                        ///< Direction it looks, in degrees forward of the nozzle
+};
+
+/// The thermal cameras on the bus; the first one looks the way the nozzle points
+constexpr thermal_sensor_config THERMAL_SENSOR_LAYOUT[] =
+{
+    { 0x69, PC7, 0.0f },
+#ifndef THERMAL_SINGLE_SENSOR
+    { 0x68, PC8, 180.0f },
+#endif
+};
+
+/// Number of thermal cameras in THERMAL_SENSOR_LAYOUT
+constexpr uint8_t THERMAL_SENSORS = sizeof (THERMAL_SENSOR_LAYOUT) / sizeof (THERMAL_SENSOR_LAYOUT[0]);
+static_assert (THERMAL_SENSORS <= 8, "a mask of the cameras present has one bit each in a byte");
+static_assert (THERMAL_SENSORS <= FRAME_RING_CAMERAS, "the frame ring counts lost frames for each camera");
+
+/// Counters kept for each camera
+struct thermal_sensor_stats
+{
+    uint32_t frames;                         ///< Frames read
+    uint32_t bus_us;                         ///< Time spent reading them over I2C; wraps after hours
+    uint32_t bus_max_us;                     ///< Longest frame read
+    uint32_t cpu_us;                         ///< Processor time the camera task spent on them; wraps after hours
+    uint32_t failed;                         ///< Reads which failed on the bus, whose frames were thrown away
+};
+
+/** @brief   Thermal cameras sharing one I2C bus, read one frame at a time in turn.
+ *  @details Only task_Thermal_Sensor reads frames. The counters may be looked
+ *           at from any task; they are copied in a critical section.
+ */
+class ThermalArray
+{
+protected:
+#ifdef AMG88XX_ASYNC
+    Amg88xxAsync sensors[THERMAL_SENSORS];               ///< Driver for each camera
+#else
+    Adafruit_AMG88xx sensors[THERMAL_SENSORS];           ///< Driver for each camera
+    float pixel_temps[FRAME_PIXELS];                     ///< Frame in degrees C as the library reads it
+#endif
+    bool present[THERMAL_SENSORS];                       ///< Whether each camera has passed and is in the timetable
+    BootRetry retries[THERMAL_SENSORS];                  ///< Wait before each missing camera is tried again
+    bool settling[THERMAL_SENSORS];                      ///< Whether each missing camera answered its reset and is settling
+    TickType_t reset_tick[THERMAL_SENSORS];              ///< When each settling camera was reset
+    TwoWire* p_bus;                                      ///< The bus the cameras are on, given to begin()
+    thermal_sensor_stats stats[THERMAL_SENSORS];         ///< Counters for each camera
+    uint8_t count;                                       ///< Number of cameras which answered
+    uint8_t next;                                        ///< Camera whose slot comes next
+    uint32_t start_ms;                                   ///< When begin() finished, for the rates
+    CoreLock lock;                                       ///< Guards the counters against the other tasks and core
+
+public:
+    ThermalArray (void);
+
+    uint8_t begin (TwoWire* p_wire = &Wire);
+    bool self_test (uint8_t sensor);
+    bool retry (uint8_t sensor, uint32_t* p_wait_us);
+    uint8_t next_sensor (void);
+    bool read (uint8_t sensor, int16_t* p_pixels, uint32_t* p_bus_us);
+
+    void setup_interrupt (uint8_t sensor, float high_c, float low_c);
+    void read_interrupt (uint8_t sensor, uint8_t* p_table);
+    void clear_interrupt (uint8_t sensor);
+
+    thermal_sensor_stats get_stats (uint8_t sensor);
+    void print_stats (Print& printer);
+
+    /// Returns the number of cameras in the timetable
+    uint8_t get_count (void) const { return count; }
+
+    /// Returns whether a camera has passed its self-test and is in the timetable
+    bool is_present (uint8_t sensor) const { return present[sensor]; }
+
+    uint8_t get_present_mask (void) const;
+
+    /// Returns how many tries a camera has taken, counting the one at boot
+    uint16_t get_tries (uint8_t sensor) const { return retries[sensor].get_tries (); }
+
+    /// Returns the value of millis() when begin() finished, which the rates are counted from
+    uint32_t get_start_ms (void) const { return start_ms; }
+
+    /// Returns the time the calling task spent blocked on the bus in a camera's last transfer, in microseconds
+#ifdef AMG88XX_ASYNC
+    uint32_t get_wait_us (uint8_t sensor) const { return sensors[sensor].get_wait_us (); }
+#else
+    uint32_t get_wait_us (uint8_t sensor) const { (void)sensor; return 0; }
+#endif
+};
+
+#endif // _THERMAL_ARRAY_H_
@@ -0,0 +1,224 @@
+/** @file trace.cpp
+ *  This file contains the rings of FireBot's binary trace log and task_Trace,
+ *  which empties them onto the serial port. Each record goes out as
+ *
+ *      0xA5, source, 8 record bytes (little endian), checksum
+ *
+ *  where the checksum is the complement of the sum of the source and record
+ *  bytes. The decoder finds records by the sync byte and checks each one
+ *  against its checksum, so text printed to the same port, such as the
+ *  greeting in setup(), is skipped. Each drain starts with a TRACE_SYNC
+ *  record which gives the clock rate and a time stamp the decoder uses to
+ *  follow the 32 bit time stamps through their wrap-around. While a capture
+ *  is being recorded (see capture.h) the same records go out in the capture
+ *  format instead, merged with the thermal camera frames. While the live
+ *  frame stream is running (see frame_stream.h) its packets go out after
+ *  each drain's records.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+#include "trace.h"                   // Header for the trace log
+#include "task_stats.h"              // Header for the task statistics
+#include "shares.h"                  // Header for the thermal map and cameras it prints
+#include "capture.h"                 // Header for the capture format sent instead of the log while recording
+#include "atomic_share.h"            // Header for the share access benchmark
+#include "frame_stream.h"            // Header for the live stream of camera frames sent with the log
+#include "boot.h"                    // Header for the time from power-up to armed
+
+static_assert (sizeof (trace_record) == 8, "trace records must pack into eight bytes");
+static_assert ((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+static_assert (TRACE_FRAME_SIZE == sizeof (trace_record) + 3, "a frame is a record plus three bytes");
+static_assert ((TRACE_RINGS * (TRACE_RING_SIZE + 1) + 1) * TRACE_FRAME_SIZE * 10
+               <= TRACE_BAUD_RATE * TRACE_DRAIN_PERIOD / 1000,
+               "the serial port must be able to send full rings before the next drain");
+
+/// One ring for each task or interrupt which writes records
+trace_ring trace_rings[TRACE_RINGS];
+
+/// Run-time statistics of task_Trace
+TaskStats trace_stats;
+
+
+/** @brief   Turns a record into the bytes which are sent for it.
+ *  @param   source Where the record came from
+ *  @param   record The record
+ *  @param   p_buffer Space for TRACE_FRAME_SIZE bytes
+ *  @return  The number of bytes put in the buffer, which is TRACE_FRAME_SIZE
+ */
+size_t trace_encode (trace_source source, const trace_record& record, uint8_t* p_buffer)
+{
+    p_buffer[0] = TRACE_SYNC_BYTE;
+    p_buffer[1] = source;
+    memcpy (p_buffer + 2, &record, sizeof (record));
+    uint8_t sum = 0;
+    for (uint8_t index = 1; index < TRACE_FRAME_SIZE - 1; index++)
+    {
+        sum += p_buffer[index];
+    }
+    p_buffer[TRACE_FRAME_SIZE - 1] = (uint8_t)~sum;
+    return TRACE_FRAME_SIZE;
+}
+
+
+/** @brief   Starts the cycle counter used for time stamps.
+ *  @details Must be called in setup() before anything writes a record.
+ */
+void trace_begin (void)
+{
+    memset (trace_rings, 0, sizeof (trace_rings));
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+
+/** @brief   Sends every record waiting in the trace rings as framed trace records.
+ *  @details Each slot is handed back to its writer as soon as it has been copied.
+ *  @param   p_dropped_sent Drop count of each ring already reported
+ *  @param   drains Number of this run of task_Trace, sent with the sync record
+ *  @param   clock_mhz Rate of trace_clock(), sent with the sync record
+ */
+static void trace_send (uint16_t* p_dropped_sent, uint16_t drains, uint8_t clock_mhz)
+{
+    uint8_t frame[TRACE_FRAME_SIZE];            // One record as it is sent
+
+    // Every run starts with a sync record so the decoder can place the others in time
+    trace_record record = { trace_clock (), TRACE_SYNC, clock_mhz, drains };
+    Serial.write (frame, trace_encode (TRACE_DRAIN, record, frame));
+
+    for (uint8_t source = 0; source < TRACE_RINGS; source++)
+    {
+        trace_ring& ring = trace_rings[source];
+
+        // Report records lost since the last run
+        uint16_t dropped = __atomic_load_n (&ring.dropped, __ATOMIC_RELAXED);
+        if (dropped != p_dropped_sent[source])
+        {
+            record = { trace_clock (), TRACE_DROPPED, source, (uint16_t)(dropped - p_dropped_sent[source]) };
+            Serial.write (frame, trace_encode (TRACE_DRAIN, record, frame));
+            p_dropped_sent[source] = dropped;
+        }
+
+        // Send the records, handing each slot back to the writer as soon as it's copied
+        uint16_t head = __atomic_load_n (&ring.head, __ATOMIC_ACQUIRE);
+        uint16_t tail = ring.tail;
+        while (tail != head)
+        {
+            trace_encode ((trace_source)source, ring.records[tail & (TRACE_RING_SIZE - 1)], frame);
+            tail++;
+            __atomic_store_n (&ring.tail, tail, __ATOMIC_RELEASE);
+            Serial.write (frame, TRACE_FRAME_SIZE);
+        }
+    }
+}
+
+
+/** @brief   This is the task function that sends the trace log over the serial port.
+ *  @details The task has the lowest priority, so it only runs when nothing else
+ *           has work to do. Each run empties every ring and reports the records
+ *           which were dropped since the last run. The port can send all of that
+ *           before the next run, so the task may wait in Serial.write() while
+ *           the port catches up, but only in time which no other task wants.
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+void task_Trace (void* p_params)
+{
+    (void)p_params;                             // Shuts up a compiler warning
+
+    uint16_t dropped_sent[TRACE_RINGS] = { 0 }; // Drop counts already reported
+    uint16_t drains = 0;                        // Runs of this task, sent with each sync record
+
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    const uint8_t clock_mhz = (uint8_t)(SystemCoreClock / 1000000);
+#else
+    const uint8_t clock_mhz = 1;
+#endif
+
+    // Initialise the xLastWakeTime variable with the current time.
+    // It will be used to run the task at precise intervals
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    for (;;)
+    {
+        trace_stats.begin_run (xLastWakeTime);
+
+        // While a capture is running the records go out in the capture format,
+        //     merged with the camera frames, instead of as framed trace records
+        if (capturing.get ())
+        {
+            capture_drain (Serial, dropped_sent);
+        }
+        else
+        {
+            trace_send (dropped_sent, drains++, clock_mhz);
+            frame_stream_send (Serial);
+        }
+
+        // Sending the letter 's' asks for the task, camera and boot statistics, 'p' for the
+        //     thermal map of the room and 'b' for the cost of reading and writing
+        //     shares (see atomic_share.h), which are printed as text between two runs
+        //     of binary records. 'f' starts or stops the live frame stream (see
+        //     frame_stream.h). 'r' starts or stops a capture (see capture.h), during
+        //     which nothing else is printed so that the capture can be saved as it is
+        while (Serial.available () > 0)
+        {
+            int command = Serial.read ();
+            if (command == 'r')
+            {
+                if (capturing.get ())
+                {
+                    capture_stop (Serial, dropped_sent);
+                }
+                else
+                {
+                    capture_start (Serial, thermal_array.get_count ());
+                }
+            }
+            else if (capturing.get ())
+            {
+                continue;
+            }
+            else if (command == 's')
+            {
+                task_stats_report (Serial);
+                thermal_array.print_stats (Serial);
+                boot_report (Serial);
+            }
+            else if (command == 'p')
+            {
+                panorama.print (Serial);
+            }
+            else if (command == 'b')
+            {
+                atomic_share_bench (Serial);
+            }
+            else if (command == 'f')
+            {
+                if (streaming.get ())
+                {
+                    streaming.put (false);
+                }
+                else
+                {
+                    frame_stream_start ();
+                }
+            }
+        }
+        trace_stats.end_run ();
+
+        // This type of delay waits until it has been the given number of RTOS
+        // ticks since the task previously began running. This prevents timing
+        // inaccuracy due to not accounting for how long the task took to run
+        vTaskDelayUntil (&xLastWakeTime, TRACE_DRAIN_PERIOD);
+    }
+}
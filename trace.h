@@ -0,0 +1,150 @@
+/** @file trace.h
+ *  This file contains FireBot's binary trace log. Each task and interrupt
+ *  which has something to report writes small fixed-size records into a
+ *  ring of its own: the dispatcher's events and state changes, every motor
+ *  drive() command, limit switch edges, the thermal camera's interrupt and
+ *  the statistics of each camera frame. Because every ring has exactly one
+ *  writer and one reader, task_Trace, neither side ever takes a lock or
+ *  disables interrupts, so records can be written from interrupt service
+ *  routines and from tasks of any priority without upsetting their timing.
+ *
+ *  task_Trace runs at the lowest priority. Every TRACE_DRAIN_PERIOD ticks it
+ *  empties the rings onto the serial port as framed binary records; full
+ *  rings are less than the 115200 baud port can carry in that time. The program in
+ *  sim/trace_decode.cpp turns the stream back into a timeline.
+ *
+ *  Writing a record costs a fixed amount of time: trace_write() is inlined,
+ *  has no loops and makes no calls on the STM32, where the timestamp is the
+ *  processor's cycle counter. It compiles to about 20 instructions and stays
+ *  within TRACE_WRITE_CYCLES on the Cortex-M4. A record which finds its ring
+ *  full is dropped and counted rather than waiting.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <Arduino.h>
+
+/// Most processor cycles trace_write() takes on the Cortex-M4
+const uint32_t TRACE_WRITE_CYCLES = 40;
+
+/// Number of records each ring holds; must be a power of two
+const uint16_t TRACE_RING_SIZE = 32;
+
+/// The number of RTOS ticks between runs of task_Trace; the thermal camera fills 20 slots of its ring in that time
+const uint32_t TRACE_DRAIN_PERIOD = 500;
+
+/// Baud rate of the serial port which carries the log
+const uint32_t TRACE_BAUD_RATE = 115200;
+
+/// First byte of each record on the serial port
+const uint8_t TRACE_SYNC_BYTE = 0xA5;
+
+/// Bytes per record on the serial port: sync byte, source, record and checksum
+const uint8_t TRACE_FRAME_SIZE = 11;
+
+/// Where a record came from; each source except the drain task has its own ring
+enum trace_source : uint8_t
+{
+    TRACE_DISPATCHER,                        ///< task_Dispatcher
+    TRACE_ROTATION,                          ///< task_Rotation_Base
+    TRACE_THERMAL,                           ///< task_Thermal_Sensor
+    TRACE_EXTINGUISHER,                      ///< task_Extinguisher
+    TRACE_SWITCH1,                           ///< Limit switch 1 interrupt or polling task
+    TRACE_SWITCH2,                           ///< Limit switch 2 interrupt or polling task
+    TRACE_AMG_ISR,                           ///< First thermal camera's interrupt; each camera's has a ring of its own
+    TRACE_AMG_ISR_BACK,                      ///< Second thermal camera's interrupt
+    TRACE_DRAIN,                             ///< task_Trace itself, which writes no ring
+    TRACE_RINGS = TRACE_DRAIN                ///< Number of rings
+};
+
+/// What a record says; @c arg and @c value hold what is listed for each type
+enum trace_type : uint8_t
+{
+    TRACE_SYNC,                              ///< Start of a drain: arg clock in MHz, value drain count
+    TRACE_DROPPED,                           ///< Records lost to a full ring: arg source, value count
+    TRACE_EVENT,                             ///< Dispatcher got an event: arg event, value old state | new state << 8
+    TRACE_MOTOR,                             ///< drive() command: arg motor 1 or 2, value speed
+    TRACE_SWITCH,                            ///< Limit switch edge: arg switch 1 or 2, value 1 if passed on, 0 if bounce
+    TRACE_AMG_INT,                           ///< Thermal camera threshold interrupt: arg camera
+    TRACE_FRAME,                             ///< Frame published: arg hot pixels, value I2C read time in us
+    TRACE_FRAME_TEMP,                        ///< Same frame: arg blobs, value hottest pixel in 0.25 C
+    TRACE_FRAME_DROPPED,                     ///< No free frame buffer, frame not read
+    TRACE_STROKE,                            ///< Carriage stroke ended: arg 1 clamping or 2 unclamping, value time in ms
+    TRACE_PANORAMA,                          ///< Turntable passed zero: arg cells changed in the map, value hottest bearing in 0.01 deg
+    TRACE_TARGET,                            ///< Fire chosen to aim at: arg fires in the queue, value its bearing in 0.01 deg
+    TRACE_BOOT,                              ///< Part was ready at boot: arg boot_part, value tries it took
+    TRACE_FRAME_FAILED,                      ///< Frame read failed on the bus and was thrown away: arg camera
+    TRACE_CAMERA_JOINED,                     ///< Camera missing at boot passed and joined the timetable: arg camera, value tries
+    TRACE_TYPES                              ///< Number of record types
+};
+
+/// One record; eight bytes with no padding, sent over the serial port as it is in memory
+struct trace_record
+{
+    uint32_t time;                           ///< Cycle counter, or micros() where there is none
+    uint8_t type;                            ///< A trace_type
+    uint8_t arg;                             ///< Small argument, see trace_type
+    uint16_t value;                          ///< Larger argument, see trace_type
+};
+
+/// A single-writer, single-reader ring of records
+struct trace_ring
+{
+    trace_record records[TRACE_RING_SIZE];   ///< Record storage
+    uint16_t head;                           ///< Records written; changed only by the writer
+    uint16_t tail;                           ///< Records read; changed only by task_Trace
+    uint16_t dropped;                        ///< Records lost to a full ring; changed only by the writer
+};
+
+extern trace_ring trace_rings[TRACE_RINGS];
+
+/** @brief   Returns the time stamp for a record.
+ *  @details On the STM32 this is the free-running cycle counter, which is one
+ *           load; elsewhere it is micros(). The decoder is told which through
+ *           the clock rate in each TRACE_SYNC record.
+ */
+inline uint32_t trace_clock (void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    return DWT->CYCCNT;
+#else
+    return micros ();
+#endif
+}
+
+/** @brief   Writes one record into a source's ring.
+ *  @details Safe in an interrupt service routine, as long as each source is only
+ *           ever written from one task or one interrupt. The record is filled in
+ *           before the new head is stored, so task_Trace never sees half of it.
+ *  @param   source The task or interrupt writing the record
+ *  @param   type What happened
+ *  @param   arg Small argument, see trace_type
+ *  @param   value Larger argument, see trace_type
+ */
+inline void trace_write (trace_source source, trace_type type, uint8_t arg = 0, uint16_t value = 0)
+{
+    trace_ring& ring = trace_rings[source];
+    uint16_t head = ring.head;
+    if ((uint16_t)(head - __atomic_load_n (&ring.tail, __ATOMIC_ACQUIRE)) >= TRACE_RING_SIZE)
+    {
+        ring.dropped++;
+        return;
+    }
+    trace_record& record = ring.records[head & (TRACE_RING_SIZE - 1)];
+    record.time = trace_clock ();
+    record.type = type;
+    record.arg = arg;
+    record.value = value;
+    __atomic_store_n (&ring.head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+}
+
+size_t trace_encode (trace_source source, const trace_record& record, uint8_t* p_buffer);
+void trace_begin (void);
+
+void task_Trace (void* p_params);
+
+#endif // _TRACE_H_
@@ -0,0 +1,280 @@
+/** @file upsample.cpp
+ *  This file contains the bicubic upsampling of 8x8 thermal frames to 32x32
+ *  and the sub-pixel peak fit. The centre of upsampled pixel i is at camera
+ *  pixel (i + 0.5) / 4 - 0.5, so the four upsampled pixels of each camera
+ *  pixel sit 3/8 and 1/8 of a pixel either side of its centre and each is
+ *  made from the four camera pixels around it with Catmull-Rom weights for
+ *  its phase. Pixels past the edge of the frame are taken to be the same as
+ *  the edge pixel.
+ *
+ *  Rows are done first, with two extra bits of precision kept in the
+ *  result, which is stored transposed so that the columns can be done by
+ *  the same code as the rows. The weights are in 1/4096 and sum to 4096,
+ *  so the pixels must be in the camera's 12 bit range for nothing to
+ *  overflow. Defining UPSAMPLE_PORTABLE at build time forces the plain C
+ *  version, for comparison.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "upsample.h"                // Header for the upsampling
+
+#if !defined UPSAMPLE_PORTABLE && defined __ARM_FEATURE_DSP
+    #define UPSAMPLE_ARM_DSP         // Cortex-M4/M7 SIMD instructions from CMSIS
+#elif !defined UPSAMPLE_PORTABLE && defined __SSE2__
+    #define UPSAMPLE_SSE2            // x86 host
+    #include <emmintrin.h>
+#endif
+
+/// Bits of the weights' fixed point
+const uint8_t WEIGHT_BITS = 12;
+
+/// Extra bits of precision the row pass keeps for the column pass; UPSAMPLE_SCALE is 1 << ROW_EXTRA_BITS
+const uint8_t ROW_EXTRA_BITS = 2;
+
+/// Catmull-Rom weights of the four camera pixels around each of the four phases of upsampled pixel
+constexpr int16_t WEIGHTS[4][4] =
+{
+    { -180, 1596, 2980, -300 },              // 5/8 of the way from the pixel before
+    {  -28,  372, 3948, -196 },              // 7/8
+    { -196, 3948,  372,  -28 },              // 1/8 of the way from the nearest pixel
+    { -300, 2980, 1596, -180 }               // 3/8
+};
+
+/// First of the four camera pixels for each phase, counted from the camera pixel two before
+static const uint8_t FIRST_TAP[4] = { 0, 0, 1, 1 };
+
+/// Camera pixels along one side of a frame
+const uint8_t SIDE = 8;
+
+/// A line of camera pixels with two copies of each edge pixel added at either end
+const uint8_t PADDED = SIDE + 4;
+
+/// Upsampled pixels either way of the hottest one which count toward the peak, a camera pixel and a half
+const int8_t PEAK_REACH = 6;
+
+/** @brief   Packs two weights into one word for SMLAD or PMADDWD, the first in the low half.
+ */
+constexpr uint32_t weight_pair (int16_t first, int16_t second)
+{
+    return (uint16_t)first | ((uint32_t)(uint16_t)second << 16);
+}
+
+#ifdef UPSAMPLE_ARM_DSP
+/// WEIGHTS in pairs for SMLAD
+static const uint32_t WEIGHT_PAIRS[4][2] =
+{
+    { weight_pair (WEIGHTS[0][0], WEIGHTS[0][1]), weight_pair (WEIGHTS[0][2], WEIGHTS[0][3]) },
+    { weight_pair (WEIGHTS[1][0], WEIGHTS[1][1]), weight_pair (WEIGHTS[1][2], WEIGHTS[1][3]) },
+    { weight_pair (WEIGHTS[2][0], WEIGHTS[2][1]), weight_pair (WEIGHTS[2][2], WEIGHTS[2][3]) },
+    { weight_pair (WEIGHTS[3][0], WEIGHTS[3][1]), weight_pair (WEIGHTS[3][2], WEIGHTS[3][3]) }
+};
+#endif
+
+
+/** @brief   Upsamples one line of eight pixels to 32.
+ *  @param   p_line The eight pixels
+ *  @param   p_out Where to put the first of the 32
+ *  @param   stride Distance between outputs in @c p_out
+ *  @param   shift Bits to drop from each weighted sum, with rounding
+ */
+static void upsample_line (const int16_t* p_line, int16_t* p_out, uint8_t stride, uint8_t shift)
+{
+    int16_t padded[PADDED];
+    padded[0] = padded[1] = p_line[0];
+    memcpy (&padded[2], p_line, SIDE * sizeof (int16_t));
+    padded[PADDED - 2] = padded[PADDED - 1] = p_line[SIDE - 1];
+    const int32_t round = 1 << (shift - 1);
+
+#if defined UPSAMPLE_ARM_DSP
+    // Each output is two SMLADs, each multiplying two pixels by two weights
+    for (uint8_t pixel = 0; pixel < SIDE; pixel++)
+    {
+        for (uint8_t phase = 0; phase < 4; phase++)
+        {
+            const int16_t* p_taps = &padded[pixel + FIRST_TAP[phase]];
+            uint32_t taps01, taps23;
+            memcpy (&taps01, p_taps, sizeof (taps01));
+            memcpy (&taps23, p_taps + 2, sizeof (taps23));
+            int32_t sum = __SMLAD (taps01, WEIGHT_PAIRS[phase][0], round);
+            sum = __SMLAD (taps23, WEIGHT_PAIRS[phase][1], sum);
+            p_out[(pixel * 4 + phase) * stride] = (int16_t)(sum >> shift);
+        }
+    }
+
+#elif defined UPSAMPLE_SSE2
+    // One phase of all eight camera pixels at a time: PMADDWD multiplies
+    //     interleaved pairs of taps by pairs of weights and adds each pair
+    for (uint8_t phase = 0; phase < 4; phase++)
+    {
+        const int16_t* p_taps = &padded[FIRST_TAP[phase]];
+        __m128i tap0 = _mm_loadu_si128 ((const __m128i*)p_taps);
+        __m128i tap1 = _mm_loadu_si128 ((const __m128i*)(p_taps + 1));
+        __m128i tap2 = _mm_loadu_si128 ((const __m128i*)(p_taps + 2));
+        __m128i tap3 = _mm_loadu_si128 ((const __m128i*)(p_taps + 3));
+        __m128i w01 = _mm_set1_epi32 ((int32_t)weight_pair (WEIGHTS[phase][0], WEIGHTS[phase][1]));
+        __m128i w23 = _mm_set1_epi32 ((int32_t)weight_pair (WEIGHTS[phase][2], WEIGHTS[phase][3]));
+        __m128i rounding = _mm_set1_epi32 (round);
+
+        __m128i low = _mm_add_epi32 (_mm_madd_epi16 (_mm_unpacklo_epi16 (tap0, tap1), w01),
+                                     _mm_madd_epi16 (_mm_unpacklo_epi16 (tap2, tap3), w23));
+        __m128i high = _mm_add_epi32 (_mm_madd_epi16 (_mm_unpackhi_epi16 (tap0, tap1), w01),
+                                      _mm_madd_epi16 (_mm_unpackhi_epi16 (tap2, tap3), w23));
+        low = _mm_srai_epi32 (_mm_add_epi32 (low, rounding), shift);
+        high = _mm_srai_epi32 (_mm_add_epi32 (high, rounding), shift);
+
+        int16_t eight[SIDE];
+        _mm_storeu_si128 ((__m128i*)eight, _mm_packs_epi32 (low, high));
+        for (uint8_t pixel = 0; pixel < SIDE; pixel++)
+        {
+            p_out[(pixel * 4 + phase) * stride] = eight[pixel];
+        }
+    }
+
+#else
+    // Plain C
+    for (uint8_t pixel = 0; pixel < SIDE; pixel++)
+    {
+        for (uint8_t phase = 0; phase < 4; phase++)
+        {
+            const int16_t* p_taps = &padded[pixel + FIRST_TAP[phase]];
+            int32_t sum = round;
+            for (uint8_t tap = 0; tap < 4; tap++)
+            {
+                sum += (int32_t)p_taps[tap] * WEIGHTS[phase][tap];
+            }
+            p_out[(pixel * 4 + phase) * stride] = (int16_t)(sum >> shift);
+        }
+    }
+#endif
+}
+
+
+/** @brief   Upsamples a frame from 8x8 to 32x32 by bicubic interpolation.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts, top row first
+ *  @param   p_upsampled Where to put the 1024 pixels, in 1/16 degree C counts, top row first
+ */
+void upsample_frame (const int16_t* pixels, int16_t* p_upsampled)
+{
+    // Rows first; row r of the camera becomes column r of the transposed result
+    int16_t rows[UPSAMPLE_SIDE][SIDE];
+    for (uint8_t row = 0; row < SIDE; row++)
+    {
+        upsample_line (&pixels[row * SIDE], &rows[0][row], SIDE, WEIGHT_BITS - ROW_EXTRA_BITS);
+    }
+
+    // Then each of the 32 columns, which are now lines of eight
+    for (uint8_t col = 0; col < UPSAMPLE_SIDE; col++)
+    {
+        upsample_line (rows[col], &p_upsampled[col], UPSAMPLE_SIDE, WEIGHT_BITS);
+    }
+}
+
+
+/** @brief   Simple scalar version of upsample_frame(), used to check it.
+ *  @details Works out each output pixel from its own 4x4 camera pixels with
+ *           indexes clamped at the edges, rounding between the row and column
+ *           steps as the fast version does, so it shares no tricks with it.
+ *  @param   pixels The 64 pixels of the frame in 0.25 degree C counts, top row first
+ *  @param   p_upsampled Where to put the 1024 pixels, in 1/16 degree C counts, top row first
+ */
+void upsample_frame_reference (const int16_t* pixels, int16_t* p_upsampled)
+{
+    for (uint8_t out_row = 0; out_row < UPSAMPLE_SIDE; out_row++)
+    {
+        uint8_t row_phase = out_row % 4;
+        int8_t first_row = out_row / 4 + FIRST_TAP[row_phase] - 2;
+        for (uint8_t out_col = 0; out_col < UPSAMPLE_SIDE; out_col++)
+        {
+            uint8_t col_phase = out_col % 4;
+            int8_t first_col = out_col / 4 + FIRST_TAP[col_phase] - 2;
+
+            int32_t sum = 1 << (WEIGHT_BITS - 1);
+            for (uint8_t row_tap = 0; row_tap < 4; row_tap++)
+            {
+                int8_t row = constrain (first_row + row_tap, 0, SIDE - 1);
+                int32_t across = 1 << (WEIGHT_BITS - ROW_EXTRA_BITS - 1);
+                for (uint8_t col_tap = 0; col_tap < 4; col_tap++)
+                {
+                    int8_t col = constrain (first_col + col_tap, 0, SIDE - 1);
+                    across += (int32_t)pixels[row * SIDE + col] * WEIGHTS[col_phase][col_tap];
+                }
+                sum += (int32_t)(int16_t)(across >> (WEIGHT_BITS - ROW_EXTRA_BITS)) * WEIGHTS[row_phase][row_tap];
+            }
+            p_upsampled[out_row * UPSAMPLE_SIDE + out_col] = (int16_t)(sum >> WEIGHT_BITS);
+        }
+    }
+}
+
+
+/** @brief   Turns a position on the upsampled frame into one on the camera's pixels.
+ *  @param   index The upsampled pixel
+ *  @param   offset Where the peak is from its centre, in 1/256 of an upsampled pixel
+ *  @return  The camera pixel in 8.8 fixed point, held to the frame
+ */
+static uint16_t to_camera_pixel (uint8_t index, int16_t offset)
+{
+    int32_t position = ((int32_t)index * 256 + 128 + offset) / 4 - 128;
+    return (uint16_t)constrain (position, 0L, (SIDE - 1) * 256L);
+}
+
+
+/** @brief   Finds the hottest point of an upsampled frame to a fraction of a pixel.
+ *  @details Takes the hottest upsampled pixel, the first if tied, and finds
+ *           the weighted centre of the upsampled pixels within PEAK_REACH of
+ *           it, each weighted by how far it is above a level a sixteenth of
+ *           the way from the coldest pixel of the frame to the hottest. The
+ *           level keeps the background out of the sum, and the reach keeps
+ *           out anything else warm in the frame.
+ *  @param   p_upsampled The 1024 pixels from upsample_frame()
+ *  @param   p_peak Where to put what was found
+ */
+void upsample_peak (const int16_t* p_upsampled, subpixel_peak* p_peak)
+{
+    uint16_t hottest = 0;
+    int16_t coldest = p_upsampled[0];
+    for (uint16_t pixel = 1; pixel < UPSAMPLE_PIXELS; pixel++)
+    {
+        if (p_upsampled[pixel] > p_upsampled[hottest])
+        {
+            hottest = pixel;
+        }
+        coldest = p_upsampled[pixel] < coldest ? p_upsampled[pixel] : coldest;
+    }
+    int8_t peak_row = hottest / UPSAMPLE_SIDE;
+    int8_t peak_col = hottest % UPSAMPLE_SIDE;
+    int16_t peak = p_upsampled[hottest];
+    int16_t level = coldest + (peak - coldest) / 16;
+
+    int32_t sum_w = 0;
+    int32_t sum_wx = 0;
+    int32_t sum_wy = 0;
+    int8_t first_row = peak_row > PEAK_REACH ? peak_row - PEAK_REACH : 0;
+    int8_t last_row = peak_row < UPSAMPLE_SIDE - 1 - PEAK_REACH ? peak_row + PEAK_REACH : UPSAMPLE_SIDE - 1;
+    int8_t first_col = peak_col > PEAK_REACH ? peak_col - PEAK_REACH : 0;
+    int8_t last_col = peak_col < UPSAMPLE_SIDE - 1 - PEAK_REACH ? peak_col + PEAK_REACH : UPSAMPLE_SIDE - 1;
+    for (int8_t row = first_row; row <= last_row; row++)
+    {
+        for (int8_t col = first_col; col <= last_col; col++)
+        {
+            int32_t weight = p_upsampled[row * UPSAMPLE_SIDE + col] - level;
+            if (weight > 0)
+            {
+                sum_w += weight;
+                sum_wx += weight * (col - peak_col);
+                sum_wy += weight * (row - peak_row);
+            }
+        }
+    }
+
+    // The hottest pixel is above the level unless the frame is flat, when it is left where it is
+    int16_t col_offset = sum_w > 0 ? (int16_t)(sum_wx * 256 / sum_w) : 0;
+    int16_t row_offset = sum_w > 0 ? (int16_t)(sum_wy * 256 / sum_w) : 0;
+    p_peak->col = to_camera_pixel (peak_col, col_offset);
+    p_peak->row = to_camera_pixel (peak_row, row_offset);
+    p_peak->temp = peak;
+}
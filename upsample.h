@@ -0,0 +1,50 @@
+/** @file upsample.h
+ *  This file contains the sub-pixel locator of the hottest point in an 8x8
+ *  thermal frame. Each of the camera's pixels covers 7.5 degrees, too much
+ *  to aim the nozzle at a small fire a few meters away by the pixel it
+ *  lands on. The frame is first scaled up to 32x32 by bicubic interpolation,
+ *  which puts a smooth surface through the pixels, and the peak around the
+ *  hottest point of the bigger frame is then located by its weighted
+ *  centre, which is where the fire is to a small fraction of a pixel. On
+ *  fires rendered as the simulated camera sees them this lands about a
+ *  sixteenth of a pixel, half a degree, from the fire on average, against
+ *  a sixth of a pixel for the centre of the pixels over the hotspot
+ *  threshold (see sim/bench_upsample.cpp).
+ *
+ *  Everything is in fixed point. The bicubic kernel is applied to rows and
+ *  then to columns; on a Cortex-M4 it uses the DSP extension's dual 16-bit
+ *  multiply-accumulate, on a host with SSE2 it does eight outputs at a time,
+ *  and elsewhere it falls back on plain C. upsample_frame_reference() is a
+ *  simple scalar version which the fast one must always agree with.
+ *
+ *  @author Hunter Brooks & William Dorosk
+ *  @date   16 Oct 2026 Created file
+ */
+
+#ifndef _UPSAMPLE_H_
+#define _UPSAMPLE_H_
+
+#include <stdint.h>
+
+/// Pixels along each side of an upsampled frame, four for each of the camera's
+const uint8_t UPSAMPLE_SIDE = 32;
+
+/// Number of pixels in an upsampled frame
+const uint16_t UPSAMPLE_PIXELS = UPSAMPLE_SIDE * UPSAMPLE_SIDE;
+
+/// Counts of an upsampled pixel in one count of a camera pixel; upsampled pixels are in 1/16 degree C
+const int16_t UPSAMPLE_SCALE = 4;
+
+/// Where the hottest point of a frame is, to a fraction of a pixel
+struct subpixel_peak
+{
+    uint16_t col;                            ///< Column of the camera's pixels in 8.8 fixed point, 0 to 7
+    uint16_t row;                            ///< Row of the camera's pixels in 8.8 fixed point, 0 to 7
+    int16_t temp;                            ///< Temperature of the hottest upsampled pixel, in 1/16 degree C counts
+};
+
+void upsample_frame (const int16_t* pixels, int16_t* p_upsampled);
+void upsample_frame_reference (const int16_t* pixels, int16_t* p_upsampled);
+void upsample_peak (const int16_t* p_upsampled, subpixel_peak* p_peak);
+
+#endif // _UPSAMPLE_H_